@@ -69,6 +69,12 @@ def ex(cmd):
 def ev(trigger):
 	GemRB.EvaluateString(trigger)
 
+def fstats():
+	s = GemRB.GetFactoryStats()
+	lookups = s["Hits"] + s["Misses"]
+	hitRate = 100.0 * s["Hits"] / lookups if lookups else 0
+	print ("%d cached in %d/%d KB, %.1f%% hits, %d evicted freeing %d KB" % (s["Entries"], s["Bytes"] // 1024, s["Budget"] // 1024, hitRate, s["Evicted"], s["BytesFreed"] // 1024))
+
 # the actual function that the GemRB::Console calls
 def Exec(cmd):
 	import sys
@@ -0,0 +1,145 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "ActorGrid.h"
+
+#include "Scriptable/Actor.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+void ActorGrid::Reset(const Size& mapSize)
+{
+	columns = std::max(1, (mapSize.w + CELL_WIDTH - 1) / CELL_WIDTH);
+	rows = std::max(1, (mapSize.h + CELL_HEIGHT - 1) / CELL_HEIGHT);
+	cells.assign(columns * rows, {});
+	maxCircleSize = 0;
+	for (auto& it : records) {
+		Record& rec = it.second;
+		rec.pos = rec.actor->Pos;
+		rec.cell = CellIndex(rec.pos);
+		cells[rec.cell].push_back({ rec.actor, rec.serial });
+		maxCircleSize = std::max(maxCircleSize, rec.actor->circleSize);
+	}
+	// keep the buckets in insertion order, like the rest of the grid does
+	for (auto& cell : cells) {
+		std::sort(cell.begin(), cell.end(), [](const Entry& a, const Entry& b) {
+			return a.serial < b.serial;
+		});
+	}
+}
+
+// positions outside the map are clamped to the border cells, which
+// the (equally clamped) query rectangles will always include
+size_t ActorGrid::CellIndex(const Point& p) const
+{
+	int x = Clamp(p.x / CELL_WIDTH, 0, columns - 1);
+	int y = Clamp(p.y / CELL_HEIGHT, 0, rows - 1);
+	return y * columns + x;
+}
+
+void ActorGrid::Insert(Actor *actor)
+{
+	if (cells.empty() || records.count(actor)) {
+		return;
+	}
+
+	Record rec { actor, actor->Pos, CellIndex(actor->Pos), nextSerial++ };
+	cells[rec.cell].push_back({ actor, rec.serial });
+	records.emplace(actor, rec);
+	maxCircleSize = std::max(maxCircleSize, actor->circleSize);
+}
+
+void ActorGrid::Remove(const Actor *actor)
+{
+	auto it = records.find(actor);
+	if (it == records.end()) {
+		return;
+	}
+
+	auto& cell = cells[it->second.cell];
+	cell.erase(std::find_if(cell.begin(), cell.end(), [actor](const Entry& e) {
+		return e.actor == actor;
+	}));
+	records.erase(it);
+}
+
+void ActorGrid::Relocate(Record& rec)
+{
+	maxCircleSize = std::max(maxCircleSize, rec.actor->circleSize);
+	if (rec.pos == rec.actor->Pos) {
+		return;
+	}
+
+	rec.pos = rec.actor->Pos;
+	size_t newCell = CellIndex(rec.pos);
+	if (newCell == rec.cell) {
+		return;
+	}
+
+	auto& oldBucket = cells[rec.cell];
+	oldBucket.erase(std::find_if(oldBucket.begin(), oldBucket.end(), [&rec](const Entry& e) {
+		return e.actor == rec.actor;
+	}));
+	auto& newBucket = cells[newCell];
+	auto pos = std::upper_bound(newBucket.begin(), newBucket.end(), rec.serial, [](unsigned long serial, const Entry& e) {
+		return serial < e.serial;
+	});
+	newBucket.insert(pos, { rec.actor, rec.serial });
+	rec.cell = newCell;
+}
+
+void ActorGrid::Update(const Actor *actor)
+{
+	auto it = records.find(actor);
+	if (it != records.end()) {
+		Relocate(it->second);
+	}
+}
+
+// the actors of the covered cells, in insertion order
+void ActorGrid::Collect(const Region& rgn, std::vector<Entry>& entries) const
+{
+	if (cells.empty()) {
+		return;
+	}
+
+	size_t first = CellIndex(rgn.origin);
+	size_t last = CellIndex(rgn.Maximum());
+	int x1 = int(first % columns);
+	int x2 = int(last % columns);
+	int y1 = int(first / columns);
+	int y2 = int(last / columns);
+
+	for (int y = y1; y <= y2; ++y) {
+		for (int x = x1; x <= x2; ++x) {
+			const auto& cell = cells[y * columns + x];
+			entries.insert(entries.end(), cell.begin(), cell.end());
+		}
+	}
+	if (x1 != x2 || y1 != y2) {
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+			return a.serial < b.serial;
+		});
+	}
+}
+
+}
@@ -0,0 +1,113 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef ACTORGRID_H
+#define ACTORGRID_H
+
+#include "exports.h"
+
+#include "Region.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+class Actor;
+
+// A uniform grid over the area, bucketing actors by position, so the
+// point, radius and rect lookups of Map don't have to visit every actor.
+// Queries return a superset of the actors in the requested rectangle
+// (the callers still do the exact checks) in the order they were added
+// to the area, so results match what a scan of Map::actors would find.
+class GEM_EXPORT ActorGrid {
+public:
+	static constexpr int CELL_WIDTH = 128;
+	static constexpr int CELL_HEIGHT = 96;
+
+	void Reset(const Size& mapSize);
+	void Insert(Actor *actor);
+	void Remove(const Actor *actor);
+	// move an actor to the cell of its current position, if it changed
+	// Scriptable::SetPos calls it for every move, so the grid never goes stale
+	void Update(const Actor *actor);
+
+	// calls fn for the actors until it returns true and returns that actor (or nullptr)
+	// nothing is allocated, since the hot lookups (eg. per pathfinder node) go through here
+	// reverse visits them last added first, like the GetActor(i, true) scans did
+	template <typename F>
+	Actor* Query(const Region& rgn, F&& fn, bool reverse = false) const
+	{
+		// borrow the scratch buffer, so a nested query just gets its own
+		std::vector<Entry> entries;
+		std::swap(entries, scratch);
+		Collect(rgn, entries);
+		Actor* found = nullptr;
+		size_t count = entries.size();
+		for (size_t i = 0; i < count; ++i) {
+			const Entry& e = entries[reverse ? count - i - 1 : i];
+			if (fn(e.actor)) {
+				found = e.actor;
+				break;
+			}
+		}
+		entries.clear();
+		std::swap(entries, scratch);
+		return found;
+	}
+	template <typename F>
+	Actor* QueryRadius(const Point& p, int radius, F&& fn) const
+	{
+		radius = std::max(0, radius);
+		return Query(Region(p - Point(radius, radius), Size(2 * radius + 1, 2 * radius + 1)), std::forward<F>(fn));
+	}
+	// the largest circle size seen, for padding the queries of IsOver style checks
+	int MaxCircleSize() const { return maxCircleSize; }
+
+private:
+	struct Entry {
+		Actor *actor;
+		unsigned long serial;
+	};
+	struct Record {
+		Actor *actor;
+		Point pos;
+		size_t cell;
+		unsigned long serial;
+	};
+
+	size_t CellIndex(const Point& p) const;
+	void Collect(const Region& rgn, std::vector<Entry>& entries) const;
+	void Relocate(Record& rec);
+
+	int columns = 0;
+	int rows = 0;
+	std::vector<std::vector<Entry>> cells;
+	std::unordered_map<const Actor*, Record> records;
+	unsigned long nextSerial = 0;
+	int maxCircleSize = 0;
+	mutable std::vector<Entry> scratch;
+};
+
+}
+
+#endif
@@ -25,18 +25,60 @@
 
 namespace GemRB {
 
+static size_t FrameSize(const Holder<Sprite2D>& frame)
+{
+	return frame ? frame->GetPitch() * frame->Frame.h : 0;
+}
+
 AnimationFactory::AnimationFactory(const ResRef &resref,
 								   std::vector<Holder<Sprite2D>> f,
 								   std::vector<CycleEntry> c,
 								   std::vector<index_t> flt)
 : FactoryObject(resref, IE_BAM_CLASS_ID),
 frames(std::move(f)),
+decoded(frames.size(), true),
+frameSizes(frames.size()),
 cycles(std::move(c)),
 FLTable(std::move(flt))
 {
 	assert(frames.size() < InvalidIndex);
 	assert(cycles.size() < InvalidIndex);
 	assert(FLTable.size() < InvalidIndex);
+	for (size_t i = 0; i < frames.size(); ++i) {
+		frameSizes[i] = FrameSize(frames[i]);
+		frameBytes += frameSizes[i];
+	}
+}
+
+AnimationFactory::AnimationFactory(const ResRef &resref, index_t frameCount, FrameLoader load,
+								   size_t loadBytes,
+								   std::vector<CycleEntry> c,
+								   std::vector<index_t> flt)
+: FactoryObject(resref, IE_BAM_CLASS_ID),
+frames(frameCount),
+decoded(frameCount, false),
+frameSizes(frameCount),
+loaderBytes(loadBytes),
+cycles(std::move(c)),
+FLTable(std::move(flt)),
+loader(std::move(load))
+{
+	assert(frames.size() < InvalidIndex);
+	assert(cycles.size() < InvalidIndex);
+	assert(FLTable.size() < InvalidIndex);
+}
+
+const Holder<Sprite2D>& AnimationFactory::Frame(index_t index) const
+{
+	if (!decoded[index]) {
+		size_t bytes = 0;
+		frames[index] = loader(index, bytes);
+		decoded[index] = true;
+		frameSizes[index] = bytes;
+		frameBytes += bytes;
+		UsageChanged(bytes, 0);
+	}
+	return frames[index];
 }
 
 Animation* AnimationFactory::GetCycle(index_t cycle) const noexcept
@@ -49,7 +91,7 @@ Animation* AnimationFactory::GetCycle(index_t cycle) const noexcept
 	std::vector<Animation::frame_t> animframes;
 	animframes.reserve(cycles[cycle].FramesCount);
 	for (index_t i = ff; i < lf; i++) {
-		animframes.push_back(frames[FLTable[i]]);
+		animframes.push_back(Frame(FLTable[i]));
 	}
 	assert(cycles[cycle].FramesCount == animframes.size());
 	return new Animation(std::move(animframes));
@@ -66,7 +108,7 @@ Holder<Sprite2D> AnimationFactory::GetFrame(index_t index, index_t cycle) const
 	if(index >= fc) {
 		return nullptr;
 	}
-	return frames[FLTable[ff+index]];
+	return Frame(FLTable[ff+index]);
 }
 
 Holder<Sprite2D> AnimationFactory::GetFrameWithoutCycle(index_t index) const
@@ -74,7 +116,7 @@ Holder<Sprite2D> AnimationFactory::GetFrameWithoutCycle(index_t index) const
 	if(index >= frames.size()) {
 		return NULL;
 	}
-	return frames[index];
+	return Frame(index);
 }
 
 Holder<Sprite2D> AnimationFactory::GetPaperdollImage(const ieDword *Colors,
@@ -101,7 +143,8 @@ Holder<Sprite2D> AnimationFactory::GetPaperdollImage(const ieDword *Colors,
 		return NULL;
 	}
 
-	Picture2 = frames[second]->copy();
+	const Holder<Sprite2D>& bottom = Frame(second);
+	Picture2 = bottom->copy();
 	if (!Picture2) {
 		return NULL;
 	}
@@ -110,17 +153,18 @@ Holder<Sprite2D> AnimationFactory::GetPaperdollImage(const ieDword *Colors,
 		palette->SetupPaperdollColours(Colors, type);
 	}
 
-	Picture2->Frame.x = frames[second]->Frame.x;
-	Picture2->Frame.y = frames[second]->Frame.y - 80;
+	Picture2->Frame.x = bottom->Frame.x;
+	Picture2->Frame.y = bottom->Frame.y - 80;
 
-	Holder<Sprite2D> spr = frames[first]->copy();
+	const Holder<Sprite2D>& top = Frame(first);
+	Holder<Sprite2D> spr = top->copy();
 	if (Colors) {
 		PaletteHolder palette = spr->GetPalette();
 		palette->SetupPaperdollColours(Colors, type);
 	}
 
-	spr->Frame.x = frames[first]->Frame.x;
-	spr->Frame.y = frames[first]->Frame.y;
+	spr->Frame.x = top->Frame.x;
+	spr->Frame.y = top->Frame.y;
 	return spr;
 }
 
@@ -132,4 +176,28 @@ AnimationFactory::index_t AnimationFactory::GetCycleSize(index_t idx) const
 	return cycles[idx].FramesCount;
 }
 
+size_t AnimationFactory::MemoryUsage() const noexcept
+{
+	return sizeof(AnimationFactory) + cycles.size() * sizeof(CycleEntry) + FLTable.size() * sizeof(index_t) + loaderBytes + frameBytes;
+}
+
+// frames that are not part of any live animation can be decoded again
+size_t AnimationFactory::ReleaseUnused() noexcept
+{
+	if (!loader) return 0;
+
+	size_t freed = 0;
+	for (size_t i = 0; i < frames.size(); ++i) {
+		if (!frames[i] || frames[i]->GetRefCount() > 1) continue;
+
+		freed += frameSizes[i];
+		frameSizes[i] = 0;
+		frames[i] = nullptr;
+		decoded[i] = false;
+	}
+	frameBytes -= freed;
+	UsageChanged(0, freed);
+	return freed;
+}
+
 }
@@ -27,6 +27,8 @@
 #include "Animation.h"
 #include "FactoryObject.h"
 
+#include <functional>
+
 namespace GemRB {
 
 class GEM_EXPORT AnimationFactory : public FactoryObject {
@@ -39,10 +41,19 @@ public:
 		index_t FirstFrame;
 	};
 
+	// decodes a frame and reports the bytes it keeps beyond the loader's own data
+	using FrameLoader = std::function<Holder<Sprite2D>(index_t, size_t& bytes)>;
+
 	AnimationFactory(const ResRef &resref,
 					 std::vector<Holder<Sprite2D>> frames,
 					 std::vector<CycleEntry> cycles,
 					 std::vector<index_t> FLTable);
+	// frames are only decoded by the loader once they are asked for,
+	// loaderBytes is what the loader itself holds on to for that
+	AnimationFactory(const ResRef &resref, index_t frameCount, FrameLoader loader,
+					 size_t loaderBytes,
+					 std::vector<CycleEntry> cycles,
+					 std::vector<index_t> FLTable);
 
 	Animation* GetCycle(index_t cycle) const noexcept;
 	/** No descriptions */
@@ -53,11 +64,20 @@ public:
 	index_t GetCycleSize(index_t idx) const;
 	Holder<Sprite2D> GetPaperdollImage(const ieDword *Colors, Holder<Sprite2D> &Picture2,
 		unsigned int type) const;
+	size_t MemoryUsage() const noexcept override;
+	size_t ReleaseUnused() noexcept override;
 	
 private:
-	std::vector<Holder<Sprite2D>> frames;
+	mutable std::vector<Holder<Sprite2D>> frames;
+	mutable std::vector<bool> decoded;
+	mutable std::vector<size_t> frameSizes;
+	mutable size_t frameBytes = 0;
+	size_t loaderBytes = 0;
 	std::vector<CycleEntry> cycles;
 	std::vector<index_t> FLTable;	// Frame Lookup Table
+	FrameLoader loader;
+
+	const Holder<Sprite2D>& Frame(index_t index) const;
 };
 
 }
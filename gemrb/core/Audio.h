@@ -124,6 +124,8 @@ public:
 	virtual void QueueBuffer(int stream, unsigned short bits,
 				int channels, short* memory, int size, int samplerate) = 0;
 	virtual void UpdateMapAmbient(MapReverb&) {};
+	/** Hint that these sounds will be played soon, drivers may decode them ahead of time */
+	virtual void Preload(const std::vector<ResRef>& /*sounds*/) {};
 
 	unsigned int CreateChannel(const char *name);
 	void SetChannelVolume(const char *name, int volume);
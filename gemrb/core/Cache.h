@@ -22,6 +22,9 @@
 #define CACHE_H
 
 #include "globals.h"
+#include "OpenHashMap.h"
+
+#include <functional>
 
 namespace GemRB {
 
@@ -29,24 +32,18 @@ namespace GemRB {
 using ReleaseFun = void (*)(void*);
 #endif
 
-class Cache
+class GEM_EXPORT Cache
 {
 protected:
-	// Association
-	struct MyAssoc {
-		MyAssoc* pNext;
-		MyAssoc** pPrev;
-		ResRef key;
-		ieDword nRefCount;
-		void* data;
-	};
-	struct MemBlock {
-		MemBlock* pNext;
+	struct Entry {
+		void* data = nullptr;
+		ieDword nRefCount = 0;
 	};
+	using Map = OpenHashMap<ResRef, Entry, CstrHashCI<ResRef>, std::equal_to<ResRef>>;
 
 public:
 	// Construction
-	explicit Cache(int nBlockSize = 10, int nHashTableSize = 129);
+	Cache() = default;
 	Cache(const Cache&) = delete;
 	~Cache();
 	Cache& operator=(const Cache&) = delete;
@@ -55,14 +52,14 @@ public:
 	// number of elements
 	inline int GetCount() const
 	{
-		return m_nCount;
+		return int(m_map.Size());
 	}
 	inline bool IsEmpty() const
 	{
-		return m_nCount==0;
+		return m_map.IsEmpty();
 	}
 	// Lookup
-	void *GetResource(const ResRef& key) const;
+	void *GetResource(const ResRef& key);
 	// Operations
 	bool SetAt(const ResRef& key, void *rValue);
 	// decreases refcount or drops data
@@ -71,21 +68,12 @@ public:
 	int RefCount(const ResRef& key) const;
 	void RemoveAll(ReleaseFun fun);//removes all refcounts
 	void Cleanup();  //removes only zero refcounts
-	void InitHashTable(unsigned int hashSize, bool bAllocNow = true);
 
 	// Implementation
 protected:
-	MyAssoc** m_pHashTable = nullptr;
-	unsigned int m_nHashTableSize;
-	int m_nCount = 0;
-	MyAssoc* m_pFreeList = nullptr;
-	MemBlock* m_pBlocks = nullptr;
-	int m_nBlockSize;
+	Map m_map;
 
-	Cache::MyAssoc* NewAssoc();
-	void FreeAssoc(Cache::MyAssoc*);
-	Cache::MyAssoc* GetAssocAt(const ResRef&) const;
-	Cache::MyAssoc *GetNextAssoc(Cache::MyAssoc * rNextPosition) const;
+	int DecRef(size_t pos, bool free);
 };
 
 }
@@ -488,6 +488,22 @@ void CharAnimations::CheckColorMod()
 	lockPalette = false;
 }
 
+// would CheckColorMod clear anything? The palette lock is left out, since
+// only the effects set it and they reapply it on every refresh
+bool CharAnimations::HasExpiredColorMod() const
+{
+	if (!GlobalColorMod.locked && GlobalColorMod.type != RGBModifier::NONE) {
+		return true;
+	}
+
+	for (const RGBModifier& mod : ColorMods) {
+		if (!mod.phase && mod.type != RGBModifier::NONE) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void CharAnimations::SetupColors(PaletteType type)
 {
 	PaletteHolder pal = PartPalettes[type];
@@ -200,6 +200,7 @@ public:
 	void SetOffhandRef(const char* ref);
 	void SetColors(const ieDword *Colors);
 	void CheckColorMod();
+	bool HasExpiredColorMod() const;
 	void SetupColors(PaletteType type);
 	void LockPalette(const ieDword *Colors);
 
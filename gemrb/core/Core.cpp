@@ -30,6 +30,7 @@
 #include "Interface.h"
 #include "Scriptable/Actor.h"
 
+#include <atomic>
 #include <cmath>
 #include <cctype>
 
@@ -324,4 +325,11 @@ int CountElements(const char *str, char separator)
 	return count;
 }
 
+std::atomic<tick_t> fixedClock { 0 };
+
+void SetFixedClock(tick_t time)
+{
+	fixedClock.store(time, std::memory_order_relaxed);
+}
+
 }
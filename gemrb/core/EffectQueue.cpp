@@ -36,6 +36,7 @@
 #include "Spell.h" //needs for the source flags bitfield
 #include "TableMgr.h"
 
+#include <algorithm>
 #include <cstdio>
 #include "GameData.h"
 
@@ -429,6 +430,63 @@ void EffectQueue::AddEffect(Effect* fx, bool insert)
 		effects.push_back(std::move(*fx));
 	}
 	delete fx;
+	revision++;
+
+	if (opcodeIndex.dirty) return;
+	queue_t::iterator added = insert ? effects.begin() : std::prev(effects.end());
+	auto& bucket = opcodeIndex.buckets[added->Opcode];
+	if (insert) {
+		bucket.insert(bucket.begin(), added);
+		// the others moved up a place
+		++opcodeIndex.generation;
+	} else {
+		bucket.push_back(added);
+	}
+}
+
+EffectQueue::OpcodeRange EffectQueue::OpcodeEffects(ieDword opcode) const
+{
+	// the index hands out the same access the list gives the caller
+	queue_t& list = const_cast<queue_t&>(effects);
+	if (opcodeIndex.dirty) {
+		for (auto fx = list.begin(); fx != list.end(); ++fx) {
+			opcodeIndex.buckets[fx->Opcode].push_back(fx);
+		}
+		opcodeIndex.dirty = false;
+	}
+
+	OpcodeRange range;
+	range.last.fx = list.end();
+	auto bucket = opcodeIndex.buckets.find(opcode);
+	if (bucket == opcodeIndex.buckets.end() || bucket->second.empty()) {
+		range.first = range.last;
+		return range;
+	}
+
+	OpcodeRange::iterator& first = range.first;
+	first.queue = this;
+	first.bucket = &bucket->second;
+	first.opcode = opcode;
+	first.generation = opcodeIndex.generation;
+	first.fx = bucket->second.front();
+	return range;
+}
+
+EffectQueue::OpcodeRange::iterator& EffectQueue::OpcodeRange::iterator::operator++()
+{
+	queue_t& list = const_cast<queue_t&>(queue->effects);
+	if (bucket && generation == queue->opcodeIndex.generation) {
+		// effects appended meanwhile are still visited, like in a list walk
+		fx = ++pos < bucket->size() ? (*bucket)[pos] : list.end();
+		return *this;
+	}
+
+	// the index changed under us, so continue from the list node we are at
+	bucket = nullptr;
+	do {
+		++fx;
+	} while (fx != list.end() && fx->Opcode != opcode);
+	return *this;
 }
 
 //This method can remove an effect described by a pointer to it, or
@@ -438,6 +496,8 @@ bool EffectQueue::RemoveEffect(const Effect* fx)
 	for (auto f = effects.begin(); f != effects.end(); ++f) {
 		if (*fx == *f) {
 			effects.erase(f);
+			opcodeIndex.Invalidate();
+			revision++;
 			return true;
 		}
 	}
@@ -451,25 +511,49 @@ void EffectQueue::ApplyAllEffects(Actor* target)
 {
 	const auto& Opcodes = Globals::Get().Opcodes;
 
+	volatileEffects = false;
+	stableUntil = ieDword(-1);
 	for (auto& fx : effects) {
+		ieDword opcode = fx.Opcode;
 		if (Opcodes[fx.Opcode].Flags & EFFECT_REINIT_ON_LOAD) {
 			// pretend to be the first application (FirstApply==1)
 			ApplyEffect(target, &fx, 1);
 		} else {
 			ApplyEffect(target, &fx, 0);
 		}
+		// some effects turn into others when applied
+		if (fx.Opcode != opcode && !opcodeIndex.dirty) {
+			opcodeIndex.Invalidate();
+		}
+
+		if (fx.TimingMode == FX_DURATION_JUST_EXPIRED) continue;
+		// opcodes are volatile unless marked otherwise, but unimplemented ones do nothing
+		if (fx.Opcode >= Globals::MAX_EFFECTS || (Opcodes[fx.Opcode] && !(Opcodes[fx.Opcode].Flags & EFFECT_STABLE))) {
+			volatileEffects = true;
+		}
+		// delayed effects trigger and limited ones expire once their time comes
+		int delay = DelayType(fx.TimingMode & 0xff);
+		if (delay == TIMING_DELAYED || delay == TIMING_DURATION) {
+			stableUntil = std::min(stableUntil, fx.Duration);
+		}
 	}
 }
 
 void EffectQueue::Cleanup()
 {
+	bool removed = false;
 	for (auto f = effects.begin(); f != effects.end(); ) {
 		if (f->TimingMode == FX_DURATION_JUST_EXPIRED) {
 			f = effects.erase(f);
+			removed = true;
 		} else {
 			++f;
 		}
 	}
+	if (removed) {
+		opcodeIndex.Invalidate();
+		revision++;
+	}
 }
 
 //Handle the target flag when the effect is applied first
@@ -1141,6 +1225,9 @@ int EffectQueue::ApplyEffect(Actor* target, Effect* fx, ieDword first_apply, ieD
 	ieDword GameTime = core->GetGame()->GameTime;
 
 	if (first_apply) {
+		// a new application can touch anything on the target, including
+		// effects already in its queue, so its stats need a full refresh
+		if (target) target->fxqueue.revision++;
 		fx->FirstApply = 1;
 		// we do proper target vs targetless checks below
 		if (target) fx->SetPosition(target->Pos);
@@ -1312,11 +1399,12 @@ static inline bool IsLive(ieByte timingmode)
 //will be killed along with it
 void EffectQueue::RemoveAllEffects(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1329,6 +1417,7 @@ bool EffectQueue::RemoveEquippingEffects(ieDwordSigned slotcode)
 		MATCH_SLOTCODE()
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 		removed = true;
 	}
 	return removed;
@@ -1341,6 +1430,7 @@ void EffectQueue::RemoveAllEffectsWithProjectile(ieDword projectile)
 		MATCH_PROJECTILE()
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1354,6 +1444,7 @@ void EffectQueue::RemoveAllEffects(const ResRef &removed)
 		}
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 
 	Actor* OwnerActor = Owner->As<Actor>();
@@ -1407,6 +1498,7 @@ void EffectQueue::RemoveAllEffects(const ResRef &removed, ieByte timing)
 		}
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1423,12 +1515,13 @@ void EffectQueue::RemoveAllEffects(EffectRef &effect_reference)
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithResource(ieDword opcode, const ResRef &resource)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) { continue; }
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1442,7 +1535,7 @@ void EffectQueue::RemoveAllEffectsWithResource(EffectRef &effect_reference, cons
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithSource(ieDword opcode, const ResRef &source, int mode)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		if (fx.SourceRef != source) continue;
 
@@ -1460,6 +1553,7 @@ void EffectQueue::RemoveAllEffectsWithSource(ieDword opcode, const ResRef &sourc
 		// mode 0 or anything else means remove all effects that match
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1473,7 +1567,7 @@ void EffectQueue::RemoveAllEffectsWithSource(EffectRef &effectReference, const R
 //(works only if a higher stat means good for the target)
 void EffectQueue::RemoveAllDetrimentalEffects(ieDword opcode, ieDword current)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1491,6 +1585,7 @@ void EffectQueue::RemoveAllDetrimentalEffects(ieDword opcode, ieDword current)
 			break;
 		}
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1507,12 +1602,13 @@ void EffectQueue::RemoveAllDetrimentalEffects(EffectRef &effect_reference, ieDwo
 //opcode need to be removed (see removal of portrait icon)
 void EffectQueue::RemoveAllEffectsWithParam(ieDword opcode, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1526,7 +1622,7 @@ void EffectQueue::RemoveAllEffectsWithParam(EffectRef &effect_reference, ieDword
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithParamAndResource(ieDword opcode, ieDword param2, const ResRef &resource)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1534,6 +1630,7 @@ void EffectQueue::RemoveAllEffectsWithParamAndResource(ieDword opcode, ieDword p
 		if (!resource.IsEmpty() && fx.Resource != resource) continue;
 
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 	}
 }
 
@@ -1561,6 +1658,7 @@ void EffectQueue::RemoveExpiredEffects(ieDword futuretime)
 		//it should remove them as well, i think
 		if (DelayType(fx.TimingMode) != TIMING_PERMANENT && fx.Duration <= GameTime) {
 			fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+			revision++;
 		}
 	}
 }
@@ -1572,6 +1670,7 @@ void EffectQueue::RemoveAllNonPermanentEffects()
 	for (auto& fx : effects) {
 		if (IsRemovable(fx.TimingMode)) {
 			fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+			revision++;
 		}
 	}
 }
@@ -1602,6 +1701,7 @@ void EffectQueue::RemoveLevelEffects(ieDword level, ieDword Flags, ieDword match
 			continue;
 		}
 		fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+		revision++;
 		if (Flags & RL_REMOVEFIRST) {
 			removed = fx.SourceRef;
 		}
@@ -1633,13 +1733,14 @@ void EffectQueue::DispelEffects(const Effect *dispeller, ieDword level)
 		if (roll == 100 || roll < diff) {
 			// finally dispel
 			fx.TimingMode = FX_DURATION_JUST_EXPIRED;
+			revision++;
 		}
 	}
 }
 
 const Effect *EffectQueue::HasOpcode(ieDword opcode) const
 {
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1659,7 +1760,7 @@ const Effect *EffectQueue::HasEffect(EffectRef &effect_reference) const
 
 Effect *EffectQueue::HasOpcode(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1679,7 +1780,7 @@ Effect *EffectQueue::HasEffect(EffectRef &effect_reference)
 
 const Effect *EffectQueue::HasOpcodeWithParam(ieDword opcode, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1704,7 +1805,7 @@ const Effect *EffectQueue::HasEffectWithParam(EffectRef &effect_reference, ieDwo
 
 const Effect *EffectQueue::HasOpcodeWithParamPair(ieDword opcode, ieDword param1, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1731,7 +1832,7 @@ const Effect *EffectQueue::HasEffectWithParamPair(EffectRef &effect_reference, i
 //this could be used for stoneskins and mirror images as well
 void EffectQueue::DecreaseParam1OfEffect(ieDword opcode, ieDword amount)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		ieDword value = fx.Parameter1;
@@ -1743,6 +1844,7 @@ void EffectQueue::DecreaseParam1OfEffect(ieDword opcode, ieDword amount)
 			value = 0;
 		}
 		fx.Parameter1 = value;
+		revision++;
 		if (value) {
 			return;
 		}
@@ -1762,7 +1864,7 @@ void EffectQueue::DecreaseParam1OfEffect(EffectRef &effect_reference, ieDword am
 //returns the damage amount NOT soaked
 int EffectQueue::DecreaseParam3OfEffect(ieDword opcode, ieDword amount, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1775,6 +1877,7 @@ int EffectQueue::DecreaseParam3OfEffect(ieDword opcode, ieDword amount, ieDword
 			value = 0;
 		}
 		fx.Parameter3 = value;
+		revision++;
 		if (value) {
 			return 0;
 		}
@@ -1801,7 +1904,7 @@ static const int ids_stats[9]={IE_FACTION, IE_TEAM, IE_EA, IE_GENERAL, IE_RACE,
 int EffectQueue::BonusAgainstCreature(ieDword opcode, const Actor *actor) const
 {
 	ieDword sum = 0;
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Parameter1) {
@@ -1853,7 +1956,7 @@ int EffectQueue::BonusAgainstCreature(EffectRef &effect_reference, const Actor *
 int EffectQueue::BonusForParam2(ieDword opcode, ieDword param2) const
 {
 	int sum = 0;
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1875,7 +1978,7 @@ int EffectQueue::MaxParam1(ieDword opcode, bool positive) const
 {
 	int max = 0;
 	ieDwordSigned param1 = 0;
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1898,7 +2001,7 @@ int EffectQueue::MaxParam1(EffectRef &effect_reference, bool positive) const
 
 bool EffectQueue::WeaponImmunity(ieDword opcode, int enchantment, ieDword weapontype) const
 {
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1938,7 +2041,8 @@ void EffectQueue::AddWeaponEffects(EffectQueue* fxqueue, EffectRef& fx_ref, ieDw
 	ieDword opcode = fx_ref.opcode;
 	Point p(-1,-1);
 
-	for (const auto& fx : effects) {
+	// fxqueue may be this queue, but the copies go to its front, behind the walk
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (!param2 && fx.Parameter2 != param2) continue;
@@ -1958,7 +2062,7 @@ int EffectQueue::SumDamageReduction(EffectRef &effect_reference, ieDword weaponE
 	int remaining = 0;
 	int count = 0;
 
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1979,7 +2083,7 @@ int EffectQueue::SumDamageReduction(EffectRef &effect_reference, ieDword weaponE
 //useful for immunity vs spell, can't use item, etc.
 const Effect *EffectQueue::HasOpcodeWithResource(ieDword opcode, const ResRef &resource) const
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) continue;
@@ -2004,7 +2108,7 @@ const Effect *EffectQueue::HasEffectWithPower(EffectRef &effect_reference, ieDwo
 
 const Effect *EffectQueue::HasOpcodeWithPower(ieDword opcode, ieDword power) const
 {
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		// NOTE: matching greater or equals!
@@ -2032,7 +2136,7 @@ const Effect *EffectQueue::HasSource(const ResRef &removed) const
 //used in contingency/sequencer code (cannot have the same contingency twice)
 const Effect *EffectQueue::HasOpcodeWithSource(ieDword opcode, const ResRef &removed) const
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (removed != fx.SourceRef) {
@@ -2110,6 +2214,8 @@ const Effect *EffectQueue::GetNextEffect(queue_t::const_iterator &f) const
 
 Effect *EffectQueue::GetNextEffect(queue_t::iterator &f)
 {
+	// the caller may modify what it gets
+	revision++;
 	if( f!=effects.end()) return &(*f++);
 	return nullptr;
 }
@@ -2118,7 +2224,7 @@ ieDword EffectQueue::CountEffects(ieDword opcode, ieDword param1, ieDword param2
 {
 	ieDword cnt = 0;
 
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		if( param1!=0xffffffff)
 			MATCH_PARAM1()
@@ -2135,7 +2241,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effect_reference, const Effe
 	ieDword cnt = 1;
 	ieDword opcode = ResolveEffect(effect_reference);
 
-	for (const auto& fx : effects) {
+	for (const Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (&fx == fx2) break;
@@ -2146,10 +2252,11 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effect_reference, const Effe
 
 void EffectQueue::ModifyEffectPoint(ieDword opcode, ieDword x, ieDword y)
 {
-	for (auto& fx : effects) {
+	for (Effect& fx : OpcodeEffects(opcode)) {
 		MATCH_OPCODE()
 		fx.Pos = Point(x, y);
 		fx.Parameter3 = 0;
+		revision++;
 		return;
 	}
 }
@@ -2199,6 +2306,7 @@ int EffectQueue::CheckImmunity(Actor *target) const
 		int ret = check_type(target, fx);
 		if (ret < 0 && target->Modified[IE_SANCTUARY] & (1 << OV_BOUNCE)) {
 			target->Modified[IE_SANCTUARY]|=(1<<OV_BOUNCE2);
+			target->MarkStatsDirty();
 		}
 		return ret;
 	}
@@ -37,6 +37,8 @@
 
 #include <cstdlib>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 namespace GemRB {
 
@@ -169,7 +171,10 @@ enum EffectFlags {
 	EFFECT_NO_ACTOR = 4,
 	EFFECT_REINIT_ON_LOAD = 8,
 	EFFECT_PRESET_TARGET = 16,
-	EFFECT_SPECIAL_UNDO = 32
+	EFFECT_SPECIAL_UNDO = 32,
+	// only depends on the effect and the target's stats, so reapplying it gives the same result;
+	// anything unmarked may depend on time, chance or the surroundings and keeps the refreshes going
+	EFFECT_STABLE = 64
 };
 
 // unusual SpellProt types which need hacking (fake stats)
@@ -217,6 +222,71 @@ private:
 	/** List of Effects applied on the Actor */
 	using queue_t = std::list<Effect>;
 	queue_t effects;
+	/** The effects of each opcode, in queue order, so lookups skip the rest.
+	 * Built lazily; copies of a queue start with a dirty index, since the
+	 * pointers would refer to the other list. */
+	struct OpcodeIndex {
+		using bucket_t = std::vector<queue_t::iterator>;
+		std::unordered_map<ieDword, bucket_t> buckets;
+		bool dirty = true;
+		// bumped whenever effects may change their place in the buckets
+		unsigned long generation = 0;
+
+		OpcodeIndex() noexcept = default;
+		OpcodeIndex(const OpcodeIndex&) noexcept {}
+		OpcodeIndex& operator=(const OpcodeIndex&) noexcept
+		{
+			Invalidate();
+			return *this;
+		}
+		void Invalidate()
+		{
+			// keep the buckets themselves, callers may hold references to them
+			for (auto& bucket : buckets) {
+				bucket.second.clear();
+			}
+			dirty = true;
+			++generation;
+		}
+	};
+	/** Walks the effects of one opcode in queue order. If the walk changes
+	 * the queue so that the index moves or drops them, it carries on over
+	 * the list from the current effect, so none get skipped or revisited. */
+	class OpcodeRange {
+	public:
+		class iterator {
+			const EffectQueue* queue = nullptr;
+			const OpcodeIndex::bucket_t* bucket = nullptr; // nullptr once walking the list
+			ieDword opcode = 0;
+			size_t pos = 0;
+			unsigned long generation = 0;
+			queue_t::iterator fx;
+
+			friend class EffectQueue;
+		public:
+			Effect& operator*() const { return *fx; }
+			bool operator!=(const iterator& other) const { return fx != other.fx; }
+			iterator& operator++();
+		};
+
+		iterator begin() const { return first; }
+		iterator end() const { return last; }
+
+	private:
+		iterator first;
+		iterator last;
+
+		friend class EffectQueue;
+	};
+	mutable OpcodeIndex opcodeIndex;
+	/** Bumped whenever effects are added, removed, expire or get modified
+	 * outside of ApplyAllEffects, so the owner can tell if a stat refresh
+	 * would change anything. */
+	ieDword revision = 0;
+	/** What the last ApplyAllEffects found: whether a live effect is volatile
+	 * and the game time when the first delayed or limited effect changes */
+	bool volatileEffects = true;
+	ieDword stableUntil = 0;
 	/** Actor which is target of the Effects */
 	Scriptable* Owner = nullptr;
 
@@ -231,6 +301,10 @@ public:
 	void SetOwner(Scriptable* act) { Owner = act; }
 	/** Returns Actor affected by these effects */
 	Scriptable* GetOwner() const { return Owner; }
+	/** Returns the change counter of the queue */
+	ieDword GetRevision() const { return revision; }
+	/** Returns true if ApplyAllEffects would give the same result as the last time at this game time */
+	bool IsStableAt(ieDword gameTime) const { return !volatileEffects && gameTime < stableUntil; }
 
 	/** adds an effect to the queue, */
 	void AddEffect(Effect* fx, bool insert=false);
@@ -365,6 +439,8 @@ private:
 	int MaxParam1(ieDword opcode, bool positive) const;
 	int BonusAgainstCreature(ieDword opcode, const Actor *actor) const;
 	bool WeaponImmunity(ieDword opcode, int enchantment, ieDword weapontype) const;
+	/** the effects with this opcode, in queue order */
+	OpcodeRange OpcodeEffects(ieDword opcode) const;
 };
 
 }
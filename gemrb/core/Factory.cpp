@@ -20,39 +20,105 @@
 
 #include "Factory.h"
 
+#include "Logging/Logging.h"
+
 namespace GemRB {
 
-Factory::~Factory(void)
+Factory::~Factory() noexcept
 {
-	for (auto& fObject : fobjects) {
-		delete fObject;
+	// whatever is still referenced elsewhere must not report to us anymore
+	for (const auto& object : entries) {
+		object->cacheBytes = nullptr;
 	}
 }
 
 void Factory::AddFactoryObject(FactoryObject* fobject)
 {
-	fobjects.push_back( fobject );
+	auto& typeIndex = index[fobject->SuperClassID];
+	auto it = typeIndex.find(fobject->resRef);
+	if (it != typeIndex.end()) {
+		const Holder<FactoryObject>& old = *it->second;
+		bytes -= old->MemoryUsage();
+		old->cacheBytes = nullptr;
+		entries.erase(it->second);
+	}
+
+	entries.push_front(Holder<FactoryObject>(fobject));
+	typeIndex[fobject->resRef] = entries.begin();
+	bytes += fobject->MemoryUsage();
+	fobject->cacheBytes = &bytes;
 }
 
-int Factory::IsLoaded(const ResRef& resref, SClass_ID type) const
+FactoryObject* Factory::GetFactoryObject(const ResRef& resRef, SClass_ID type)
 {
-	if (resref.IsEmpty()) {
-		return -1;
+	if (resRef.IsEmpty()) {
+		return nullptr;
+	}
+
+	auto typeIndex = index.find(type);
+	if (typeIndex == index.end()) {
+		stats.misses++;
+		return nullptr;
 	}
+	auto it = typeIndex->second.find(resRef);
+	if (it == typeIndex->second.end()) {
+		stats.misses++;
+		return nullptr;
+	}
+
+	stats.hits++;
+	entries.splice(entries.begin(), entries, it->second);
+	return it->second->get();
+}
 
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		if (fobjects[i]->SuperClassID == type) {
-			if (fobjects[i]->resRef == resref) {
-				return i;
-			}
-		}
+void Factory::Trim()
+{
+	if (!budget) {
+		return;
 	}
-	return -1;
+
+	if (bytes <= budget) {
+		return;
+	}
+
+	auto it = entries.end();
+	while (bytes > budget && it != entries.begin()) {
+		--it;
+		const Holder<FactoryObject>& object = *it;
+		// still used by a window, the worldmap or the like
+		if (object->GetRefCount() > 1) continue;
+
+		size_t size = object->MemoryUsage();
+		bytes -= size;
+		stats.evicted++;
+		stats.bytesFreed += size;
+		object->cacheBytes = nullptr;
+		index[object->SuperClassID].erase(object->resRef);
+		it = entries.erase(it);
+	}
+
+	// what's left is in use, but not necessarily all of its frames
+	// ReleaseUnused reports the shrinking to bytes itself
+	for (auto rit = entries.rbegin(); bytes > budget && rit != entries.rend(); ++rit) {
+		stats.bytesFreed += (*rit)->ReleaseUnused();
+	}
+}
+
+Factory::Stats Factory::GetStats() const
+{
+	Stats current = stats;
+	current.entries = entries.size();
+	current.bytes = bytes;
+	current.budget = budget;
+	return current;
 }
 
-FactoryObject* Factory::GetFactoryObject(int pos) const
+void Factory::LogStats() const
 {
-	return fobjects[pos];
+	Stats current = GetStats();
+	Log(DEBUG, "Factory", "{} objects in {} KB (budget {} KB), {} hits, {} misses, {} evicted freeing {} KB",
+		current.entries, current.bytes / 1024, current.budget / 1024, current.hits, current.misses,
+		current.evicted, current.bytesFreed / 1024);
 }
 
 }
@@ -27,19 +27,49 @@
 #include "AnimationFactory.h"
 #include "FactoryObject.h"
 
+#include <list>
+#include <unordered_map>
+
 namespace GemRB {
 
+// Cache of the decoded BAM and BMP resources. Lookups are hashed and
+// objects the cache alone holds are evicted, least recently used first,
+// once the total size goes over the budget.
 class GEM_EXPORT Factory {
+public:
+	struct Stats {
+		unsigned long hits = 0;
+		unsigned long misses = 0;
+		unsigned long evicted = 0;
+		size_t bytesFreed = 0;
+		size_t entries = 0;
+		size_t bytes = 0;
+		size_t budget = 0;
+	};
+
 private:
-	std::vector< FactoryObject*> fobjects;
+	// most recently used first
+	std::list<Holder<FactoryObject>> entries;
+	std::unordered_map<SClass_ID, ResRefMap<std::list<Holder<FactoryObject>>::iterator>> index;
+	// the objects keep this up to date as their frames get decoded or released
+	size_t bytes = 0;
+	size_t budget = 0; // no limit
+	Stats stats;
+
 public:
 	Factory() noexcept = default;
 	Factory(const Factory&) = delete;
-	~Factory();
 	Factory& operator=(const Factory&) = delete;
+	~Factory() noexcept;
 	void AddFactoryObject(FactoryObject* fobject);
-	int IsLoaded(const ResRef& resRef, SClass_ID type) const;
-	FactoryObject* GetFactoryObject(int pos) const;
+	FactoryObject* GetFactoryObject(const ResRef& resRef, SClass_ID type);
+
+	void SetBudget(size_t limit) { budget = limit; }
+	/** Frees unused objects, then unused frames, until the cache fits its budget.
+	 * Call it only when no plain pointers to the objects are in use */
+	void Trim();
+	Stats GetStats() const;
+	void LogStats() const;
 };
 
 }
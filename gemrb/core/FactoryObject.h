@@ -24,17 +24,36 @@
 #include "exports.h"
 #include "globals.h"
 
+#include "Holder.h"
 #include "SClassID.h"
 #include "Resource.h"
 
 namespace GemRB {
 
-class GEM_EXPORT FactoryObject {
+class GEM_EXPORT FactoryObject : public Held<FactoryObject> {
 public:
 	SClass_ID SuperClassID;
 	ResRef resRef;
 	FactoryObject(const ResRef &name, SClass_ID superClassID) : SuperClassID(superClassID), resRef(name) {};
-	virtual ~FactoryObject() noexcept = default;
+	~FactoryObject() noexcept override = default;
+
+	/** Approximate size of the decoded data, for the cache budget */
+	virtual size_t MemoryUsage() const noexcept = 0;
+	/** Drops data nobody else uses and that can be recreated, returns the bytes freed */
+	virtual size_t ReleaseUnused() noexcept { return 0; }
+
+protected:
+	/** Keeps the total of the cache holding this object up to date when it grows or shrinks */
+	void UsageChanged(size_t added, size_t removed) const noexcept
+	{
+		if (cacheBytes) {
+			*cacheBytes = *cacheBytes + added - removed;
+		}
+	}
+
+private:
+	friend class Factory;
+	size_t* cacheBytes = nullptr;
 };
 
 }
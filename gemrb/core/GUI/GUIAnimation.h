@@ -20,6 +20,7 @@
 #ifndef Animations_h
 #define Animations_h
 
+#include "AnimationFactory.h"
 #include "Holder.h"
 #include "Region.h"
 
@@ -129,12 +130,11 @@ private:
 	bool HasEnded() const override;
 };
 
-class AnimationFactory;
 class Sprite2D;
 
 class GEM_EXPORT SpriteAnimation : public GUIAnimation<Holder<Sprite2D>> {
 private:
-	AnimationFactory* bam = nullptr;
+	Holder<AnimationFactory> bam;
 	uint8_t cycle = 0;
 	uint8_t frame = 0;
 	unsigned int anim_phase = 0;
@@ -597,21 +597,16 @@ void GameControl::DrawSelf(const Region& screen, const Region& /*clip*/)
 	}
 
 	// Draw path
-	if (drawPath) {
-		PathListNode* node = drawPath;
-		while (true) {
-			Point p = Map::ConvertCoordFromTile(node->point) + Point(8, 6);
-			if (!node->Parent) {
-				video->DrawCircle( p, 2, ColorRed );
-			} else {
-				Point old = Map::ConvertCoordFromTile(node->Parent->point) + Point(8, 6);
-				video->DrawLine(old, p, ColorGreen);
-			}
-			if (!node->Next) {
-				video->DrawCircle( p, 2, ColorGreen );
-				break;
-			}
-			node = node->Next;
+	for (size_t i = 0; i < drawPath.size(); i++) {
+		Point p = Map::ConvertCoordFromTile(drawPath[i].point) + Point(8, 6);
+		if (i == 0) {
+			video->DrawCircle( p, 2, ColorRed );
+		} else {
+			Point old = Map::ConvertCoordFromTile(drawPath[i - 1].point) + Point(8, 6);
+			video->DrawLine(old, p, ColorGreen);
+		}
+		if (i == drawPath.size() - 1) {
+			video->DrawCircle( p, 2, ColorGreen );
 		}
 	}
 
@@ -99,7 +99,7 @@ private:
 	int lastCursor = 0;
 	Point vpVector;
 	int numScrollCursor = 0;
-	PathListNode* drawPath = nullptr;
+	Path drawPath;
 	unsigned int ScreenFlags = SF_CENTERONACTOR;
 	unsigned int DialogueFlags = DF_FREEZE_SCRIPTS;
 	String DisplayText;
@@ -44,6 +44,7 @@
 #include "MapReverb.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iterator>
 #include <utility>
 #include <vector>
@@ -430,8 +431,8 @@ void Game::InitActorPos(Actor *actor) const
 	const auto area = start->QueryField(mode[playmode],"AREA");
 	const auto rot = start->QueryField(mode[playmode],"ROT");
 
-	actor->Pos.x = actor->Destination.x = strta->QueryFieldSigned<int>(strta->GetRowIndex(xpos), ip);
-	actor->Pos.y = actor->Destination.y = strta->QueryFieldSigned<int>(strta->GetRowIndex(ypos), ip);
+	actor->SetPos(Point(strta->QueryFieldSigned<int>(strta->GetRowIndex(xpos), ip), strta->QueryFieldSigned<int>(strta->GetRowIndex(ypos), ip)));
+	actor->Destination = actor->Pos;
 	actor->HomeLocation = actor->Pos;
 	actor->SetOrientation(ClampToOrientation(strta->QueryFieldSigned<int>(strta->GetRowIndex(rot), ip)), false);
 
@@ -832,10 +833,21 @@ int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 		sE->RunFunction("LoadScreen", "SetLoadScreen");
 	}
 
+	// per stage timings, reported once the area is up
+	using namespace std::chrono;
+	auto stageStart = steady_clock::now();
+	auto lap = [&stageStart]() {
+		auto now = steady_clock::now();
+		auto elapsed = duration_cast<milliseconds>(now - stageStart).count();
+		stageStart = now;
+		return elapsed;
+	};
+
 	if (core->saveGameAREExtractor.extractARE(resRef.CString()) != GEM_OK) {
 		core->LoadProgress(100);
 		return GEM_ERROR;
 	}
+	auto extractTime = lap();
 
 	DataStream* ds = gamedata->GetResource(resRef, IE_ARE_CLASS_ID);
 	auto mM = GetImporter<MapMgr>(IE_ARE_CLASS_ID, ds);
@@ -844,11 +856,17 @@ int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 		return GEM_ERROR;
 	}
 
+	// start reading what the area needs while the importer works through it
+	gamedata->Prefetch(mM->GetDependencies(IsDay()));
+	auto headerTime = lap();
+
 	Map *newMap = mM->GetMap(resRef, IsDay());
 	if (!newMap) {
+		gamedata->EndPrefetch();
 		core->LoadProgress(100);
 		return GEM_ERROR;
 	}
+	auto mapTime = lap();
 
 	int ret = AddMap( newMap );
 
@@ -862,6 +880,8 @@ int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 
 	PlacePersistents(newMap, resRef);
 	newMap->InitActors();
+	newMap->PreloadSounds();
+	auto actorTime = lap();
 
 	//this feature exists in all blackisle games but not in bioware games
 	// make sure to do it after other actors, so UpdateFog can run and
@@ -872,6 +892,15 @@ int Game::LoadMap(const ResRef &resRef, bool loadscreen)
 	}
 
 	core->GetAudioDrv()->UpdateMapAmbient(newMap->reverb);
+	auto spawnTime = lap();
+
+	auto prefetched = gamedata->EndPrefetch();
+	Log(DEBUG, "Game", "Loaded area {} in {}ms: extraction {}ms, header {}ms, map {}ms, actors {}ms, spawns {}ms",
+		resRef, extractTime + headerTime + mapTime + actorTime + spawnTime,
+		extractTime, headerTime, mapTime, actorTime, spawnTime);
+	Log(DEBUG, "Game", "Prefetched {} of {} resources ({} KB): {} used, {} waited on, {} unused",
+		prefetched.loaded, prefetched.requested, prefetched.bytes / 1024,
+		prefetched.claimed, prefetched.waited, prefetched.wasted);
 
 	core->LoadProgress(100);
 	return ret;
@@ -912,7 +941,7 @@ bool Game::CheckForReplacementActor(size_t i)
 			if (!newact) {
 				error("Game::CheckForReplacementActor", "GetNPC failed: cannot find act!");
 			} else {
-				newact->Pos = act->Pos; // the map is not loaded yet, so no SetPosition
+				newact->SetPos(act->Pos); // the map is not loaded yet, so no SetPosition
 				newact->TalkCount = act->TalkCount;
 				newact->InteractCount = act->InteractCount;
 				newact->Area = act->Area;
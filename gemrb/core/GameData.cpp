@@ -88,6 +88,9 @@ void GameData::ClearCaches()
 		stores.erase(stores.begin());
 		delete store;
 	}
+
+	LogIndexStats();
+	factory->LogStats();
 }
 
 Actor* GameData::GetCreature(const ResRef& creature, unsigned int PartySlot)
@@ -385,8 +388,8 @@ FactoryObject* GameData::GetFactoryResource(const ResRef& resName, SClass_ID typ
 	if (resName.IsEmpty()) return nullptr;
 
 	// already cached?
-	int objectIndex = factory->IsLoaded(resName, type);
-	if (objectIndex != -1) return factory->GetFactoryObject(objectIndex);
+	FactoryObject* cached = factory->GetFactoryObject(resName, type);
+	if (cached) return cached;
 
 	switch (type) {
 	case IE_BAM_CLASS_ID:
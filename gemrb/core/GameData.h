@@ -134,6 +134,7 @@ public:
 	FactoryObject* GetFactoryResource(const ResRef& resName, SClass_ID type, bool silent = false);
 
 	void AddFactoryResource(FactoryObject* res);
+	Factory& GetFactory() { return *factory; }
 
 	Store* GetStore(const ResRef &resRef);
 	/// Saves a store to the cache and frees it.
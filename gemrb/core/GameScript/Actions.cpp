@@ -123,16 +123,16 @@ void GameScript::SG(Scriptable* Sender, Action* parameters)
 
 void GameScript::SetGlobal(Scriptable* Sender, Action* parameters)
 {
-	SetVariable( Sender, parameters->string0Parameter, parameters->int0Parameter );
+	SetVariable(Sender, parameters->Var0(), parameters->int0Parameter);
 }
 
 void GameScript::SetGlobalRandom(Scriptable* Sender, Action* parameters)
 {
 	int max=parameters->int1Parameter-parameters->int0Parameter+1;
 	if (max>0) {
-		SetVariable( Sender, parameters->string0Parameter, RandomNumValue%max+parameters->int0Parameter );
+		SetVariable(Sender, parameters->Var0(), RandomNumValue%max+parameters->int0Parameter);
 	} else {
-		SetVariable( Sender, parameters->string0Parameter, 0);
+		SetVariable(Sender, parameters->Var0(), 0);
 	}
 }
 
@@ -152,7 +152,7 @@ void GameScript::SetGlobalTimer(Scriptable* Sender, Action* parameters)
 	ieDword mytime;
 
 	mytime=core->GetGame()->GameTime; //gametime (should increase it)
-	SetVariable( Sender, parameters->string0Parameter,
+	SetVariable(Sender, parameters->Var0(),
 		parameters->int0Parameter * core->Time.ai_update_time + mytime);
 }
 
@@ -171,17 +171,17 @@ void GameScript::SetGlobalTimerRandom(Scriptable* Sender, Action* parameters)
 		random = RandomNumValue % random + parameters->int1Parameter;
 	}
 	mytime=core->GetGame()->GameTime; //gametime (should increase it)
-	SetVariable(Sender, parameters->string0Parameter, random * core->Time.ai_update_time + mytime);
+	SetVariable(Sender, parameters->Var0(), random * core->Time.ai_update_time + mytime);
 }
 
 void GameScript::SetGlobalTimerOnce(Scriptable* Sender, Action* parameters)
 {
-	ieDword mytime = CheckVariable( Sender, parameters->string0Parameter );
+	ieDword mytime = CheckVariable(Sender, parameters->Var0());
 	if (mytime != 0) {
 		return;
 	}
 	mytime=core->GetGame()->GameTime; //gametime (should increase it)
-	SetVariable( Sender, parameters->string0Parameter,
+	SetVariable(Sender, parameters->Var0(),
 		parameters->int0Parameter * core->Time.ai_update_time + mytime);
 }
 
@@ -189,7 +189,7 @@ void GameScript::RealSetGlobalTimer(Scriptable* Sender, Action* parameters)
 {
 	ieDword mytime=core->GetGame()->RealTime;
 
-	SetVariable( Sender, parameters->string0Parameter,
+	SetVariable(Sender, parameters->Var0(),
 		parameters->int0Parameter * core->Time.ai_update_time + mytime);
 }
 
@@ -982,7 +982,7 @@ void GameScript::CreateCreatureAtLocation(Scriptable* Sender, Action* parameters
 	if (parameters->variable0Parameter.IsEmpty()) {
 		parameters->variable0Parameter = "LOCALSsavedlocation";
 	}
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter);
+	ieDword value = CheckVariable(Sender, parameters->Var0());
 	parameters->pointParameter.y = (ieWord) (value & 0xffff);
 	parameters->pointParameter.x = (ieWord) (value >> 16);
 	CreateCreatureCore(Sender, parameters, CC_CHECK_IMPASSABLE|CC_STRING1);
@@ -2043,7 +2043,7 @@ void GameScript::PlaySequence(Scriptable* Sender, Action* parameters)
 //same as PlaySequence, but the value comes from a variable
 void GameScript::PlaySequenceGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter);
+	ieDword value = CheckVariable(Sender, parameters->Var0());
 	PlaySequenceCore(Sender, parameters, value);
 }
 
@@ -3091,7 +3091,7 @@ void GameScript::SetToken(Scriptable* /*Sender*/, Action* parameters)
 //Assigns a numeric variable to the token
 void GameScript::SetTokenGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Var0());
 	core->GetTokenDictionary()->SetAtAsString(parameters->string1Parameter, value);
 }
 
@@ -3207,8 +3207,8 @@ void GameScript::AnkhegHide(Scriptable* Sender, Action* /*parameters*/)
 
 void GameScript::GlobalSetGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
-	SetVariable( Sender, parameters->string1Parameter, value );
+	ieDword value = CheckVariable(Sender, parameters->Var0());
+	SetVariable(Sender, parameters->Var1(), value);
 }
 
 /* adding the second variable to the first, they must be GLOBAL */
@@ -3222,25 +3222,23 @@ void GameScript::AddGlobals(Scriptable* Sender, Action* parameters)
 /* adding the second variable to the first, they could be area or locals */
 void GameScript::GlobalAddGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 + value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 + value2);
 }
 
 /* adding the number to the global, they could be area or locals */
 void GameScript::IncrementGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
-		value + parameters->int0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Var0());
+	SetVariable(Sender, parameters->Var0(),
+		value + parameters->int0Parameter);
 }
 
 /* adding the number to the global ONLY if the first global is zero */
 void GameScript::IncrementGlobalOnce(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable( Sender, parameters->string0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Var0());
 	if (value != 0) {
 		return;
 	}
@@ -3248,180 +3246,162 @@ void GameScript::IncrementGlobalOnce(Scriptable* Sender, Action* parameters)
 	//just a best guess at how the two parameters are changed, and could
 	//well be more complex; the original usage of this function is currently
 	//not well understood (relates to hardcoded alignment changes)
-	SetVariable( Sender, parameters->string0Parameter, 1 );
+	SetVariable(Sender, parameters->Var0(), 1);
 
-	value = CheckVariable( Sender, parameters->string1Parameter );
-	SetVariable( Sender, parameters->string1Parameter,
-		value + parameters->int0Parameter );
+	value = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var1(),
+		value + parameters->int0Parameter);
 }
 
 void GameScript::GlobalSubGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 - value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 - value2);
 }
 
 void GameScript::GlobalAndGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 && value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 && value2);
 }
 
 void GameScript::GlobalOrGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 || value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 || value2);
 }
 
 void GameScript::GlobalBOrGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 | value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 | value2);
 }
 
 void GameScript::GlobalBAndGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 & value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 & value2);
 }
 
 void GameScript::GlobalXorGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender,
-		parameters->string1Parameter );
-	SetVariable( Sender, parameters->string0Parameter, value1 ^ value2 );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
+	SetVariable(Sender, parameters->Var0(), value1 ^ value2);
 }
 
 void GameScript::GlobalBOr(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
-		value1 | parameters->int0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	SetVariable(Sender, parameters->Var0(),
+		value1 | parameters->int0Parameter);
 }
 
 void GameScript::GlobalBAnd(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
-		value1 & parameters->int0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	SetVariable(Sender, parameters->Var0(),
+		value1 & parameters->int0Parameter);
 }
 
 void GameScript::GlobalXor(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
-		value1 ^ parameters->int0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	SetVariable(Sender, parameters->Var0(),
+		value1 ^ parameters->int0Parameter);
 }
 
 void GameScript::GlobalMax(Scriptable* Sender, Action* parameters)
 {
-	int value1 = CheckVariable( Sender, parameters->string0Parameter );
+	int value1 = CheckVariable(Sender, parameters->Var0());
 	if (value1 > parameters->int0Parameter) {
-		SetVariable( Sender, parameters->string0Parameter, value1 );
+		SetVariable(Sender, parameters->Var0(), value1);
 	}
 }
 
 void GameScript::GlobalMin(Scriptable* Sender, Action* parameters)
 {
-	int value1 = CheckVariable( Sender, parameters->string0Parameter );
+	int value1 = CheckVariable(Sender, parameters->Var0());
 	if (value1 < parameters->int0Parameter) {
-		SetVariable( Sender, parameters->string0Parameter, value1 );
+		SetVariable(Sender, parameters->Var0(), value1);
 	}
 }
 
 void GameScript::BitClear(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
-	SetVariable( Sender, parameters->string0Parameter,
-		value1 & ~parameters->int0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	SetVariable(Sender, parameters->Var0(),
+		value1 & ~parameters->int0Parameter);
 }
 
 void GameScript::GlobalShL(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
 	ieDword value2 = parameters->int0Parameter;
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 <<= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable(Sender, parameters->Var0(), value1);
 }
 
 void GameScript::GlobalShR(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender,
-		parameters->string0Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
 	ieDword value2 = parameters->int0Parameter;
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 >>= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable(Sender, parameters->Var0(), value1);
 }
 
 void GameScript::GlobalMaxGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
 	if (value1 < value2) {
-		SetVariable( Sender, parameters->string0Parameter, value2 );
+		SetVariable(Sender, parameters->Var0(), value2);
 	}
 }
 
 void GameScript::GlobalMinGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
 	if (value1 > value2) {
-		SetVariable( Sender, parameters->string0Parameter, value2 );
+		SetVariable(Sender, parameters->Var0(), value2);
 	}
 }
 
 void GameScript::GlobalShLGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 <<= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable(Sender, parameters->Var0(), value1);
 }
 void GameScript::GlobalShRGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable( Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable( Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
 	if (value2 > 31) {
 		value1 = 0;
 	} else {
 		value1 >>= value2;
 	}
-	SetVariable( Sender, parameters->string0Parameter, value1 );
+	SetVariable(Sender, parameters->Var0(), value1);
 }
 
 void GameScript::ClearAllActions(Scriptable* Sender, Action* /*parameters*/)
@@ -3570,17 +3550,17 @@ void GameScript::SetTextColor(Scriptable* /*Sender*/, Action* parameters)
 
 void GameScript::BitGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter );
+	ieDword value = CheckVariable(Sender, parameters->Var0());
 	HandleBitMod(value, parameters->int0Parameter, BitOp(parameters->int1Parameter));
-	SetVariable(Sender, parameters->string0Parameter, value);
+	SetVariable(Sender, parameters->Var0(), value);
 }
 
 void GameScript::GlobalBitGlobal(Scriptable* Sender, Action* parameters)
 {
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter );
-	ieDword value2 = CheckVariable(Sender, parameters->string1Parameter );
+	ieDword value1 = CheckVariable(Sender, parameters->Var0());
+	ieDword value2 = CheckVariable(Sender, parameters->Var1());
 	HandleBitMod(value1, value2, BitOp(parameters->int1Parameter));
-	SetVariable(Sender, parameters->string0Parameter, value1);
+	SetVariable(Sender, parameters->Var0(), value1);
 }
 
 void GameScript::SetVisualRange(Scriptable* Sender, Action* parameters)
@@ -4084,7 +4064,7 @@ void GameScript::CreateItemNumGlobal(Scriptable *Sender, Action* parameters)
 		default:
 			return;
 	}
-	int value = CheckVariable( Sender, parameters->string0Parameter );
+	int value = CheckVariable(Sender, parameters->Var0());
 	CREItem *item = new CREItem();
 	if (!CreateItemCore(item, parameters->resref1Parameter, value, 0, 0)) {
 		delete item;
@@ -6158,7 +6138,7 @@ void GameScript::GetStat(Scriptable* Sender, Action* parameters)
 	if (actor) {
 		value = actor->GetStat( parameters->int0Parameter );
 	}
-	SetVariable( Sender, parameters->string0Parameter, value );
+	SetVariable(Sender, parameters->Var0(), value);
 }
 
 void GameScript::BreakInstants(Scriptable* Sender, Action* /*parameters*/)
@@ -808,7 +808,7 @@ static Point FindOffScreenPoint(const Scriptable *Sender, int flags, int creatur
 			}
 
 			// Check if walkableStartPoint can traverse to walkableGoal
-			bool isWalkable = map->FindPath(walkableStartPoint, walkableGoal, creatureSize) != nullptr;
+			bool isWalkable = !map->FindPath(walkableStartPoint, walkableGoal, creatureSize).empty();
 
 			if (isPassable && (!(flags & CC_OBJECT) || isWalkable)) {
 				// walkableStartPoint is the final point
@@ -962,6 +962,7 @@ void ChangeAnimationCore(Actor* src, const ResRef& replacement, bool effect)
 		Point pos = src->Pos;
 		// make sure to copy the HP, to avoid things like magically-healing trolls
 		tar->BaseStats[IE_HITPOINTS] = src->BaseStats[IE_HITPOINTS];
+		tar->MarkStatsDirty();
 		tar->SetOrientation(src->GetOrientation(), false);
 		src->DestroySelf();
 		// can't SetPosition while the old actor is taking the spot
@@ -1880,6 +1881,9 @@ Action* GenerateActionCore(const char *src, const char *str, unsigned short acti
 		if (*src == ',' || *src==')')
 			src++;
 	}
+	if (actionflags[newAction->actionID] & AF_MERGESTRINGS) {
+		newAction->ResolveVariables();
+	}
 	return newAction;
 }
 
@@ -2037,6 +2041,8 @@ Action *ParamCopy(const Action *parameters)
 	newAction->pointParameter = parameters->pointParameter;
 	newAction->string0Parameter = parameters->string0Parameter;
 	newAction->string1Parameter = parameters->string1Parameter;
+	newAction->var0Ref = parameters->var0Ref;
+	newAction->var1Ref = parameters->var1Ref;
 	for (int c=0;c<3;c++) {
 		newAction->objects[c]= ObjectCopy( parameters->objects[c] );
 	}
@@ -2053,6 +2059,8 @@ Action *ParamCopyNoOverride(const Action *parameters)
 	newAction->pointParameter = parameters->pointParameter;
 	newAction->string0Parameter = parameters->string0Parameter;
 	newAction->string1Parameter = parameters->string1Parameter;
+	newAction->var0Ref = parameters->var0Ref;
+	newAction->var1Ref = parameters->var1Ref;
 	newAction->objects[0]= NULL;
 	newAction->objects[1]= ObjectCopy( parameters->objects[1] );
 	newAction->objects[2]= ObjectCopy( parameters->objects[2] );
@@ -2184,6 +2192,9 @@ Trigger *GenerateTriggerCore(const char *src, const char *str, int trIndex, int
 		if (*src == ',' || *src==')')
 			src++;
 	}
+	if (mergestrings) {
+		newTrigger->ResolveVariables();
+	}
 	return newTrigger;
 }
 
@@ -2227,6 +2238,98 @@ void SetVariable(Scriptable* Sender, const StringParam& VarName, ieDword value,
 	}
 }
 
+VariableRef::VariableRef(const StringParam& varName)
+{
+	const char* name = &varName[6];
+	//some HoW triggers use a : to separate the scope from the variable name
+	if (*name == ':') {
+		name++;
+	}
+	key = Variables::InternKey(Variables::key_t(name));
+
+	VarContext context;
+	context.Format("{:.6}", varName);
+	if (context == "MYAREA") {
+		scope = Scope::MyArea;
+	} else if (context == "LOCALS") {
+		scope = Scope::Locals;
+	} else if (HasKaputz && context == "KAPUTZ") {
+		scope = Scope::Kaputz;
+	} else if (context == "GLOBAL") {
+		scope = Scope::Global;
+	} else {
+		scope = Scope::Area;
+		area = context;
+	}
+}
+
+static Variables* GetVariables(const Scriptable* Sender, const VariableRef& var)
+{
+	const Game* game = core->GetGame();
+	switch (var.scope) {
+		case VariableRef::Scope::MyArea:
+			return Sender->GetCurrentArea()->locals;
+		case VariableRef::Scope::Locals:
+			return Sender->locals;
+		case VariableRef::Scope::Kaputz:
+			return game->kaputz;
+		case VariableRef::Scope::Global:
+			return game->locals;
+		case VariableRef::Scope::Area:
+		{
+			const Map* map = game->GetMap(game->FindMap(var.area));
+			return map ? map->locals : nullptr;
+		}
+		default:
+			error("GameScript", "Unresolved variable {}!", Variables::InternedKey(var.key));
+	}
+}
+
+// the scope prefix the variable was written with, for the debug output
+static const char* ScopeName(const VariableRef& var)
+{
+	switch (var.scope) {
+		case VariableRef::Scope::Global:
+			return "GLOBAL";
+		case VariableRef::Scope::Locals:
+			return "LOCALS";
+		case VariableRef::Scope::MyArea:
+			return "MYAREA";
+		case VariableRef::Scope::Kaputz:
+			return "KAPUTZ";
+		case VariableRef::Scope::Area:
+			return var.area.CString();
+		default:
+			return "";
+	}
+}
+
+void SetVariable(Scriptable* Sender, const VariableRef& var, ieDword value)
+{
+	ScriptDebugLog(ID_VARIABLES, "Setting variable(\"{}{}\", {})", ScopeName(var), Variables::InternedKey(var.key), value);
+
+	Variables* vars = GetVariables(Sender, var);
+	if (vars) {
+		vars->SetAt(var.key, value, NoCreate);
+	} else if (core->InDebugMode(ID_VARIABLES)) {
+		Log(WARNING, "GameScript", "Invalid variable {} {} in SetVariable", ScopeName(var), Variables::InternedKey(var.key));
+	}
+}
+
+ieDword CheckVariable(const Scriptable* Sender, const VariableRef& var, bool* valid)
+{
+	ieDword value = 0;
+	const Variables* vars = GetVariables(Sender, var);
+	if (vars) {
+		vars->Lookup(var.key, value);
+	} else {
+		if (valid) *valid = false;
+		ScriptDebugLog(ID_VARIABLES, "Invalid variable {} {} in checkvariable", ScopeName(var), Variables::InternedKey(var.key));
+	}
+	ScriptDebugLog(ID_VARIABLES, "CheckVariable {}{}: {}", ScopeName(var), Variables::InternedKey(var.key), value);
+	return value;
+}
+
 void SetPointVariable(Scriptable *Sender, const StringParam& VarName, const Point &p, const VarContext& Context)
 {
 	SetVariable(Sender, VarName, ((p.y & 0xFFFF) << 16) | (p.x & 0xFFFF), Context);
@@ -2363,7 +2466,7 @@ Actor *GetNearestEnemyOf(const Map *map, const Actor *origin, int whoseeswho)
 		return NULL;
 	}
 
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Acquire();
 
 	int i = map->GetActorCount(true);
 	Actor *ac;
@@ -2395,13 +2498,13 @@ Actor *GetNearestEnemyOf(const Map *map, const Actor *origin, int whoseeswho)
 		}
 	}
 	ac = static_cast<Actor*>(tgts->GetTarget(0, ST_ACTOR));
-	delete tgts;
+	tgts->Release();
 	return ac;
 }
 
 Actor *GetNearestOf(const Map *map, const Actor *origin, int whoseeswho)
 {
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Acquire();
 
 	int i = map->GetActorCount(true);
 	Actor *ac;
@@ -2424,7 +2527,7 @@ Actor *GetNearestOf(const Map *map, const Actor *origin, int whoseeswho)
 		tgts->AddTarget(ac, distance, GA_NO_DEAD|GA_NO_UNSCHEDULED);
 	}
 	ac = static_cast<Actor*>(tgts->GetTarget(0, ST_ACTOR));
-	delete tgts;
+	tgts->Release();
 	return ac;
 }
 
@@ -52,7 +52,9 @@
 #include "TableMgr.h"
 #include "RNG.h"
 
+#include <algorithm>
 #include <cstdarg>
+#include <unordered_map>
 
 namespace GemRB {
 
@@ -73,20 +75,20 @@ static const TriggerLink triggernames[] = {
 	{"animstate", GameScript::AnimState, 0},
 	{"anypconmap", GameScript::AnyPCOnMap, 0},
 	{"anypcseesenemy", GameScript::AnyPCSeesEnemy, 0},
-	{"areacheck", GameScript::AreaCheck, 0},
+	{"areacheck", GameScript::AreaCheck, TF_CACHEABLE},
 	{"areacheckobject", GameScript::AreaCheckObject, 0},
-	{"areaflag", GameScript::AreaFlag, 0},
-	{"arearestdisabled", GameScript::AreaRestDisabled, 0},
-	{"areatype", GameScript::AreaType, 0},
+	{"areaflag", GameScript::AreaFlag, TF_CACHEABLE},
+	{"arearestdisabled", GameScript::AreaRestDisabled, TF_CACHEABLE},
+	{"areatype", GameScript::AreaType, TF_CACHEABLE},
 	{"assaltedby", GameScript::AttackedBy, 0},//pst
 	{"assign", GameScript::Assign, 0},
 	{"atlocation", GameScript::AtLocation, 0},
 	{"attackedby", GameScript::AttackedBy, 0},
 	{"becamevisible", GameScript::BecameVisible, 0},
 	{"beeninparty", GameScript::BeenInParty, 0},
-	{"bitcheck", GameScript::BitCheck,TF_MERGESTRINGS},
-	{"bitcheckexact", GameScript::BitCheckExact,TF_MERGESTRINGS},
-	{"bitglobal", GameScript::BitGlobal_Trigger,TF_MERGESTRINGS},
+	{"bitcheck", GameScript::BitCheck,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"bitcheckexact", GameScript::BitCheckExact,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"bitglobal", GameScript::BitGlobal_Trigger,TF_MERGESTRINGS|TF_CACHEABLE},
 	{"bouncingspelllevel", GameScript::BouncingSpellLevel, 0},
 	{"breakingpoint", GameScript::BreakingPoint, 0},
 	{"calanderday", GameScript::CalendarDay, 0}, //illiterate developers O_o
@@ -134,9 +136,9 @@ static const TriggerLink triggernames[] = {
 	{"detected", GameScript::Detected, 0}, //trap or secret door detected
 	{"die", GameScript::Die, 0},
 	{"died", GameScript::Died, 0},
-	{"difficulty", GameScript::Difficulty, 0},
-	{"difficultygt", GameScript::DifficultyGT, 0},
-	{"difficultylt", GameScript::DifficultyLT, 0},
+	{"difficulty", GameScript::Difficulty, TF_CACHEABLE},
+	{"difficultygt", GameScript::DifficultyGT, TF_CACHEABLE},
+	{"difficultylt", GameScript::DifficultyLT, TF_CACHEABLE},
 	{"disarmed", GameScript::Disarmed, 0},
 	{"disarmfailed", GameScript::DisarmFailed, 0},
 	{"e", GameScript::E, 0},
@@ -158,26 +160,26 @@ static const TriggerLink triggernames[] = {
 	{"g", GameScript::G_Trigger, 0},
 	{"gender", GameScript::Gender, 0},
 	{"general", GameScript::General, 0},
-	{"ggt", GameScript::GGT_Trigger, 0},
-	{"glt", GameScript::GLT_Trigger, 0},
-	{"global", GameScript::Global,TF_MERGESTRINGS},
-	{"globalandglobal", GameScript::GlobalAndGlobal_Trigger,TF_MERGESTRINGS},
-	{"globalband", GameScript::BitCheck,TF_MERGESTRINGS},
-	{"globalbandglobal", GameScript::GlobalBAndGlobal_Trigger,TF_MERGESTRINGS},
-	{"globalbandglobalexact", GameScript::GlobalBAndGlobalExact,TF_MERGESTRINGS},
-	{"globalbitglobal", GameScript::GlobalBitGlobal_Trigger,TF_MERGESTRINGS},
-	{"globalequalsglobal", GameScript::GlobalsEqual,TF_MERGESTRINGS}, //this is the same
-	{"globalgt", GameScript::GlobalGT,TF_MERGESTRINGS},
-	{"globalgtglobal", GameScript::GlobalGTGlobal,TF_MERGESTRINGS},
-	{"globallt", GameScript::GlobalLT,TF_MERGESTRINGS},
-	{"globalltglobal", GameScript::GlobalLTGlobal,TF_MERGESTRINGS},
-	{"globalorglobal", GameScript::GlobalOrGlobal_Trigger,TF_MERGESTRINGS},
-	{"globalsequal", GameScript::GlobalsEqual, 0},
-	{"globalsgt", GameScript::GlobalsGT, 0},
-	{"globalslt", GameScript::GlobalsLT, 0},
-	{"globaltimerexact", GameScript::GlobalTimerExact, 0},
-	{"globaltimerexpired", GameScript::GlobalTimerExpired, 0},
-	{"globaltimernotexpired", GameScript::GlobalTimerNotExpired, 0},
+	{"ggt", GameScript::GGT_Trigger, TF_CACHEABLE},
+	{"glt", GameScript::GLT_Trigger, TF_CACHEABLE},
+	{"global", GameScript::Global,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalandglobal", GameScript::GlobalAndGlobal_Trigger,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalband", GameScript::BitCheck,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalbandglobal", GameScript::GlobalBAndGlobal_Trigger,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalbandglobalexact", GameScript::GlobalBAndGlobalExact,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalbitglobal", GameScript::GlobalBitGlobal_Trigger,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalequalsglobal", GameScript::GlobalsEqual,TF_MERGESTRINGS|TF_CACHEABLE}, //this is the same
+	{"globalgt", GameScript::GlobalGT,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalgtglobal", GameScript::GlobalGTGlobal,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globallt", GameScript::GlobalLT,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalltglobal", GameScript::GlobalLTGlobal,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalorglobal", GameScript::GlobalOrGlobal_Trigger,TF_MERGESTRINGS|TF_CACHEABLE},
+	{"globalsequal", GameScript::GlobalsEqual, TF_CACHEABLE},
+	{"globalsgt", GameScript::GlobalsGT, TF_CACHEABLE},
+	{"globalslt", GameScript::GlobalsLT, TF_CACHEABLE},
+	{"globaltimerexact", GameScript::GlobalTimerExact, TF_CACHEABLE},
+	{"globaltimerexpired", GameScript::GlobalTimerExpired, TF_CACHEABLE},
+	{"globaltimernotexpired", GameScript::GlobalTimerNotExpired, TF_CACHEABLE},
 	{"globaltimerstarted", GameScript::GlobalTimerStarted, 0},
 	{"gt", GameScript::GT, 0},
 	{"happiness", GameScript::Happiness, 0},
@@ -281,9 +283,9 @@ static const TriggerLink triggernames[] = {
 	{"levelparty", GameScript::LevelParty, 0},
 	{"levelpartygt", GameScript::LevelPartyGT, 0},
 	{"levelpartylt", GameScript::LevelPartyLT, 0},
-	{"localsequal", GameScript::LocalsEqual, 0},
-	{"localsgt", GameScript::LocalsGT, 0},
-	{"localslt", GameScript::LocalsLT, 0},
+	{"localsequal", GameScript::LocalsEqual, TF_CACHEABLE},
+	{"localsgt", GameScript::LocalsGT, TF_CACHEABLE},
+	{"localslt", GameScript::LocalsLT, TF_CACHEABLE},
 	{"los", GameScript::LOS, 0},
 	{"lt", GameScript::LT, 0},
 	{"modalstate", GameScript::ModalState, 0},
@@ -427,10 +429,10 @@ static const TriggerLink triggernames[] = {
 	{"systemvariable", GameScript::SystemVariable_Trigger, 0}, //gemrb
 	{"targetunreachable", GameScript::TargetUnreachable, 0},
 	{"team", GameScript::Team, 0},
-	{"time", GameScript::Time, 0},
-	{"timegt", GameScript::TimeGT, 0},
-	{"timelt", GameScript::TimeLT, 0},
-	{"timeofday", GameScript::TimeOfDay, 0},
+	{"time", GameScript::Time, TF_CACHEABLE},
+	{"timegt", GameScript::TimeGT, TF_CACHEABLE},
+	{"timelt", GameScript::TimeLT, TF_CACHEABLE},
+	{"timeofday", GameScript::TimeOfDay, TF_CACHEABLE},
 	{"timeractive", GameScript::TimerActive, 0},
 	{"timerexpired", GameScript::TimerExpired, 0},
 	{"timestopcounter", GameScript::TimeStopCounter, 0},
@@ -1239,6 +1241,38 @@ static const IDSLink* FindIdentifier(const char* idsname)
 }
 
 /********************** Targets **********************************/
+static std::vector<Targets*> targetsPool;
+// more than enough for the nesting of object filters and script recursion
+static const size_t MAX_POOLED_TARGETS = 64;
+
+Targets* Targets::Acquire()
+{
+	if (targetsPool.empty()) {
+		return new Targets();
+	}
+	Targets* tgts = targetsPool.back();
+	targetsPool.pop_back();
+	return tgts;
+}
+
+void Targets::Release()
+{
+	objects.clear();
+	if (targetsPool.size() < MAX_POOLED_TARGETS) {
+		targetsPool.push_back(this);
+	} else {
+		delete this;
+	}
+}
+
+void Targets::ReleasePool()
+{
+	for (const Targets* tgts : targetsPool) {
+		delete tgts;
+	}
+	targetsPool.clear();
+}
+
 
 int Targets::Count() const
 {
@@ -1256,8 +1290,7 @@ targettype *Targets::RemoveTargetAt(targetlist::iterator &m)
 
 const targettype *Targets::GetLastTarget(int Type)
 {
-	targetlist::const_iterator m = objects.end();
-	while (m--!=objects.begin() ) {
+	for (auto m = objects.rbegin(); m != objects.rend(); ++m) {
 		if (Type == -1 || (*m).actor->Type == Type) {
 			return &(*m);
 		}
@@ -1327,14 +1360,11 @@ void Targets::AddTarget(Scriptable* target, unsigned int distance, int ga_flags)
 	default:
 		break;
 	}
-	targettype Target = {target, distance};
-	for (auto m = objects.begin(); m != objects.end(); ++m) {
-		if ( (*m).distance>distance) {
-			objects.insert( m, Target);
-			return;
-		}
-	}
-	objects.push_back( Target );
+	// keep the set sorted by distance, after any targets just as far
+	auto m = std::upper_bound(objects.begin(), objects.end(), distance, [](unsigned int dist, const targettype& t) {
+		return dist < t.distance;
+	});
+	objects.insert(m, { target, distance });
 }
 
 void Targets::Clear()
@@ -1357,18 +1387,16 @@ void Targets::FilterObjectRect(const Object *oC)
 	// can't match anything if the second pair of coordinates (or all of them) are unset
 	if (oC->objectRect.w <= 0 || oC->objectRect.h <= 0) return;
 
-	for (auto m = objects.begin(); m != objects.end();) {
-		if (!IsInObjectRect((*m).actor->Pos, oC->objectRect)) {
-			m = objects.erase(m);
-		} else {
-			++m;
-		}
-	}
+	auto outside = std::remove_if(objects.begin(), objects.end(), [oC](const targettype& t) {
+		return !IsInObjectRect(t.actor->Pos, oC->objectRect);
+	});
+	objects.erase(outside, objects.end());
 }
 
 /** releasing global memory */
 static void CleanupIEScript()
 {
+	Targets::ReleasePool();
 	triggersTable.reset();
 	actionsTable.reset();
 	objectsTable.reset();
@@ -1779,6 +1807,32 @@ void InitializeIEScript()
 	}
 }
 
+/********************** Script *******************************/
+// Scripts tend to repeat the same variable and area checks in many blocks,
+// so identical side effect free triggers share a result slot and are only
+// evaluated once per run. Triggers with an object (set by NextTriggerObject)
+// are left alone, since the object could change what they look at.
+void Script::AssignMemoSlots()
+{
+	std::unordered_map<std::string, int> slots;
+	for (const ResponseBlock* rB : responseBlocks) {
+		if (!rB->condition) continue;
+		for (Trigger* tR : rB->condition->triggers) {
+			if (!(triggerflags[tR->triggerID] & TF_CACHEABLE) || tR->objectParameter) {
+				continue;
+			}
+			// the negation is applied after the lookup, so it's not part of the key
+			std::string key = fmt::format("{} {} {} {} {} {} {} \"{}\" \"{}\"", tR->triggerID,
+				tR->int0Parameter, tR->int1Parameter, tR->int2Parameter,
+				tR->pointParameter.x, tR->pointParameter.y,
+				tR->flags & ~TF_NEGATE, tR->string0Parameter, tR->string1Parameter);
+			auto it = slots.emplace(std::move(key), int(slots.size())).first;
+			tR->memoSlot = it->second;
+		}
+	}
+	memoSlots = slots.size();
+}
+
 /********************** GameScript *******************************/
 GameScript::GameScript(const ResRef& resref, Scriptable* MySelf,
 	int ScriptLevel, bool AIScript)
@@ -1839,6 +1893,7 @@ Script* GameScript::CacheScript(const ResRef& resRef, bool AIScript)
 		stream->ReadLine( line, 10 );
 	}
 	delete stream;
+	newScript->AssignMemoSlots();
 	return newScript;
 }
 
@@ -1960,6 +2015,9 @@ static Trigger* ReadTrigger(DataStream* stream)
 		delete tR;
 		return NULL;
 	}
+	if (triggerflags[tR->triggerID] & TF_MERGESTRINGS) {
+		tR->ResolveVariables();
+	}
 	return tR;
 }
 
@@ -2026,9 +2084,10 @@ bool GameScript::Update(bool *continuing, bool *done)
 	if (continuing) continueExecution = *continuing;
 
 	RandomNumValue = RAND_ALL();
+	triggerMemo.assign(script->memoSlots, -1);
 	for (size_t a = 0; a < script->responseBlocks.size(); a++) {
 		ResponseBlock* rB = script->responseBlocks[a];
-		if (!rB->condition->Evaluate(MySelf)) {
+		if (!rB->condition->Evaluate(MySelf, &triggerMemo)) {
 			continue;
 		}
 
@@ -2068,6 +2127,8 @@ bool GameScript::Update(bool *continuing, bool *done)
 		running = true;
 		continueExecution = rB->responseSet->Execute(MySelf) != 0;
 		running = false;
+		// instant actions may have changed what the triggers check
+		std::fill(triggerMemo.begin(), triggerMemo.end(), -1);
 		if (continuing) *continuing = continueExecution;
 		if (!continueExecution) {
 			if (done) *done = true;
@@ -2216,6 +2277,9 @@ Response* GameScript::ReadResponse(DataStream* stream)
 				//just to find bugs faster
 				aC->int0Parameter = -1;
 			}
+			if (actionflags[aC->actionID] & AF_MERGESTRINGS) {
+				aC->ResolveVariables();
+			}
 		}
 		rE->actions.push_back( aC );
 		stream->ReadLine( line, 1024 );
@@ -2253,7 +2317,7 @@ int GameScript::EvaluateString(Scriptable* Sender, const char* String)
 	return 0;
 }
 
-bool Condition::Evaluate(Scriptable *Sender) const
+bool Condition::Evaluate(Scriptable *Sender, std::vector<int>* memo) const
 {
 	int ORcount = 0;
 	unsigned int result = 0;
@@ -2267,7 +2331,7 @@ bool Condition::Evaluate(Scriptable *Sender) const
 		//do not evaluate triggers in an Or() block if one of them
 		//was already True() ... but this sane approach was only used in iwd2!
 		if (!core->HasFeature(GF_EFFICIENT_OR) || !ORcount || !subresult) {
-			result = tR->Evaluate(Sender);
+			result = tR->Evaluate(Sender, memo);
 		}
 		if (result > 1) {
 			//we started an Or() block
@@ -2300,26 +2364,40 @@ bool Condition::Evaluate(Scriptable *Sender) const
 }
 
 /* this may return more than a boolean, in case of Or(x) */
-int Trigger::Evaluate(Scriptable *Sender) const
+static StringView TriggerName(unsigned short triggerID)
+{
+	StringView name = triggersTable->GetValue(triggerID);
+	if (name.empty()) {
+		name = triggersTable->GetValue(triggerID|0x4000);
+	}
+	return name;
+}
+
+int Trigger::Evaluate(Scriptable *Sender, std::vector<int>* memo) const
 {
 	if (triggerID >= MAX_TRIGGERS) {
 		Log(ERROR, "GameScript", "Corrupted (too high) trigger code: {}", triggerID);
 		return 0;
 	}
 	TriggerFunction func = triggers[triggerID];
-	StringView tmpstr = triggersTable->GetValue(triggerID);
-	if (tmpstr.empty()) {
-		tmpstr = triggersTable->GetValue(triggerID|0x4000);
-	}
 	if (!func) {
 		triggers[triggerID] = GameScript::False;
 		Log(WARNING, "GameScript", "Unhandled trigger code: {:#x} {}",
-			triggerID, tmpstr );
+			triggerID, TriggerName(triggerID));
 		return 0;
 	}
-	ScriptDebugLog(ID_TRIGGERS, "Executing trigger code: {:#x} {} (Sender: {} / {})", triggerID, tmpstr, Sender->GetScriptName(), fmt::WideToChar{Sender->GetName()});
 
-	int ret = func( Sender, this );
+	int ret;
+	int* memoized = memo && memoSlot >= 0 ? &(*memo)[memoSlot] : nullptr;
+	if (memoized && *memoized >= 0) {
+		ret = *memoized;
+	} else {
+		if (core->InDebugMode(ID_TRIGGERS)) {
+			ScriptDebugLog(ID_TRIGGERS, "Executing trigger code: {:#x} {} (Sender: {} / {})", triggerID, TriggerName(triggerID), Sender->GetScriptName(), fmt::WideToChar{Sender->GetName()});
+		}
+		ret = func( Sender, this );
+		if (memoized) *memoized = ret;
+	}
 	if (flags & TF_NEGATE) {
 		return !ret;
 	}
@@ -2609,6 +2687,33 @@ bool Object::isNull() const
 	return true;
 }
 
+const VariableRef& Trigger::Var0() const
+{
+	if (var0Ref.scope == VariableRef::Scope::Unresolved) {
+		var0Ref = VariableRef(string0Parameter);
+	}
+	return var0Ref;
+}
+
+const VariableRef& Trigger::Var1() const
+{
+	if (var1Ref.scope == VariableRef::Scope::Unresolved) {
+		var1Ref = VariableRef(string1Parameter);
+	}
+	return var1Ref;
+}
+
+void Trigger::ResolveVariables() const
+{
+	// empty ones may still get a default before they're used
+	if (!string0Parameter.IsEmpty()) {
+		Var0();
+	}
+	if (!string1Parameter.IsEmpty()) {
+		Var1();
+	}
+}
+
 std::string Trigger::dump() const
 {
 	AssertCanary(__func__);
@@ -2628,6 +2733,33 @@ std::string Trigger::dump() const
 	return buffer;
 }
 
+const VariableRef& Action::Var0() const
+{
+	if (var0Ref.scope == VariableRef::Scope::Unresolved) {
+		var0Ref = VariableRef(string0Parameter);
+	}
+	return var0Ref;
+}
+
+const VariableRef& Action::Var1() const
+{
+	if (var1Ref.scope == VariableRef::Scope::Unresolved) {
+		var1Ref = VariableRef(string1Parameter);
+	}
+	return var1Ref;
+}
+
+void Action::ResolveVariables() const
+{
+	// empty ones may still get a default before they're used
+	if (!string0Parameter.IsEmpty()) {
+		Var0();
+	}
+	if (!string1Parameter.IsEmpty()) {
+		Var1();
+	}
+}
+
 std::string Action::dump() const
 {
 	AssertCanary(__func__);
@@ -142,18 +142,48 @@ using SrcVector = std::vector<ieStrRef>;
 using StringParam = FixedSizeString<64, strnicmp>; // FIXME: should this be case sensetive
 static_assert(std::is_standard_layout<StringParam>::value, "Fixed Size String must be standard layout for use in unions");
 
+// A variable parameter with its scope prefix ("GLOBALfoo", "LOCALS:bar") parsed
+// and its name interned, so checking it doesn't need to look at any strings.
+struct GEM_EXPORT VariableRef {
+	enum class Scope : uint8_t {
+		Unresolved,
+		Global,
+		Locals,
+		MyArea,
+		Kaputz,
+		Area // a named one, eg. AR1324
+	};
+
+	Scope scope = Scope::Unresolved;
+	Variables::key_id key = 0;
+	ResRef area;
+
+	VariableRef() noexcept = default;
+	explicit VariableRef(const StringParam& varName);
+};
+
 struct targettype {
 	Scriptable *actor; //hmm, could be door
 	unsigned int distance;
 };
 
-using targetlist = std::list<targettype>;
+using targetlist = std::vector<targettype>;
 
+// Object resolution creates and drops these sets all the time, so they are
+// recycled through a pool instead of being allocated each time: get one
+// with Acquire and hand it back with Release, which keeps its storage.
 class GEM_EXPORT Targets {
 	targetlist objects;
+
+	Targets() noexcept = default;
 public:
-	Targets() noexcept {};
-	
+	Targets(const Targets&) = delete;
+	Targets& operator=(const Targets&) = delete;
+
+	static Targets* Acquire();
+	void Release();
+	static void ReleasePool();
+
 	int Count() const;
 	void dump() const;
 	targettype *RemoveTargetAt(targetlist::iterator &m);
@@ -226,7 +256,7 @@ public:
 			objectParameter = nullptr;
 		}
 	}
-	int Evaluate(Scriptable *Sender) const;
+	int Evaluate(Scriptable *Sender, std::vector<int>* memo = nullptr) const;
 
 	unsigned short triggerID = 0;
 	int int0Parameter = 0;
@@ -235,6 +265,8 @@ public:
 	int int2Parameter = 0;
 	Point pointParameter;
 	Object* objectParameter = nullptr;
+	// result slot shared by the identical cacheable triggers of a script, see Script::AssignMemoSlots
+	int memoSlot = -1;
 	
 	union {
 		StringParam string0Parameter;
@@ -248,6 +280,13 @@ public:
 		ResRef resref1Parameter;
 	};
 
+	// the string parameters as scoped variables, resolved on load or first use
+	mutable VariableRef var0Ref;
+	mutable VariableRef var1Ref;
+	const VariableRef& Var0() const;
+	const VariableRef& Var1() const;
+	void ResolveVariables() const;
+
 	std::string dump() const;
 
 	void Release()
@@ -271,7 +310,7 @@ public:
 	{
 		delete this;
 	}
-	bool Evaluate(Scriptable *Sender) const;
+	bool Evaluate(Scriptable *Sender, std::vector<int>* memo = nullptr) const;
 
 	std::vector<Trigger*> triggers;
 };
@@ -317,6 +356,13 @@ public:
 		ResRef resref1Parameter;
 	};
 
+	// the string parameters as scoped variables, resolved on load or first use
+	mutable VariableRef var0Ref;
+	mutable VariableRef var1Ref;
+	const VariableRef& Var0() const;
+	const VariableRef& Var1() const;
+	void ResolveVariables() const;
+
 	uint32_t flags = 0;
 private:
 	int RefCount = 0;
@@ -429,7 +475,10 @@ public:
 	}
 
 	std::vector<ResponseBlock*> responseBlocks;
+	// number of distinct cacheable triggers, the size of a run's memo
+	size_t memoSlots = 0;
 
+	void AssignMemoSlots();
 	void Release()
 	{
 		delete this;
@@ -445,6 +494,7 @@ using IDSFunction = int (*)(const Actor*, int parameter);
 #define TF_CONDITION    1 //this isn't a trigger, just a condition (0x4000)
 #define TF_SAVED        2 //trigger is in svtriobj.ids
 #define TF_MERGESTRINGS 8 //same value as actions' mergestring
+#define TF_CACHEABLE    16 //side effect free, evaluated at most once per script run
 
 struct TriggerLink {
 	const char* Name;
@@ -569,6 +619,8 @@ private: //Internal Functions
 	Script* script;
 	size_t lastAction = -1;
 	int scriptlevel;
+	// results of the cacheable triggers during the current run, -1 if not evaluated yet
+	std::vector<int> triggerMemo;
 public: //Script Functions
 	static int ID_Alignment(const Actor *actor, int parameter);
 	static int ID_Allegiance(const Actor *actor, int parameter);
@@ -36,7 +36,7 @@ namespace GemRB {
 static inline Targets* ReturnScriptableAsTarget(Scriptable *sc)
 {
 	if (!sc) return NULL;
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Acquire();
 	tgts->AddTarget(sc, 0, 0);
 	return tgts;
 }
@@ -87,7 +87,7 @@ static inline Targets *DoObjectFiltering(const Scriptable *Sender, Targets *tgts
 
 		tgts = func(Sender, tgts, ga_flags);
 		if (!tgts->Count()) {
-			delete tgts;
+			tgts->Release();
 			return NULL;
 		}
 	}
@@ -186,21 +186,19 @@ static Targets *EvaluateObject(const Map *map, const Scriptable *Sender, const O
 
 	Targets *tgts = NULL;
 
-	//we need to get a subset of actors from the large array
-	//if this gets slow, we will need some index tables
-	int i = map->GetActorCount(true);
-	while (i--) {
-		Actor *ac = map->GetActor(i, true);
-		if (!ac) continue; // is this check really needed?
+	// set when an actor passes the IDS check without any filter applying
+	bool unfiltered = false;
+	auto match = [&](Actor* ac) {
+		if (!ac) return false; // is this check really needed?
 		// don't return Sender in IDS targeting!
 		// unless it's pst, which relies on it in 3012cut2-3012cut7.bcs
 		// FIXME: do we need more fine-grained control?
 		// FIXME: stop abusing old GF flags
-		if (!core->HasFeature(GF_AREA_OVERRIDE) && ac == Sender) continue;
+		if (!core->HasFeature(GF_AREA_OVERRIDE) && ac == Sender) return false;
 
 		bool filtered = false;
 		if (!DoObjectIDSCheck(oC, ac, &filtered)) {
-			continue;
+			return false;
 		}
 
 		// this is needed so eg. Range trigger gets a good object
@@ -208,13 +206,32 @@ static Targets *EvaluateObject(const Map *map, const Scriptable *Sender, const O
 		if (!filtered) {
 			// if no filters were applied..
 			assert(!tgts);
-			return nullptr;
+			unfiltered = true;
+			return true;
 		}
 		int dist;
 		if (DoObjectChecks(map, Sender, ac, dist, (ga_flags & GA_DETECT) != 0, oC)) {
-			if (!tgts) tgts = new Targets();
+			if (!tgts) tgts = Targets::Acquire();
 			tgts->AddTarget((Scriptable *) ac, dist, ga_flags);
 		}
+		return false;
+	};
+
+	//we need to get a subset of actors from the large array
+	//actors out of visual range won't pass DoObjectChecks, so only look around the sender
+	if (Sender->Type == ST_ACTOR && !(HasAdditionalRect && oC->objectRect.size.Area() > 0)) {
+		// one extra cell for the rounding in SquaredMapDistance
+		int range = int(static_cast<const Actor*>(Sender)->Modified[IE_VISUALRANGE]) + 2;
+		map->QueryActorsNear(Region(Sender->Pos - Point(range * 16, range * 12), Size(range * 32 + 1, range * 24 + 1)), match, true);
+	} else {
+		const auto& actors = map->GetAllActors();
+		size_t i = actors.size();
+		while (i--) {
+			if (match(actors[i])) break;
+		}
+	}
+	if (unfiltered) {
+		return nullptr;
 	}
 
 	return tgts;
@@ -236,7 +253,7 @@ Targets *GetAllObjects(const Map *map, Scriptable *Sender, const Object *oC, int
 	//it is possible to start from blank sheets using endpoint filters
 	//like (Myself, Protagonist etc)
 	if (!tgts) {
-		tgts = new Targets();
+		tgts = Targets::Acquire();
 	}
 	tgts = DoObjectFiltering(Sender, tgts, oC, ga_flags);
 	if (tgts) {
@@ -250,7 +267,7 @@ Targets *GetAllActors(Scriptable *Sender, int ga_flags)
 	const Map *map = Sender->GetCurrentArea();
 
 	int i = map->GetActorCount(true);
-	Targets *tgts = new Targets();
+	Targets *tgts = Targets::Acquire();
 	//make sure that Sender is always first in the list, even if there
 	//are other (e.g. dead) targets at the same location
 	tgts->AddTarget(Sender, 0, ga_flags);
@@ -324,7 +341,7 @@ Scriptable *GetScriptableFromObject(Scriptable *Sender, const Object *oC, int ga
 	if (tgts) {
 		//now this could return other than actor objects
 		aC = tgts->GetTarget(0,-1);
-		delete tgts;
+		tgts->Release();
 		if (aC || !oC || oC->objectFields[0]!=-1) {
 			return aC;
 		}
@@ -401,7 +418,7 @@ bool MatchActor(const Scriptable *Sender, ieDword actorID, const Object *oC)
 	if (oC->objectFilters[0]) {
 		// object filters insist on having a stupid targets list,
 		// so we waste a lot of time here
-		Targets *tgts = new Targets();
+		Targets *tgts = Targets::Acquire();
 		int ga_flags = 0; // TODO: correct?
 
 		// handle already-filtered vs not-yet-filtered cases
@@ -425,7 +442,7 @@ bool MatchActor(const Scriptable *Sender, ieDword actorID, const Object *oC)
 			}
 			tt = tgts->GetNextTarget(m, ST_ACTOR);
 		}
-		delete tgts;
+		tgts->Release();
 		if (!ret) return false;
 	}
 	return true;
@@ -443,7 +460,7 @@ int GetObjectCount(Scriptable *Sender, const Object *oC)
 	int count = 0; // silly fallback to avoid potential crashes
 	if (tgts) {
 		count = tgts->Count();
-		delete tgts;
+		tgts->Release();
 	}
 	return count;
 }
@@ -472,8 +489,8 @@ int GetObjectLevelCount(Scriptable *Sender, const Object *oC)
 			count += ((Actor *) tt->actor)->GetXPLevel(true);
 			tt = tgts->GetNextTarget(m, ST_ACTOR);
 		}
+		tgts->Release();
 	}
-	delete tgts;
 	return count;
 }
 
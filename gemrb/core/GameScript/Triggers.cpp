@@ -525,7 +525,7 @@ int GameScript::BitCheck(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid && value & parameters->int0Parameter) return 1;
 	return 0;
 }
@@ -534,7 +534,7 @@ int GameScript::BitCheckExact(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
 		ieDword tmp = (ieDword) parameters->int0Parameter ;
 		if ((value & tmp) == tmp) return 1;
@@ -548,7 +548,7 @@ int GameScript::BitGlobal_Trigger(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
 		HandleBitMod(value, parameters->int0Parameter, BitOp(parameters->int1Parameter));
 		if (value!=0) return 1;
@@ -560,10 +560,10 @@ int GameScript::GlobalOrGlobal_Trigger(Scriptable *Sender, const Trigger *parame
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
 		if (value1) return 1;
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid && value2) return 1;
 	}
 	return 0;
@@ -573,9 +573,9 @@ int GameScript::GlobalAndGlobal_Trigger(Scriptable *Sender, const Trigger *param
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid && value1) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid && value2) return 1;
 	}
 	return 0;
@@ -585,9 +585,9 @@ int GameScript::GlobalBAndGlobal_Trigger(Scriptable *Sender, const Trigger *para
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid && (value1 & value2) != 0) return 1;
 	}
 	return 0;
@@ -597,9 +597,9 @@ int GameScript::GlobalBAndGlobalExact(Scriptable *Sender, const Trigger *paramet
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid && (value1 & value2) == value2) return 1;
 	}
 	return 0;
@@ -609,9 +609,9 @@ int GameScript::GlobalBitGlobal_Trigger(Scriptable *Sender, const Trigger *param
 {
 	bool valid=true;
 
-	ieDword value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
-		ieDword value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDword value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid) {
 			HandleBitMod(value1, value2, BitOp(parameters->int1Parameter));
 			if (value1!=0) return 1;
@@ -624,7 +624,7 @@ int GameScript::GlobalBitGlobal_Trigger(Scriptable *Sender, const Trigger *param
 //i just assume it sets a global in the trigger block
 int GameScript::TriggerSetGlobal(Scriptable *Sender, const Trigger *parameters)
 {
-	SetVariable( Sender, parameters->string0Parameter, parameters->int0Parameter );
+	SetVariable(Sender, parameters->Var0(), parameters->int0Parameter);
 	return 1;
 }
 
@@ -633,7 +633,7 @@ int GameScript::Xor(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDword value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDword value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid && (value ^ parameters->int0Parameter) != 0) return 1;
 	return 0;
 }
@@ -692,7 +692,7 @@ int GameScript::Global(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDwordSigned value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid && value == parameters->int0Parameter) {
 		return 1;
 	}
@@ -709,7 +709,7 @@ int GameScript::GlobalLT(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDwordSigned value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid && value < parameters->int0Parameter) return 1;
 	return 0;
 }
@@ -724,7 +724,7 @@ int GameScript::GlobalGT(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDwordSigned value = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid && value > parameters->int0Parameter) return 1;
 	return 0;
 }
@@ -733,9 +733,9 @@ int GameScript::GlobalLTGlobal(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDwordSigned value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
-		ieDwordSigned value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDwordSigned value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid && value1 < value2) return 1;
 	}
 	return 0;
@@ -745,9 +745,9 @@ int GameScript::GlobalGTGlobal(Scriptable *Sender, const Trigger *parameters)
 {
 	bool valid=true;
 
-	ieDwordSigned value1 = CheckVariable(Sender, parameters->string0Parameter, {}, &valid);
+	ieDwordSigned value1 = CheckVariable(Sender, parameters->Var0(), &valid);
 	if (valid) {
-		ieDwordSigned value2 = CheckVariable(Sender, parameters->string1Parameter, {}, &valid);
+		ieDwordSigned value2 = CheckVariable(Sender, parameters->Var1(), &valid);
 		if (valid && value1 > value2) return 1;
 	}
 	return 0;
@@ -1732,8 +1732,8 @@ int GameScript::IsOverMe(Scriptable *Sender, const Trigger *parameters)
 			}
 			tt = tgts->GetNextTarget(m, ST_ACTOR);
 		}
+		tgts->Release();
 	}
-	delete tgts;
 
 	// manually set LastTrigger, since IsOverMe is not in svtriobj
 	if (ret != 0) {
@@ -3667,7 +3667,7 @@ int GameScript::StuffGlobalRandom( Scriptable *Sender, const Trigger *parameters
 	} else {
 		Value = RandomNumValue;
 	}
-	SetVariable( Sender, parameters->string0Parameter, Value );
+	SetVariable(Sender, parameters->Var0(), Value);
 	if (Value) {
 		return 1;
 	}
@@ -4114,7 +4114,7 @@ int GameScript::SystemVariable_Trigger(Scriptable *Sender, const Trigger *parame
 		return 0;
 	}
 
-	SetVariable(Sender, parameters->string0Parameter, value);
+	SetVariable(Sender, parameters->Var0(), value);
 	return 1;
 }
 
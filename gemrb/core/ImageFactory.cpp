@@ -32,4 +32,11 @@ ImageFactory::ImageFactory(const ResRef &resref, Holder<Sprite2D> bitmap_)
 
 }
 
+size_t ImageFactory::MemoryUsage() const noexcept
+{
+	size_t bytes = sizeof(ImageFactory);
+	if (bitmap) bytes += bitmap->GetPitch() * bitmap->Frame.h;
+	return bytes;
+}
+
 }
@@ -36,6 +36,7 @@ public:
 	ImageFactory(const ResRef& resref, Holder<Sprite2D> bitmap);
 
 	Holder<Sprite2D> GetSprite2D() const { return bitmap; }
+	size_t MemoryUsage() const noexcept override;
 };
 
 }
@@ -75,9 +75,14 @@
 #include "GUI/WorldMapControl.h"
 #include "RNG.h"
 #include "Scriptable/Container.h"
+#include "Streams/BufferStream.h"
 #include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
 #include "System/FileFilters.h"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -259,6 +264,9 @@ Interface::Interface() noexcept
 
 Interface::~Interface() noexcept
 {
+	// the save writer still needs the plugins and the area extractor
+	saveGameWriter.Wait();
+
 	WindowManager::CursorMouseUp = NULL;
 	WindowManager::CursorMouseDown = NULL;
 
@@ -612,6 +620,22 @@ void Interface::Main()
 	fpsRgn.x = 5;
 	fpsRgn.y = 0;
 
+	// in benchmark mode every frame is exactly one game tick on the fixed clock,
+	// without a frame cap, so runs are repeatable and only limited by the cpu
+	using BenchClock = std::chrono::steady_clock;
+	bool benchmark = config.BenchmarkTicks > 0;
+	int benchTicks = 0;
+	tick_t tickLength = Time.Ticks2Ms(1);
+	BenchClock::time_point benchStart;
+	BenchClock::duration loopTime {};
+	BenchClock::duration drawTime {};
+	uint64_t benchBlits = 0;
+	uint64_t benchDrawCalls = 0;
+	if (benchmark && !StartBenchmark()) {
+		benchmark = false;
+		QuitFlag = QF_KILL;
+	}
+
 	tick_t frame = 0;
 	tick_t time = GetMilliseconds();
 	tick_t timebase = time;
@@ -640,11 +664,38 @@ void Interface::Main()
 			HandleGUIBehaviour(gamectrl);
 		}
 
+		BenchClock::time_point loopStart = BenchClock::now();
 		GameLoop();
 		// TODO: find other animations that need to be synchronized
 		// we can create a manager for them and everything can be updated at once
 		GlobalColorCycle.AdvanceTime(time);
+		BenchClock::time_point drawStart = BenchClock::now();
 		winmgr->DrawWindows();
+		// nothing holds on to plain factory pointers between frames
+		gamedata->GetFactory().Trim();
+		saveGameWriter.Update();
+		if (benchmark) {
+			// only count the ticks spent in the game, not the loading
+			if (game && gamectrl) {
+				if (!benchTicks) benchStart = loopStart;
+				loopTime += drawStart - loopStart;
+				drawTime += BenchClock::now() - drawStart;
+				// these are from the previous frame, which evens out over the run
+				benchBlits += video->GetFrameStats().blits;
+				benchDrawCalls += video->GetFrameStats().drawCalls;
+				if (++benchTicks == config.BenchmarkTicks) {
+					using ms = std::chrono::duration<double, std::milli>;
+					double total = ms(BenchClock::now() - benchStart).count();
+					Log(MESSAGE, "Benchmark", "{} ticks in {:.1f} ms: {:.3f} ms per tick, {:.3f} ms game loop, {:.3f} ms drawing",
+						benchTicks, total, total / benchTicks,
+						ms(loopTime).count() / benchTicks, ms(drawTime).count() / benchTicks);
+					Log(MESSAGE, "Benchmark", "{:.1f} blits and {:.1f} draw calls per frame",
+						double(benchBlits) / benchTicks, double(benchDrawCalls) / benchTicks);
+					ExitGemRB();
+				}
+			}
+			SetFixedClock(fixedClock.load(std::memory_order_relaxed) + tickLength);
+		}
 		time = GetMilliseconds();
 		if (config.DrawFPS) {
 			frame++;
@@ -658,8 +709,27 @@ void Interface::Main()
 			video->DrawRect( fpsRgn, ColorBlack );
 			fps->Print(fpsRgn, String(fpsstring), IE_FONT_ALIGN_MIDDLE | IE_FONT_SINGLE_LINE, {ColorWhite, ColorBlack});
 		}
-	} while (video->SwapBuffers() == GEM_OK && !(QuitFlag&QF_KILL));
+	} while (video->SwapBuffers(benchmark ? 0 : 30) == GEM_OK && !(QuitFlag&QF_KILL));
 	QuitGame(0);
+	SetFixedClock(0);
+}
+
+bool Interface::StartBenchmark()
+{
+	Holder<SaveGame> save = sgiterator->GetSaveGame(config.BenchmarkSave);
+	if (!save) {
+		Log(ERROR, "Benchmark", "Save '{}' not found.", config.BenchmarkSave);
+		return false;
+	}
+
+	Log(MESSAGE, "Benchmark", "Running {} ticks of '{}'.", config.BenchmarkTicks, config.BenchmarkSave);
+	// the same rolls and the same clock on every run
+	RNG::getInstance().Seed(0);
+	SetFixedClock(GetMilliseconds());
+	SetupLoadGame(save, 0);
+	// skip the start screens and go straight into the game
+	QuitFlag = QF_LOADGAME | QF_ENTERGAME;
+	return true;
 }
 
 int Interface::LoadSprites()
@@ -798,11 +868,13 @@ int Interface::Init(const InterfaceConfig* cfg)
 			var ( atoi( value ) ); \
 		value = nullptr
 
+	CONFIG_INT("BenchmarkTicks", config.BenchmarkTicks =);
 	CONFIG_INT("Bpp", config.Bpp =);
 	CONFIG_INT("CaseSensitive", config.CaseSensitive =);
 	CONFIG_INT("DoubleClickDelay", EventMgr::DCDelay = );
 	CONFIG_INT("DrawFPS", config.DrawFPS =);
 	CONFIG_INT("EnableCheatKeys", EnableCheatKeys);
+	CONFIG_INT("FactoryCacheSize", config.FactoryCacheSize =);
 	CONFIG_INT("GCDebug", GameControl::DebugFlags = );
 	CONFIG_INT("Height", config.Height =);
 	CONFIG_INT("KeepCache", config.KeepCache =);
@@ -825,6 +897,8 @@ int Interface::Init(const InterfaceConfig* cfg)
 
 #undef CONFIG_INT
 
+	gamedata->GetFactory().SetBudget(size_t(std::max(config.FactoryCacheSize, 0)) * 1024 * 1024);
+
 // first param is the preference name, second is the key from gemrb.cfg.
 #define CONFIG_VARS_MAP(var, key) \
 		value = cfg->GetValueForKey(key); \
@@ -959,6 +1033,7 @@ int Interface::Init(const InterfaceConfig* cfg)
 		value = nullptr
 
 	CONFIG_STRING("AudioDriver", config.AudioDriverName);
+	CONFIG_STRING("BenchmarkSave", config.BenchmarkSave);
 	CONFIG_STRING("VideoDriver", config.VideoDriverName);
 	CONFIG_STRING("Encoding", config.Encoding);
 #undef CONFIG_STRING
@@ -1070,7 +1145,8 @@ int Interface::Init(const InterfaceConfig* cfg)
 
 	char path[_MAX_PATH];
 	PathJoin(path, config.CachePath, nullptr);
-	if (!gamedata->AddSource(path, "Cache", PLUGIN_RESOURCE_DIRECTORY)) {
+	// files written to the cache are reported by FileStream, so it can be listed
+	if (!gamedata->AddSource(path, "Cache", PLUGIN_RESOURCE_CACHEDDIRECTORY)) {
 		Log(FATAL, "Core", "The cache path couldn't be registered, please check!");
 		return GEM_ERROR;
 	}
@@ -2762,6 +2838,8 @@ void Interface::LoadGame(SaveGame *sg, int ver_override)
 
 	// Yes, it uses goto. Other ways seemed too awkward for me.
 
+	// the save may still be in the works
+	saveGameWriter.Wait();
 	gamedata->SaveAllStores();
 	strings->CloseAux();
 	tokens->RemoveAll(NULL); //clearing the token dictionary
@@ -2778,7 +2856,10 @@ void Interface::LoadGame(SaveGame *sg, int ver_override)
 	WorldMapArray* new_worldmap = NULL;
 
 	LoadProgress(10);
-	if (!config.KeepCache) DelTree((const char *) config.CachePath, true);
+	if (!config.KeepCache) {
+		DelTree((const char *) config.CachePath, true);
+		gamedata->RefreshSource("Cache");
+	}
 	LoadProgress(15);
 
 	saveGameAREExtractor.changeSaveGame(sg);
@@ -3325,6 +3406,9 @@ void Interface::RemoveFromCache(const ResRef& resref, SClass_ID ClassID) const
 
 	PathJoinExt(filename, config.CachePath, resref.CString(), TypeExt(ClassID));
 	unlink ( filename);
+	char name[_MAX_PATH];
+	ExtractFileFromPath(name, filename);
+	gamedata->RefreshSource("Cache", name);
 }
 
 //this function checks if the path is eligible as a cache
@@ -3917,7 +4001,7 @@ Effect *Interface::GetEffect(const ResRef& resname, int level, const Point &p)
 }
 
 // dealing with saved games
-int Interface::SwapoutArea(Map *map) const
+int Interface::SwapoutArea(Map *map, SaveGameWriter::Snapshot* snapshot) const
 {
 	//refuse to save ambush areas, for example
 	if (map->AreaFlags & AF_NOSAVE) {
@@ -3932,7 +4016,20 @@ int Interface::SwapoutArea(Map *map) const
 		return -1;
 	}
 	int size = mm->GetStoredFileSize (map);
-	if (size > 0) {
+	if (size > 0 && snapshot) {
+		// saving: the cache copy isn't needed, the area stays loaded
+		std::string name = fmt::format("{}.{}", map->GetScriptName(), TypeExt(IE_ARE_CLASS_ID));
+		DataStream* str = new BufferStream(name.c_str(), size);
+		if (mm->PutArea(str, map) < 0) {
+			delete str;
+			Log(WARNING, "Core", "Area removed: {}",
+				map->GetScriptName());
+			RemoveFromCache(map->GetScriptRef(), IE_ARE_CLASS_ID);
+		} else {
+			str->Rewind();
+			snapshot->emplace_back(str, false);
+		}
+	} else if (size > 0) {
 		//created streams are always autofree (close file on destruct)
 		//this one will be destructed when we return from here
 		FileStream str;
@@ -4060,50 +4157,72 @@ static bool IsBlobSaveItem(const char *path) {
 	return areExt != nullptr && path + pathLength - 4 == areExt;
 }
 
-int Interface::CompressSave(const char *folder, bool overrideRunning)
+// reads a whole file from the cache, so it can be changed while it's being saved
+static DataStream* ReadIntoMemory(const char* path)
 {
-	FileStream str;
+	FileStream fs;
+	if (!fs.Open(path)) {
+		return nullptr;
+	}
 
-	str.Create(folder, GameNameResRef.CString(), IE_SAV_CLASS_ID);
+	strpos_t size = fs.Size();
+	void* buffer = malloc(size);
+	if (size && (!buffer || fs.Read(buffer, size) != strret_t(size))) {
+		free(buffer);
+		return nullptr;
+	}
+	return new MemoryStream(path, buffer, size);
+}
+
+int Interface::CompressSave(const char *folder, bool overrideRunning, SaveGameWriter::Snapshot areas)
+{
 	DirectoryIterator dir(config.CachePath);
 	if (!dir) {
 		return GEM_ERROR;
 	}
-	PluginHolder<ArchiveImporter> ai = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
-	ai->CreateArchive( &str);
 
 	tick_t startTime = GetMilliseconds();
-	// If we override the savegame we are running to fetch AREs from, it has already dumped
-	// itself as "ares.blb" into the cache folder. Otherwise, just copy directly.
-	if (!overrideRunning && saveGameAREExtractor.copyRetainedAREs(&str) == GEM_ERROR) {
-		Log(ERROR, "Interface", "Failed to copy ARE files into new save game.");
+	std::unique_ptr<FileStream> str(new FileStream());
+	if (!str->Create(folder, GameNameResRef.CString(), IE_SAV_CLASS_ID)) {
+		Log(ERROR, "Interface", "Failed to create the SAV file in \"{}\".", folder);
 		return GEM_ERROR;
 	}
+	PluginHolder<ArchiveImporter> ai = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
+	ai->CreateArchive(str.get());
 
+	// If we override the savegame we are running to fetch AREs from, it has already dumped
+	// itself as "ares.blb" into the cache folder. Otherwise, they are copied directly
+	// (by the writer, since that only reads from the running save).
+	SaveGameWriter::Snapshot snapshot;
 	dir.SetFlags(DirectoryIterator::Files);
 	//.tot and .toh should be saved last, because they are updated when an .are is saved
 	int priority=2;
 	while(priority) {
 		do {
 			const char *name = dir.GetName();
-			if (SavedExtension(name)==priority) {
-				char dtmp[_MAX_PATH];
-				dir.GetFullPath(dtmp);
-				FileStream fs;
-				if (!fs.Open(dtmp)) {
-					Log(ERROR, "Interface", "Failed to open \"{}\".", dtmp);
-				}
+			if (SavedExtension(name) != priority) continue;
 
-				if (IsBlobSaveItem(dtmp)) {
-					if (overrideRunning) {
-						saveGameAREExtractor.updateSaveGame(str.GetPos());
-						ai->AddToSaveGameCompressed(&str, &fs);
-					}
-				} else {
-					ai->AddToSaveGame(&str, &fs);
-				}
+			// the loaded areas were serialized anew, their cached copies are stale
+			auto fresh = std::find_if(areas.begin(), areas.end(), [name](const SaveGameWriter::Entry& area) {
+				return stricmp(area.stream->filename, name) == 0;
+			});
+			if (fresh != areas.end()) continue;
+
+			char dtmp[_MAX_PATH];
+			dir.GetFullPath(dtmp);
+			bool blob = IsBlobSaveItem(dtmp);
+			if (blob && !overrideRunning) continue;
+
+			DataStream* fs = ReadIntoMemory(dtmp);
+			if (!fs) {
+				Log(ERROR, "Interface", "Failed to open \"{}\".", dtmp);
+				continue;
 			}
+			snapshot.emplace_back(fs, blob);
 		} while (++dir);
+		if (priority == 2) {
+			std::move(areas.begin(), areas.end(), std::back_inserter(snapshot));
+		}
 		//reopen list for the second round
 		priority--;
 		if (priority>0) {
@@ -4112,7 +4231,8 @@ int Interface::CompressSave(const char *folder, bool overrideRunning)
 	}
 
 	tick_t endTime = GetMilliseconds();
-	Log(WARNING, "Core", "{} ms (compressing SAV file)", endTime - startTime);
+	Log(WARNING, "Core", "{} ms (save game snapshot)", endTime - startTime);
+	saveGameWriter.Write(std::move(str), std::move(snapshot), !overrideRunning, folder);
 	return GEM_OK;
 }
 
@@ -45,6 +45,7 @@
 #include "Timer.h"
 #include "Variables.h"
 #include "SaveGameAREExtractor.h"
+#include "SaveGameWriter.h"
 #include "StringMgr.h"
 #include "System/VFS.h"
 
@@ -339,11 +340,16 @@ struct CFGConfigData {
 	int MaxPartySize = 6;
 
 	bool KeepCache = false;
+	int FactoryCacheSize = 256; // MB of decoded animations and images, 0 for no limit
 	bool MultipleQuickSaves = false;
 	// once GemRB own format is working well, this might be set to 0
 	int SaveAsOriginal = 1; // if true, saves files in compatible mode
 	std::string VideoDriverName = "sdl"; // consider deprecating? It's now a hidden option
 	std::string AudioDriverName = "openal";
+
+	// benchmark mode: run this many game ticks of the save as fast as possible, then quit
+	std::string BenchmarkSave;
+	int BenchmarkTicks = 0;
 };
 
 /**
@@ -436,6 +442,7 @@ public:
 	int EventFlag = EF_CONTROL;
 	Holder<SaveGame> LoadGameIndex;
 	SaveGameAREExtractor saveGameAREExtractor;
+	SaveGameWriter saveGameWriter;
 	int VersionOverride = 0;
 	size_t SlotTypes = 0; // this is the same as the inventory size
 	ResRef GlobalScript = "BALDUR";
@@ -671,16 +678,16 @@ public:
 	int ApplyEffectQueue(EffectQueue *fxqueue, Actor *actor, Scriptable *caster) const;
 	int ApplyEffectQueue(EffectQueue *fxqueue, Actor *actor, Scriptable *caster, Point p) const;
 	Effect *GetEffect(const ResRef& resname, int level, const Point &p);
-	/** dumps an area object to the cache */
-	int SwapoutArea(Map *map) const;
+	/** dumps an area object to the cache, or into the snapshot of a save game */
+	int SwapoutArea(Map *map, SaveGameWriter::Snapshot* snapshot = nullptr) const;
 	/** saves (exports a character to the characters folder */
 	int WriteCharacter(StringView name, const Actor *actor);
 	/** saves the game object to the destination folder */
 	int WriteGame(const char *folder);
 	/** saves the worldmap object to the destination folder */
 	int WriteWorldMap(const char *folder);
-	/** saves the .are and .sto files to the destination folder */
-	int CompressSave(const char *folder, bool overrideRunning);
+	/** saves the .are and .sto files to the destination folder (in the background) */
+	int CompressSave(const char *folder, bool overrideRunning, SaveGameWriter::Snapshot areas);
 	/** toggles the pause. returns either PAUSE_ON or PAUSE_OFF to reflect the script state after toggling. */
 	PauseSetting TogglePause() const;
 	/** returns true the passed pause setting was applied. false otherwise. */
@@ -753,6 +760,8 @@ private:
 	void HandleEvents();
 	/** handles hardcoded gui behaviour */
 	void HandleGUIBehaviour(GameControl*);
+	/** Sets up loading and entering the benchmark save on a fixed clock */
+	bool StartBenchmark();
 	/** Creates a game control, closes all other windows */
 	GameControl* StartGameControl();
 	/** Executes everything (non graphical) in the main game loop */
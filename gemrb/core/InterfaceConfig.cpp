@@ -80,6 +80,14 @@ CFGConfig::CFGConfig(int argc, char *argv[])
 		} else if (stricmp(argv[i], "-q") == 0) {
 			// quiet mode
 			SetKeyValuePair("AudioDriver", "none");
+		} else if (stricmp(argv[i], "-b") == 0 && i + 2 < argc) {
+			// benchmark mode: load the save and run the given number of ticks headless
+			SetKeyValuePair("BenchmarkSave", argv[++i]);
+			SetKeyValuePair("BenchmarkTicks", argv[++i]);
+			SetKeyValuePair("AudioDriver", "none");
+			if (!GetValueForKey("VideoDriver")) {
+				SetKeyValuePair("VideoDriver", "none");
+			}
 		} else {
 			// assume a path was passed, soft force configless startup
 			SetKeyValuePair("GamePath", argv[i]);
@@ -851,6 +851,7 @@ bool Inventory::DropItemAtLocation(const ResRef& resRef, unsigned int flags, Map
 			return dropped;
 		}
 		Owner->BaseStats[IE_GOLD] = 0;
+		Owner->MarkStatsDirty();
 		CREItem *gold = new CREItem();
 		if (CreateItemCore(gold, core->GoldResRef, static_cast<int>(Owner->BaseStats[IE_GOLD]), 0, 0)) {
 			map->AddItemToLocation(loc, gold);
@@ -1227,6 +1228,8 @@ int Inventory::GetEquippedSlot() const
 bool Inventory::SetEquippedSlot(ieWordSigned slotcode, ieWord header, bool noFX)
 {
 	EquippedHeader = header;
+	// the weapon affects the attacks per round and the like
+	if (Owner) Owner->MarkStatsDirty();
 	
 	//doesn't work if magic slot is used, refresh the magic slot just in case
 	if (MagicSlotEquipped() && (slotcode!=SLOT_MAGIC-SLOT_MELEE)) {
@@ -1310,6 +1313,7 @@ void Inventory::SetEquipped(ieWordSigned slot, ieWord header)
 {
 	Equipped = slot;
 	EquippedHeader = header;
+	if (Owner) Owner->MarkStatsDirty();
 }
 
 bool Inventory::FistsEquipped() const
@@ -59,14 +59,14 @@
 
 namespace GemRB {
 
-static constexpr unsigned int MAX_CIRCLESIZE = 8;
-
 const PixelFormat TileProps::pixelFormat(0, 0, 0, 0,
 										 searchMapShift, materialMapShift,
 										 heightMapShift, lightMapShift,
 										 searchMapMask, materialMapMask,
 										 heightMapMask, lightMapMask,
 										 4, 32, 0, false, false, nullptr);
+// taken by reference in assign and fill
+constexpr uint8_t TileProps::clearanceNone;
 
 TileProps::TileProps(Holder<Sprite2D> props) noexcept
 : propImage(std::move(props))
@@ -138,6 +138,19 @@ Color TileProps::QueryLighting(const Point& p) const noexcept
 	return propImage->GetPalette()->col[val];
 }
 
+// extends the bounds of the pending changes to also cover p
+static void GrowBounds(bool& pending, Point& min, Point& max, const Point& p)
+{
+	if (pending) {
+		min = Point(std::min(min.x, p.x), std::min(min.y, p.y));
+		max = Point(std::max(max.x, p.x), std::max(max.y, p.y));
+	} else {
+		min = p;
+		max = p;
+		pending = true;
+	}
+}
+
 void TileProps::SetSearchMap(const Point& p, PathMapFlags value) const noexcept
 {
 	if (!size.PointInside(p)) {
@@ -145,7 +158,35 @@ void TileProps::SetSearchMap(const Point& p, PathMapFlags value) const noexcept
 	}
 	
 	uint32_t& pixel = propPtr[p.y * size.w + p.x];
+	PathMapFlags oldValue = static_cast<PathMapFlags>((pixel & searchMapMask) >> searchMapShift);
 	pixel = (pixel & ~searchMapMask) | (uint32_t(value) << propImage->Format().Rshift);
+
+	bool staticChange = (oldValue & PathMapFlags::NOTACTOR) != (value & PathMapFlags::NOTACTOR);
+	if (staticChange) {
+		GrowBounds(staticChanged, staticChangeMin, staticChangeMax, p);
+	}
+
+	if (clearance.empty()) return;
+	bool hadActor = bool(oldValue & PathMapFlags::ACTOR);
+	bool hasActor = bool(value & PathMapFlags::ACTOR);
+	if (hadActor != hasActor) {
+		int blocksPerRow = (size.w + actorBlockSize - 1) / actorBlockSize;
+		uint16_t& count = actorCells[(p.y / actorBlockSize) * blocksPerRow + p.x / actorBlockSize];
+		count += hasActor ? 1 : -1;
+	}
+	if (staticChange) {
+		// refreshed lazily, doors change many cells at once
+		GrowBounds(clearanceDirty, clearanceDirtyMin, clearanceDirtyMax, p);
+	}
+}
+
+bool TileProps::TakeStaticChanges(Point& min, Point& max) const noexcept
+{
+	if (!staticChanged) return false;
+	min = staticChangeMin;
+	max = staticChangeMax;
+	staticChanged = false;
+	return true;
 }
 
 // Valid values are - PathMapFlags::UNMARKED, PathMapFlags::PC, PathMapFlags::NPC
@@ -194,6 +235,186 @@ void TileProps::BlockSearchMap(const Point& Pos, unsigned int blocksize, PathMap
 	}
 }
 
+PathMapFlags TileProps::QueryStaticBlocked(const Point& p) const noexcept
+{
+	PathMapFlags ret = QuerySearchMap(p) & PathMapFlags::NOTACTOR;
+	if (bool(ret & PathMapFlags::DOOR_IMPASSABLE)) {
+		ret &= ~PathMapFlags::PASSABLE;
+	}
+	if (bool(ret & PathMapFlags::DOOR_OPAQUE)) {
+		ret = PathMapFlags::SIDEWALL;
+	}
+	return ret;
+}
+
+// the ClearanceKind bits describing a cell, anything outside the map is impassable
+uint8_t TileProps::ClearanceKinds(const Point& p) const noexcept
+{
+	PathMapFlags value = QueryStaticBlocked(p);
+	if (value == PathMapFlags::IMPASSABLE) {
+		return 1 << CK_IMPASSABLE;
+	}
+
+	uint8_t kinds = 0;
+	if (bool(value & PathMapFlags::PASSABLE)) kinds |= 1 << CK_PASSABLE;
+	if (bool(value & PathMapFlags::TRAVEL)) kinds |= 1 << CK_TRAVEL;
+	if (bool(value & PathMapFlags::NO_SEE)) kinds |= 1 << CK_NO_SEE;
+	if (bool(value & PathMapFlags::SIDEWALL)) kinds |= 1 << CK_SIDEWALL;
+	if (bool(value & PathMapFlags::DOOR_IMPASSABLE)) kinds |= 1 << CK_DOOR_IMPASSABLE;
+	return kinds;
+}
+
+void TileProps::BuildClearance() const
+{
+	clearance.assign(size.Area() * CK_COUNT, clearanceNone);
+	clearanceDirty = false;
+	RefreshClearance(Point(0, 0), Point(size.w - 1, size.h - 1));
+
+	int blocksPerRow = (size.w + actorBlockSize - 1) / actorBlockSize;
+	int blocksPerColumn = (size.h + actorBlockSize - 1) / actorBlockSize;
+	actorCells.assign(blocksPerRow * blocksPerColumn, 0);
+	for (int y = 0; y < size.h; y++) {
+		for (int x = 0; x < size.w; x++) {
+			if (bool(QuerySearchMap(Point(x, y)) & PathMapFlags::ACTOR)) {
+				actorCells[(y / actorBlockSize) * blocksPerRow + x / actorBlockSize]++;
+			}
+		}
+	}
+}
+
+void TileProps::UpdateClearance() const
+{
+	if (clearance.empty()) {
+		BuildClearance();
+	} else if (clearanceDirty) {
+		RefreshClearance(clearanceDirtyMin, clearanceDirtyMax);
+		clearanceDirty = false;
+	}
+}
+
+// recomputes the clearance of every cell that can reach the changed cells in [min, max]
+// first the distance to each kind along the rows, then the closest of those along the columns
+void TileProps::RefreshClearance(const Point& min, const Point& max) const
+{
+	constexpr int reach = clearanceReach;
+	int x0 = std::max(0, min.x - reach);
+	int x1 = std::min(size.w - 1, max.x + reach);
+	int y0 = std::max(0, min.y - reach);
+	int y1 = std::min(size.h - 1, max.y + reach);
+	int rowsY0 = y0 - reach;
+	int rowCount = y1 - y0 + 1 + 2 * reach;
+	int width = x1 - x0 + 1;
+
+	std::vector<uint8_t> kinds((width + 2 * reach) * rowCount);
+	for (int row = 0; row < rowCount; row++) {
+		for (int col = 0; col < width + 2 * reach; col++) {
+			kinds[row * (width + 2 * reach) + col] = ClearanceKinds(Point(x0 - reach + col, rowsY0 + row));
+		}
+	}
+
+	constexpr uint8_t far = reach + 1;
+	std::vector<uint8_t> rowDist(width * rowCount * CK_COUNT, far);
+	for (int row = 0; row < rowCount; row++) {
+		for (int col = 0; col < width; col++) {
+			uint8_t* dist = &rowDist[(row * width + col) * CK_COUNT];
+			for (int dx = -reach; dx <= reach; dx++) {
+				uint8_t cellKinds = kinds[row * (width + 2 * reach) + col + reach + dx];
+				for (int kind = 0; kind < CK_COUNT; kind++) {
+					if (cellKinds & (1 << kind)) {
+						dist[kind] = std::min<uint8_t>(dist[kind], std::abs(dx));
+					}
+				}
+			}
+		}
+	}
+
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			uint8_t* cell = &clearance[(y * size.w + x) * CK_COUNT];
+			std::fill(cell, cell + CK_COUNT, clearanceNone);
+			for (int dy = -reach; dy <= reach; dy++) {
+				const uint8_t* dist = &rowDist[((y - rowsY0 + dy) * width + x - x0) * CK_COUNT];
+				for (int kind = 0; kind < CK_COUNT; kind++) {
+					if (dist[kind] == far) continue;
+					uint8_t squared = dist[kind] * dist[kind] + dy * dy;
+					cell[kind] = std::min(cell[kind], squared);
+				}
+			}
+		}
+	}
+}
+
+// the slow way, also used near the top and left map edges, since navmap
+// coordinates just outside the map still resolve to the first column/row
+PathMapFlags TileProps::ScanStaticInRadius(const Point& p, unsigned int circleSize, bool stopOnImpassable) const noexcept
+{
+	auto edge = [](int v) { return v == -1 ? 0 : v; };
+	unsigned int r = (circleSize - 2) * (circleSize - 2) + 1;
+	if (circleSize == 2) r = 0;
+	PathMapFlags ret = PathMapFlags::IMPASSABLE;
+	for (int i = 0; i < int(circleSize - 1); i++) {
+		for (int j = 0; j < int(circleSize - 1); j++) {
+			if (unsigned(i * i + j * j) > r) continue;
+			const Point corners[] = {
+				Point(p.x + i, p.y + j), Point(p.x + i, edge(p.y - j)),
+				Point(edge(p.x - i), p.y + j), Point(edge(p.x - i), edge(p.y - j))
+			};
+			for (const Point& corner : corners) {
+				PathMapFlags blockStatus = QueryStaticBlocked(corner);
+				if (stopOnImpassable && blockStatus == PathMapFlags::IMPASSABLE) {
+					return PathMapFlags::IMPASSABLE;
+				}
+				ret |= blockStatus;
+			}
+		}
+	}
+	return ret;
+}
+
+PathMapFlags TileProps::QueryStaticInRadius(const Point& p, unsigned int circleSize, bool stopOnImpassable) const
+{
+	circleSize = Clamp<unsigned int>(circleSize, 2, MAX_CIRCLESIZE);
+	int reach = circleSize - 2;
+	if (!size.PointInside(p) || p.x < reach || p.y < reach) {
+		return ScanStaticInRadius(p, circleSize, stopOnImpassable);
+	}
+
+	UpdateClearance();
+
+	// the circle covers every offset with i^2 + j^2 <= r, see GetBlockedInRadius
+	unsigned int r = circleSize == 2 ? 0 : reach * reach + 1;
+	const uint8_t* cell = &clearance[(p.y * size.w + p.x) * CK_COUNT];
+	if (stopOnImpassable && cell[CK_IMPASSABLE] <= r) {
+		return PathMapFlags::IMPASSABLE;
+	}
+
+	PathMapFlags ret = PathMapFlags::IMPASSABLE;
+	if (cell[CK_PASSABLE] <= r) ret |= PathMapFlags::PASSABLE;
+	if (cell[CK_TRAVEL] <= r) ret |= PathMapFlags::TRAVEL;
+	if (cell[CK_NO_SEE] <= r) ret |= PathMapFlags::NO_SEE;
+	if (cell[CK_SIDEWALL] <= r) ret |= PathMapFlags::SIDEWALL;
+	if (cell[CK_DOOR_IMPASSABLE] <= r) ret |= PathMapFlags::DOOR_IMPASSABLE;
+	return ret;
+}
+
+bool TileProps::ActorsInReach(const Point& p, unsigned int circleSize) const
+{
+	UpdateClearance();
+
+	int reach = Clamp<unsigned int>(circleSize, 2, MAX_CIRCLESIZE) - 2;
+	int blocksPerRow = (size.w + actorBlockSize - 1) / actorBlockSize;
+	int bx0 = std::max(0, p.x - reach) / actorBlockSize;
+	int bx1 = std::min(size.w - 1, p.x + reach) / actorBlockSize;
+	int by0 = std::max(0, p.y - reach) / actorBlockSize;
+	int by1 = std::min(size.h - 1, p.y + reach) / actorBlockSize;
+	for (int by = by0; by <= by1; by++) {
+		for (int bx = bx0; bx <= bx1; bx++) {
+			if (actorCells[by * blocksPerRow + bx]) return true;
+		}
+	}
+	return false;
+}
+
 #define YESNO(x) ( (x)?"Yes":"No")
 
 struct Spawns {
@@ -405,6 +626,7 @@ reverb(*this)
 {
 	area = this;
 	MasterArea = core->GetGame()->MasterArea(scriptName);
+	actorGrid.Reset(GetSize());
 }
 
 Map::~Map(void)
@@ -454,6 +676,9 @@ Map::~Map(void)
 void Map::SetTileMapProps(TileProps props)
 {
 	tileProps = std::move(props);
+	pathHierarchy.Reset();
+	losCache.clear();
+	fogGeneration++;
 }
 
 void Map::AutoLockDoors() const
@@ -631,6 +856,8 @@ void Map::DrawPortal(const InfoPoint *ip, int enable)
 
 void Map::UpdateScripts()
 {
+	losCache.clear();
+
 	bool has_pcs = false;
 	for (const auto& actor : actors) {
 		if (actor->InParty) {
@@ -901,6 +1128,20 @@ void Map::ClearSearchMapFor(const Movable *actor) const
 	}
 }
 
+void Map::InvalidateSearchMap() const
+{
+	// once for the whole door, not per point
+	losCache.clear();
+	fogGeneration++;
+}
+
+void Map::UpdateActorIndex(const Actor *actor) const
+{
+	if (actor) {
+		actorGrid.Update(actor);
+	}
+}
+
 Size Map::FogMapSize() const
 {
 	// Ratio of bg tile size and fog tile size
@@ -1905,20 +2146,17 @@ void Map::DrawDebugOverlay(const Region &vp, uint32_t dFlags) const
 		// draw also pathfinding waypoints
 		const Actor *act = core->GetFirstSelectedActor();
 		if (!act) return;
-		const PathListNode *path = act->GetPath();
-		if (!path) return;
-		const PathListNode *step = path->Next;
+		const Path& path = act->GetPath();
+		if (path.empty()) return;
 		Color waypoint(0, 64, 128, 128); // darker blue-ish
-		int i = 0;
 		block.w = 8;
 		block.h = 6;
-		while (step) {
-			block.x = (step->point.x+64) - vp.x;
-			block.y = (step->point.y+6) - vp.y;
-			Log(DEBUG, "Map", "Waypoint {} at {}", i, step->point);
+		for (size_t i = 1; i < path.size(); i++) {
+			const PathNode& step = path[i];
+			block.x = (step.point.x+64) - vp.x;
+			block.y = (step.point.y+6) - vp.y;
+			Log(DEBUG, "Map", "Waypoint {} at {}", i - 1, step.point);
 			vid->DrawRect(block, waypoint);
-			step = step->Next;
-			i++;
 		}
 	}
 }
@@ -1942,6 +2180,22 @@ void Map::UpdateEffects()
 	}
 }
 
+void Map::CountRefresh(bool full)
+{
+	const Game* game = core->GetGame();
+	ieDword tick = game ? ieDword(game->GameTime) : 0;
+	if (tick != refreshCounts.tick) {
+		lastRefreshCounts = refreshCounts;
+		refreshCounts = RefreshCounts();
+		refreshCounts.tick = tick;
+	}
+	if (full) {
+		refreshCounts.full++;
+	} else {
+		refreshCounts.skipped++;
+	}
+}
+
 void Map::Shout(const Actor* actor, int shoutID, bool global) const
 {
 	for (auto listener : actors) {
@@ -2044,6 +2298,8 @@ void Map::InitActors()
 	while (i--) {
 		Actor *actor = actors[i];
 		actor->SetMap(this);
+		// moves made before the actor knew its area didn't reach the index
+		UpdateActorIndex(actor);
 		MarkVisited(actor);
 	}
 }
@@ -2065,6 +2321,7 @@ void Map::AddActor(Actor* actor, bool init)
 	actor->Area = scriptName;
 	if (!HasActor(actor)) {
 		actors.push_back( actor );
+		actorGrid.Insert(actor);
 	}
 	if (init) {
 		actor->SetMap(this);
@@ -2100,6 +2357,7 @@ void Map::DeleteActor(int i)
 		game->LeaveParty( actor );
 		//this frees up the spot under the feet circle
 		ClearSearchMapFor( actor );
+		actorGrid.Remove(actor);
 		//remove the area reference from the actor
 		actor->SetMap(NULL);
 		actor->Area.Reset();
@@ -2203,48 +2461,43 @@ Actor* Map::GetActorByGlobalID(ieDword objectID) const
 */
 Actor* Map::GetActor(const Point &p, int flags, const Movable *checker) const
 {
-	for (auto actor : actors) {
-		if (!actor->IsOver( p ))
-			continue;
-		if (!actor->ValidTarget(flags, checker) ) {
-			continue;
-		}
-		return actor;
-	}
-	return NULL;
+	// IsOver only looks at the extent of the ground circle
+	int csize = std::max(actorGrid.MaxCircleSize(), 2) - 1;
+	Region rgn(p - Point(csize * 16, csize * 12), Size(csize * 32 + 1, csize * 24 + 1));
+	return actorGrid.Query(rgn, [&](const Actor* actor) {
+		return actor->IsOver(p) && actor->ValidTarget(flags, checker);
+	});
 }
 
 Actor* Map::GetActorInRadius(const Point &p, int flags, unsigned int radius) const
 {
-	for (auto actor : actors) {
-		if (PersonalDistance( p, actor ) > radius)
-			continue;
-		if (!actor->ValidTarget(flags) ) {
-			continue;
-		}
-		return actor;
-	}
-	return NULL;
+	// PersonalDistance subtracts the circle size from the distance
+	int reach = int(radius) + actorGrid.MaxCircleSize() * 10 + 1;
+	return actorGrid.QueryRadius(p, reach, [&](const Actor* actor) {
+		return PersonalDistance(p, actor) <= radius && actor->ValidTarget(flags);
+	});
 }
 
 std::vector<Actor *> Map::GetAllActorsInRadius(const Point &p, int flags, unsigned int radius, const Scriptable *see) const
 {
 	std::vector<Actor *> neighbours;
-	for (auto actor : actors) {
+	// a foot is at most 16 pixels long
+	actorGrid.QueryRadius(p, int(radius) * 16 + 1, [&](Actor* actor) {
 		if (!WithinRange(actor, p, radius)) {
-			continue;
+			return false;
 		}
 		if (!actor->ValidTarget(flags, see) ) {
-			continue;
+			return false;
 		}
 		if (!(flags&GA_NO_LOS)) {
 			//line of sight visibility
 			if (!IsVisibleLOS(actor->Pos, p)) {
-				continue;
+				return false;
 			}
 		}
 		neighbours.emplace_back(actor);
-	}
+		return false;
+	});
 	return neighbours;
 }
 
@@ -2283,7 +2536,9 @@ void Map::JumpActors(bool jump) const
 		if (actor->Modified[IE_DONOTJUMP]&DNJ_JUMP) {
 			if (jump && !(actor->GetStat(IE_DONOTJUMP) & DNJ_BIRD)) {
 				ClearSearchMapFor(actor);
-				AdjustPositionNavmap(actor->Pos);
+				Point goal = actor->Pos;
+				AdjustPositionNavmap(goal);
+				actor->SetPos(goal);
 				actor->ImpedeBumping();
 			}
 			actor->SetBase(IE_DONOTJUMP,0);
@@ -2352,7 +2607,7 @@ void Map::PurgeArea(bool items)
 		if (actor->GetStat(IE_MC_FLAGS) & MC_IGNORE_RETURN) continue;
 		if (!actor->ValidTarget(GA_NO_DEAD|GA_NO_UNSCHEDULED|GA_NO_ALLY|GA_NO_ENEMY)) continue;
 		if (!actor->HomeLocation.IsZero() && !actor->HomeLocation.IsInvalid() && actor->Pos != actor->HomeLocation) {
-			actor->Pos = actor->HomeLocation;
+			actor->SetPos(actor->HomeLocation);
 		}
 	}
 }
@@ -2473,16 +2728,23 @@ Actor *Map::GetActorByScriptName(const ieVariable& name) const
 std::vector<Actor*> Map::GetActorsInRect(const Region& rgn, int excludeFlags) const
 {
 	std::vector<Actor*> actorlist;
-	actorlist.reserve(actors.size());
-	for (auto actor : actors) {
+	// IsOver also matches actors whose circle covers the origin
+	int csize = std::max(actorGrid.MaxCircleSize(), 2) - 1;
+	Region search = rgn;
+	search.x = std::min(search.x, rgn.x - csize * 16);
+	search.y = std::min(search.y, rgn.y - csize * 12);
+	search.w = std::max(rgn.x + rgn.w, rgn.x + csize * 16 + 1) - search.x;
+	search.h = std::max(rgn.y + rgn.h, rgn.y + csize * 12 + 1) - search.y;
+	actorGrid.Query(search, [&](Actor* actor) {
 		if (!actor->ValidTarget(excludeFlags))
-			continue;
+			return false;
 		if (!rgn.PointInside(actor->Pos)
 			&& !actor->IsOver(rgn.origin)) // imagine drawing a tiny box inside the circle, but not over the center
-			continue;
+			return false;
 
 		actorlist.push_back(actor);
-	}
+		return false;
+	});
 	
 	return actorlist;
 }
@@ -2554,7 +2816,12 @@ PathMapFlags Map::GetBlocked(const Point &p, int size) const
 // If they shouldn't be, the caller should check for PathMapFlags::PASSABLE | PathMapFlags::ACTOR
 PathMapFlags Map::GetBlocked(const Point &p) const
 {
-	PathMapFlags ret = tileProps.QuerySearchMap(ConvertCoordToTile(p));
+	return GetBlockedTile(ConvertCoordToTile(p));
+}
+
+PathMapFlags Map::GetBlockedTile(const SearchmapPoint &p) const
+{
+	PathMapFlags ret = tileProps.QuerySearchMap(p);
 	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR))) {
 		ret &= ~PathMapFlags::PASSABLE;
 	}
@@ -2575,6 +2842,17 @@ PathMapFlags Map::GetBlockedInRadius(const Point &p, unsigned int size, bool sto
 	if (size < 2) size = 2;
 	PathMapFlags ret = PathMapFlags::IMPASSABLE;
 
+	// Most circles are nowhere near an actor, so the clearance layer has the whole answer
+	Point center = ConvertCoordToTile(p);
+	int reach = size - 2;
+	if (p.x >= 0 && p.y >= 0 && center.x >= reach && center.y >= reach && tileProps.GetSize().PointInside(center) && !tileProps.ActorsInReach(center, size)) {
+		ret = tileProps.QueryStaticInRadius(center, size, stopOnImpassable);
+		if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::SIDEWALL))) {
+			ret &= ~PathMapFlags::PASSABLE;
+		}
+		return ret;
+	}
+
 	unsigned int r = (size - 2) * (size - 2) + 1;
 	if (size == 2) r = 0;
 	for (unsigned int i = 0; i < size - 1; i++) {
@@ -2603,22 +2881,48 @@ PathMapFlags Map::GetBlockedInRadius(const Point &p, unsigned int size, bool sto
 	return ret;
 }
 
-PathMapFlags Map::GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable, const Actor *caller) const
+// Visits every searchmap cell the segment crosses, in order, stepping
+// into whichever neighbour the line reaches first
+PathMapFlags Map::GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable) const
 {
 	PathMapFlags ret = PathMapFlags::IMPASSABLE;
-	Point p = s;
-	while (p != d) {
-		double dx = d.x - p.x;
-		double dy = d.y - p.y;
-		double factor = caller && caller->GetSpeed() ? double(gamedata->GetStepTime()) / double(caller->GetSpeed()) : 1;
-		NormalizeDeltas(dx, dy, factor);
-		p.x += dx;
-		p.y += dy;
-		PathMapFlags blockStatus = GetBlocked(p);
-		if (stopOnImpassable && blockStatus == PathMapFlags::IMPASSABLE) {
+	if (s == d) {
+		return ret;
+	}
+
+	const SearchmapPoint start = ConvertCoordToTile(s);
+	const SearchmapPoint goal = ConvertCoordToTile(d);
+	SearchmapPoint cell = start;
+	const int stepX = d.x > s.x ? 1 : -1;
+	const int stepY = d.y > s.y ? 1 : -1;
+	const long lenX = std::abs(d.x - s.x);
+	const long lenY = std::abs(d.y - s.y);
+	while (true) {
+		PathMapFlags blockStatus = GetBlockedTile(cell);
+		// an actor pushed or teleported onto an impassable cell must still be able to leave it
+		if (stopOnImpassable && blockStatus == PathMapFlags::IMPASSABLE && cell != start) {
 			return PathMapFlags::IMPASSABLE;
 		}
 		ret |= blockStatus;
+		if (cell == goal) {
+			break;
+		}
+
+		bool moveX = cell.x != goal.x;
+		bool moveY = cell.y != goal.y;
+		if (moveX && moveY) {
+			// compare the distances to the next column and row boundary as fractions of the line;
+			// a boundary crossed backwards is only left just after it is reached, so it loses ties
+			long toX = stepX > 0 ? (cell.x + 1) * 16 - s.x : s.x - cell.x * 16;
+			long toY = stepY > 0 ? (cell.y + 1) * 12 - s.y : s.y - cell.y * 12;
+			long crossX = toX * lenY;
+			long crossY = toY * lenX;
+			bool tie = crossX == crossY;
+			moveX = crossX < crossY || (tie && (stepX == stepY || stepX > 0));
+			moveY = crossY < crossX || (tie && (stepX == stepY || stepY > 0));
+		}
+		if (moveX) cell.x += stepX;
+		if (moveY) cell.y += stepY;
 	}
 	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE|PathMapFlags::ACTOR|PathMapFlags::SIDEWALL))) {
 		ret &= ~PathMapFlags::PASSABLE;
@@ -2631,16 +2935,38 @@ PathMapFlags Map::GetBlockedInLine(const Point &s, const Point &d, bool stopOnIm
 }
 
 // PathMapFlags::SIDEWALL obstructs LOS, while PathMapFlags::IMPASSABLE doesn't
-bool Map::IsVisibleLOS(const Point &s, const Point &d, const Actor *caller) const
+// Actors don't affect it, so the answer is kept for the rest of the tick (or until
+// a door changes the searchmap). The line is always traced from the smaller point,
+// so seeing is mutual even where it grazes a corner
+bool Map::IsVisibleLOS(const Point &s, const Point &d) const
 {
-	PathMapFlags ret = GetBlockedInLine(s, d, false, caller);
-	return !bool(ret & PathMapFlags::SIDEWALL);
+	if (s == d) {
+		return true;
+	}
+
+	bool swap = s.y > d.y || (s.y == d.y && s.x > d.x);
+	const Point& from = swap ? d : s;
+	const Point& to = swap ? s : d;
+	uint64_t key = uint64_t(uint16_t(from.x)) << 48 | uint64_t(uint16_t(from.y)) << 32 | uint64_t(uint16_t(to.x)) << 16 | uint16_t(to.y);
+	auto cached = losCache.find(key);
+	if (cached != losCache.end()) {
+		return cached->second;
+	}
+
+	bool visible = !bool(GetBlockedInLine(from, to, false) & PathMapFlags::SIDEWALL);
+
+	// busy areas shouldn't grow it without bounds within a tick
+	if (losCache.size() >= 8192) {
+		losCache.clear();
+	}
+	losCache.emplace(key, visible);
+	return visible;
 }
 
 // Used by the pathfinder, so PathMapFlags::IMPASSABLE obstructs walkability
-bool Map::IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking, const Actor *caller) const
+bool Map::IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking) const
 {
-	PathMapFlags ret = GetBlockedInLine(s, d, true, caller);
+	PathMapFlags ret = GetBlockedInLine(s, d, true);
 	PathMapFlags mask = PathMapFlags::PASSABLE | PathMapFlags::TRAVEL | (actorsAreBlocking ? PathMapFlags::UNMARKED : PathMapFlags::ACTOR);
 	return bool(ret & mask);
 }
@@ -2900,6 +3226,7 @@ void Map::RemoveActor(Actor* actor)
 			//path is invalid outside this area, but actions may be valid
 			actor->ClearPath(true);
 			ClearSearchMapFor(actor);
+			actorGrid.Remove(actor);
 			actor->SetMap(NULL);
 			actor->Area.Reset();
 			actors.erase( actors.begin()+i );
@@ -2958,6 +3285,7 @@ std::string Map::dump(bool show_actors) const
 	AppendFormat(buffer, "Weather: {}\n", YESNO(AreaType & AT_WEATHER ) );
 	AppendFormat(buffer, "Area Type: {}\n", AreaType & (AT_CITY|AT_FOREST|AT_DUNGEON) );
 	AppendFormat(buffer, "Can rest: {}\n", YESNO(core->GetGame()->CanPartyRest(REST_AREA)));
+	AppendFormat(buffer, "Stat refreshes last tick: {} full, {} skipped\n", lastRefreshCounts.full, lastRefreshCounts.skipped);
 
 	if (show_actors) {
 		buffer.append("\n");
@@ -3129,6 +3457,27 @@ void Map::SetupAmbients() const
 	ambim->SetAmbients(ambients);
 }
 
+void Map::PreloadSounds() const
+{
+	std::vector<ResRef> sounds;
+	for (const Ambient *ambient : ambients) {
+		sounds.insert(sounds.end(), ambient->sounds.begin(), ambient->sounds.end());
+	}
+	// the battle cries, attack, damage and death sounds of everyone who isn't using a soundset
+	for (const Actor *actor : actors) {
+		if (actor->PCStats && !actor->PCStats->SoundSet.IsEmpty()) continue;
+		for (int vc = VB_ATTACK; vc <= VB_DIE; vc++) {
+			ieStrRef strref = actor->GetVerbalConstant(vc);
+			if (strref == ieStrRef::INVALID) continue;
+			StringBlock sb = core->strings->GetStringBlock(strref);
+			if (!sb.Sound.IsEmpty()) {
+				sounds.push_back(sb.Sound);
+			}
+		}
+	}
+	core->GetAudioDrv()->Preload(sounds);
+}
+
 ieWord Map::GetAmbientCount(bool toSave) const
 {
 	if (!toSave) return static_cast<ieWord>(ambients.size());
@@ -3364,6 +3713,7 @@ Size Map::GetSize() const
 void Map::FillExplored(bool explored)
 {
 	ExploredBitmap.fill(explored ? 0xff : 0x00);
+	fogStale = true;
 }
 
 void Map::ExploreTile(const Point &p, bool fogOnly)
@@ -3378,13 +3728,29 @@ void Map::ExploreTile(const Point &p, bool fogOnly)
 	ExploredBitmap[fogP] = true;
 	if (!fogOnly) {
 		VisibleBitmap[fogP] = true;
+		fogStale = true;
 	}
 }
 
 void Map::ExploreMapChunk(const Point &Pos, int range, int los)
+{
+	std::vector<uint32_t> cells;
+	TraceVisibility(Pos, range, los, cells);
+	for (uint32_t cell : cells) {
+		ExploredBitmap[cell & ~FOG_VISIBLE] = true;
+		if (cell & FOG_VISIBLE) {
+			VisibleBitmap[cell & ~FOG_VISIBLE] = true;
+			fogStale = true;
+		}
+	}
+}
+
+// collects the fog cells the rays from Pos reach; they may repeat
+void Map::TraceVisibility(const Point &Pos, int range, int los, std::vector<uint32_t> &cells) const
 {
 	Point Tile;
 	const Explore& explore = Explore::Get();
+	const Size fogSize = FogMapSize();
 
 	if (range > explore.MaxVisibility) {
 		range = explore.MaxVisibility;
@@ -3419,15 +3785,22 @@ void Map::ExploreMapChunk(const Point &Pos, int range, int los)
 					if (!Pass) break;
 				}
 			}
-			ExploreTile(Tile, fogOnly);
+			Point fogP = ConvertPointToFog(Tile);
+			if (!fogSize.PointInside(fogP)) {
+				continue;
+			}
+			uint32_t cell = fogP.y * fogSize.w + fogP.x;
+			cells.push_back(fogOnly ? cell : cell | FOG_VISIBLE);
 		}
 	}
 }
 
 void Map::UpdateFog()
 {
-	VisibleBitmap.fill(0);
-	
+	const Explore& explore = Explore::Get();
+	bool recompose = fogStale;
+	fogUpdates++;
+
 	std::set<Spawn*> potentialSpawns;
 	for (const auto actor : actors) {
 		if (!actor->Modified[IE_EXPLORE]) continue;
@@ -3437,13 +3810,54 @@ void Map::UpdateFog()
 		
 		int vis2 = actor->Modified[IE_VISUALRANGE];
 		if ((state&STATE_BLIND) || (vis2<2)) vis2=2; //can see only themselves
-		ExploreMapChunk (actor->Pos, vis2+actor->GetAnims()->GetCircleSize(), 1);
+		int range = std::min(vis2 + actor->GetAnims()->GetCircleSize(), int(explore.MaxVisibility));
+
+		FogFootprint& footprint = fogFootprints[actor];
+		footprint.updated = fogUpdates;
+		if (footprint.range != range || footprint.pos != actor->Pos || footprint.generation != fogGeneration) {
+			footprint.range = range;
+			footprint.pos = actor->Pos;
+			footprint.generation = fogGeneration;
+			footprint.cells.clear();
+			TraceVisibility(actor->Pos, range, 1, footprint.cells);
+			// drop the repeats, keeping a cell visible if any ray saw it so
+			std::sort(footprint.cells.begin(), footprint.cells.end(), [](uint32_t a, uint32_t b) {
+				return (a & ~FOG_VISIBLE) < (b & ~FOG_VISIBLE) || ((a & ~FOG_VISIBLE) == (b & ~FOG_VISIBLE) && a > b);
+			});
+			footprint.cells.erase(std::unique(footprint.cells.begin(), footprint.cells.end(), [](uint32_t a, uint32_t b) {
+				return (a & ~FOG_VISIBLE) == (b & ~FOG_VISIBLE);
+			}), footprint.cells.end());
+			recompose = true;
+		}
 		
 		Spawn *sp = GetSpawnRadius(actor->Pos, SPAWN_RANGE); //30 * 12
 		if (sp) {
 			potentialSpawns.insert(sp);
 		}
 	}
+
+	// forget actors that stopped exploring (or left)
+	for (auto it = fogFootprints.begin(); it != fogFootprints.end();) {
+		if (it->second.updated != fogUpdates) {
+			it = fogFootprints.erase(it);
+			recompose = true;
+		} else {
+			++it;
+		}
+	}
+
+	if (recompose) {
+		VisibleBitmap.fill(0);
+		for (const auto& footprint : fogFootprints) {
+			for (uint32_t cell : footprint.second.cells) {
+				ExploredBitmap[cell & ~FOG_VISIBLE] = true;
+				if (cell & FOG_VISIBLE) {
+					VisibleBitmap[cell & ~FOG_VISIBLE] = true;
+				}
+			}
+		}
+		fogStale = false;
+	}
 	
 	for (Spawn* spawn : potentialSpawns) {
 		TriggerSpawn(spawn);
@@ -3580,7 +3994,7 @@ Container *Map::GetPile(Point position)
 	Container *container = TMap->GetContainer(position,IE_CONTAINER_PILE);
 	if (!container) {
 		container = AddContainer(pileName, IE_CONTAINER_PILE, nullptr);
-		container->Pos=position;
+		container->SetPos(position);
 		//bounding box covers the search square
 		container->BBox = Region::RegionFromPoints(Point(position.x-8, position.y-6), Point(position.x+8,position.y+6));
 	}
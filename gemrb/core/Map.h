@@ -24,6 +24,7 @@
 #include "exports.h"
 #include "globals.h"
 
+#include "ActorGrid.h"
 #include "Bitmap.h"
 #include "Interface.h"
 #include "MapReverb.h"
@@ -35,8 +36,6 @@
 #include <queue>
 #include <unordered_map>
 
-template <class V> class FibonacciHeap;
-
 namespace GemRB {
 
 class Actor;
@@ -49,7 +48,6 @@ class IniSpawn;
 class Palette;
 using PaletteHolder = Holder<Palette>;
 class Particles;
-struct PathListNode;
 class Projectile;
 class ScriptedAnimation;
 class TileMap;
@@ -359,6 +357,33 @@ class GEM_EXPORT TileProps {
 	static constexpr uint32_t heightMapShift = 8;
 	static constexpr uint32_t lightMapShift = 0;
 
+	// Clearance layer: for every cell and kind of static searchmap value, the squared
+	// distance to the nearest cell of that kind, if any is within reach of the biggest
+	// creature circle. This answers what a circle touches without scanning it.
+	// Actors change the searchmap all the time, so they are only tracked
+	// by block, to tell whether a circle can skip looking for them.
+	enum ClearanceKind : uint8_t {
+		CK_IMPASSABLE, CK_PASSABLE, CK_TRAVEL, CK_NO_SEE, CK_SIDEWALL, CK_DOOR_IMPASSABLE, CK_COUNT
+	};
+	static constexpr int clearanceReach = MAX_CIRCLESIZE - 2;
+	static constexpr uint8_t clearanceNone = 0xff;
+	static constexpr int actorBlockSize = 8;
+	mutable std::vector<uint8_t> clearance; // CK_COUNT entries per cell
+	mutable Point clearanceDirtyMin;
+	mutable Point clearanceDirtyMax;
+	mutable bool clearanceDirty = false;
+	mutable std::vector<uint16_t> actorCells; // actor marked cells per block
+	// static changes not yet picked up by the pathfinder's searchmap layers
+	mutable Point staticChangeMin;
+	mutable Point staticChangeMax;
+	mutable bool staticChanged = false;
+
+	uint8_t ClearanceKinds(const Point& p) const noexcept;
+	void BuildClearance() const;
+	void UpdateClearance() const;
+	void RefreshClearance(const Point& min, const Point& max) const;
+	PathMapFlags ScanStaticInRadius(const Point& p, unsigned int size, bool stopOnImpassable) const noexcept;
+
 public:
 	static const PixelFormat pixelFormat;
 	
@@ -386,6 +411,16 @@ public:
 	
 	void SetSearchMap(const Point&, PathMapFlags value) const noexcept;
 	void BlockSearchMap(const Point& Pos, unsigned int blocksize, PathMapFlags value) const noexcept;
+
+	// the searchmap value of a cell as Map::GetBlocked sees it, but ignoring actors
+	PathMapFlags QueryStaticBlocked(const Point& p) const noexcept;
+	// what a creature circle centred on the cell touches, ignoring actors: the union of the
+	// static values, or IMPASSABLE if stopOnImpassable is set and it touches an impassable cell
+	PathMapFlags QueryStaticInRadius(const Point& p, unsigned int size, bool stopOnImpassable = true) const;
+	// false if no actor is marked on the searchmap within the circle's reach
+	bool ActorsInReach(const Point& p, unsigned int size) const;
+	// the bounds of the static searchmap changes since the last call, false if there were none
+	bool TakeStaticChanges(Point& min, Point& max) const noexcept;
 };
 
 class GEM_EXPORT Map : public Scriptable {
@@ -440,6 +475,39 @@ private:
 
 	std::unordered_map<const void*, std::pair<VideoBufferPtr, Region>> objectStencils;
 
+	// reused by every FindPath call on this map
+	mutable PathFinderWorkspace pathWorkspace;
+	mutable PathFinderHierarchy pathHierarchy;
+	// spatial index of actors, for the point, radius and rect lookups
+	mutable ActorGrid actorGrid;
+	// IsVisibleLOS results of this tick, keyed by the ordered point pair
+	mutable std::unordered_map<uint64_t, bool> losCache;
+
+	// what an exploring actor saw last time, so UpdateFog only traces rays after changes
+	struct FogFootprint {
+		Point pos;
+		int range = 0;
+		uint32_t generation = 0;
+		ieDword updated = 0;
+		// fog cell indices, the top bit marks the ones that also become visible
+		std::vector<uint32_t> cells;
+	};
+	static constexpr uint32_t FOG_VISIBLE = 0x80000000;
+	std::unordered_map<const Actor*, FogFootprint> fogFootprints;
+	ieDword fogUpdates = 0;
+	// bumped by searchmap changes, which may open or close lines of sight
+	mutable uint32_t fogGeneration = 0;
+	// set when VisibleBitmap was touched outside of the footprints
+	bool fogStale = true;
+	// actor stat refreshes, full rebuilds and skipped ones, of the current and the last tick
+	struct RefreshCounts {
+		ieDword tick = 0;
+		unsigned int full = 0;
+		unsigned int skipped = 0;
+	};
+	RefreshCounts refreshCounts;
+	RefreshCounts lastRefreshCounts;
+
 public:
 	Map(TileMap *tm, TileProps tileProps, Holder<Sprite2D> sm);
 	~Map(void) override;
@@ -459,6 +527,8 @@ public:
 	ResRef ResolveTerrainSound(const ResRef &sound, const Point &pos) const;
 	void DoStepForActor(Actor *actor, ieDword time) const;
 	void UpdateEffects();
+	/** Called by the actors for each of their stat refreshes */
+	void CountRefresh(bool full);
 	/* removes empty heaps and returns total itemcount */
 	int ConsolidateContainers();
 	/* transfers all ever visible piles (loose items) to the specified position */
@@ -520,6 +590,13 @@ public:
 	std::vector<Actor *> GetAllActorsInRadius(const Point &p, int flags, unsigned int radius, const Scriptable *see = NULL) const;
 	const std::vector<Actor *> &GetAllActors() const { return actors; }
 	std::vector<Actor*> GetActorsInRect(const Region& rgn, int excludeFlags) const;
+	/* calls fn for the actors that may stand in rgn, in area order, until it returns true;
+	 * callers still need to check the positions */
+	template <typename F>
+	Actor* QueryActorsNear(const Region& rgn, F&& fn, bool reverse = false) const
+	{
+		return actorGrid.Query(rgn, std::forward<F>(fn), reverse);
+	}
 	Actor* GetActor(const ieVariable& Name, int flags) const;
 	Actor* GetActor(int i, bool any) const;
 	Actor* GetActor(const Point &p, int flags, const Movable *checker = NULL) const;
@@ -589,6 +666,10 @@ public:
 	void ExploreMapChunk(const Point &Pos, int range, int los);
 	void BlockSearchMapFor(const Movable *actor) const;
 	void ClearSearchMapFor(const Movable *actor) const;
+	/* call after changing the static (non-actor) part of the searchmap, so sight gets redone */
+	void InvalidateSearchMap() const;
+	/* call after moving an actor, so the area lookups find it at its new position */
+	void UpdateActorIndex(const Actor *actor) const;
 	/* update VisibleBitmap by resolving vision of all explore actors */
 	void UpdateFog();
 	//PathFinder
@@ -596,25 +677,22 @@ public:
 	void AdjustPosition(Point &goal, int radiusx = 0, int radiusy = 0, int size = -1) const;
 	void AdjustPositionNavmap(Point &goal, int radiusx = 0, int radiusy = 0) const;
 	/* Finds the path which leads the farthest from d */
-	PathListNode* RunAway(const Point &s, const Point &d, unsigned int size, int maxPathLength, bool backAway, const Actor *caller) const;
-	PathListNode* RandomWalk(const Point &s, int size, int radius, const Actor *caller) const;
+	Path RunAway(const Point &s, const Point &d, unsigned int size, int maxPathLength, bool backAway, const Actor *caller) const;
+	Path RandomWalk(const Point &s, int size, int radius, const Actor *caller) const;
 	/* Returns true if there is no path to d */
 	bool TargetUnreachable(const Point &s, const Point &d, unsigned int size, bool actorsAreBlocking = false) const;
 	/* returns true if there is enemy visible */
 	bool AnyPCSeesEnemy() const;
 	/* Finds straight path from s, length l and orientation o, f=1 passes wall, f=2 rebounds from wall*/
-	PathListNode* GetLine(const Point &start, const Point &dest, int flags) const;
-	PathListNode* GetLine(const Point &start, int steps, orient_t orient) const;
-	PathListNode* GetLine(const Point &start, int Steps, orient_t Orientation, int flags) const;
-	PathListNode* GetLine(const Point &start, const Point &dest, int speed, orient_t Orientation, int flags) const;
+	Path GetLine(const Point &start, int steps, orient_t orient) const;
 	Path GetLinePath(const Point &start, const Point &dest, int speed, orient_t Orientation, int flags) const;
 	/* Finds the path which leads to near d */
-	PathListNode* FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance = 0, int flags = PF_SIGHT, const Actor *caller = NULL) const;
+	Path FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance = 0, int flags = PF_SIGHT, const Actor *caller = NULL) const;
 
 	bool IsVisible(const Point &p) const;
 	bool IsExplored(const Point &p) const;
-	bool IsVisibleLOS(const Point &s, const Point &d, const Actor *caller = NULL) const;
-	bool IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking, const Actor *caller) const;
+	bool IsVisibleLOS(const Point &s, const Point &d) const;
+	bool IsWalkableTo(const Point &s, const Point &d, bool actorsAreBlocking) const;
 
 	/* returns edge direction of map boundary, only worldmap regions */
 	WMPDirection WhichEdge(const Point &s) const;
@@ -622,6 +700,8 @@ public:
 	//ambients
 	void AddAmbient(Ambient *ambient) { ambients.push_back(ambient); }
 	void SetupAmbients() const;
+	/* start decoding the sounds the area is likely to play soon */
+	void PreloadSounds() const;
 	Ambient *GetAmbient(int i) const { return ambients[i]; }
 	ieWord GetAmbientCount(bool toSave = false) const;
 
@@ -702,7 +782,10 @@ private:
 	bool AdjustPositionY(Point &goal, int radiusx, int radiusy, int size = -1) const;
 	
 	void UpdateSpawns() const;
-	PathMapFlags GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable, const Actor *caller = NULL) const;
+	void TraceVisibility(const Point &Pos, int range, int los, std::vector<uint32_t> &cells) const;
+	PathMapFlags GetBlockedTile(const SearchmapPoint &p) const;
+	PathMapFlags GetBlockedInLine(const Point &s, const Point &d, bool stopOnImpassable) const;
+	Path SearchPath(const NavmapPoint &s, NavmapPoint d, const Point &goal, unsigned int size, unsigned int minDistance, int flags, const Actor *caller, bool useCorridor) const;
 	void AddProjectile(Projectile* pro);
 
 };
@@ -28,6 +28,9 @@
 #define MAPMGR_H
 
 #include "Plugin.h"
+#include "ResourcePrefetcher.h"
+
+#include <vector>
 
 namespace GemRB {
 
@@ -42,6 +45,8 @@ class GEM_EXPORT MapMgr : public ImporterBase {
 public:
 	virtual bool ChangeMap(Map *map, bool day_or_night) = 0;
 	virtual Map* GetMap(const ResRef& ResRef, bool day_or_night) = 0;
+	/** Lists the resources GetMap is going to load, so they can be prefetched */
+	virtual std::vector<PrefetchRequest> GetDependencies(bool /*day_or_night*/) { return {}; }
 
 	virtual int GetStoredFileSize(Map *map) = 0;
 	virtual int PutArea(DataStream* stream, const Map *map) const = 0;
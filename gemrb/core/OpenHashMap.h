@@ -0,0 +1,188 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef OPENHASHMAP_H
+#define OPENHASHMAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+// Open addressing hash table with linear probing, for the hot string keyed
+// lookups (game variables, resource caches). The slots are kept in one
+// array together with the full hash of their key, so probing mostly
+// compares integers and growing doesn't need to rehash the keys.
+//
+// HASH and EQUAL may be templated to allow lookups with other key types
+// (eg. a StringView for a std::string key); a key is hashed only once per
+// operation and the hash can be passed along to do several operations.
+//
+// Positions are plain slot indices: they stay valid until the next Erase
+// or growth, both of which bump Generation().
+template <typename KEY, typename VALUE, typename HASH, typename EQUAL>
+class OpenHashMap {
+public:
+	using hash_t = uint32_t;
+	static constexpr size_t npos = size_t(-1);
+
+	struct Slot {
+		hash_t hash = 0; // 0 marks an empty slot
+		KEY key {};
+		VALUE value {};
+	};
+
+	explicit OpenHashMap(HASH hash = HASH(), EQUAL eq = EQUAL())
+	: hasher(std::move(hash)), equal(std::move(eq))
+	{}
+
+	size_t Size() const { return count; }
+	bool IsEmpty() const { return count == 0; }
+	size_t Capacity() const { return slots.size(); }
+	unsigned long Generation() const { return generation; }
+
+	template <typename K>
+	hash_t Hash(const K& key) const
+	{
+		size_t h = hasher(key);
+		hash_t folded = hash_t(h ^ (uint64_t(h) >> 32));
+		return folded ? folded : 1;
+	}
+
+	template <typename K>
+	size_t Find(const K& key, hash_t hash) const
+	{
+		if (count == 0) return npos;
+		for (size_t idx = Home(hash); ; idx = (idx + 1) & mask) {
+			const Slot& slot = slots[idx];
+			if (slot.hash == 0) return npos;
+			if (slot.hash == hash && equal(slot.key, key)) return idx;
+		}
+	}
+
+	template <typename K>
+	size_t Find(const K& key) const
+	{
+		return Find(key, Hash(key));
+	}
+
+	// the key must not be present yet
+	size_t Insert(KEY key, VALUE value, hash_t hash)
+	{
+		if ((count + 1) * 4 > slots.size() * 3) {
+			Grow();
+		}
+		size_t idx = Home(hash);
+		while (slots[idx].hash) {
+			idx = (idx + 1) & mask;
+		}
+		Slot& slot = slots[idx];
+		slot.hash = hash;
+		slot.key = std::move(key);
+		slot.value = std::move(value);
+		++count;
+		return idx;
+	}
+
+	// backward shift deletion, so lookups never have to skip tombstones
+	void Erase(size_t idx)
+	{
+		assert(idx < slots.size() && slots[idx].hash);
+		size_t hole = idx;
+		for (size_t next = (hole + 1) & mask; slots[next].hash; next = (next + 1) & mask) {
+			size_t home = Home(slots[next].hash);
+			// only move entries whose home isn't cyclically in (hole, next]
+			if (((next - home) & mask) >= ((next - hole) & mask)) {
+				slots[hole] = std::move(slots[next]);
+				hole = next;
+			}
+		}
+		slots[hole] = Slot();
+		--count;
+		++generation;
+	}
+
+	void Clear()
+	{
+		slots.clear();
+		slots.shrink_to_fit();
+		mask = 0;
+		shift = 32;
+		count = 0;
+		++generation;
+	}
+
+	// iteration: Next(npos) is the first occupied position, npos ends it
+	size_t Next(size_t pos) const
+	{
+		for (size_t idx = pos + 1; idx < slots.size(); ++idx) {
+			if (slots[idx].hash) return idx;
+		}
+		return npos;
+	}
+
+	Slot& operator[](size_t idx) { return slots[idx]; }
+	const Slot& operator[](size_t idx) const { return slots[idx]; }
+
+private:
+	std::vector<Slot> slots;
+	size_t mask = 0;
+	unsigned int shift = 32;
+	size_t count = 0;
+	unsigned long generation = 0;
+	HASH hasher;
+	EQUAL equal;
+
+	// fibonacci hashing spreads the weak low bits of the string hashes
+	size_t Home(hash_t hash) const
+	{
+		return size_t((hash * 2654435769U) >> shift) & mask;
+	}
+
+	void Grow()
+	{
+		size_t size = slots.empty() ? 16 : slots.size() * 2;
+		std::vector<Slot> old(size);
+		std::swap(old, slots);
+		mask = size - 1;
+		shift = 32;
+		while (size > 1) {
+			size >>= 1;
+			--shift;
+		}
+		++generation;
+
+		for (Slot& slot : old) {
+			if (!slot.hash) continue;
+			size_t idx = Home(slot.hash);
+			while (slots[idx].hash) {
+				idx = (idx + 1) & mask;
+			}
+			slots[idx] = std::move(slot);
+		}
+	}
+};
+
+}
+
+#endif
@@ -34,7 +34,6 @@
 // Moving to each node in the path thus becomes an automatic regulation problem
 // which is solved with a P regulator, see Scriptable.cpp
 
-#include "FibonacciHeap.h"
 #include "GameData.h"
 #include "Map.h"
 #include "PathFinder.h"
@@ -57,10 +56,22 @@ constexpr std::array<double, RAND_DEGREES_OF_FREEDOM> dxRand{{0.000, -0.383, -0.
 // Sines
 constexpr std::array<double, RAND_DEGREES_OF_FREEDOM> dyRand{{1.000, 0.924, 0.707, 0.383, 0.000, -0.383, -0.707, -0.924, -1.000, -0.924, -0.707, -0.383, 0.000, 0.383, 0.707, 0.924}};
 
+// whether a creature of this size fits on the cell, ignoring actors, since those
+// either get bumped or are checked separately; the fine search and the layers
+// both use this, so they agree on what is connected
+static bool IsOpenFor(const TileProps& props, const SearchmapPoint& p, unsigned int size)
+{
+	PathMapFlags ret = props.QueryStaticInRadius(p, size);
+	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE | PathMapFlags::SIDEWALL))) {
+		ret &= ~PathMapFlags::PASSABLE;
+	}
+	return bool(ret & (PathMapFlags::PASSABLE | PathMapFlags::TRAVEL));
+}
+
 // Find the best path of limited length that brings us the farthest from d
-PathListNode *Map::RunAway(const Point &s, const Point &d, unsigned int size, int maxPathLength, bool backAway, const Actor *caller) const
+Path Map::RunAway(const Point &s, const Point &d, unsigned int size, int maxPathLength, bool backAway, const Actor *caller) const
 {
-	if (!caller || !caller->GetSpeed()) return nullptr;
+	if (!caller || !caller->GetSpeed()) return {};
 	Point p = s;
 	double dx = s.x - d.x;
 	double dy = s.y - d.y;
@@ -85,9 +96,9 @@ PathListNode *Map::RunAway(const Point &s, const Point &d, unsigned int size, in
 	return FindPath(s, p, size, size, flags, caller);
 }
 
-PathListNode *Map::RandomWalk(const Point &s, int size, int radius, const Actor *caller) const
+Path Map::RandomWalk(const Point &s, int size, int radius, const Actor *caller) const
 {
-	if (!caller || !caller->GetSpeed()) return nullptr;
+	if (!caller || !caller->GetSpeed()) return {};
 	NavmapPoint p = s;
 	size_t i = RAND<size_t>(0, RAND_DEGREES_OF_FREEDOM - 1);
 	double dx = 3 * dxRand[i];
@@ -100,7 +111,7 @@ PathListNode *Map::RandomWalk(const Point &s, int size, int radius, const Actor
 			tries++;
 			// Give up if backed into a corner
 			if (tries > RAND_DEGREES_OF_FREEDOM) {
-				return nullptr;
+				return {};
 			}
 			// Random rotation
 			i = RAND<size_t>(0, RAND_DEGREES_OF_FREEDOM - 1);
@@ -117,122 +128,33 @@ PathListNode *Map::RandomWalk(const Point &s, int size, int radius, const Actor
 		p.x -= dx;
 		p.y -= dy;
 	}
-	PathListNode *step = new PathListNode;
 	const Size& mapSize = PropsSize();
-	step->point = Clamp(p, Point(1, 1), Point((mapSize.w - 1) * 16, (mapSize.h - 1) * 12));
-	step->Parent = nullptr;
-	step->Next = nullptr;
-	step->orient = GetOrient(p, s);
-	return step;
+	PathNode step;
+	step.point = Clamp(p, Point(1, 1), Point((mapSize.w - 1) * 16, (mapSize.h - 1) * 12));
+	step.orient = GetOrient(p, s);
+	return Path { step };
 }
 
 bool Map::TargetUnreachable(const Point &s, const Point &d, unsigned int size, bool actorsAreBlocking) const
 {
+	// the searchmap layers can vouch for connected ends, unless actors need to be
+	// taken into account or one of the ends is somewhere a creature of this size
+	// can't normally stand; FindPath rejects disconnected ends by itself
+	SearchmapPoint smptSource = ConvertCoordToTile(s);
+	SearchmapPoint smptDest = ConvertCoordToTile(d);
+	if (smptSource == smptDest) return true; // FindPath doesn't bother either
+	uint32_t sourceComponent = pathHierarchy.GetComponent(tileProps, smptSource, size);
+	uint32_t destComponent = pathHierarchy.GetComponent(tileProps, smptDest, size);
+	if (sourceComponent && sourceComponent == destComponent && !actorsAreBlocking) {
+		return false;
+	}
+
 	int flags = PF_SIGHT;
 	if (actorsAreBlocking) flags |= PF_ACTORS_ARE_BLOCKING;
-	PathListNode *path = FindPath(s, d, size, 0, flags);
-	bool targetUnreachable = path == nullptr;
-	if (!targetUnreachable) {
-		PathListNode *thisNode = path;
-		while (thisNode) {
-			PathListNode *nextNode = thisNode->Next;
-			delete thisNode;
-			thisNode = nextNode;
-		}
-	}
-	return targetUnreachable;
+	return FindPath(s, d, size, 0, flags).empty();
 }
 
 // Use this function when you target something by a straight line projectile (like a lightning bolt, arrow, etc)
-PathListNode *Map::GetLine(const Point &start, const Point &dest, int flags) const
-{
-	orient_t Orientation = GetOrient(start, dest);
-	return GetLine(start, dest, 1, Orientation, flags);
-}
-
-PathListNode *Map::GetLine(const Point &start, int Steps, orient_t Orientation, int flags) const
-{
-	Point dest = start;
-
-	double xoff, yoff, mult;
-	if (Orientation <= 4) {
-		xoff = -Orientation / 4.0;
-	} else if (Orientation <= 12) {
-		xoff = -1.0 + (Orientation - 4) / 4.0;
-	} else {
-		xoff = 1.0 - (Orientation - 12) / 4.0;
-	}
-
-	if (Orientation <= 8) {
-		yoff = 1.0 - Orientation / 4.0;
-	} else {
-		yoff = -1.0 + (Orientation - 8) / 4.0;
-	}
-
-	mult = 1.0 / std::max(std::fabs(xoff), std::fabs(yoff));
-
-	dest.x += Steps * mult * xoff + 0.5;
-	dest.y += Steps * mult * yoff + 0.5;
-
-	return GetLine(start, dest, 2, Orientation, flags);
-}
-
-PathListNode *Map::GetLine(const Point &start, const Point &dest, int Speed, orient_t Orientation, int flags) const
-{
-	PathListNode *StartNode = new PathListNode;
-	PathListNode *Return = StartNode;
-	StartNode->Next = nullptr;
-	StartNode->Parent = nullptr;
-	StartNode->point = start;
-	StartNode->orient = Orientation;
-
-	int Count = 0;
-	int Max = Distance(start, dest);
-	for (int Steps = 0; Steps < Max; Steps++) {
-		Point p;
-		p.x = start.x + ((dest.x - start.x) * Steps / Max);
-		p.y = start.y + ((dest.y - start.y) * Steps / Max);
-
-		//the path ends here as it would go off the screen, causing problems
-		//maybe there is a better way, but i needed a quick hack to fix
-		//the crash in projectiles
-		if (p.x < 0 || p.y < 0) {
-			return Return;
-		}
-		
-		const Size& mapSize = PropsSize();
-		if (p.x > mapSize.w * 16 || p.y > mapSize.h * 12) {
-			return Return;
-		}
-
-		if (!Count) {
-			StartNode->Next = new PathListNode;
-			StartNode->Next->Parent = StartNode;
-			StartNode = StartNode->Next;
-			StartNode->Next = nullptr;
-			Count = Speed;
-		} else {
-			Count--;
-		}
-
-		StartNode->point = p;
-		StartNode->orient = Orientation;
-		bool wall = bool(GetBlocked(p) & (PathMapFlags::DOOR_IMPASSABLE | PathMapFlags::SIDEWALL));
-		if (wall) switch (flags) {
-			case GL_REBOUND:
-				Orientation = ReflectOrientation(Orientation);
-				// TODO: recalculate dest (mirror it)
-				break;
-			case GL_PASS:
-				break;
-			default: //premature end
-				return Return;
-		}
-	}
-
-	return Return;
-}
-
 Path Map::GetLinePath(const Point &start, const Point &dest, int Speed, orient_t Orientation, int flags) const
 {
 	int Count = 0;
@@ -283,22 +205,20 @@ Path Map::GetLinePath(const Point &start, const Point &dest, int Speed, orient_t
 	return path;
 }
 
-PathListNode *Map::GetLine(const Point &p, int steps, orient_t orient) const
+Path Map::GetLine(const Point &p, int steps, orient_t orient) const
 {
-	PathListNode *step = new PathListNode;
-	step->point.x = p.x + steps * SEARCHMAP_SQUARE_DIAGONAL * dxRand[orient];
-	step->point.y = p.y + steps * SEARCHMAP_SQUARE_DIAGONAL * dyRand[orient];
+	PathNode step;
+	step.point.x = p.x + steps * SEARCHMAP_SQUARE_DIAGONAL * dxRand[orient];
+	step.point.y = p.y + steps * SEARCHMAP_SQUARE_DIAGONAL * dyRand[orient];
 	const Size& mapSize = PropsSize();
-	step->point = Clamp(step->point, Point(1, 1), Point((mapSize.w - 1) * 16, (mapSize.h - 1) * 12));
-	step->orient = GetOrient(step->point, p);
-	step->Next = nullptr;
-	step->Parent = nullptr;
-	return step;
+	step.point = Clamp(step.point, Point(1, 1), Point((mapSize.w - 1) * 16, (mapSize.h - 1) * 12));
+	step.orient = GetOrient(step.point, p);
+	return Path { step };
 }
 
 // Find a path from start to goal, ending at the specified distance from the
 // target (the goal must be in sight of the end, if PF_SIGHT is specified)
-PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
+Path Map::FindPath(const Point &s, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller) const
 {
 	Log(DEBUG, "FindPath", "s = {}, d = {}, caller = {}, dist = {}, size = {}", s, d, caller ? MBStringFromString(caller->GetShortName()) : "nullptr", minDistance, size);
 	NavmapPoint nmptDest = d;
@@ -312,31 +232,70 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 	}
 	if (minDistance < size && !(GetBlockedInRadius(nmptDest, size) & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR))) {
 		Log(DEBUG, "FindPath", "{} can't fit in destination", caller ? MBStringFromString(caller->GetShortName()) : "nullptr");
-		return nullptr;
+		return {};
 	}
 	SearchmapPoint smptSource(nmptSource.x / 16, nmptSource.y / 12);
 	SearchmapPoint smptDest(nmptDest.x / 16, nmptDest.y / 12);
-	if (smptDest == smptSource) return nullptr;
+	if (smptDest == smptSource) return {};
+
+	const Size& mapSize = PropsSize();
+	if (!mapSize.PointInside(smptSource)) return {};
+
+	// Consult the coarse searchmap layer first: it judges cells just like the
+	// fine search and is always up to date, so disconnected ends need no search,
+	// unless we may stop short of the goal. Long routes between connected ends
+	// are first planned over clusters and only searched within them
+	bool useCorridor = false;
+	uint32_t sourceComponent = pathHierarchy.GetComponent(tileProps, smptSource, size);
+	uint32_t destComponent = pathHierarchy.GetComponent(tileProps, smptDest, size);
+	if (sourceComponent && destComponent) {
+		if (sourceComponent != destComponent) {
+			if (!minDistance) {
+				Log(DEBUG, "FindPath", "{} is disconnected from {}", s, nmptDest);
+				return {};
+			}
+		} else if (pathHierarchy.IsLongRoute(smptSource, smptDest)) {
+			useCorridor = pathHierarchy.PlanCorridor(tileProps, smptSource, smptDest, size);
+		}
+	}
+
+	Path path = SearchPath(nmptSource, nmptDest, d, size, minDistance, flags, caller, useCorridor);
+	if (path.empty() && useCorridor) {
+		// actors may be blocking the corridor, so retry with the whole map
+		path = SearchPath(nmptSource, nmptDest, d, size, minDistance, flags, caller, false);
+	}
+
+	if (!path.empty()) {
+		return path;
+	} else if (caller) {
+		Log(DEBUG, "FindPath", "Pathing failed for {}", fmt::WideToChar{caller->GetShortName()});
+	} else {
+		Log(DEBUG, "FindPath", "Pathing failed");
+	}
+
+	return path;
+}
 
+// The actual Theta* search, optionally limited to the clusters of the planned corridor
+Path Map::SearchPath(const NavmapPoint &nmptSource, NavmapPoint nmptDest, const Point &d, unsigned int size, unsigned int minDistance, int flags, const Actor *caller, bool useCorridor) const
+{
+	SearchmapPoint smptSource(nmptSource.x / 16, nmptSource.y / 12);
+	SearchmapPoint smptDest(nmptDest.x / 16, nmptDest.y / 12);
 	const Size& mapSize = PropsSize();
-	if (!mapSize.PointInside(smptSource)) return nullptr;
 
 	// Initialize data structures
-	FibonacciHeap<PQNode> open;
-	std::vector<bool> isClosed(mapSize.Area(), false);
-	std::vector<NavmapPoint> parents(mapSize.Area(), Point(0, 0));
-	std::vector<unsigned short> distFromStart(mapSize.Area(), std::numeric_limits<unsigned short>::max());
-	distFromStart[smptSource.y * mapSize.w + smptSource.x] = 0;
-	parents[smptSource.y * mapSize.w + smptSource.x] = nmptSource;
-	open.emplace(PQNode(nmptSource, 0));
+	PathFinderWorkspace& ws = pathWorkspace;
+	ws.Reset(mapSize);
+	ws.SetParent(smptSource, nmptSource, 0);
+	ws.PushOpen(PQNode(nmptSource, 0));
 	bool foundPath = false;
 	unsigned int squaredMinDist = minDistance * minDistance;
 
-	while (!open.empty()) {
-		NavmapPoint nmptCurrent = open.top().point;
-		open.pop();
+	while (!ws.OpenEmpty()) {
+		NavmapPoint nmptCurrent = ws.PopOpen().point;
 		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-		if (parents[smptCurrent.y * mapSize.w + smptCurrent.x] == Point(0, 0)) {
+		NavmapPoint nmptParent = ws.GetParent(smptCurrent);
+		if (nmptParent == Point(0, 0)) {
 			continue;
 		}
 
@@ -345,8 +304,7 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 			foundPath = true;
 			break;
 		} else if (minDistance) {
-			if (parents[smptCurrent.y * mapSize.w + smptCurrent.x] != nmptCurrent &&
-					SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist) {
+			if (nmptParent != nmptCurrent && SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist) {
 				if (!(flags & PF_SIGHT) || IsVisibleLOS(nmptCurrent, d)) {
 					smptDest = smptCurrent;
 					nmptDest = nmptCurrent;
@@ -355,47 +313,44 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 				}
 			}
 		}
-		isClosed[smptCurrent.y * mapSize.w + smptCurrent.x] = true;
+		ws.Close(smptCurrent);
 
 		for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
 			NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
 			SearchmapPoint smptChild(nmptChild.x / 16, nmptChild.y / 12);
 			// Outside map
 			if (smptChild.x < 0 ||	smptChild.y < 0 || smptChild.x >= mapSize.w || smptChild.y >= mapSize.h) continue;
+			// Off the planned route
+			if (useCorridor && !pathHierarchy.InCorridor(smptChild)) continue;
 			// Already visited
-			if (isClosed[smptChild.y * mapSize.w + smptChild.x]) continue;
+			if (ws.IsClosed(smptChild)) continue;
 			// If there's an actor, check it can be bumped away
 			const Actor* childActor = GetActor(nmptChild, GA_NO_DEAD | GA_NO_UNSCHEDULED);
 			bool childIsUnbumpable = childActor && childActor != caller && (flags & PF_ACTORS_ARE_BLOCKING || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
 			if (childIsUnbumpable) continue;
 
-			PathMapFlags childBlockStatus = GetBlockedInRadius(nmptChild, size);
-			bool childBlocked = !(childBlockStatus & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR | PathMapFlags::TRAVEL));
-			if (childBlocked) continue;
+			if (!IsOpenFor(tileProps, smptChild, size)) continue;
 
 			// Weighted heuristic. Finds sub-optimal paths but should be quite a bit faster
 			const float HEURISTIC_WEIGHT = 1.5;
-			SearchmapPoint smptCurrent2(nmptCurrent.x / 16, nmptCurrent.y / 12);
-			NavmapPoint nmptParent = parents[smptCurrent2.y * mapSize.w + smptCurrent2.x];
-			unsigned short oldDist = distFromStart[smptChild.y * mapSize.w + smptChild.x];
+			unsigned short oldDist = ws.GetDistance(smptChild);
+			unsigned short newDist = oldDist;
 			// Theta-star path if there is LOS
-			if (IsWalkableTo(nmptParent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
+			if (IsWalkableTo(nmptParent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING)) {
 				SearchmapPoint smptParent(nmptParent.x / 16, nmptParent.y / 12);
-				unsigned short newDist = distFromStart[smptParent.y * mapSize.w + smptParent.x] + Distance(smptParent, smptChild);
+				newDist = ws.GetDistance(smptParent) + Distance(smptParent, smptChild);
 				if (newDist < oldDist) {
-					parents[smptChild.y * mapSize.w + smptChild.x] = nmptParent;
-					distFromStart[smptChild.y * mapSize.w + smptChild.x] = newDist;
+					ws.SetParent(smptChild, nmptParent, newDist);
 				}
 			// Fall back to A-star path
-			} else if (IsWalkableTo(nmptCurrent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING, caller)) {
-				unsigned short newDist = distFromStart[smptCurrent2.y * mapSize.w + smptCurrent2.x] + Distance(smptCurrent2, smptChild);
+			} else if (IsWalkableTo(nmptCurrent, nmptChild, flags & PF_ACTORS_ARE_BLOCKING)) {
+				newDist = ws.GetDistance(smptCurrent) + Distance(smptCurrent, smptChild);
 				if (newDist < oldDist) {
-					parents[smptChild.y * mapSize.w + smptChild.x] = nmptCurrent;
-					distFromStart[smptChild.y * mapSize.w + smptChild.x] = newDist;
+					ws.SetParent(smptChild, nmptCurrent, newDist);
 				}
 			}
 
-			if (distFromStart[smptChild.y * mapSize.w + smptChild.x] < oldDist) {
+			if (newDist < oldDist) {
 				// Calculate heuristic
 				int xDist = smptChild.x - smptDest.x;
 				int yDist = smptChild.y - smptDest.y;
@@ -405,46 +360,37 @@ PathListNode *Map::FindPath(const Point &s, const Point &d, unsigned int size, u
 				int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
 				double distance = std::hypot(xDist, yDist);
 				double heuristic = HEURISTIC_WEIGHT * (distance + crossProduct);
-				double estDist = distFromStart[smptChild.y * mapSize.w + smptChild.x] + heuristic;
-				PQNode newNode(nmptChild, estDist);
-				open.emplace(newNode);
+				double estDist = newDist + heuristic;
+				ws.PushOpen(PQNode(nmptChild, estDist));
 			}
 		}
 	}
 
 	if (foundPath) {
-		PathListNode *resultPath = nullptr;
+		// walk the parents back to the start, then flip the result around
+		Path resultPath;
 		NavmapPoint nmptCurrent = nmptDest;
-		NavmapPoint nmptParent;
 		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
-		while (!resultPath || nmptCurrent != parents[smptCurrent.y * mapSize.w + smptCurrent.x]) {
-			nmptParent = parents[smptCurrent.y * mapSize.w + smptCurrent.x];
-			PathListNode *newStep = new PathListNode;
-			newStep->point = nmptCurrent;
-			newStep->Next = resultPath;
-			newStep->Parent = nullptr;
+		while (resultPath.empty() || nmptCurrent != ws.GetParent(smptCurrent)) {
+			NavmapPoint nmptParent = ws.GetParent(smptCurrent);
+			PathNode newStep;
+			newStep.point = nmptCurrent;
 			if (flags & PF_BACKAWAY) {
-				newStep->orient = GetOrient(nmptParent, nmptCurrent);
+				newStep.orient = GetOrient(nmptParent, nmptCurrent);
 			} else {
-				newStep->orient = GetOrient(nmptCurrent, nmptParent);
-			}
-			if (resultPath) {
-				resultPath->Parent = newStep;
+				newStep.orient = GetOrient(nmptCurrent, nmptParent);
 			}
-			resultPath = newStep;
+			resultPath.push_back(newStep);
 			nmptCurrent = nmptParent;
 
 			smptCurrent.x = nmptCurrent.x / 16;
 			smptCurrent.y = nmptCurrent.y / 12;
 		}
+		std::reverse(resultPath.begin(), resultPath.end());
 		return resultPath;
-	} else if (caller) {
-		Log(DEBUG, "FindPath", "Pathing failed for {}", fmt::WideToChar{caller->GetShortName()});
-	} else {
-		Log(DEBUG, "FindPath", "Pathing failed");
 	}
 
-	return nullptr;
+	return {};
 }
 
 void Map::NormalizeDeltas(double &dx, double &dy, const double &factor)
@@ -476,4 +422,302 @@ void Map::NormalizeDeltas(double &dx, double &dy, const double &factor)
 	dx = std::ceil(dx) * xSign;
 	dy = std::ceil(dy) * ySign;
 }
+
+void PathFinderHierarchy::Reset()
+{
+	for (Layer& layer : layers) {
+		layer = Layer();
+	}
+	mapSize.reset();
+}
+
+void PathFinderHierarchy::Invalidate(const SearchmapPoint& min, const SearchmapPoint& max)
+{
+	if (mapSize.IsZero()) return;
+
+	// a cell's openness depends on everything within the largest creature circle
+	constexpr int reach = MAX_CIRCLESIZE;
+	int x1 = Clamp(min.x - reach, 0, mapSize.w - 1) / CLUSTER_SIZE;
+	int x2 = Clamp(max.x + reach, 0, mapSize.w - 1) / CLUSTER_SIZE;
+	int y1 = Clamp(min.y - reach, 0, mapSize.h - 1) / CLUSTER_SIZE;
+	int y2 = Clamp(max.y + reach, 0, mapSize.h - 1) / CLUSTER_SIZE;
+	for (Layer& layer : layers) {
+		if (!layer.built) continue;
+		for (int y = y1; y <= y2; y++) {
+			for (int x = x1; x <= x2; x++) {
+				layer.dirty[y * clusterCount.w + x] = 1;
+			}
+		}
+		layer.anyDirty = true;
+	}
+}
+
+PathFinderHierarchy::Layer& PathFinderHierarchy::GetLayer(const TileProps& props, unsigned int size)
+{
+	size = Clamp<unsigned int>(size, 2, MAX_CIRCLESIZE);
+	if (mapSize != props.GetSize()) {
+		Reset();
+		mapSize = props.GetSize();
+		clusterCount.w = (mapSize.w + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+		clusterCount.h = (mapSize.h + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	}
+	SearchmapPoint changedMin;
+	SearchmapPoint changedMax;
+	if (props.TakeStaticChanges(changedMin, changedMax)) {
+		Invalidate(changedMin, changedMax);
+	}
+
+	Layer& layer = layers[size];
+	if (!layer.built) {
+		layer.cellLabels.assign(mapSize.Area(), 0);
+		layer.clusterNodes.assign(clusterCount.Area(), 0);
+		layer.rightLinks.assign(clusterCount.Area(), {});
+		layer.downLinks.assign(clusterCount.Area(), {});
+		layer.dirty.assign(clusterCount.Area(), 1);
+		layer.anyDirty = true;
+		layer.built = true;
+	}
+	if (layer.anyDirty) {
+		relink.assign(clusterCount.Area(), 0);
+		for (int cluster = 0; cluster < clusterCount.Area(); cluster++) {
+			if (!layer.dirty[cluster]) continue;
+			LabelCluster(props, layer, cluster, size);
+			layer.dirty[cluster] = 0;
+			// the left and upper neighbours keep the links over the shared borders
+			relink[cluster] = 1;
+			if (cluster % clusterCount.w) relink[cluster - 1] = 1;
+			if (cluster >= clusterCount.w) relink[cluster - clusterCount.w] = 1;
+		}
+		for (int cluster = 0; cluster < clusterCount.Area(); cluster++) {
+			if (relink[cluster]) LinkBorders(layer, cluster);
+		}
+		LinkClusters(layer);
+		layer.anyDirty = false;
+	}
+	return layer;
+}
+
+// flood fills the open cells of a cluster
+void PathFinderHierarchy::LabelCluster(const TileProps& props, Layer& layer, int cluster, unsigned int size)
+{
+	int x0 = (cluster % clusterCount.w) * CLUSTER_SIZE;
+	int y0 = (cluster / clusterCount.w) * CLUSTER_SIZE;
+	int x1 = std::min(x0 + CLUSTER_SIZE, mapSize.w);
+	int y1 = std::min(y0 + CLUSTER_SIZE, mapSize.h);
+
+	constexpr uint16_t UNLABELLED = std::numeric_limits<uint16_t>::max();
+	for (int y = y0; y < y1; y++) {
+		for (int x = x0; x < x1; x++) {
+			layer.cellLabels[y * mapSize.w + x] = IsOpenFor(props, SearchmapPoint(x, y), size) ? UNLABELLED : 0;
+		}
+	}
+
+	uint16_t label = 0;
+	for (int y = y0; y < y1; y++) {
+		for (int x = x0; x < x1; x++) {
+			if (layer.cellLabels[y * mapSize.w + x] != UNLABELLED) continue;
+
+			label++;
+			layer.cellLabels[y * mapSize.w + x] = label;
+			cellStack.emplace_back(x, y);
+			while (!cellStack.empty()) {
+				SearchmapPoint p = cellStack.back();
+				cellStack.pop_back();
+				for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
+					SearchmapPoint n(p.x + dxAdjacent[i], p.y + dyAdjacent[i]);
+					if (n.x < x0 || n.x >= x1 || n.y < y0 || n.y >= y1) continue;
+					uint16_t& cell = layer.cellLabels[n.y * mapSize.w + n.x];
+					if (cell != UNLABELLED) continue;
+					cell = label;
+					cellStack.push_back(n);
+				}
+			}
+		}
+	}
+	layer.clusterNodes[cluster] = label;
+}
+
+// collects the links over the right and bottom border of a cluster
+void PathFinderHierarchy::LinkBorders(Layer& layer, int cluster) const
+{
+	int x0 = (cluster % clusterCount.w) * CLUSTER_SIZE;
+	int y0 = (cluster / clusterCount.w) * CLUSTER_SIZE;
+	int x1 = std::min(x0 + CLUSTER_SIZE, mapSize.w);
+	int y1 = std::min(y0 + CLUSTER_SIZE, mapSize.h);
+
+	auto add = [](std::vector<LabelPair>& pairs, uint16_t here, uint16_t there) {
+		if (!here || !there) return;
+		LabelPair pair(here, there);
+		if (std::find(pairs.begin(), pairs.end(), pair) == pairs.end()) {
+			pairs.push_back(pair);
+		}
+	};
+
+	std::vector<LabelPair>& right = layer.rightLinks[cluster];
+	right.clear();
+	if (x1 < mapSize.w) {
+		for (int y = y0; y < y1; y++) {
+			add(right, layer.cellLabels[y * mapSize.w + x1 - 1], layer.cellLabels[y * mapSize.w + x1]);
+		}
+	}
+
+	std::vector<LabelPair>& down = layer.downLinks[cluster];
+	down.clear();
+	if (y1 < mapSize.h) {
+		for (int x = x0; x < x1; x++) {
+			add(down, layer.cellLabels[(y1 - 1) * mapSize.w + x], layer.cellLabels[y1 * mapSize.w + x]);
+		}
+	}
+}
+
+// rebuilds the abstract graph from the border links; cheap compared to labelling,
+// since no cells are looked at
+void PathFinderHierarchy::LinkClusters(Layer& layer)
+{
+	layer.firstNode.resize(clusterCount.Area() + 1);
+	layer.firstNode[0] = 0;
+	for (int cluster = 0; cluster < clusterCount.Area(); cluster++) {
+		layer.firstNode[cluster + 1] = layer.firstNode[cluster] + layer.clusterNodes[cluster];
+	}
+	uint32_t nodeCount = layer.firstNode.back();
+	layer.nodeCluster.resize(nodeCount);
+	// clearing instead of reassigning keeps the adjacency lists allocated
+	layer.links.resize(nodeCount);
+	for (int cluster = 0; cluster < clusterCount.Area(); cluster++) {
+		for (uint32_t node = layer.firstNode[cluster]; node < layer.firstNode[cluster + 1]; node++) {
+			layer.nodeCluster[node] = cluster;
+			layer.links[node].clear();
+		}
+	}
+
+	auto link = [&layer](int cluster, int other, const LabelPair& pair) {
+		uint32_t a = layer.firstNode[cluster] + pair.first - 1;
+		uint32_t b = layer.firstNode[other] + pair.second - 1;
+		layer.links[a].push_back(b);
+		layer.links[b].push_back(a);
+	};
+	for (int cluster = 0; cluster < clusterCount.Area(); cluster++) {
+		for (const LabelPair& pair : layer.rightLinks[cluster]) {
+			link(cluster, cluster + 1, pair);
+		}
+		for (const LabelPair& pair : layer.downLinks[cluster]) {
+			link(cluster, cluster + clusterCount.w, pair);
+		}
+	}
+
+	layer.components.assign(nodeCount, 0);
+	uint32_t component = 0;
+	for (uint32_t start = 0; start < nodeCount; start++) {
+		if (layer.components[start]) continue;
+		component++;
+		layer.components[start] = component;
+		nodeStack.push_back(start);
+		while (!nodeStack.empty()) {
+			uint32_t node = nodeStack.back();
+			nodeStack.pop_back();
+			for (uint32_t neighbour : layer.links[node]) {
+				if (layer.components[neighbour]) continue;
+				layer.components[neighbour] = component;
+				nodeStack.push_back(neighbour);
+			}
+		}
+	}
+}
+
+// 1-based node index, 0 for closed cells
+uint32_t PathFinderHierarchy::GetNode(const Layer& layer, const SearchmapPoint& p) const
+{
+	uint16_t label = layer.cellLabels[p.y * mapSize.w + p.x];
+	if (!label) return 0;
+	return layer.firstNode[ClusterIndex(p)] + label;
+}
+
+uint32_t PathFinderHierarchy::GetComponent(const TileProps& props, const SearchmapPoint& p, unsigned int size)
+{
+	const Layer& layer = GetLayer(props, size);
+	if (!mapSize.PointInside(p)) return 0;
+	uint32_t node = GetNode(layer, p);
+	return node ? layer.components[node - 1] : 0;
+}
+
+bool PathFinderHierarchy::IsLongRoute(const SearchmapPoint& s, const SearchmapPoint& d) const
+{
+	int dx = std::abs(s.x / CLUSTER_SIZE - d.x / CLUSTER_SIZE);
+	int dy = std::abs(s.y / CLUSTER_SIZE - d.y / CLUSTER_SIZE);
+	return dx + dy > 1;
+}
+
+// A* over the abstract graph, using the cluster centres as node positions
+bool PathFinderHierarchy::PlanCorridor(const TileProps& props, const SearchmapPoint& s, const SearchmapPoint& d, unsigned int size)
+{
+	const Layer& layer = GetLayer(props, size);
+	if (!mapSize.PointInside(s) || !mapSize.PointInside(d)) return false;
+	uint32_t start = GetNode(layer, s);
+	uint32_t goal = GetNode(layer, d);
+	if (!start || !goal) return false;
+	start--;
+	goal--;
+	if (layer.components[start] != layer.components[goal]) return false;
+
+	auto centre = [this, &layer](uint32_t node) {
+		int cluster = layer.nodeCluster[node];
+		return Point(cluster % clusterCount.w, cluster / clusterCount.w);
+	};
+
+	// every node is stamped with the search that last reached it, so nothing needs clearing
+	uint32_t nodeCount = layer.firstNode.back();
+	if (visited.size() < nodeCount) {
+		visited.resize(nodeCount, 0);
+		dist.resize(nodeCount);
+		parent.resize(nodeCount);
+	}
+	if (++generation == 0) {
+		std::fill(visited.begin(), visited.end(), 0);
+		generation = 1;
+	}
+	auto distance = [this](uint32_t node) {
+		return visited[node] == generation ? dist[node] : std::numeric_limits<unsigned int>::max();
+	};
+
+	Point goalCentre = centre(goal);
+	visited[start] = generation;
+	dist[start] = 0;
+	parent[start] = start;
+	open.clear();
+	open.emplace_back(0, start);
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), std::greater<QueueEntry>());
+		uint32_t node = open.back().second;
+		open.pop_back();
+		if (node == goal) break;
+		for (uint32_t neighbour : layer.links[node]) {
+			// neighbours are always in adjacent clusters
+			unsigned int newDist = dist[node] + CLUSTER_SIZE;
+			if (newDist >= distance(neighbour)) continue;
+			visited[neighbour] = generation;
+			dist[neighbour] = newDist;
+			parent[neighbour] = node;
+			Point there = centre(neighbour);
+			unsigned int heuristic = (std::abs(there.x - goalCentre.x) + std::abs(there.y - goalCentre.y)) * CLUSTER_SIZE;
+			open.emplace_back(newDist + heuristic, neighbour);
+			std::push_heap(open.begin(), open.end(), std::greater<QueueEntry>());
+		}
+	}
+	if (distance(goal) == std::numeric_limits<unsigned int>::max()) return false;
+
+	// mark the route and its surroundings, so the fine search has some room to cut corners
+	corridor.assign(clusterCount.Area(), 0);
+	uint32_t node = goal;
+	while (true) {
+		Point c = centre(node);
+		for (int y = std::max(0, c.y - 1); y <= std::min(clusterCount.h - 1, c.y + 1); y++) {
+			for (int x = std::max(0, c.x - 1); x <= std::min(clusterCount.w - 1, c.x + 1); x++) {
+				corridor[y * clusterCount.w + x] = 1;
+			}
+		}
+		if (node == start) break;
+		node = parent[node];
+	}
+	return true;
+}
 }
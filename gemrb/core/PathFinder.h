@@ -26,11 +26,21 @@
 #include "Region.h"
 #include "Resource.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace GemRB {
 
+class TileProps;
+
+// the largest circle the searchmap checks for a creature
+constexpr unsigned int MAX_CIRCLESIZE = 8;
+
 //searchmap conversion bits
 
 enum class PathMapFlags : uint8_t {
@@ -60,21 +70,12 @@ struct PathNode {
 	orient_t orient;
 };
 
-// FIXME: does Path have to be a linked list?
-// its meant to replace PathListNode which is a linked list
-// however, Projectile (and presumably other future users)
+// a vector, since Projectile (and presumably other future users)
 // needs to keep track of which PathNode it is currently in
 // list iterators get invalidated during copy/move
 // nor are they randomly accessible so indexing isn't a good option
 using Path = std::vector<PathNode>;
 
-struct PathListNode {
-	PathListNode* Parent;
-	PathListNode* Next;
-	Point point;
-	orient_t orient;
-};
-
 enum {
 	PF_SIGHT = 1,
 	PF_BACKAWAY = 2,
@@ -101,6 +102,168 @@ public:
 
 };
 
+// Search state for Map::FindPath, kept around between searches, so
+// pathfinding doesn't allocate anything once the buffers have grown
+// Every cell is stamped with the generation of the search that last touched it,
+// anything with an older stamp is treated as unvisited, so no clearing is needed
+class GEM_EXPORT PathFinderWorkspace {
+	struct Cell {
+		uint32_t generation = 0;
+		bool closed = false;
+		unsigned short distFromStart = 0;
+		NavmapPoint parent;
+	};
+
+	std::vector<Cell> cells;
+	std::vector<PQNode> open; // binary min-heap
+	uint32_t generation = 0;
+	int width = 0;
+
+	size_t Index(const SearchmapPoint& p) const { return p.y * width + p.x; }
+	const Cell* Visited(const SearchmapPoint& p) const
+	{
+		const Cell& cell = cells[Index(p)];
+		return cell.generation == generation ? &cell : nullptr;
+	}
+	Cell& Touch(const SearchmapPoint& p)
+	{
+		Cell& cell = cells[Index(p)];
+		if (cell.generation != generation) {
+			cell = Cell();
+			cell.generation = generation;
+			cell.distFromStart = std::numeric_limits<unsigned short>::max();
+		}
+		return cell;
+	}
+
+public:
+	void Reset(const Size& mapSize)
+	{
+		width = mapSize.w;
+		if (cells.size() < size_t(mapSize.Area())) {
+			cells.resize(mapSize.Area());
+		}
+		open.clear();
+		if (++generation == 0) {
+			// wrapped around, so old stamps could look current again
+			std::fill(cells.begin(), cells.end(), Cell());
+			generation = 1;
+		}
+	}
+
+	bool IsClosed(const SearchmapPoint& p) const
+	{
+		const Cell* cell = Visited(p);
+		return cell && cell->closed;
+	}
+	void Close(const SearchmapPoint& p) { Touch(p).closed = true; }
+
+	// (0, 0) marks cells without a parent, like for the unvisited ones
+	NavmapPoint GetParent(const SearchmapPoint& p) const
+	{
+		const Cell* cell = Visited(p);
+		return cell ? cell->parent : NavmapPoint(0, 0);
+	}
+	unsigned short GetDistance(const SearchmapPoint& p) const
+	{
+		const Cell* cell = Visited(p);
+		return cell ? cell->distFromStart : std::numeric_limits<unsigned short>::max();
+	}
+	void SetParent(const SearchmapPoint& p, const NavmapPoint& parent, unsigned short dist)
+	{
+		Cell& cell = Touch(p);
+		cell.parent = parent;
+		cell.distFromStart = dist;
+	}
+
+	bool OpenEmpty() const { return open.empty(); }
+	void PushOpen(const PQNode& node)
+	{
+		open.push_back(node);
+		std::push_heap(open.begin(), open.end(), std::greater<PQNode>());
+	}
+	PQNode PopOpen()
+	{
+		std::pop_heap(open.begin(), open.end(), std::greater<PQNode>());
+		PQNode node = open.back();
+		open.pop_back();
+		return node;
+	}
+};
+
+// Coarse, HPA*-like view of the searchmap
+// The map is split into square clusters and the cells inside each of them where
+// a creature could stand (ignoring other actors, since those can be bumped) are
+// labelled by local connected component. These local components are the nodes of
+// an abstract graph, linked across cluster borders, and the connected components
+// of that graph answer reachability queries without searching.
+// Every creature size gets its own layer, since big creatures don't fit everywhere.
+// Layers are built on first use and pick up the searchmap changes (doors) before
+// answering, so only the affected clusters get relabelled and have their border
+// links rescanned and a layer never answers for an outdated searchmap.
+class GEM_EXPORT PathFinderHierarchy {
+public:
+	static constexpr int CLUSTER_SIZE = 16; // in searchmap cells
+
+	// drops all layers, eg. when the searchmap gets replaced
+	void Reset();
+	// returns 0 if a creature of this size can't stand there
+	uint32_t GetComponent(const TileProps& props, const SearchmapPoint& p, unsigned int size);
+	// true if the points are far enough apart to benefit from a coarse route
+	bool IsLongRoute(const SearchmapPoint& s, const SearchmapPoint& d) const;
+	// plans a route over the abstract graph and marks the clusters along it
+	// (and their neighbours) in the corridor, false if there is no coarse route
+	bool PlanCorridor(const TileProps& props, const SearchmapPoint& s, const SearchmapPoint& d, unsigned int size);
+	bool InCorridor(const SearchmapPoint& p) const { return corridor[ClusterIndex(p)]; }
+
+private:
+	// a link across a cluster border: local component here, local component there
+	using LabelPair = std::pair<uint16_t, uint16_t>;
+
+	struct Layer {
+		bool built = false;
+		bool anyDirty = false;
+		std::vector<uint8_t> dirty; // per cluster
+		std::vector<uint16_t> cellLabels; // local component per cell, 0 where closed
+		std::vector<uint16_t> clusterNodes; // local component count per cluster
+		// per cluster, so a change only needs its borders rescanned
+		std::vector<std::vector<LabelPair>> rightLinks;
+		std::vector<std::vector<LabelPair>> downLinks;
+		std::vector<uint32_t> firstNode; // prefix sums of clusterNodes
+		std::vector<uint32_t> nodeCluster; // cluster of every node
+		std::vector<std::vector<uint32_t>> links; // abstract graph adjacency
+		std::vector<uint32_t> components; // connected component per node
+	};
+
+	Size mapSize; // in searchmap cells
+	Size clusterCount;
+	std::array<Layer, MAX_CIRCLESIZE + 1> layers; // indexed by clamped size
+	std::vector<uint8_t> corridor; // per cluster
+
+	// scratch space, kept between calls like in PathFinderWorkspace
+	std::vector<SearchmapPoint> cellStack;
+	std::vector<uint32_t> nodeStack;
+	std::vector<uint8_t> relink; // per cluster
+	using QueueEntry = std::pair<unsigned int, uint32_t>;
+	std::vector<QueueEntry> open; // binary min-heap
+	std::vector<uint32_t> visited; // search generation per node
+	std::vector<unsigned int> dist;
+	std::vector<uint32_t> parent;
+	uint32_t generation = 0;
+
+	size_t ClusterIndex(const SearchmapPoint& p) const
+	{
+		return (p.y / CLUSTER_SIZE) * clusterCount.w + p.x / CLUSTER_SIZE;
+	}
+	// marks the clusters that depend on the searchmap cells in [min, max]
+	void Invalidate(const SearchmapPoint& min, const SearchmapPoint& max);
+	Layer& GetLayer(const TileProps& props, unsigned int size);
+	void LabelCluster(const TileProps& props, Layer& layer, int cluster, unsigned int size);
+	void LinkBorders(Layer& layer, int cluster) const;
+	void LinkClusters(Layer& layer);
+	uint32_t GetNode(const Layer& layer, const SearchmapPoint& p) const;
+};
+
 }
 
 #endif
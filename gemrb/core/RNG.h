@@ -41,6 +41,11 @@ class GEM_EXPORT RNG {
 	std::mt19937_64 engine;
 	public:
 	static RNG& getInstance();
+
+	// for reproducible runs, the engine is seeded from the time otherwise
+	void Seed(uint32_t seed) noexcept {
+		engine.seed(seed);
+	}
 	
 	/**
 	 * It is possible to generate random numbers from [-min, +/-max].
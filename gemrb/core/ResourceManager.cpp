@@ -27,6 +27,16 @@
 
 namespace GemRB {
 
+// the prefetcher is never replaced, since the workers and the decoder
+// threads look at it without any locking
+ResourceManager::ResourceManager()
+: searchPath(std::make_shared<SourceList>()), prefetcher(new ResourcePrefetcher([this](const ResRef& resRef, SClass_ID type) {
+	Sources sources;
+	size_t source;
+	return FindResource(resRef, type, sources, source);
+}))
+{}
+
 bool ResourceManager::AddSource(const char *path, const char *description, PluginID type, int flags)
 {
 	PluginHolder<ResourceSource> source = MakePluginHolder<ResourceSource>(type);
@@ -35,19 +45,153 @@ bool ResourceManager::AddSource(const char *path, const char *description, Plugi
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(sourcesMutex);
+	auto sources = std::make_shared<SourceList>(*searchPath);
+	size_t changed = sources->size();
 	if (flags & RM_REPLACE_SAME_SOURCE) {
-		for (auto& path2 : searchPath) {
-			if (description == path2->GetDescription()) {
-				path2 = source;
+		for (size_t i = 0; i < sources->size(); ++i) {
+			if (description == (*sources)[i]->GetDescription()) {
+				(*sources)[i] = source;
+				changed = i;
 				break;
 			}
 		}
 	} else {
-		searchPath.push_back(source);
+		sources->push_back(source);
 	}
+
+	searchPath = std::move(sources);
+	InvalidateIndex(changed);
 	return true;
 }
 
+void ResourceManager::RefreshSource(const char* description, const char* fileName)
+{
+	std::lock_guard<std::mutex> lock(sourcesMutex);
+	for (size_t i = 0; i < searchPath->size(); ++i) {
+		ResourceSource& source = *(*searchPath)[i];
+		if (description != source.GetDescription()) continue;
+
+		source.Refresh(fileName);
+		if (!fileName) {
+			InvalidateIndex(i);
+			break;
+		}
+
+		// only the name matters, the extension decides about the type
+		const char* dot = strrchr(fileName, '.');
+		size_t length = dot ? size_t(dot - fileName) : strlen(fileName);
+		if (length <= ResRef::Size) {
+			ResRef resRef(fileName, length);
+			InvalidateIndex(i, &resRef);
+		}
+		break;
+	}
+}
+
+// called with the mutex held; whatever was found in an earlier source is still there
+void ResourceManager::InvalidateIndex(size_t firstChanged, const ResRef* resRef) const
+{
+	indexRevision++;
+	for (auto it = index.begin(); it != index.end();) {
+		bool affected = it->second < 0 || size_t(it->second) >= firstChanged;
+		if (affected && (!resRef || it->first.resRef == *resRef)) {
+			it = index.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+ResourceManager::Lookup ResourceManager::FirstStaticSource(StringView resRef, const char* ext, ieWord keyType,
+	const std::function<bool(ResourceSource&)>& has) const
+{
+	Lookup lookup;
+	size_t extLength = ext ? strlen(ext) : 0;
+	bool indexed = resRef.length() <= ResRef::Size && extLength <= 4;
+	IndexKey key;
+	if (indexed) {
+		key.resRef = ResRef(resRef.c_str(), resRef.length());
+		key.ext = FixedSizeString<4, strnicmp>(ext, extLength);
+		key.keyType = keyType;
+	}
+
+	unsigned long revision;
+	{
+		std::lock_guard<std::mutex> lock(sourcesMutex);
+		lookup.sources = searchPath;
+		revision = indexRevision;
+		if (indexed) {
+			auto it = index.find(key);
+			if (it != index.end()) {
+				indexCounters.hits.fetch_add(1, std::memory_order_relaxed);
+				lookup.firstStatic = it->second;
+				return lookup;
+			}
+		}
+	}
+
+	// probe without holding the lock; a racing lookup of the same resource
+	// comes to the same answer, so whichever gets stored first is fine
+	indexCounters.misses.fetch_add(1, std::memory_order_relaxed);
+	const SourceList& sources = *lookup.sources;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		if (!sources[i]->IsStatic()) continue;
+		indexCounters.probes.fetch_add(1, std::memory_order_relaxed);
+		if (has(*sources[i])) {
+			lookup.firstStatic = int(i);
+			break;
+		}
+	}
+	if (!indexed) return lookup;
+
+	std::lock_guard<std::mutex> lock(sourcesMutex);
+	// the answer is only good if the sources didn't change in the meantime
+	if (indexRevision == revision) {
+		index.emplace(key, lookup.firstStatic);
+	}
+	return lookup;
+}
+
+// static sources before the first one with the resource don't have it;
+// the later ones are still tried, in case it turns out to be unreadable
+bool ResourceManager::SkipSource(const SourceList& sources, size_t idx, int firstStatic) const
+{
+	if (sources[idx]->IsStatic() && (firstStatic < 0 || int(idx) < firstStatic)) {
+		return true;
+	}
+	indexCounters.probes.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+ResourceManager::IndexStats ResourceManager::GetIndexStats() const
+{
+	IndexStats stats;
+	stats.hits = indexCounters.hits.load(std::memory_order_relaxed);
+	stats.misses = indexCounters.misses.load(std::memory_order_relaxed);
+	stats.probes = indexCounters.probes.load(std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(sourcesMutex);
+	stats.entries = index.size();
+	return stats;
+}
+
+void ResourceManager::LogIndexStats() const
+{
+	IndexStats stats = GetIndexStats();
+	Log(DEBUG, "ResourceManager", "Index: {} entries, {} hits, {} misses, {} source probes",
+		stats.entries, stats.hits, stats.misses, stats.probes);
+}
+
+void ResourceManager::Prefetch(std::vector<PrefetchRequest> requests)
+{
+	prefetcher->Prefetch(std::move(requests));
+}
+
+ResourcePrefetcher::Stats ResourceManager::EndPrefetch()
+{
+	return prefetcher->Finish();
+}
+
 static void PrintPossibleFiles(std::string& buffer, StringView ResRef, const TypeID *type)
 {
 	const std::vector<ResourceDesc>& types = PluginMgr::Get()->GetResourceDesc(type);
@@ -60,9 +204,13 @@ bool ResourceManager::Exists(StringView ResRef, SClass_ID type, bool silent) con
 {
 	if (ResRef.empty())
 		return false;
-	// TODO: check various caches
-	for (const auto& path : searchPath) {
-		if (path->HasResource(ResRef, type)) {
+	Lookup lookup = FirstStaticSource(ResRef, core->TypeExt(type), type & 0xFFFF, [&](ResourceSource& src) {
+		return src.HasResource(ResRef, type);
+	});
+	const SourceList& sources = *lookup.sources;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		if (SkipSource(sources, i, lookup.firstStatic)) continue;
+		if (sources[i]->HasResource(ResRef, type)) {
 			return true;
 		}
 	}
@@ -77,11 +225,15 @@ bool ResourceManager::Exists(StringView ResRef, const TypeID *type, bool silent)
 {
 	if (ResRef[0] == '\0')
 		return false;
-	// TODO: check various caches
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
 	for (const auto& type2 : types) {
-		for (const auto& path : searchPath) {
-			if (path->HasResource(ResRef, type2)) {
+		Lookup lookup = FirstStaticSource(ResRef, type2.GetExt(), type2.GetKeyType(), [&](ResourceSource& src) {
+			return src.HasResource(ResRef, type2);
+		});
+		const SourceList& sources = *lookup.sources;
+		for (size_t i = 0; i < sources.size(); ++i) {
+			if (SkipSource(sources, i, lookup.firstStatic)) continue;
+			if (sources[i]->HasResource(ResRef, type2)) {
 				return true;
 			}
 		}
@@ -94,18 +246,41 @@ bool ResourceManager::Exists(StringView ResRef, const TypeID *type, bool silent)
 	return false;
 }
 
+DataStream* ResourceManager::FindResource(StringView ResRef, SClass_ID type, Sources& sources, size_t& source) const
+{
+	Lookup lookup = FirstStaticSource(ResRef, core->TypeExt(type), type & 0xFFFF, [&](ResourceSource& src) {
+		return src.HasResource(ResRef, type);
+	});
+	sources = lookup.sources;
+	for (source = 0; source < sources->size(); ++source) {
+		if (SkipSource(*sources, source, lookup.firstStatic)) continue;
+		DataStream *ds = (*sources)[source]->GetResource(ResRef, type);
+		if (ds) {
+			return ds;
+		}
+	}
+	return nullptr;
+}
+
 DataStream* ResourceManager::GetResource(StringView ResRef, SClass_ID type, bool silent) const
 {
 	if (ResRef.empty())
 		return nullptr;
-	for (const auto& path : searchPath) {
-		DataStream *ds = path->GetResource(ResRef, type);
-		if (ds) {
-			if (!silent) {
-				Log(MESSAGE, "ResourceManager", "Found '{}.{}' in '{}'.", ResRef, core->TypeExt(type), path->GetDescription());
-			}
-			return ds;
+	DataStream* prefetched = prefetcher->Take(ResRef, type);
+	if (prefetched) {
+		if (!silent) {
+			Log(MESSAGE, "ResourceManager", "Found '{}.{}' (prefetched).", ResRef, core->TypeExt(type));
+		}
+		return prefetched;
+	}
+	Sources sources;
+	size_t source;
+	DataStream *ds = FindResource(ResRef, type, sources, source);
+	if (ds) {
+		if (!silent) {
+			Log(MESSAGE, "ResourceManager", "Found '{}.{}' in '{}'.", ResRef, core->TypeExt(type), (*sources)[source]->GetDescription());
 		}
+		return ds;
 	}
 	if (!silent) {
 		Log(ERROR, "ResourceManager", "Couldn't find '{}.{}'.", ResRef, core->TypeExt(type));
@@ -122,7 +297,23 @@ Resource* ResourceManager::GetResource(StringView ResRef, const TypeID *type, bo
 	}
 	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
 	for (const auto& type2 : types) {
-		for (const auto& path : searchPath) {
+		DataStream* prefetched = prefetcher->Take(ResRef, type2.GetKeyType());
+		if (prefetched) {
+			Resource *res = type2.Create(prefetched);
+			if (res) {
+				if (!silent) {
+					Log(MESSAGE, "ResourceManager", "Found '{}.{}' (prefetched).", ResRef, type2.GetExt());
+				}
+				return res;
+			}
+		}
+		Lookup lookup = FirstStaticSource(ResRef, type2.GetExt(), type2.GetKeyType(), [&](ResourceSource& src) {
+			return src.HasResource(ResRef, type2);
+		});
+		const SourceList& sources = *lookup.sources;
+		for (size_t i = 0; i < sources.size(); ++i) {
+			if (SkipSource(sources, i, lookup.firstStatic)) continue;
+			const auto& path = sources[i];
 			DataStream *str = path->GetResource(ResRef, type2);
 			if (!str && useCorrupt && core->UseCorruptedHack) {
 				// don't look at other paths if requested
@@ -150,4 +341,31 @@ Resource* ResourceManager::GetResource(StringView ResRef, const TypeID *type, bo
 	return NULL;
 }
 
+Resource* ResourceManager::LoadResource(StringView ResRef, const TypeID *type) const
+{
+	if (ResRef.empty())
+		return nullptr;
+	const std::vector<ResourceDesc> &types = PluginMgr::Get()->GetResourceDesc(type);
+	for (const auto& type2 : types) {
+		DataStream* prefetched = prefetcher->Take(ResRef, type2.GetKeyType());
+		Resource *res = prefetched ? type2.Create(prefetched) : nullptr;
+		if (res) {
+			return res;
+		}
+		Lookup lookup = FirstStaticSource(ResRef, type2.GetExt(), type2.GetKeyType(), [&](ResourceSource& src) {
+			return src.HasResource(ResRef, type2);
+		});
+		const SourceList& sources = *lookup.sources;
+		for (size_t i = 0; i < sources.size(); ++i) {
+			if (SkipSource(sources, i, lookup.firstStatic)) continue;
+			DataStream *str = sources[i]->GetResource(ResRef, type2);
+			res = str ? type2.Create(str) : nullptr;
+			if (res) {
+				return res;
+			}
+		}
+	}
+	return nullptr;
+}
+
 }
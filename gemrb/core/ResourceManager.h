@@ -25,8 +25,15 @@
 
 #include "Holder.h"
 #include "Resource.h"
+#include "ResourcePrefetcher.h"
 #include "ResourceSource.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
@@ -38,6 +45,8 @@ class TypeID;
 
 class GEM_EXPORT ResourceManager {
 public:
+	ResourceManager();
+
 	/**
 	 * Add ResourceSource to search path
 	 * @param[in] path Path to be used for source.
@@ -46,6 +55,12 @@ public:
 	 * @param[in] type Plugin type used for source.
 	 **/
 	bool AddSource(const char *path, const char *description, PluginID type, int flags=0);
+	/**
+	 * Tells the source with this description that its directory changed, so
+	 * the listing is read again. If the name of the file is known, only it is
+	 * checked and the index only forgets about that resource.
+	 **/
+	void RefreshSource(const char* description, const char* fileName = nullptr);
 
 	/** returns true if resource exists */
 	bool Exists(StringView resRef, SClass_ID type, bool silent=false) const;
@@ -56,9 +71,80 @@ public:
 	DataStream* GetResource(StringView resname, SClass_ID type, bool silent = false) const;
 	/** Returns Resource object associated to given resource */
 	Resource* GetResource(StringView resname, const TypeID *type, bool silent = false, bool useCorrupt = false) const;
+	/** Quiet GetResource without the corrupted file workaround, for use off the main thread */
+	Resource* LoadResource(StringView resname, const TypeID *type) const;
+
+	/** Starts loading the resources in the background, GetResource hands them out once they're done */
+	void Prefetch(std::vector<PrefetchRequest> requests);
+	/** Drops the prefetched resources nobody asked for */
+	ResourcePrefetcher::Stats EndPrefetch();
+
+	struct IndexStats {
+		unsigned long hits = 0; // answered by the index
+		unsigned long misses = 0; // had to probe the static sources first
+		unsigned long probes = 0; // individual source lookups
+		size_t entries = 0;
+	};
+	IndexStats GetIndexStats() const;
+	void LogIndexStats() const;
 
 private:
-	std::vector<std::shared_ptr<ResourceSource> > searchPath;
+	using SourceList = std::vector<std::shared_ptr<ResourceSource>>;
+	using Sources = std::shared_ptr<const SourceList>;
+
+	// Sources that only change when told (the KEY file and cached
+	// directories, like the cache and save dirs) are only probed once per
+	// resource: the result is remembered as the position of the first one
+	// that has it (or -1). Plain directories are always probed.
+	// Resources with longer names or extensions aren't remembered.
+	struct IndexKey {
+		ResRef resRef;
+		FixedSizeString<4, strnicmp> ext;
+		ieWord keyType = 0; // differs for some synonyms (bs vs bcs)
+
+		bool operator==(const IndexKey& other) const
+		{
+			return keyType == other.keyType && resRef == other.resRef && ext == other.ext;
+		}
+	};
+	struct IndexKeyHash {
+		size_t operator()(const IndexKey& key) const
+		{
+			size_t hash = CstrHashCI<ResRef>()(key.resRef);
+			hash = (hash << 5) ^ CstrHashCI<FixedSizeString<4, strnicmp>>()(key.ext);
+			return (hash << 5) ^ key.keyType;
+		}
+	};
+
+	// the sources to look in and the first static one with the resource
+	struct Lookup {
+		Sources sources;
+		int firstStatic = -1;
+	};
+	Lookup FirstStaticSource(StringView resRef, const char* ext, ieWord keyType,
+		const std::function<bool(ResourceSource&)>& has) const;
+	bool SkipSource(const SourceList& sources, size_t idx, int firstStatic) const;
+	DataStream* FindResource(StringView resRef, SClass_ID type, Sources& sources, size_t& source) const;
+	// drops what the index knows about the sources from this position on
+	void InvalidateIndex(size_t firstChanged, const ResRef* resRef = nullptr) const;
+
+	// replaced as a whole when the sources change, so lookups on other
+	// threads can keep using the list they started with
+	Sources searchPath;
+	mutable std::unordered_map<IndexKey, int, IndexKeyHash> index;
+	mutable unsigned long indexRevision = 0; // bumped whenever entries get dropped
+	// bumped on every lookup, so they don't go through sourcesMutex
+	struct IndexCounters {
+		std::atomic<unsigned long> hits {0};
+		std::atomic<unsigned long> misses {0};
+		std::atomic<unsigned long> probes {0};
+	};
+	mutable IndexCounters indexCounters;
+	// guards searchPath and index
+	mutable std::mutex sourcesMutex;
+	// declared last, so the workers are gone before the sources they read from;
+	// created along with the manager and never replaced
+	std::unique_ptr<ResourcePrefetcher> prefetcher;
 };
 
 }
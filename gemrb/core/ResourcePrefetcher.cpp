@@ -0,0 +1,234 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "ResourcePrefetcher.h"
+
+#include "Logging/Logging.h"
+#include "Streams/MemoryStream.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+static const unsigned int MAX_PREFETCH_THREADS = 4;
+
+ResourcePrefetcher::ResourcePrefetcher(Loader load)
+: loader(std::move(load))
+{}
+
+ResourcePrefetcher::~ResourcePrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+		queue.clear();
+	}
+	queueCond.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	for (auto& job : jobs) {
+		delete job.second.stream;
+	}
+}
+
+std::string ResourcePrefetcher::Key(StringView resRef, SClass_ID type)
+{
+	std::string key(resRef.c_str(), resRef.length());
+	StringToLower(key);
+	// the word masking is the same synonym hack the sources use (bcs == bs)
+	key.append(fmt::format(".{:x}", type & 0xFFFF));
+	return key;
+}
+
+// called with the mutex held
+void ResourcePrefetcher::Enqueue(std::vector<PrefetchRequest>& requests)
+{
+	for (auto& request : requests) {
+		if (request.resRef.IsEmpty()) continue;
+		auto inserted = jobs.emplace(Key(request.resRef, request.type), Job());
+		if (!inserted.second) continue;
+		stats.requested++;
+		queue.push_back(std::move(request));
+	}
+}
+
+void ResourcePrefetcher::Prefetch(std::vector<PrefetchRequest> requests)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// most resource managers (eg. the ones of saved games) never prefetch,
+		// so the workers are only started once there is something to do
+		if (workers.empty()) {
+			unsigned int count = Clamp(std::thread::hardware_concurrency(), 1U, MAX_PREFETCH_THREADS);
+			for (unsigned int i = 0; i < count; ++i) {
+				workers.emplace_back(&ResourcePrefetcher::Work, this);
+			}
+		}
+		Enqueue(requests);
+	}
+	queueCond.notify_all();
+}
+
+// brings the whole resource into memory: mapped data just has its
+// pages touched, anything else is read into a buffer
+static DataStream* Preload(DataStream* ds)
+{
+	const MemoryStream* mem = dynamic_cast<const MemoryStream*>(ds);
+	if (mem) {
+		const char* data = mem->GetData();
+		volatile char touched = 0;
+		for (strpos_t pos = 0; pos < mem->Size(); pos += 4096) {
+			touched = data[pos];
+		}
+		(void) touched;
+		return ds;
+	}
+
+	strpos_t size = ds->Size();
+	void* buffer = malloc(size);
+	if (!buffer || ds->Read(buffer, size) != strret_t(size)) {
+		free(buffer);
+		ds->Rewind();
+		return ds;
+	}
+
+	MemoryStream* copy = new MemoryStream(ds->originalfile, buffer, size);
+	strlcpy(copy->filename, ds->filename, sizeof(copy->filename));
+	delete ds;
+	return copy;
+}
+
+void ResourcePrefetcher::Work()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		queueCond.wait(lock, [this]() { return !running || !queue.empty(); });
+		if (!running) break;
+
+		PrefetchRequest request = std::move(queue.front());
+		queue.pop_front();
+		std::string key = Key(request.resRef, request.type);
+		jobs[key].state = State::Loading;
+
+		lock.unlock();
+		DataStream* ds = loader(request.resRef, request.type);
+		std::vector<PrefetchRequest> more;
+		if (ds) {
+			ds = Preload(ds);
+			if (request.expand) {
+				more = request.expand(*ds);
+				ds->Rewind();
+			}
+		}
+		lock.lock();
+
+		auto it = jobs.find(key);
+		if (it->second.dropped) {
+			// Finish was called while we were loading
+			delete ds;
+			jobs.erase(it);
+			continue;
+		}
+		it->second.state = State::Done;
+		it->second.stream = ds;
+		if (ds) {
+			stats.loaded++;
+			stats.bytes += ds->Size();
+		}
+		Enqueue(more);
+		doneCond.notify_all();
+		if (!more.empty()) {
+			queueCond.notify_all();
+		}
+	}
+}
+
+DataStream* ResourcePrefetcher::Take(StringView resRef, SClass_ID type)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (jobs.empty()) {
+		return nullptr;
+	}
+
+	auto it = jobs.find(Key(resRef, type));
+	if (it == jobs.end() || it->second.dropped) {
+		return nullptr;
+	}
+
+	if (it->second.state == State::Queued) {
+		auto queued = std::find_if(queue.begin(), queue.end(), [&](const PrefetchRequest& request) {
+			return Key(request.resRef, request.type) == it->first;
+		});
+		if (!queued->expand) {
+			// not started yet, the caller is just as fast loading it directly
+			queue.erase(queued);
+			jobs.erase(it);
+			return nullptr;
+		}
+		// the expansion would be lost, so let the next worker do it right away
+		PrefetchRequest request = std::move(*queued);
+		queue.erase(queued);
+		queue.push_front(std::move(request));
+	}
+
+	if (it->second.state != State::Done) {
+		stats.waited++;
+		std::string key = it->first;
+		doneCond.wait(lock, [&]() {
+			it = jobs.find(key);
+			return it == jobs.end() || it->second.state == State::Done;
+		});
+		if (it == jobs.end() || it->second.dropped) {
+			return nullptr;
+		}
+	}
+
+	DataStream* ds = it->second.stream;
+	jobs.erase(it);
+	if (ds) {
+		stats.claimed++;
+	}
+	return ds;
+}
+
+ResourcePrefetcher::Stats ResourcePrefetcher::Finish()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	queue.clear();
+	for (auto it = jobs.begin(); it != jobs.end();) {
+		// the workers still own whatever they are loading
+		if (it->second.state == State::Loading) {
+			it->second.dropped = true;
+			++it;
+			continue;
+		}
+		if (it->second.stream) {
+			stats.wasted++;
+			delete it->second.stream;
+		}
+		it = jobs.erase(it);
+	}
+	Stats done = stats;
+	stats = Stats();
+	return done;
+}
+
+}
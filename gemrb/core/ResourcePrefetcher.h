@@ -0,0 +1,106 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef RESOURCEPREFETCHER_H
+#define RESOURCEPREFETCHER_H
+
+#include "exports.h"
+#include "SClassID.h"
+#include "globals.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace GemRB {
+
+class DataStream;
+
+struct GEM_EXPORT PrefetchRequest {
+	ResRef resRef;
+	SClass_ID type;
+	// optional: lists further resources found inside this one (eg. the tilesets of a wed)
+	std::function<std::vector<PrefetchRequest>(DataStream&)> expand;
+
+	PrefetchRequest(const ResRef& ref, SClass_ID t) noexcept : resRef(ref), type(t) {}
+};
+
+/**
+ * Reads resources into memory on a small pool of worker threads, so that
+ * the disk access and decompression overlap with the importers on the main
+ * thread. Only raw data is loaded: the caches and the video driver aren't
+ * safe to use from other threads, so decoding stays with the consumers.
+ * Finished streams wait in a completion table until Take claims them.
+ */
+class GEM_EXPORT ResourcePrefetcher {
+public:
+	using Loader = std::function<DataStream*(const ResRef&, SClass_ID)>;
+
+	struct Stats {
+		unsigned int requested = 0;
+		unsigned int loaded = 0;
+		unsigned int claimed = 0;
+		unsigned int waited = 0; // claims that had to wait for a worker
+		unsigned int wasted = 0; // loaded, but never claimed
+		size_t bytes = 0;
+	};
+
+	explicit ResourcePrefetcher(Loader loader);
+	ResourcePrefetcher(const ResourcePrefetcher&) = delete;
+	~ResourcePrefetcher();
+	ResourcePrefetcher& operator=(const ResourcePrefetcher&) = delete;
+
+	void Prefetch(std::vector<PrefetchRequest> requests);
+	/** Returns the prefetched stream (waiting for it if it's being loaded) or nullptr if there is none */
+	DataStream* Take(StringView resRef, SClass_ID type);
+	/** Drops the queue and all unclaimed streams, returning what was done since the last call */
+	Stats Finish();
+
+private:
+	enum class State { Queued, Loading, Done };
+	struct Job {
+		State state = State::Queued;
+		DataStream* stream = nullptr;
+		bool dropped = false; // abandoned while a worker was loading it
+	};
+
+	static std::string Key(StringView resRef, SClass_ID type);
+	void Work();
+	void Enqueue(std::vector<PrefetchRequest>& requests);
+
+	Loader loader;
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable queueCond;
+	std::condition_variable doneCond;
+	std::deque<PrefetchRequest> queue;
+	std::unordered_map<std::string, Job> jobs;
+	Stats stats;
+	bool running = true;
+};
+
+}
+
+#endif
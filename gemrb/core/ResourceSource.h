@@ -39,6 +39,10 @@ public:
 	virtual bool HasResource(StringView resname, const ResourceDesc &type) = 0;
 	virtual DataStream* GetResource(StringView resname, SClass_ID type) = 0;
 	virtual DataStream* GetResource(StringView resname, const ResourceDesc &type) = 0;
+	/** true if the contents only change on Refresh, so lookups may be indexed */
+	virtual bool IsStatic() const { return false; }
+	/** checks the named file again or, without a name, reads the whole listing again */
+	virtual void Refresh(const char* /*fileName*/) {}
 	const std::string& GetDescription() const { return description; }
 protected:
 	std::string description;
@@ -89,6 +89,8 @@ int32_t SaveGameAREExtractor::copyRetainedAREs(DataStream *destStream, bool trac
 }
 
 int32_t SaveGameAREExtractor::createCacheBlob() {
+	// copyRetainedAREs is also used by the save writer, don't race it
+	core->saveGameWriter.Wait();
 	if (areLocations.empty()) {
 		return 0;
 	}
@@ -110,6 +112,8 @@ int32_t SaveGameAREExtractor::createCacheBlob() {
 }
 
 int32_t SaveGameAREExtractor::extractARE(std::string key) {
+	// a pending save may be rewriting the running one or moving the locations
+	core->saveGameWriter.Wait();
 	StringToLower(key);
 	key.append(".are");
 
@@ -163,6 +167,7 @@ void SaveGameAREExtractor::registerLocation(std::string key, unsigned long pos)
 }
 
 void SaveGameAREExtractor::changeSaveGame(SaveGame* newSave) {
+	core->saveGameWriter.Wait();
 	if (saveGame != nullptr) {
 		saveGame->release();
 	}
@@ -110,7 +110,8 @@ SaveGame::SaveGame(std::string path, std::string name, const ResRef& prefix, std
 		strftime(nPath, _MAX_PATH, "%c", localtime(&my_stat.st_mtime));
 		Date = nPath;
 	}
-	manager.AddSource(Path.c_str(), Name.c_str(), PLUGIN_RESOURCE_DIRECTORY);
+	// the folder doesn't change anymore, since rescans wait for the writer
+	manager.AddSource(Path.c_str(), Name.c_str(), PLUGIN_RESOURCE_CACHEDDIRECTORY);
 }
 
 Holder<Sprite2D> SaveGame::GetPortrait(int index) const
@@ -248,6 +249,7 @@ bool SaveGameIterator::RescanSaveGames()
 {
 	// delete old entries
 	save_slots.clear();
+	core->saveGameWriter.Wait();
 
 	char Path[_MAX_PATH];
 	PathJoin(Path, core->config.SavePath, SaveDir().c_str(), nullptr);
@@ -377,11 +379,12 @@ void SaveGameIterator::PruneQuickSave(StringView folder) const
 static bool DoSaveGame(const char *Path, bool overrideRunning)
 {
 	const Game *game = core->GetGame();
-	//saving areas to cache currently in memory
+	//serializing the areas currently in memory
+	SaveGameWriter::Snapshot areas;
 	unsigned int mc = (unsigned int) game->GetLoadedMapCount();
 	while (mc--) {
 		Map *map = game->GetMap(mc);
-		if (core->SwapoutArea(map)) {
+		if (core->SwapoutArea(map, &areas)) {
 			return false;
 		}
 	}
@@ -390,7 +393,7 @@ static bool DoSaveGame(const char *Path, bool overrideRunning)
 
 	//compress files in cache named: .STO and .ARE
 	//no .CRE would be saved in cache
-	if (core->CompressSave(Path, overrideRunning)) {
+	if (core->CompressSave(Path, overrideRunning, std::move(areas))) {
 		return false;
 	}
 
@@ -553,6 +556,8 @@ static bool CreateSavePath(char *Path, int index, StringView slotname)
 
 int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 {
+	// the previous save may still be writing into the slots
+	core->saveGameWriter.Wait();
 	AutoTable tab = gamedata->LoadTable("savegame");
 	StringView slotname;
 	int qsave = 0;
@@ -613,6 +618,7 @@ int SaveGameIterator::CreateSaveGame(int index, bool mqs) const
 
 int SaveGameIterator::CreateSaveGame(Holder<SaveGame> save, StringView slotname, bool force) const
 {
+	core->saveGameWriter.Wait();
 	if (!slotname) {
 		return GEM_ERROR;
 	}
@@ -676,6 +682,7 @@ void SaveGameIterator::DeleteSaveGame(const Holder<SaveGame>& game) const
 		return;
 	}
 
+	core->saveGameWriter.Wait();
 	core->DelTree(game->GetPath().c_str(), false); //remove all files from folder
 	rmdir(game->GetPath().c_str());
 }
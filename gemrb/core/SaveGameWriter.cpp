@@ -0,0 +1,155 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SaveGameWriter.h"
+
+#include "strrefs.h"
+
+#include "ArchiveImporter.h"
+#include "DisplayMessage.h"
+#include "Interface.h"
+#include "PluginMgr.h"
+#include "Logging/Logging.h"
+#include "Streams/BufferStream.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace GemRB {
+
+static const unsigned int MAX_COMPRESSION_THREADS = 4;
+
+SaveGameWriter::~SaveGameWriter()
+{
+	// never drop a save half written
+	Wait();
+}
+
+void SaveGameWriter::Write(std::unique_ptr<DataStream> archive, Snapshot snapshot, bool copyRetainedAREs, const char* folder)
+{
+	Wait();
+	done = false;
+	failed = false;
+	entryCount = snapshot.size();
+	saveFolder = folder;
+	// the thread owns the archive and the snapshot from now on
+	writer = std::thread([this, copyRetainedAREs](std::unique_ptr<DataStream> sav, Snapshot entries) {
+		tick_t startTime = GetMilliseconds();
+		WriteArchive(sav.get(), entries, copyRetainedAREs);
+		sav.reset(); // closes the file
+		writeTime = GetMilliseconds() - startTime;
+		done = true;
+	}, std::move(archive), std::move(snapshot));
+}
+
+// runs on the writer thread, so no logging here (the message window isn't thread safe)
+void SaveGameWriter::WriteArchive(DataStream* archive, Snapshot& snapshot, bool copyRetainedAREs)
+{
+	// the retained areas come first, like they always did
+	if (copyRetainedAREs && core->saveGameAREExtractor.copyRetainedAREs(archive) == GEM_ERROR) {
+		failed = true;
+		return;
+	}
+
+	size_t count = snapshot.size();
+	std::vector<std::unique_ptr<BufferStream>> results(count);
+	std::vector<char> ready(count, 0);
+	size_t next = 0;
+	std::mutex mutex;
+	std::condition_variable readyCond;
+
+	auto compress = [&]() {
+		PluginHolder<ArchiveImporter> ai = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
+		std::unique_lock<std::mutex> lock(mutex);
+		while (next < count) {
+			size_t idx = next++;
+			lock.unlock();
+			BufferStream* result = nullptr;
+			DataStream* entry = snapshot[idx].stream.get();
+			if (!snapshot[idx].compressed) {
+				result = new BufferStream(entry->filename, entry->Size() / 2);
+				ai->AddToSaveGame(result, entry);
+			}
+			lock.lock();
+			results[idx].reset(result);
+			ready[idx] = 1;
+			readyCond.notify_all();
+		}
+	};
+
+	unsigned int threads = Clamp(std::thread::hardware_concurrency(), 1U, MAX_COMPRESSION_THREADS);
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < threads && i < count; ++i) {
+		workers.emplace_back(compress);
+	}
+
+	PluginHolder<ArchiveImporter> ai = MakePluginHolder<ArchiveImporter>(IE_SAV_CLASS_ID);
+	for (size_t idx = 0; idx < count; ++idx) {
+		std::unique_lock<std::mutex> lock(mutex);
+		readyCond.wait(lock, [&]() { return ready[idx] != 0; });
+		std::unique_ptr<BufferStream> result = std::move(results[idx]);
+		lock.unlock();
+
+		if (snapshot[idx].compressed) {
+			core->saveGameAREExtractor.updateSaveGame(archive->GetPos());
+			ai->AddToSaveGameCompressed(archive, snapshot[idx].stream.get());
+		} else if (archive->Write(result->GetData(), result->Size()) == DataStream::Error) {
+			failed = true;
+		}
+		// the entry is done, so free its memory right away
+		snapshot[idx].stream.reset();
+	}
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void SaveGameWriter::Join()
+{
+	writer.join();
+	Log(WARNING, "Core", "{} ms (compressing SAV file, {} entries)", writeTime, entryCount);
+	if (!failed) return;
+
+	// the game already said it saved, so take that back and don't
+	// leave a save behind that would fail to load
+	Log(ERROR, "SaveGameWriter", "Failed to write the SAV file, removing \"{}\"!", saveFolder);
+	if (displaymsg) {
+		displaymsg->DisplayConstantString(STR_CANTSAVE, GUIColors::XPCHANGE);
+	}
+	core->DelTree(saveFolder.c_str(), false);
+	rmdir(saveFolder.c_str());
+}
+
+void SaveGameWriter::Wait()
+{
+	if (writer.joinable()) {
+		Join();
+	}
+}
+
+void SaveGameWriter::Update()
+{
+	if (writer.joinable() && done) {
+		Join();
+	}
+}
+
+}
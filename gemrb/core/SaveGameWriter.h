@@ -0,0 +1,85 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SAVEGAMEWRITER_H
+#define SAVEGAMEWRITER_H
+
+#include "exports.h"
+#include "globals.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GemRB {
+
+class DataStream;
+
+/**
+ * Builds the SAV archive of a save game in the background. The main thread
+ * only takes a snapshot of the entries (the loaded areas are serialized
+ * straight into memory, the rest is read from the cache), then a small
+ * worker pool compresses them and a single writer thread appends them to
+ * the archive in their original order.
+ *
+ * Anything reading the save folders or the running save has to Wait first.
+ */
+class GEM_EXPORT SaveGameWriter {
+public:
+	struct Entry {
+		std::unique_ptr<DataStream> stream;
+		// already a complete archive entry (the retained areas blob), copied as is
+		bool compressed = false;
+
+		Entry(DataStream* str, bool comp) noexcept : stream(str), compressed(comp) {}
+	};
+	using Snapshot = std::vector<Entry>;
+
+	SaveGameWriter() noexcept = default;
+	SaveGameWriter(const SaveGameWriter&) = delete;
+	~SaveGameWriter();
+	SaveGameWriter& operator=(const SaveGameWriter&) = delete;
+
+	/** Completes the archive in the background, after any pending one;
+	 * if that fails, the save in folder is reported and removed */
+	void Write(std::unique_ptr<DataStream> archive, Snapshot snapshot, bool copyRetainedAREs, const char* folder);
+	/** Blocks until the pending archive is written */
+	void Wait();
+	/** Reaps a finished archive without blocking, once per frame */
+	void Update();
+
+private:
+	std::thread writer;
+	std::atomic<bool> done { false };
+	// results, only read after joining
+	bool failed = false;
+	size_t entryCount = 0;
+	tick_t writeTime = 0;
+	std::string saveFolder;
+
+	void WriteArchive(DataStream* archive, Snapshot& snapshot, bool copyRetainedAREs);
+	void Join();
+};
+
+}
+
+#endif
@@ -55,6 +55,7 @@
 #include "System/FileFilters.h"
 #include "StringMgr.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace GemRB {
@@ -493,6 +494,7 @@ void Actor::SetAnimationID(unsigned int AnimID)
 	} else {
 		BaseStats[IE_DONOTJUMP]=DNJ_BIRD;
 	}
+	statsDirty = true;
 	SetCircleSize();
 	anims->SetColors(&BaseStats[IE_COLORS]);
 
@@ -2556,6 +2558,8 @@ bool Actor::SetStat(unsigned int StatIndex, stat_t Value, int pcf)
 		return false;
 	}
 	Value = ClampStat(StatIndex, Value);
+	// effects set stats during refreshes too, which then clear this again
+	statsDirty = true;
 
 	unsigned int previous = GetSafeStat(StatIndex);
 	if (Modified[StatIndex]!=Value) {
@@ -2650,6 +2654,7 @@ void Actor::AddPortraitIcon(ieByte icon) const
 		return;
 	}
 	PCStats->EnableState(icon);
+	statsDirty = true;
 }
 
 void Actor::DisablePortraitIcon(ieByte icon) const
@@ -2658,6 +2663,7 @@ void Actor::DisablePortraitIcon(ieByte icon) const
 		return;
 	}
 	PCStats->DisableState(icon);
+	statsDirty = true;
 }
 
 
@@ -2897,10 +2903,80 @@ void Actor::RefreshEffects(bool first, const stats_t& previous)
 	}
 }
 
-void Actor::RefreshEffects()
+// a rebuild is deterministic while the effects, the base stats and the state
+// ResetStats clears are untouched, unless something in it depends on time
+bool Actor::CanSkipRefresh(ieDword gameTime) const
 {
+	if (!lastRefresh.valid || statsDirty || checkHP) {
+		return false;
+	}
+	if (fxqueue.GetRevision() != lastRefresh.fxRevision || !fxqueue.IsStableAt(gameTime)) {
+		return false;
+	}
+	if (gameTime >= lastRefresh.stableUntil) {
+		return false;
+	}
+	// new triggers still need to see the effects
+	for (const auto& trigger : triggers) {
+		if (!(trigger.flags & TEF_PROCESSED_EFFECTS)) {
+			return false;
+		}
+	}
+	// expired color mods still need to be cleared
+	return !anims || !anims->HasExpiredColorMod();
+}
+
+// when the parts of a refresh outside of the effects change with time alone
+ieDword Actor::NextTimedRefresh(ieDword gameTime) const
+{
+	// these depend on the ticks, another actor or a global
+	if (Immobile() || Modified[IE_PUPPETID] || (pstflags && Modified[IE_SEX] != BaseStats[IE_SEX])) {
+		return gameTime;
+	}
+	ieDword next = ieDword(-1);
+	if (!HasPlayerClass()) {
+		return next;
+	}
+
+	// morale recovery, constitution regeneration and fatigue in RefreshPCStats
+	ieDword mrec = GetStat(IE_MORALERECOVERYTIME);
+	if (mrec && BaseStats[IE_MORALE] != 10 && ShouldModifyMorale()) {
+		next = std::min(next, (gameTime / mrec + 1) * mrec);
+	}
+	ieDword rate = GetConHealAmount();
+	if (rate && BaseStats[IE_HITPOINTS] < Modified[IE_MAXHITPOINTS]) {
+		next = std::min(next, (gameTime / rate + 1) * rate);
+	}
+	if (InParty) {
+		ieDword period = ieDword(4 * core->Time.hour_size);
+		ieDword rested = ieDword(TicksLastRested);
+		next = std::min(next, rested + ((gameTime - rested) / period + 1) * period);
+	}
+	return next;
+}
+
+bool Actor::RefreshEffects()
+{
+	const Game* game = core->GetGame();
+	ieDword gameTime = game ? ieDword(game->GameTime) : 0;
+	Map* area = GetCurrentArea();
+
 	bool first = !(InternalFlags&IF_INITIALIZED); //initialize base stats
+	if (!first && CanSkipRefresh(gameTime)) {
+		if (area) area->CountRefresh(false);
+		return false;
+	}
+
+	if (area) area->CountRefresh(true);
+	// queue changes made by the rebuild itself warrant another one
+	lastRefresh.fxRevision = fxqueue.GetRevision();
 	RefreshEffects(first, ResetStats(first));
+
+	// but the stats it set are accounted for
+	statsDirty = false;
+	lastRefresh.valid = game != nullptr;
+	lastRefresh.stableUntil = NextTimedRefresh(gameTime);
+	return true;
 }
 
 int Actor::GetProficiency(int proftype) const
@@ -3993,6 +4069,7 @@ void Actor::Panic(const Scriptable *attacker, int panicmode)
 	case PANIC_BERSERK:
 		action = GenerateAction( "Berserk()" );
 		BaseStats[IE_CHECKFORBERSERK]=3;
+		statsDirty = true;
 		//SetBaseBit(IE_STATE_ID, STATE_BERSERK, true);
 		break;
 	default:
@@ -5134,6 +5211,7 @@ void Actor::Die(Scriptable *killer, bool grantXP)
 		SetStance(IE_ANI_DIE);
 	}
 	BaseStats[IE_GENERAL] = GEN_DEAD;
+	statsDirty = true;
 	AddTrigger(TriggerEntry(trigger_die));
 	SendDiedTrigger();
 	if (pstflags) {
@@ -6949,6 +7027,7 @@ void Actor::PerformAttack(ieDword gameTime)
 	ieDword state = GetStat(IE_STATE_ID);
 	if (state&STATE_BERSERK) {
 		BaseStats[IE_CHECKFORBERSERK]=3;
+		statsDirty = true;
 	}
 
 	Log(DEBUG, "Actor", "Performattack for {}, target is: {}", fmt::WideToChar{GetShortName()}, fmt::WideToChar{target->GetShortName()});
@@ -7459,6 +7538,7 @@ void Actor::UpdateModalState(ieDword gameTime)
 	if (!roundFraction) {
 		if (BaseStats[IE_CHECKFORBERSERK]) {
 			BaseStats[IE_CHECKFORBERSERK]--;
+			statsDirty = true;
 		}
 		if (state & STATE_CONFUSED) {
 			std::string actionString;
@@ -7620,6 +7700,7 @@ void Actor::SetColor( ieDword idx, ieDword grd)
 		value |= Modified[IE_COLORS+index] & ~(255<<shift);
 		Modified[IE_COLORS+index] = value;
 	}
+	statsDirty = true;
 }
 
 void Actor::SetColorMod(ieDword location, RGBModifier::Type type, int speed,
@@ -7816,7 +7897,7 @@ void Actor::NewPath()
 		return;
 	}
 	WalkTo(savedDest, InternalFlags, pathfindingDistance);
-	if (!GetPath()) {
+	if (GetPath().empty()) {
 		IncrementPathTries();
 	}
 }
@@ -9645,6 +9726,7 @@ void Actor::SetGradient(ieDword gradient)
 	for(int i=0;i<7;i++) {
 		Modified[IE_COLORS+i]=gradient;
 	}
+	statsDirty = true;
 }
 
 //sets one bit of the sanctuary stat (used for overlays)
@@ -9663,6 +9745,7 @@ bool Actor::SetSpellState(unsigned int spellstate) const
 	unsigned int bit = 1 << (spellstate & 31);
 	if (spellStates[pos] & bit) return true;
 	spellStates[pos] |= bit;
+	statsDirty = true;
 	return false;
 }
 
@@ -9762,6 +9845,7 @@ ieDword Actor::ImmuneToProjectile(ieDword projectile) const
 void Actor::AddProjectileImmunity(ieDword projectile) const
 {
 	projectileImmunity[projectile/32]|=1<<(projectile&31);
+	statsDirty = true;
 }
 
 //2nd edition rules
@@ -9887,6 +9971,7 @@ void Actor::ResetMC()
 void Actor::CreateDerivedStats()
 {
 	ResetMC();
+	statsDirty = true;
 
 	if (third) {
 		CreateDerivedStatsIWD2();
@@ -433,6 +433,15 @@ private:
 	tick_t remainingTalkSoundTime = 0;
 	tick_t lastTalkTimeCheckAt = 0;
 	ieDword lastScriptCheck = 0;
+	/** change tracking for skipping stat refreshes, see CanSkipRefresh */
+	struct {
+		bool valid = false;
+		ieDword fxRevision = 0;
+		// game time when the time driven parts outside of the effects change
+		ieDword stableUntil = 0;
+	} lastRefresh;
+	// base stats or the state ResetStats clears changed since the last refresh
+	mutable bool statsDirty = true;
 	/** paint the actor itself. Called internally by Draw() */
 	void DrawActorSprite(const Point& p, BlitFlags flags,
 						 const std::vector<AnimationPart>& anims, const Color& tint) const;
@@ -481,6 +490,9 @@ private:
 	stats_t ResetStats(bool init);
 	void RefreshEffects(bool init, const stats_t& prev);
 
+	bool CanSkipRefresh(ieDword gameTime) const;
+	ieDword NextTimedRefresh(ieDword gameTime) const;
+
 public:
 	Actor(void);
 	Actor(const Actor&) = delete;
@@ -508,8 +520,10 @@ public:
 	ieDword GetCGGender() const;
 	/** some hardcoded effects in puppetmaster based on puppet type */
 	void CheckPuppet(Actor *puppet, ieDword type);
-	/** Re/Inits the Modified vector */
-	void RefreshEffects();
+	/** Re/Inits the Modified vector, returns false if nothing changed and the previous result was kept */
+	bool RefreshEffects();
+	/** Forces the next RefreshEffects to rebuild the stats */
+	void MarkStatsDirty() const { statsDirty = true; }
 	void AddEffects(EffectQueue&& eqfx);
 	/** gets saving throws */
 	void RollSaves();
@@ -102,6 +102,7 @@ void ArmorClass::RefreshTotal()
 	// add a maximum_values[IE_ARMORCLASS] check here if needed
 	if (Owner) { // not true for a short while during init, but we make amends immediately
 		Owner->Modified[IE_ARMORCLASS] = total;
+		Owner->MarkStatsDirty();
 	}
 }
 
@@ -219,6 +220,7 @@ void ToHitStats::RefreshTotal()
 	total = base + proficiencyBonus + armorBonus + shieldBonus + abilityBonus + weaponBonus + genericBonus + fxBonus;
 	if (Owner) { // not true for a short while during init, but we make amends immediately
 		Owner->Modified[IE_TOHIT] = total;
+		Owner->MarkStatsDirty();
 	}
 }
 
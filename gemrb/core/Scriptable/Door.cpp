@@ -72,6 +72,7 @@ void Door::ImpedeBlocks(const std::vector<Point> &points, PathMapFlags value) co
 		PathMapFlags tmp = area->tileProps.QuerySearchMap(point) & PathMapFlags::NOTDOOR;
 		area->tileProps.SetSearchMap(point, tmp|value);
 	}
+	area->InvalidateSearchMap();
 }
 
 void Door::UpdateDoor()
@@ -81,8 +82,7 @@ void Door::UpdateDoor()
 
 	if (outline) {
 		// update the Scriptable position
-		Pos.x = outline->BBox.x + outline->BBox.w/2;
-		Pos.y = outline->BBox.y + outline->BBox.h/2;
+		SetPos(Point(outline->BBox.x + outline->BBox.w / 2, outline->BBox.y + outline->BBox.h / 2));
 	}
 
 	PathMapFlags pmdflags;
@@ -125,6 +125,15 @@ void Scriptable::SetMap(Map *map)
 	area = map;
 }
 
+void Scriptable::SetPos(const Point& pos)
+{
+	Pos = pos;
+	// keep the area's actor index in step, it has no other way to notice
+	if (area) {
+		area->UpdateActorIndex(As<Actor>());
+	}
+}
+
 //ai is nonzero if this is an actor currently in the party
 //if the script level is AI_SCRIPT_LEVEL, then we need to
 //load an AI script (.bs) instead of (.bcs)
@@ -1743,6 +1752,10 @@ void Selectable::Select(int Value)
 void Selectable::SetCircle(int circlesize, float factor, const Color &color, Holder<Sprite2D> normal_circle, Holder<Sprite2D> selected_circle)
 {
 	circleSize = circlesize;
+	// the index pads its lookups by the largest circle
+	if (area) {
+		area->UpdateActorIndex(As<Actor>());
+	}
 	sizeFactor = factor;
 	selectedColor = color;
 	overColor.r = color.r >> 1;
@@ -1884,46 +1897,41 @@ bool Highlightable::PossibleToSeeTrap() const
 
 Movable::~Movable(void)
 {
-	if (path) {
+	if (!path.empty()) {
 		ClearPath(true);
 	}
 }
 
 int Movable::GetPathLength() const
 {
-	const PathListNode *node = GetNextStep(0);
+	const PathNode *node = GetNextStep(0);
 	if (!node) return 0;
 
-	int i = 0;
-	while (node->Next) {
-		i++;
-		node = node->Next;
-	}
-	return i;
+	return int(path.size() - stepIdx - 1);
 }
 
-PathListNode *Movable::GetNextStep(int x) const
+const PathNode *Movable::GetNextStep(int x) const
 {
-	if (!step) {
+	if (!pathStarted) {
 		error("GetNextStep", "Hit with step = null");
 	}
-	PathListNode *node = step;
-	while(node && x--) {
-		node = node->Next;
+	size_t idx = stepIdx + x;
+	if (idx >= path.size()) {
+		return nullptr;
 	}
-	return node;
+	return &path[idx];
 }
 
 Point Movable::GetMostLikelyPosition() const
 {
-	if (!path) {
+	if (path.empty()) {
 		return Pos;
 	}
 
 //actually, sometimes middle path would be better, if
 //we stand in Destination already
 	int halfway = GetPathLength()/2;
-	const PathListNode *node = GetNextStep(halfway);
+	const PathNode *node = GetNextStep(halfway);
 	if (node) {
 		return Map::ConvertCoordFromTile(node->point) + Point(8, 6);
 	}
@@ -1997,11 +2005,12 @@ void Movable::SetAttackMoveChances(const ieWord *amc)
 //this could be used for WingBuffet as well
 void Movable::MoveLine(int steps, orient_t orient)
 {
-	if (path || !steps) {
+	if (!path.empty() || !steps) {
 		return;
 	}
 	// DoStep takes care of stopping on walls if necessary
 	path = area->GetLine(Pos, steps, orient);
+	pathStarted = false;
 }
 
 orient_t Movable::GetNextFace() const
@@ -2031,7 +2040,9 @@ void Movable::BumpAway()
 	if (!IsBumped()) oldPos = Pos;
 	bumped = true;
 	bumpBackTries = 0;
-	area->AdjustPositionNavmap(Pos);
+	Point goal = Pos;
+	area->AdjustPositionNavmap(goal);
+	SetPos(goal);
 }
 
 void Movable::BumpBack()
@@ -2076,7 +2087,7 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 	const Actor* actor = Scriptable::As<Actor>(this);
 	// Only bump back if not moving
 	// Actors can be bumped while moving if they are backing off
-	if (!path) {
+	if (path.empty()) {
 		if (IsBumped()) {
 			BumpBack();
 		}
@@ -2089,13 +2100,16 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 		timeStartStep = time;
 		return;
 	}
-	if (!step) {
-		step = path;
+	if (!pathStarted) {
+		stepIdx = 0;
+		pathStarted = true;
 		timeStartStep = time;
 		return;
 	}
 
-	Point nmptStep = step->point;
+	const PathNode& step = path[stepIdx];
+	bool lastStep = stepIdx + 1 == path.size();
+	Point nmptStep = step.point;
 	double dx = nmptStep.x - Pos.x;
 	double dy = nmptStep.y - Pos.y;
 	Map::NormalizeDeltas(dx, dy, double(gamedata->GetStepTime()) / double(walkScale));
@@ -2113,7 +2127,7 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 
 		if (BlocksSearchMap() && actorInTheWay && actorInTheWay != this && actorInTheWay->BlocksSearchMap()) {
 			// Give up instead of bumping if you are close to the goal
-			if (!(step->Next) && PersonalDistance(nmptStep, this) < MAX_OPERATING_DISTANCE) {
+			if (lastStep && PersonalDistance(nmptStep, this) < MAX_OPERATING_DISTANCE) {
 				ClearPath(true);
 				NewOrientation = Orientation;
 				// Do not call ReleaseCurrentAction() since other actions
@@ -2142,19 +2156,18 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 		if (InternalFlags & IF_RUNNING) {
 			StanceID = IE_ANI_RUN;
 		}
-		Pos.x += dx;
-		Pos.y += dy;
+		SetPos(Pos + Point(dx, dy));
 		oldPos = Pos;
 		if (actor && BlocksSearchMap()) {
 			auto flag = actor->IsPartyMember() ? PathMapFlags::PC : PathMapFlags::NPC;
 			area->tileProps.BlockSearchMap(Map::ConvertCoordToTile(Pos), circleSize, flag);
 		}
 
-		SetOrientation(step->orient, false);
+		SetOrientation(step.orient, false);
 		timeStartStep = time;
 		if (Pos == nmptStep) {
-			if (step->Next) {
-				step = step->Next;
+			if (!lastStep) {
+				stepIdx++;
 			} else {
 				ClearPath(true);
 				NewOrientation = Orientation;
@@ -2166,36 +2179,30 @@ void Movable::DoStep(unsigned int walkScale, ieDword time) {
 
 void Movable::AdjustPosition()
 {
-	area->AdjustPosition(Pos);
+	Point goal = Pos;
+	area->AdjustPosition(goal);
+	SetPos(goal);
 	ImpedeBumping();
 }
 
 void Movable::AddWayPoint(const Point &Des)
 {
-	if (!path) {
+	if (path.empty()) {
 		WalkTo(Des);
 		return;
 	}
 	Destination = Des;
-	//it is tempting to use 'step' here, as it could
-	//be about half of the current path already
-	PathListNode *endNode = path;
-	while(endNode->Next) {
-		endNode = endNode->Next;
-	}
-	Point p = endNode->point;
+	Point p = path.back().point;
 	area->ClearSearchMapFor(this);
-	PathListNode* path2 = area->FindPath(p, Des, circleSize);
+	Path path2 = area->FindPath(p, Des, circleSize);
 	// if the waypoint is too close to the current position, no path is generated
-	if (!path2) {
+	if (path2.empty()) {
 		if (BlocksSearchMap()) {
 			area->BlockSearchMapFor(this);
 		}
 		return;
 	}
-	endNode->Next = path2;
-	//probably it is wise to connect it both ways?
-	path2->Parent = endNode;
+	path.insert(path.end(), path2.begin(), path2.end());
 }
 
 // This function is called at each tick if an actor is following another actor
@@ -2203,7 +2210,7 @@ void Movable::AddWayPoint(const Point &Des)
 void Movable::WalkTo(const Point &Des, int distance)
 {
 	// Only rate-limit when moving
-	if ((GetPath() || InMove()) && prevTicks && Ticks < prevTicks + 2) {
+	if ((!path.empty() || InMove()) && prevTicks && Ticks < prevTicks + 2) {
 		return;
 	}
 
@@ -2223,16 +2230,17 @@ void Movable::WalkTo(const Point &Des, int distance)
 	}
 
 	if (BlocksSearchMap()) area->ClearSearchMapFor(this);
-	PathListNode* newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT | PF_ACTORS_ARE_BLOCKING, actor);
-	if (!newPath && actor && actor->ValidTarget(GA_CAN_BUMP)) {
+	Path newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT | PF_ACTORS_ARE_BLOCKING, actor);
+	if (newPath.empty() && actor && actor->ValidTarget(GA_CAN_BUMP)) {
 		Log(DEBUG, "WalkTo", "{} re-pathing ignoring actors", fmt::WideToChar{actor->GetShortName()});
 		newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT, actor);
 	}
 
-	if (newPath) {
+	if (!newPath.empty()) {
 		ClearPath(false);
-		path = newPath;
-		step = path;
+		path = std::move(newPath);
+		stepIdx = 0;
+		pathStarted = true;
 		HandleAnkhegStance(false);
 	}  else {
 		pathfindingDistance = std::max(circleSize, distance);
@@ -2247,12 +2255,13 @@ void Movable::RunAwayFrom(const Point &Source, int PathLength, bool noBackAway)
 	ClearPath(true);
 	area->ClearSearchMapFor(this);
 	path = area->RunAway(Pos, Source, circleSize, PathLength, !noBackAway, As<Actor>());
+	pathStarted = false;
 	HandleAnkhegStance(false);
 }
 
 void Movable::RandomWalk(bool can_stop, bool run)
 {
-	if (path) {
+	if (!path.empty()) {
 		return;
 	}
 	//if not continous random walk, then stops for a while
@@ -2308,11 +2317,12 @@ void Movable::RandomWalk(bool can_stop, bool run)
 	//the 5th parameter is controlling the orientation of the actor
 	//0 - back away, 1 - face direction
 	path = area->RandomWalk(Pos, circleSize, maxWalkDistance ? maxWalkDistance : 5, As<Actor>());
+	pathStarted = false;
 	if (BlocksSearchMap()) {
 		area->BlockSearchMapFor(this);
 	}
-	if (path) {
-		Destination = path->point;
+	if (!path.empty()) {
+		Destination = path.front().point;
 	} else {
 		randomWalkCounter = 0;
 		WalkTo(HomeLocation);
@@ -2324,7 +2334,7 @@ void Movable::RandomWalk(bool can_stop, bool run)
 void Movable::MoveTo(const Point &Des)
 {
 	area->ClearSearchMapFor(this);
-	Pos = Des;
+	SetPos(Des);
 	oldPos = Des;
 	Destination = Des;
 	if (BlocksSearchMap()) {
@@ -2354,14 +2364,9 @@ void Movable::ClearPath(bool resetDestination)
 		HandleAnkhegStance(true);
 		InternalFlags &= ~IF_NORETICLE;
 	}
-	PathListNode* thisNode = path;
-	while (thisNode) {
-		PathListNode* nextNode = thisNode->Next;
-		delete thisNode;
-		thisNode = nextNode;
-	}
-	path = nullptr;
-	step = nullptr;
+	path.clear();
+	stepIdx = 0;
+	pathStarted = false;
 	//don't call ReleaseCurrentAction
 }
 
@@ -2370,7 +2375,7 @@ void Movable::HandleAnkhegStance(bool emerge)
 {
 	const Actor* actor = As<Actor>();
 	int nextStance = emerge ? IE_ANI_EMERGE : IE_ANI_HIDE;
-	if (actor && path && StanceID != nextStance && actor->GetAnims()->GetAnimType() == IE_ANI_TWO_PIECE) {
+	if (actor && !path.empty() && StanceID != nextStance && actor->GetAnims()->GetAnimType() == IE_ANI_TWO_PIECE) {
 		SetStance(nextStance);
 		SetWait(15); // both stances have 15 frames, at 15 fps
 	}
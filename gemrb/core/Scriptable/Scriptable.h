@@ -25,6 +25,7 @@
 #include "ie_cursors.h"
 
 #include "CharAnimations.h"
+#include "PathFinder.h"
 #include "Variables.h"
 
 #include <list>
@@ -44,7 +45,6 @@ class InfoPoint;
 class Map;
 class Movable;
 class Object;
-struct PathListNode;
 class Projectile;
 class Scriptable;
 class Selectable;
@@ -273,6 +273,7 @@ public:
 
 	Variables* locals;
 	ScriptableType Type = ST_ACTOR;
+	// only ever changed through SetPos, which the area's actor index relies on
 	Point Pos;
 
 	ieStrRef DialogName = ieStrRef::INVALID;
@@ -355,6 +356,7 @@ public:
 	const ieVariable& GetScriptName() const;
 	Map* GetCurrentArea() const;
 	void SetMap(Map *map);
+	void SetPos(const Point& pos);
 	void SetOverheadText(String text, bool display = true);
 	const String& GetOverheadText() const { return OverheadText; };
 	bool DisplayOverheadText(bool);
@@ -487,8 +489,9 @@ private: //these seem to be sensitive, so get protection
 	orient_t NewOrientation = S;
 	ieWord AttackMovements[3] = { 100, 0 , 0 };
 
-	PathListNode* path = nullptr; // whole path
-	PathListNode* step = nullptr; // actual step
+	Path path; // whole path
+	size_t stepIdx = 0; // actual step in path
+	bool pathStarted = false; // stepIdx is only valid once we started walking the path
 	unsigned int prevTicks = 0;
 	int bumpBackTries = 0;
 	bool pathAbandoned = false;
@@ -526,18 +529,18 @@ public:
 	void BumpAway();
 	void BumpBack();
 	inline bool IsBumped() const { return bumped; }
-	PathListNode *GetNextStep(int x) const;
-	inline PathListNode *GetPath() const { return path; };
+	const PathNode *GetNextStep(int x) const;
+	inline const Path& GetPath() const { return path; };
 	inline int GetPathTries() const	{ return pathTries; }
 	inline void IncrementPathTries() { pathTries++; }
 	inline void ResetPathTries() { pathTries = 0; }
 	int GetPathLength() const;
 //inliners to protect data consistency
-	inline PathListNode * GetStep() {
-		if (!step) {
+	inline const PathNode *GetStep() {
+		if (!pathStarted) {
 			DoStep((unsigned int) ~0);
 		}
-		return step;
+		return pathStarted ? &path[stepIdx] : nullptr;
 	}
 
 	inline bool IsMoving() const {
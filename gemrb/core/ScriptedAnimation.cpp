@@ -281,6 +281,12 @@ ScriptedAnimation::ScriptedAnimation(DataStream* stream)
 		sounds[P_ONSET].Reset();
 	}
 
+	// get the sounds decoding while the animation is set up
+	Audio* audio = core->GetAudioDrv();
+	if (audio) {
+		audio->Preload({ sounds[P_ONSET], sounds[P_HOLD], sounds[P_RELEASE] });
+	}
+
 	if (SequenceFlags & IE_VVC_BAM) {
 		const AnimationFactory* af = static_cast<const AnimationFactory*>(
 			gamedata->GetFactoryResource(Anim1ResRef, IE_BAM_CLASS_ID));
@@ -79,6 +79,18 @@ Sprite2D::~Sprite2D() noexcept
 	}
 }
 
+Holder<Sprite2D> Sprite2D::copy() const
+{
+	Holder<Sprite2D> spr = MakeHolder<Sprite2D>(*this);
+	if (!freePixels && pixelOwner) {
+		// a copy of a copy only needs the real owner
+		spr->pixelOwner = pixelOwner;
+	} else if (pixels) {
+		spr->pixelOwner = Holder<Sprite2D>(const_cast<Sprite2D*>(this));
+	}
+	return spr;
+}
+
 Color Sprite2D::GetPixel(const Point& p) const noexcept
 {
 	if (Region(0, 0, Frame.w, Frame.h).PointInside(p)) {
@@ -86,6 +86,9 @@ public:
 protected:
 	void* pixels = nullptr;
 	bool freePixels = true;
+	// shallow copies share the pixels of this sprite, so they keep it alive
+	// (which also keeps the factories from evicting it while a copy is in use)
+	Holder<Sprite2D> pixelOwner;
 	
 	PixelFormat format;
 	uint16_t pitch;
@@ -103,7 +106,7 @@ public:
 	Sprite2D(Sprite2D&&) noexcept;
 	~Sprite2D() noexcept override;
 
-	virtual Holder<Sprite2D> copy() const { return MakeHolder<Sprite2D>(*this); };
+	virtual Holder<Sprite2D> copy() const;
 
 	virtual bool HasTransparency() const noexcept;
 	bool IsPixelTransparent(const Point& p) const noexcept;
@@ -0,0 +1,92 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "BufferStream.h"
+
+#include "Logging/Logging.h"
+#include "System/VFS.h"
+
+#include <cstring>
+
+namespace GemRB {
+
+BufferStream::BufferStream(const char* name, strpos_t reserve)
+{
+	buffer.reserve(reserve);
+	ExtractFileFromPath(filename, name);
+	strlcpy(originalfile, name, _MAX_PATH);
+}
+
+DataStream* BufferStream::Clone() const noexcept
+{
+	BufferStream* copy = new BufferStream(originalfile);
+	copy->buffer = buffer;
+	copy->size = size;
+	return copy;
+}
+
+strret_t BufferStream::Read(void* dest, strpos_t length)
+{
+	if (Pos + length > size) {
+		return Error;
+	}
+
+	memcpy(dest, buffer.data() + Pos, length);
+	Pos += length;
+	return length;
+}
+
+strret_t BufferStream::Write(const void* src, strpos_t length)
+{
+	if (Pos + length > buffer.size()) {
+		buffer.resize(Pos + length);
+		size = buffer.size();
+	}
+	memcpy(buffer.data() + Pos, src, length);
+	Pos += length;
+	return length;
+}
+
+stroff_t BufferStream::Seek(stroff_t newpos, strpos_t type)
+{
+	switch (type) {
+		case GEM_CURRENT_POS:
+			Pos += newpos;
+			break;
+
+		case GEM_STREAM_START:
+			Pos = newpos;
+			break;
+
+		case GEM_STREAM_END:
+			Pos = size - newpos;
+			break;
+
+		default:
+			return InvalidPos;
+	}
+	if (Pos > size) {
+		Log(ERROR, "Streams", "Invalid seek position: {} (limit: {})", Pos, size);
+		return InvalidPos;
+	}
+	return 0;
+}
+
+}
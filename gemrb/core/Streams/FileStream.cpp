@@ -20,6 +20,7 @@
 
 #include "FileStream.h"
 
+#include "GameData.h"
 #include "Interface.h"
 
 namespace GemRB {
@@ -110,6 +111,22 @@ bool FileStream::Create(const char *folder, const char* fname, SClass_ID ClassID
 	return Create(path);
 }
 
+// the cache source keeps a listing, so it has to hear about new files
+static void NoteCacheFile(const char* path)
+{
+	if (!gamedata) return;
+
+	const char* cachePath = core->config.CachePath;
+	size_t length = strlen(cachePath);
+	if (strncmp(path, cachePath, length) != 0) return;
+	if (length && cachePath[length - 1] != PathDelimiter) {
+		if (path[length] != PathDelimiter) return;
+		length++;
+	}
+	if (strchr(path + length, PathDelimiter)) return;
+	gamedata->RefreshSource("Cache", path + length);
+}
+
 //Creating file outside of the cache
 bool FileStream::Create(const char *path)
 {
@@ -125,6 +142,7 @@ bool FileStream::Create(const char *path)
 	created = true;
 	Pos = 0;
 	size = 0;
+	NoteCacheFile(originalfile);
 	return true;
 }
 
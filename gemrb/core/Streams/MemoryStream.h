@@ -39,6 +39,9 @@ public:
 	strret_t Read(void* dest, strpos_t length) override;
 	strret_t Write(const void* src, strpos_t length) override;
 	strret_t Seek(stroff_t pos, strpos_t startpos) override;
+
+	/** the backing buffer, for read-only views into it */
+	const char* GetData() const { return data; }
 };
 
 }
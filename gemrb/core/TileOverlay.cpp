@@ -24,6 +24,8 @@
 #include "GlobalTimer.h"
 #include "Interface.h"
 
+#include <algorithm>
+
 namespace GemRB {
 
 TileOverlay::TileOverlay(Size size) noexcept
@@ -35,13 +37,114 @@ void TileOverlay::AddTile(Tile&& tile)
 	tiles.push_back(std::move(tile));
 }
 
+// animated tiles and the ones with water (or whatever) are drawn every frame
+bool TileOverlay::IsAnimated(const Tile& tile)
+{
+	return tile.om || tile.GetAnimation()->GetFrameCount() > 1;
+}
+
+// renders the static tiles of tileRgn (in tiles) into the chunk buffer
+bool TileOverlay::ComposeChunk(Chunk& chunk, const Region& tileRgn) const
+{
+	Video* vid = core->GetVideoDriver();
+	if (!chunk.buffer) {
+		chunk.buffer = vid->CreateBuffer(Region(0, 0, tileRgn.w * 64, tileRgn.h * 64), Video::BufferFormat::DISPLAY);
+		if (!chunk.buffer) {
+			return false;
+		}
+	}
+
+	chunk.buffer->Clear();
+	chunk.tileIndices.clear();
+	Region clip = vid->GetScreenClip();
+	vid->PushDrawingBuffer(chunk.buffer);
+	vid->SetScreenClip(nullptr);
+	for (int y = tileRgn.y; y < tileRgn.y + tileRgn.h; ++y) {
+		for (int x = tileRgn.x; x < tileRgn.x + tileRgn.w; ++x) {
+			const Tile& tile = tiles[(y * size.w) + x];
+			chunk.tileIndices.push_back(tile.tileIndex);
+			if (IsAnimated(tile)) continue;
+
+			Point p((x - tileRgn.x) * 64, (y - tileRgn.y) * 64);
+			vid->BlitGameSprite(tile.GetAnimation()->NextFrame(), p, BlitFlags::NONE);
+		}
+	}
+	vid->PopDrawingBuffer();
+	vid->SetScreenClip(&clip);
+	return true;
+}
+
+// frees the buffers of all but the 'keep' most recently drawn chunks
+void TileOverlay::EvictChunks(size_t keep) const
+{
+	std::vector<Chunk*> composed;
+	for (auto& chunk : chunks) {
+		if (chunk.buffer) composed.push_back(&chunk);
+	}
+	if (composed.size() <= keep) return;
+
+	auto oldest = composed.end() - keep;
+	std::nth_element(composed.begin(), oldest, composed.end(), [](const Chunk* a, const Chunk* b) {
+		return a->lastDrawn < b->lastDrawn;
+	});
+	for (auto it = composed.begin(); it != oldest; ++it) {
+		(*it)->buffer = nullptr;
+		(*it)->tileIndices.clear();
+	}
+}
+
+void TileOverlay::DrawTile(const Tile& tile, const Point& p, const std::vector<TileOverlayPtr>& overlays,
+						   BlitFlags flags, const Color& tintcol) const
+{
+	Video* vid = core->GetVideoDriver();
+
+	//draw door tiles if there are any
+	Animation* anim = tile.GetAnimation();
+	assert(anim);
+
+	// this is the base terrain tile
+	vid->BlitGameSprite(anim->NextFrame(), p, flags, tintcol);
+
+	if (!tile.om || tile.tileIndex) {
+		return;
+	}
+
+	int mask = 2;
+	for (size_t z = 1; z < overlays.size(); ++z) {
+		const auto& ov = overlays[z];
+		if (ov && !ov->tiles.empty()) {
+			const Tile &ovtile = ov->tiles[0]; //allow only 1x1 tiles now
+			if (tile.om & mask) {
+				//draw overlay tiles, they should be half transparent except for BG1
+				BlitFlags transFlag = (core->HasFeature(GF_LAYERED_WATER_TILES)) ? BlitFlags::HALFTRANS : BlitFlags::NONE;
+				// this is the water (or whatever)
+				vid->BlitGameSprite(ovtile.GetAnimation(0)->NextFrame(), p, flags | transFlag, tintcol);
+
+				if (core->HasFeature(GF_LAYERED_WATER_TILES)) {
+					Animation* anim1 = tile.GetAnimation(1);
+					if (anim1) {
+						// this is the mask to blend the terrain tile with the water for everything but BG1
+						vid->BlitGameSprite(anim1->NextFrame(), p,
+											flags | BlitFlags::BLENDED, tintcol);
+					}
+				} else {
+					// in BG 1 this is the mask to blend the terrain tile with the water
+					vid->BlitGameSprite(tile.GetAnimation(0)->NextFrame(), p,
+										flags | BlitFlags::BLENDED, tintcol);
+				}
+			}
+		}
+		mask<<=1;
+	}
+}
+
 void TileOverlay::Draw(const Region& viewport, std::vector<TileOverlayPtr> &overlays, BlitFlags flags) const
 {
 	// determine which tiles are visible
 	int sx = std::max(viewport.x / 64, 0);
 	int sy = std::max(viewport.y / 64, 0);
-	int dx = ( std::max(viewport.x, 0) + viewport.w + 63 ) / 64;
-	int dy = ( std::max(viewport.y, 0) + viewport.h + 63 ) / 64;
+	int dx = std::min(( std::max(viewport.x, 0) + viewport.w + 63 ) / 64, size.w);
+	int dy = std::min(( std::max(viewport.y, 0) + viewport.h + 63 ) / 64, size.h);
 
 	const Game* game = core->GetGame();
 	assert(game);
@@ -51,52 +154,72 @@ void TileOverlay::Draw(const Region& viewport, std::vector<TileOverlayPtr> &over
 	}
 	const Color tintcol = globalTint ? * globalTint : Color();
 
-	Video* vid = core->GetVideoDriver();
-	for (int y = sy; y < dy && y < size.h; y++) {
-		for (int x = sx; x < dx && x < size.w; x++) {
-			const Tile &tile = tiles[(y * size.w) + x];
+	// the tint is applied when blitting the chunks, since it is the same for all the
+	// layers; grey and sepia are not, since not every driver can do them for buffers
+	if (flags & ~BlitFlags::COLOR_MOD) {
+		for (int y = sy; y < dy; y++) {
+			for (int x = sx; x < dx; x++) {
+				Point p = Point(x * 64, y * 64) - viewport.origin;
+				DrawTile(tiles[(y * size.w) + x], p, overlays, flags, tintcol);
+			}
+		}
+		return;
+	}
 
-			//draw door tiles if there are any
-			Animation* anim = tile.GetAnimation();
-			assert(anim);
+	int chunksW = (size.w + ChunkTiles - 1) / ChunkTiles;
+	int chunksH = (size.h + ChunkTiles - 1) / ChunkTiles;
+	chunks.resize(chunksW * chunksH);
+	++drawCount;
 
-			// this is the base terrain tile
-			Point p = Point(x * 64, y * 64) - viewport.origin;
-			vid->BlitGameSprite(anim->NextFrame(), p, flags, tintcol);
+	Video* vid = core->GetVideoDriver();
+	size_t visible = 0;
+	for (int cy = sy / ChunkTiles; cy * ChunkTiles < dy; ++cy) {
+		for (int cx = sx / ChunkTiles; cx * ChunkTiles < dx; ++cx) {
+			Region tileRgn(cx * ChunkTiles, cy * ChunkTiles, ChunkTiles, ChunkTiles);
+			tileRgn.w = std::min(tileRgn.w, size.w - tileRgn.x);
+			tileRgn.h = std::min(tileRgn.h, size.h - tileRgn.y);
+			Chunk& chunk = chunks[cy * chunksW + cx];
 
-			if (!tile.om || tile.tileIndex) {
-				continue;
+			// doors change the tiles
+			bool stale = !chunk.buffer;
+			for (int y = 0; y < tileRgn.h && !stale; ++y) {
+				for (int x = 0; x < tileRgn.w && !stale; ++x) {
+					const Tile& tile = tiles[(tileRgn.y + y) * size.w + tileRgn.x + x];
+					stale = chunk.tileIndices[y * tileRgn.w + x] != tile.tileIndex;
+				}
 			}
 
-			int mask = 2;
-			for (size_t z = 1; z < overlays.size(); ++z) {
-				const auto& ov = overlays[z];
-				if (ov && !ov->tiles.empty()) {
-					const Tile &ovtile = ov->tiles[0]; //allow only 1x1 tiles now
-					if (tile.om & mask) {
-						//draw overlay tiles, they should be half transparent except for BG1
-						BlitFlags transFlag = (core->HasFeature(GF_LAYERED_WATER_TILES)) ? BlitFlags::HALFTRANS : BlitFlags::NONE;
-						// this is the water (or whatever)
-						vid->BlitGameSprite(ovtile.GetAnimation(0)->NextFrame(), p, flags | transFlag, tintcol);
-
-						if (core->HasFeature(GF_LAYERED_WATER_TILES)) {
-							Animation* anim1 = tile.GetAnimation(1);
-							if (anim1) {
-								// this is the mask to blend the terrain tile with the water for everything but BG1
-								vid->BlitGameSprite(anim1->NextFrame(), p,
-													flags | BlitFlags::BLENDED, tintcol);
-							}
-						} else {
-							// in BG 1 this is the mask to blend the terrain tile with the water
-							vid->BlitGameSprite(tile.GetAnimation(0)->NextFrame(), p,
-												flags | BlitFlags::BLENDED, tintcol);
-						}
+			Point p = Point(tileRgn.x * 64, tileRgn.y * 64) - viewport.origin;
+			if (stale && !ComposeChunk(chunk, tileRgn)) {
+				// no buffer, so draw the tiles one by one after all
+				for (int y = tileRgn.y; y < tileRgn.y + tileRgn.h; ++y) {
+					for (int x = tileRgn.x; x < tileRgn.x + tileRgn.w; ++x) {
+						const Tile& tile = tiles[(y * size.w) + x];
+						if (IsAnimated(tile)) continue;
+						vid->BlitGameSprite(tile.GetAnimation()->NextFrame(), Point(x * 64, y * 64) - viewport.origin, flags, tintcol);
 					}
 				}
-				mask<<=1;
+				continue;
 			}
+
+			chunk.lastDrawn = drawCount;
+			vid->BlitVideoBuffer(chunk.buffer, p, flags, tintcol);
+			++visible;
 		}
 	}
+
+	for (int y = sy; y < dy; y++) {
+		for (int x = sx; x < dx; x++) {
+			const Tile& tile = tiles[(y * size.w) + x];
+			if (!IsAnimated(tile)) continue;
+
+			Point p = Point(x * 64, y * 64) - viewport.origin;
+			DrawTile(tile, p, overlays, flags, tintcol);
+		}
+	}
+
+	// keep some around for scrolling back and forth
+	EvictChunks(std::max<size_t>(visible * 2, 16));
 }
 
 }
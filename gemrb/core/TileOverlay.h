@@ -33,11 +33,31 @@ namespace GemRB {
 
 class GEM_EXPORT TileOverlay : public Held<TileOverlay> {
 public:
+	using TileOverlayPtr = Holder<TileOverlay>;
+
 	Size size;
 	std::vector<Tile> tiles;
-public:
-	using TileOverlayPtr = Holder<TileOverlay>;
 
+private:
+	// the static tiles of a chunk are composed into a buffer, so scrolling
+	// over a still area costs a blit per chunk instead of one per tile
+	struct Chunk {
+		VideoBufferPtr buffer;
+		std::vector<unsigned char> tileIndices; // door states it was composed with
+		unsigned long lastDrawn = 0;
+	};
+	static const int ChunkTiles = 4;
+
+	mutable std::vector<Chunk> chunks;
+	mutable unsigned long drawCount = 0;
+
+	static bool IsAnimated(const Tile& tile);
+	bool ComposeChunk(Chunk& chunk, const Region& tileRgn) const;
+	void EvictChunks(size_t keep) const;
+	void DrawTile(const Tile& tile, const Point& p, const std::vector<TileOverlayPtr>& overlays,
+				  BlitFlags flags, const Color& tint) const;
+
+public:
 	explicit TileOverlay(Size size) noexcept;
 	TileOverlay(const TileOverlay&) noexcept = delete;
 	TileOverlay& operator=(const TileOverlay&) noexcept = delete;
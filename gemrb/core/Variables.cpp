@@ -24,162 +24,82 @@
 #include "Streams/FileStream.h" // for LoadInitialValues
 #include "System/VFS.h"
 
+#include <unordered_map>
+
 namespace GemRB {
 
+// the names are stored normalized, the way MyCopyKey does it
+static std::vector<std::string> internedKeys;
+static std::unordered_map<std::string, Variables::key_id> internedIds;
+
 /////////////////////////////////////////////////////////////////////////////
-// private inlines 
-inline bool Variables::MyCopyKey(char*& dest, const key_t& key) const
+// private helpers
+size_t Variables::KeyHash::operator()(const StringView& key) const
 {
-	size_t j = std::count(key.begin(), key.end(), ' ');
-	dest = (char *) malloc(key.length() - j + 1);
-
-	j = 0;
+	size_t nHash = 0;
 	for (const auto& chr : key) {
 		if (chr == ' ')
 			continue;
-		dest[j++] = tolower(chr);
+		nHash = (nHash << 5) + nHash + tolower(chr);
 	}
-	dest[j] = 0;
-	return true;
+	return nHash;
 }
 
-inline bool Variables::MyCompareKey(const key_t& key, key_t str) const
+bool Variables::KeyEqual::operator()(const std::string& stored, const StringView& key) const
 {
-	// we know 'key' cannot contain spaces (created via MyCopyKey)
-	// therefore str.length() cannot be < key.length()
-	if (str.length() < key.length()) {
-		return false;
+	if (!parsed) {
+		return stored.length() == key.length() && !strnicmp(stored.c_str(), key.c_str(), key.length());
 	}
 
-	size_t s = 0;
-	size_t end = str.length();
-	for (size_t k = 0; s < end; ++s) {
-		if (str[s] == ' ')
-			continue;
-		if (tolower(key[k++]) != tolower(str[s]))
-			return false;
+	// we know 'stored' cannot contain spaces (normalized by NewAssoc)
+	// therefore key.length() cannot be < stored.length()
+	if (key.length() < stored.length()) {
+		return false;
 	}
 
-	return s == end;
-}
-
-inline unsigned int Variables::MyHashKey(const key_t& key) const
-{
-	assert(key.c_str());
-
-	unsigned int nHash = 0;
+	size_t k = 0;
 	for (const auto& chr : key) {
-		//the original engine ignores spaces in variable names
 		if (chr == ' ')
 			continue;
-		nHash = (nHash << 5) + nHash + tolower(chr);
+		if (k == stored.length() || stored[k++] != tolower(chr))
+			return false;
 	}
-	return nHash;
+	return k == stored.length();
 }
+
 /////////////////////////////////////////////////////////////////////////////
 // functions
 Variables::iterator Variables::GetNextAssoc(iterator rNextPosition, key_t& rKey,
 	ieDword& rValue) const
 {
-	assert( m_pHashTable != NULL ); // never call on empty map
+	size_t pos = rNextPosition ? size_t(rNextPosition - &m_map[0]) : m_map.Next(Map::npos);
+	assert(pos != Map::npos); // never call on empty map
 
-	Variables::MyAssoc *pAssocRet = rNextPosition;
+	const Map::Slot& slot = m_map[pos];
+	rKey = key_t(slot.key);
+	rValue = slot.value.nValue;
 
-	if (pAssocRet == NULL) {
-		// find the first association
-		for (unsigned int nBucket = 0; nBucket < m_nHashTableSize; nBucket++)
-			if (( pAssocRet = m_pHashTable[nBucket] ) != NULL)
-				break;
-		assert( pAssocRet != NULL ); // must find something
-	}
-	Variables::MyAssoc* pAssocNext;
-	if (( pAssocNext = pAssocRet->pNext ) == NULL) {
-		// go to next bucket
-		for (size_t nBucket = pAssocRet->nHashValue + 1;
-			nBucket < m_nHashTableSize;
-			nBucket++)
-			if (( pAssocNext = m_pHashTable[nBucket] ) != NULL)
-				break;
-	}
-
-	// fill in return data
-	rKey = key_t(pAssocRet->key);
-	rValue = pAssocRet->Value.nValue;
-	return pAssocNext;
+	pos = m_map.Next(pos);
+	return pos == Map::npos ? nullptr : &m_map[pos];
 }
 
-Variables::Variables(int nBlockSize, int nHashTableSize)
+void Variables::ReleaseValue(Value& value, ReleaseFun fun) const
 {
-	assert( nBlockSize > 0 );
-	assert( nHashTableSize > 16 );
-
-	m_pHashTable = NULL;
-	m_nHashTableSize = nHashTableSize; // default size
-	m_nCount = 0;
-	m_lParseKey = false;
-	m_pFreeList = NULL;
-	m_pBlocks = NULL;
-	m_nBlockSize = nBlockSize;
-	m_type = GEM_VARIABLES_INT;
-}
-
-void Variables::InitHashTable(unsigned int nHashSize, bool bAllocNow)
-	//
-	// Used to force allocation of a hash table or to override the default
-	// hash table size of (which is fairly small)
-{
-	assert( m_nCount == 0 );
-	assert( nHashSize > 16 );
-
-	if (m_pHashTable != NULL) {
-		// free hash table
-		free(m_pHashTable);
-		m_pHashTable = NULL;
+	if (fun) {
+		fun(value.pValue);
+	} else if (m_type == GEM_VARIABLES_STRING) {
+		free(value.sValue);
 	}
-
-	if (bAllocNow) {
-		m_pHashTable =(Variables::MyAssoc **) malloc(sizeof( Variables::MyAssoc *) * nHashSize);
-		memset( m_pHashTable, 0, sizeof( Variables::MyAssoc * ) * nHashSize );
-	}
-	m_nHashTableSize = nHashSize;
+	value.sValue = nullptr;
 }
 
 void Variables::RemoveAll(ReleaseFun fun)
 {
-	if (m_pHashTable != NULL) {
-		// destroy elements (values and keys)
-		for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
-			for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
-				if (fun) {
-					fun((void *) pAssoc->Value.sValue);
-				}
-				else if (m_type == GEM_VARIABLES_STRING) {
-					if (pAssoc->Value.sValue) {
-						free( pAssoc->Value.sValue );
-						pAssoc->Value.sValue = NULL;
-					}
-				}
-				if (pAssoc->key) {
-					free(pAssoc->key);
-					pAssoc->key = NULL;
-				}
-			}
-		}
-	}
-
-	// free hash table
-	free(m_pHashTable);
-	m_pHashTable = NULL;
-
-	m_nCount = 0;
-	m_pFreeList = NULL;
-	MemBlock* p = m_pBlocks;
-	while (p != NULL) {
-		MemBlock* pNext = p->pNext;
-		free(p);
-		p = pNext;
+	for (size_t pos = m_map.Next(Map::npos); pos != Map::npos; pos = m_map.Next(pos)) {
+		ReleaseValue(m_map[pos].value, fun);
 	}
-	m_pBlocks = NULL;
+	m_map.Clear();
+	m_slots.clear();
 }
 
 Variables::~Variables()
@@ -187,101 +107,118 @@ Variables::~Variables()
 	RemoveAll(NULL);
 }
 
-Variables::MyAssoc* Variables::NewAssoc(const key_t& key)
+size_t Variables::NewAssoc(const key_t& key, Map::hash_t hash)
 {
-	if (m_pFreeList == NULL) {
-		// add another block
-		Variables::MemBlock* newBlock = ( Variables::MemBlock* ) malloc( m_nBlockSize*sizeof( Variables::MyAssoc ) + sizeof( Variables::MemBlock ));
-		assert( newBlock != NULL ); // we must have something
-		newBlock->pNext = m_pBlocks;
-		m_pBlocks = newBlock;
-
-		// chain them into free list
-		Variables::MyAssoc* pAssoc = ( Variables::MyAssoc* ) ( newBlock + 1 );
-		for (int i = 0; i < m_nBlockSize; i++) {
-			pAssoc->pNext = m_pFreeList;
-			m_pFreeList = pAssoc++;
-		}
-	}
-	
-	Variables::MyAssoc* pAssoc = m_pFreeList;
-	m_pFreeList = m_pFreeList->pNext;
-	m_nCount++;
-	assert( m_nCount > 0 ); // make sure we don't overflow
+	std::string name;
 	if (m_lParseKey) {
-		MyCopyKey( pAssoc->key, key );
-	} else {
-		size_t len = key.length();
-		pAssoc->key = (char *) malloc(len + 1);
-		if (pAssoc->key) {
-			memcpy(pAssoc->key, key.begin(), len);
-			pAssoc->key[len] = 0;
+		name.reserve(key.length());
+		for (const auto& chr : key) {
+			if (chr == ' ')
+				continue;
+			name.push_back(tolower(chr));
 		}
+	} else {
+		name.assign(key.c_str(), key.length());
 	}
-#ifdef _DEBUG
-	pAssoc->Value.nValue = 0xcccccccc; //invalid value
-	pAssoc->nHashValue = 0xcccccccc; //invalid value
-#endif
-	return pAssoc;
+
+	m_nCreated++;
+	return m_map.Insert(std::move(name), Value(), hash);
+}
+
+size_t Variables::GetAssocAt(const key_t& key, Map::hash_t& hash) const
+	// find association (or return npos)
+{
+	if (key.empty() || key.c_str() == nullptr) {
+		hash = 0;
+		return Map::npos;
+	}
+
+	hash = m_map.Hash(key);
+	return m_map.Find(key, hash);
 }
 
-void Variables::FreeAssoc(Variables::MyAssoc* pAssoc)
+Variables::key_id Variables::InternKey(const key_t& key)
 {
-	if (pAssoc->key) {
-		free(pAssoc->key);
-		pAssoc->key = NULL;
+	std::string name;
+	name.reserve(key.length());
+	for (const auto& chr : key) {
+		if (chr == ' ')
+			continue;
+		name.push_back(tolower(chr));
 	}
-	pAssoc->pNext = m_pFreeList;
-	m_pFreeList = pAssoc;
-	m_nCount--;
-	assert( m_nCount >= 0 ); // make sure we don't underflow
-
-	// if no more elements, cleanup completely
-	if (m_nCount == 0) {
-		RemoveAll(NULL);
+
+	auto it = internedIds.find(name);
+	if (it != internedIds.end()) {
+		return it->second;
 	}
+	key_id id = key_id(internedKeys.size());
+	internedKeys.push_back(name);
+	internedIds.emplace(std::move(name), id);
+	return id;
 }
 
-Variables::MyAssoc* Variables::GetAssocAt(const key_t& key, unsigned int& nHash) const
-	// find association (or return NULL)
+const std::string& Variables::InternedKey(key_id id)
 {
-	if (key.empty() || key.c_str() == nullptr) {
-		nHash = 0;
-		return nullptr;
+	return internedKeys[id];
+}
+
+size_t Variables::GetAssocAt(key_id id) const
+{
+	assert(m_lParseKey && id < internedKeys.size());
+	if (id >= m_slots.size()) {
+		m_slots.resize(internedKeys.size());
 	}
 
-	nHash = MyHashKey( key ) % m_nHashTableSize;
+	KeySlot& slot = m_slots[id];
+	if (slot.pos != Map::npos && slot.generation == m_map.Generation()) {
+		return slot.pos;
+	}
+	if (slot.pos == Map::npos && slot.missedAt == m_nCreated + 1) {
+		return Map::npos;
+	}
 
-	if (m_pHashTable == NULL) {
-		return NULL;
+	Map::hash_t hash;
+	slot.pos = GetAssocAt(key_t(internedKeys[id]), hash);
+	slot.generation = m_map.Generation();
+	if (slot.pos == Map::npos) {
+		slot.missedAt = m_nCreated + 1;
 	}
+	return slot.pos;
+}
 
-	// see if it exists
-	for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
-		if (m_lParseKey) {
-			if (MyCompareKey(key_t(pAssoc->key), key)) {
-				return pAssoc;
-			}
-		} else {
-			if (!strnicmp(pAssoc->key, key.c_str(), key.length())) {
-				return pAssoc;
-			}
-		}
+bool Variables::Lookup(key_id id, ieDword& rValue) const
+{
+	assert(m_type == GEM_VARIABLES_INT);
+	size_t pos = GetAssocAt(id);
+	if (pos == Map::npos) {
+		return false;
 	}
 
-	return NULL;
+	rValue = m_map[pos].value.nValue;
+	return true;
+}
+
+void Variables::SetAt(key_id id, ieDword value, bool nocreate)
+{
+	assert(m_type == GEM_VARIABLES_INT);
+	size_t pos = GetAssocAt(id);
+	if (pos != Map::npos) {
+		m_map[pos].value.nValue = value;
+		return;
+	}
+	SetAt(key_t(internedKeys[id]), value, nocreate);
 }
 
 bool Variables::Lookup(const key_t& key, std::string& dest) const
 {
-	unsigned int nHash;
+	Map::hash_t hash;
 	assert(m_type==GEM_VARIABLES_STRING);
-	const Variables::MyAssoc* pAssoc = GetAssocAt(key, nHash);
-	if (pAssoc == NULL) {
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) {
 		return false;
 	} // not in map
 
-	dest = pAssoc->Value.sValue;
+	dest = m_map[pos].value.sValue;
 	return true;
 }
 
@@ -300,40 +237,39 @@ bool Variables::Lookup(const key_t& key, String& dest) const
 
 bool Variables::Lookup(const key_t& key, void *&dest) const
 {
-	unsigned int nHash;
+	Map::hash_t hash;
 	assert(m_type==GEM_VARIABLES_POINTER);
-	const Variables::MyAssoc* pAssoc = GetAssocAt(key, nHash);
-	if (pAssoc == NULL) {
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) {
 		return false;
 	} // not in map
 
-	dest = pAssoc->Value.pValue;
+	dest = m_map[pos].value.pValue;
 	return true;
 }
 
 bool Variables::Lookup(const key_t& key, ieDword& rValue) const
 {
-	unsigned int nHash;
+	Map::hash_t hash;
 	assert(m_type==GEM_VARIABLES_INT);
-	const Variables::MyAssoc* pAssoc = GetAssocAt(key, nHash);
-	if (pAssoc == NULL) {
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) {
 		return false;
 	} // not in map
 
-	rValue = pAssoc->Value.nValue;
+	rValue = m_map[pos].value.nValue;
 	return true;
 }
 
 bool Variables::HasKey(const key_t& key) const
 {
-	unsigned int nHash;
-	return GetAssocAt(key, nHash) != nullptr;
+	Map::hash_t hash;
+	return GetAssocAt(key, hash) != Map::npos;
 }
 
 void Variables::SetAtCString(const key_t& key, const char* str)
 {
-	unsigned int nHash;
-	Variables::MyAssoc* pAssoc;
+	Map::hash_t hash;
 
 	assert(key.length() < 256);
 
@@ -343,115 +279,63 @@ void Variables::SetAtCString(const key_t& key, const char* str)
 #endif
 
 	assert( m_type == GEM_VARIABLES_STRING );
-	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) {
+		if (!hash) return; // no key
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pos = NewAssoc(key, hash);
 	} else {
-		if (pAssoc->Value.sValue) {
-			free( pAssoc->Value.sValue );
-			pAssoc->Value.sValue = 0;
-		}
+		free(m_map[pos].value.sValue);
 	}
 
-	//set value only if we have a key
-	if (pAssoc->key) {
-		pAssoc->Value.sValue = strdup(str);
-		pAssoc->nHashValue = nHash;
-	}
+	m_map[pos].value.sValue = strdup(str);
 }
 
 void Variables::SetAt(const key_t& key, void* value)
 {
-	unsigned int nHash;
-	Variables::MyAssoc* pAssoc;
+	Map::hash_t hash;
 
 	assert( m_type == GEM_VARIABLES_POINTER );
-	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) {
+		if (!hash) return; // no key
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
+		pos = NewAssoc(key, hash);
 	} else {
-		if (pAssoc->Value.sValue) {
-			free( pAssoc->Value.sValue );
-			pAssoc->Value.sValue = 0;
-		}
-	}
-
-	//set value only if we have a key
-	if (pAssoc->key) {
-		pAssoc->Value.pValue = value;
-		pAssoc->nHashValue = nHash;
+		free(m_map[pos].value.pValue);
 	}
 
+	m_map[pos].value.pValue = value;
 }
 
 
 void Variables::SetAt(const key_t& key, ieDword value, bool nocreate)
 {
-	unsigned int nHash;
-	Variables::MyAssoc* pAssoc;
-
-	if (!key.c_str()) return;
+	Map::hash_t hash;
 
 	assert( m_type == GEM_VARIABLES_INT );
-	if (( pAssoc = GetAssocAt( key, nHash ) ) == NULL) {
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) {
+		if (!hash) return; // no key
 		if (nocreate) {
 			Log(WARNING, "Variables", "Cannot create new variable: {}", key);
 			return;
 		}
 
-		if (m_pHashTable == NULL)
-			InitHashTable( m_nHashTableSize );
-
 		// it doesn't exist, add a new Association
-		pAssoc = NewAssoc( key );
-		// put into hash table
-		pAssoc->pNext = m_pHashTable[nHash];
-		m_pHashTable[nHash] = pAssoc;
-	}
-	//set value only if we have a key
-	if (pAssoc->key) {
-		pAssoc->Value.nValue = value;
-		pAssoc->nHashValue = nHash;
+		pos = NewAssoc(key, hash);
 	}
+	m_map[pos].value.nValue = value;
 }
 
 void Variables::Remove(const key_t& key)
 {
-	unsigned int nHash;
-	Variables::MyAssoc* pAssoc;
+	Map::hash_t hash;
+	size_t pos = GetAssocAt(key, hash);
+	if (pos == Map::npos) return; // not in there
 
-	pAssoc = GetAssocAt( key, nHash );
-	if (!pAssoc) return; // not in there
-
-	if (pAssoc == m_pHashTable[nHash]) {
-		// head
-		m_pHashTable[nHash] = pAssoc->pNext;
-	} else {
-		Variables::MyAssoc* prev = m_pHashTable[nHash];
-		// Room for optimization: make each bucket a doubly linked
-		// list to make removes from a bucket O(1).
-		// (This will have limited use in gemrb's case, because we
-		// use relatively large tables and small buckets.)
-		while (prev->pNext != pAssoc) {
-			prev = prev->pNext;
-			assert( prev != NULL );
-		}
-		prev->pNext = pAssoc->pNext;		
-	}
-	pAssoc->pNext = 0;
-	FreeAssoc(pAssoc);
+	ReleaseValue(m_map[pos].value, nullptr);
+	m_map.Erase(pos);
 }
 
 void Variables::LoadInitialValues(const ResRef& name)
@@ -505,18 +389,17 @@ void Variables::DebugDump() const
 		poi = "invalid";
 	}
 	Log (DEBUG, "Variables", "Item type: {}", poi);
-	Log (DEBUG, "Variables", "Item count: {}", m_nCount);
-	Log (DEBUG, "Variables", "HashTableSize: {}", m_nHashTableSize);
-	for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
-		for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
-			switch(m_type) {
-			case GEM_VARIABLES_STRING:
-				Log (DEBUG, "Variables", "{} = {}", pAssoc->key, pAssoc->Value.sValue);
-				break;
-			default:
-				Log (DEBUG, "Variables", "{} = {}", pAssoc->key, pAssoc->Value.nValue);
-				break;
-			}
+	Log (DEBUG, "Variables", "Item count: {}", m_map.Size());
+	Log (DEBUG, "Variables", "HashTableSize: {}", m_map.Capacity());
+	for (size_t pos = m_map.Next(Map::npos); pos != Map::npos; pos = m_map.Next(pos)) {
+		const Map::Slot& slot = m_map[pos];
+		switch(m_type) {
+		case GEM_VARIABLES_STRING:
+			Log (DEBUG, "Variables", "{} = {}", slot.key, slot.value.sValue);
+			break;
+		default:
+			Log (DEBUG, "Variables", "{} = {}", slot.key, slot.value.nValue);
+			break;
 		}
 	}
 }
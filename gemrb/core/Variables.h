@@ -23,11 +23,13 @@
 
 #include "exports.h"
 #include "globals.h"
+#include "OpenHashMap.h"
 
 #include "Strings/String.h"
 #include "Strings/StringView.h"
 
 #include <cassert>
+#include <vector>
 
 namespace GemRB {
 
@@ -41,28 +43,32 @@ using ReleaseFun = void (*)(void*);
 
 class GEM_EXPORT Variables {
 protected:
-	// Association
-	class MyAssoc {
-		MyAssoc* pNext;
-		char* key;
-		union {
-			ieDword nValue;
-			char* sValue;
-			void* pValue;
-		} Value;
-		unsigned long nHashValue;
-		friend class Variables;
+	union Value {
+		ieDword nValue;
+		char* sValue;
+		void* pValue;
 	};
-	struct MemBlock {
-		MemBlock* pNext;
+	// the original engine ignores spaces in variable names
+	struct KeyHash {
+		size_t operator()(const StringView& key) const;
 	};
+	struct KeyEqual {
+		// stored keys are already normalized, the looked up ones not
+		bool parsed;
+		explicit KeyEqual(bool parse = false) : parsed(parse) {}
+		bool operator()(const std::string& stored, const StringView& key) const;
+	};
+	using Map = OpenHashMap<std::string, Value, KeyHash, KeyEqual>;
+
 public:
 	// abstract iteration position
-	using iterator = MyAssoc*;
+	using iterator = const Map::Slot*;
 	using key_t = StringView;
+	// interned game variable name, see InternKey
+	using key_id = uint32_t;
 
 	// Construction
-	explicit Variables(int nBlockSize = 10, int nHashTableSize = 2049);
+	Variables() = default;
 	Variables(const Variables&) = delete;
 	~Variables();
 	Variables& operator=(const Variables&) = delete;
@@ -73,8 +79,9 @@ public:
 	//you should set this only on an empty mapping
 	inline int ParseKey(int arg)
 	{
-		assert( m_nCount == 0 );
+		assert(m_map.IsEmpty());
 		m_lParseKey = ( arg > 0 );
+		m_map = Map(KeyHash(), KeyEqual(m_lParseKey));
 		return 0;
 	}
 	//sets the way we handle values
@@ -84,11 +91,11 @@ public:
 	}
 	inline int GetCount() const
 	{
-		return m_nCount;
+		return int(m_map.Size());
 	}
 	inline bool IsEmpty() const
 	{
-		return m_nCount == 0;
+		return m_map.IsEmpty();
 	}
 
 	bool Lookup(const key_t&, ieDword& rValue) const;
@@ -96,6 +103,15 @@ public:
 	bool Lookup(const key_t&, std::string& dest) const;
 	bool Lookup(const key_t&, void*& dest) const;
 	bool HasKey(const key_t&) const;
+
+	// Game variable names can be interned once (eg. when a script is loaded),
+	// after which the lookups by id skip hashing and comparing the name:
+	// each instance remembers where it found the variable the last time.
+	// Only for maps with parsed keys, since the ids use that normalization.
+	static key_id InternKey(const key_t& key);
+	static const std::string& InternedKey(key_id id);
+	bool Lookup(key_id id, ieDword& rValue) const;
+	void SetAt(key_id id, ieDword newValue, bool nocreate = false);
 	
 	template<typename NUM>
 	typename std::enable_if<std::is_integral<NUM>::value || std::is_enum<NUM>::value, bool>::type
@@ -131,7 +147,6 @@ public:
 	void SetAt(const key_t&, ieDword newValue, bool nocreate=false);
 	void Remove(const key_t&);
 	void RemoveAll(ReleaseFun fun);
-	void InitHashTable(unsigned int hashSize, bool bAllocNow = true);
 
 	iterator GetNextAssoc(iterator rNextPosition, key_t& rKey,
 		ieDword& rValue) const;
@@ -140,21 +155,25 @@ public:
 	void DebugDump() const;
 	// Implementation
 protected:
-	Variables::MyAssoc** m_pHashTable;
-	unsigned int m_nHashTableSize;
-	bool m_lParseKey;
-	int m_nCount;
-	Variables::MyAssoc* m_pFreeList;
-	MemBlock* m_pBlocks;
-	int m_nBlockSize;
-	int m_type; //could be string or ieDword 
-
-	Variables::MyAssoc* NewAssoc(const key_t&);
-	void FreeAssoc(Variables::MyAssoc*);
-	Variables::MyAssoc* GetAssocAt(const key_t&, unsigned int&) const;
-	inline bool MyCopyKey(char*& dest, const key_t&) const;
-	inline bool MyCompareKey(const key_t&, key_t str) const;
-	inline unsigned int MyHashKey(const key_t&) const;
+	Map m_map;
+	bool m_lParseKey = false;
+	int m_type = GEM_VARIABLES_INT; //could be string or ieDword
+
+	// where each interned key was found; positions only survive while the
+	// map generation stays the same (no removal or growth in between)
+	struct KeySlot {
+		size_t pos = Map::npos;
+		unsigned long generation = 0;
+		// a miss stays valid until the next association is created
+		unsigned long missedAt = 0; // m_nCreated + 1 at the time
+	};
+	mutable std::vector<KeySlot> m_slots;
+	unsigned long m_nCreated = 0;
+
+	size_t GetAssocAt(const key_t&, Map::hash_t&) const;
+	size_t GetAssocAt(key_id) const;
+	size_t NewAssoc(const key_t&, Map::hash_t);
+	void ReleaseValue(Value&, ReleaseFun fun) const;
 	
 	void SetAtCString(const key_t&, const char* newValue);
 };
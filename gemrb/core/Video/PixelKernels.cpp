@@ -0,0 +1,494 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "PixelKernels.h"
+
+#include "Logging/Logging.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif (defined(__ARM_NEON) || defined(_M_ARM64)) && !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+// the vector kernels index bytes by shift / 8, so they need a little endian target
+#define KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+// lets the x86 kernels be built without raising the baseline of the whole build
+#if defined(__GNUC__) || defined(__clang__)
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KERNEL_TARGET(isa)
+#endif
+
+namespace GemRB {
+
+bool PixelLayout::FromFormat(const PixelFormat& fmt, PixelLayout& layout) noexcept
+{
+	if (fmt.Bpp != 4 || fmt.RLE) return false;
+	if (fmt.Rshift % 8 || fmt.Gshift % 8 || fmt.Bshift % 8) return false;
+	if (fmt.Rshift == fmt.Gshift || fmt.Rshift == fmt.Bshift || fmt.Gshift == fmt.Bshift) return false;
+	if (fmt.Rmask != 0xffU << fmt.Rshift || fmt.Gmask != 0xffU << fmt.Gshift || fmt.Bmask != 0xffU << fmt.Bshift) {
+		return false;
+	}
+
+	// the remaining byte, since the shifts are a permutation of 0, 8, 16 and 24
+	uint8_t aShift = 48 - fmt.Rshift - fmt.Gshift - fmt.Bshift;
+	if (fmt.Amask && fmt.Amask != 0xffU << aShift) return false;
+
+	layout.rShift = fmt.Rshift;
+	layout.gShift = fmt.Gshift;
+	layout.bShift = fmt.Bshift;
+	layout.aShift = aShift;
+	return true;
+}
+
+/*
+ * scalar kernels, these define the results the vector versions have to match
+ * and handle whatever does not fill a whole vector
+ */
+
+static void ExpandScalar(const uint8_t* indices, const uint32_t* palette, uint32_t* dst, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		dst[i] = palette[indices[i]];
+	}
+}
+
+static void ScaleScalar(uint32_t* px, int n, const ScaleParams& params)
+{
+	for (int i = 0; i < n; ++i) {
+		uint32_t scaled = 0;
+		for (unsigned int k = 0; k < 4; ++k) {
+			uint32_t byte = (px[i] >> (k * 8)) & 0xff;
+			scaled |= ((byte * params.factor[k]) >> 16) << (k * 8);
+		}
+		px[i] = (scaled & ~params.keep) | (px[i] & params.keep) | params.fill;
+	}
+}
+
+static void DesaturateScalar(uint32_t* px, int n, const DesaturateParams& params)
+{
+	for (int i = 0; i < n; ++i) {
+		uint32_t colors = px[i] & params.colorMask;
+		// wraps like the Uint8 sum of ShaderGreyscale
+		uint8_t avg = uint8_t(colors + (colors >> 8) + (colors >> 16) + (colors >> 24));
+		uint32_t out = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			int value = std::min(avg + int((params.add >> shift) & 0xff), 255);
+			value = std::max(value - int((params.sub >> shift) & 0xff), 0);
+			out |= uint32_t(value) << shift;
+		}
+		px[i] = (out & params.colorMask) | (px[i] & ~params.colorMask);
+	}
+}
+
+static void BlendAlphaScalar(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	for (int i = 0; i < n; ++i) {
+		if (stencil[i] == 0xff) continue;
+
+		uint32_t a = uint8_t((src[i] >> params.aShift) - stencil[i]);
+		uint32_t out = 0;
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			uint32_t s = (src[i] >> shift) & 0xff;
+			uint32_t d = (dst[i] >> shift) & 0xff;
+			uint32_t x = 1 + a * s + (255 - a) * d;
+			out |= ((x + (x >> 8)) >> 8) << shift;
+		}
+		dst[i] = (out & params.colorMask) | params.amask;
+	}
+}
+
+static void BlendHalfScalar(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	uint32_t halfmask = (params.colorMask >> 1) & 0x7f7f7f7f;
+	for (int i = 0; i < n; ++i) {
+		if (stencil[i] == 0xff) continue;
+		dst[i] = (((dst[i] >> 1) & halfmask) + ((src[i] >> 1) & halfmask)) | params.amask;
+	}
+}
+
+static const PixelKernels scalarKernels {
+	"scalar", ExpandScalar, ScaleScalar, DesaturateScalar, BlendAlphaScalar, BlendHalfScalar
+};
+
+#ifdef KERNELS_X86
+
+KERNEL_TARGET("sse2")
+static inline __m128i LoadStencilSSE2(const uint8_t* stencil)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int32_t packed;
+	memcpy(&packed, stencil, sizeof(packed));
+	__m128i st = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+	return _mm_unpacklo_epi16(st, zero);
+}
+
+// s * a + d * (255 - a), divided by 255 like SRBlender_Alpha, on 16 bit channels
+KERNEL_TARGET("sse2")
+static inline __m128i BlendChannelsSSE2(__m128i s, __m128i d, __m128i a)
+{
+	__m128i x = _mm_mullo_epi16(s, a);
+	x = _mm_add_epi16(x, _mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a)));
+	x = _mm_add_epi16(x, _mm_set1_epi16(1));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+KERNEL_TARGET("sse2")
+static void ScaleSSE2(uint32_t* px, int n, const ScaleParams& params)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i factor = _mm_setr_epi16(short(params.factor[0]), short(params.factor[1]), short(params.factor[2]), short(params.factor[3]),
+										  short(params.factor[0]), short(params.factor[1]), short(params.factor[2]), short(params.factor[3]));
+	const __m128i keep = _mm_set1_epi32(int(params.keep));
+	const __m128i fill = _mm_set1_epi32(int(params.fill));
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + i));
+		__m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(p, zero), factor);
+		__m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(p, zero), factor);
+		__m128i out = _mm_or_si128(_mm_andnot_si128(keep, _mm_packus_epi16(lo, hi)), _mm_and_si128(keep, p));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(px + i), _mm_or_si128(out, fill));
+	}
+	ScaleScalar(px + i, n - i, params);
+}
+
+KERNEL_TARGET("sse2")
+static void DesaturateSSE2(uint32_t* px, int n, const DesaturateParams& params)
+{
+	const __m128i colorMask = _mm_set1_epi32(int(params.colorMask));
+	const __m128i add = _mm_set1_epi32(int(params.add));
+	const __m128i sub = _mm_set1_epi32(int(params.sub));
+	const __m128i lowByte = _mm_set1_epi32(0xff);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + i));
+		__m128i c = _mm_and_si128(p, colorMask);
+		__m128i avg = _mm_add_epi32(_mm_add_epi32(c, _mm_srli_epi32(c, 8)), _mm_add_epi32(_mm_srli_epi32(c, 16), _mm_srli_epi32(c, 24)));
+		avg = _mm_and_si128(avg, lowByte);
+		avg = _mm_or_si128(avg, _mm_slli_epi32(avg, 8));
+		avg = _mm_or_si128(avg, _mm_slli_epi32(avg, 16));
+		avg = _mm_subs_epu8(_mm_adds_epu8(avg, add), sub);
+		__m128i out = _mm_or_si128(_mm_and_si128(colorMask, avg), _mm_andnot_si128(colorMask, p));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(px + i), out);
+	}
+	DesaturateScalar(px + i, n - i, params);
+}
+
+KERNEL_TARGET("sse2")
+static void BlendAlphaSSE2(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lowByte = _mm_set1_epi32(0xff);
+	const __m128i colorMask = _mm_set1_epi32(int(params.colorMask));
+	const __m128i amask = _mm_set1_epi32(int(params.amask));
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i st = LoadStencilSSE2(stencil + i);
+		__m128i skip = _mm_cmpeq_epi32(st, lowByte);
+		if (_mm_movemask_epi8(skip) == 0xffff) continue;
+
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+		__m128i a = _mm_and_si128(_mm_sub_epi32(_mm_srl_epi32(s, aShift), st), lowByte);
+		a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+
+		__m128i lo = BlendChannelsSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(a, a));
+		__m128i hi = BlendChannelsSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(a, a));
+		__m128i out = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), colorMask), amask);
+		out = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, out));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+	BlendAlphaScalar(dst + i, src + i, stencil + i, n - i, params);
+}
+
+KERNEL_TARGET("sse2")
+static void BlendHalfSSE2(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	const __m128i lowByte = _mm_set1_epi32(0xff);
+	const __m128i halfmask = _mm_set1_epi32(int((params.colorMask >> 1) & 0x7f7f7f7f));
+	const __m128i amask = _mm_set1_epi32(int(params.amask));
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i skip = _mm_cmpeq_epi32(LoadStencilSSE2(stencil + i), lowByte);
+		if (_mm_movemask_epi8(skip) == 0xffff) continue;
+
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+		__m128i out = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(d, 1), halfmask), _mm_and_si128(_mm_srli_epi32(s, 1), halfmask));
+		out = _mm_or_si128(out, amask);
+		out = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, out));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+	BlendHalfScalar(dst + i, src + i, stencil + i, n - i, params);
+}
+
+KERNEL_TARGET("avx2")
+static void ExpandAVX2(const uint8_t* indices, const uint32_t* palette, uint32_t* dst, int n)
+{
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i)));
+		__m256i px = _mm256_i32gather_epi32(reinterpret_cast<const int*>(palette), idx, 4);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), px);
+	}
+	ExpandScalar(indices + i, palette, dst + i, n - i);
+}
+
+KERNEL_TARGET("avx2")
+static inline __m256i BlendChannelsAVX2(__m256i s, __m256i d, __m256i a)
+{
+	__m256i x = _mm256_mullo_epi16(s, a);
+	x = _mm256_add_epi16(x, _mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a)));
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(1));
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+KERNEL_TARGET("avx2")
+static void BlendAlphaAVX2(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i lowByte = _mm256_set1_epi32(0xff);
+	const __m256i colorMask = _mm256_set1_epi32(int(params.colorMask));
+	const __m256i amask = _mm256_set1_epi32(int(params.amask));
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i st = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(stencil + i)));
+		__m256i skip = _mm256_cmpeq_epi32(st, lowByte);
+		if (_mm256_movemask_epi8(skip) == -1) continue;
+
+		__m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+		__m256i a = _mm256_and_si256(_mm256_sub_epi32(_mm256_srl_epi32(s, aShift), st), lowByte);
+		a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+
+		// the unpacks work within 128 bit lanes, which is fine as long as they are paired
+		__m256i lo = BlendChannelsAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(a, a));
+		__m256i hi = BlendChannelsAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(a, a));
+		__m256i out = _mm256_or_si256(_mm256_and_si256(_mm256_packus_epi16(lo, hi), colorMask), amask);
+		out = _mm256_blendv_epi8(out, d, skip);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), out);
+	}
+	BlendAlphaSSE2(dst + i, src + i, stencil + i, n - i, params);
+}
+
+KERNEL_TARGET("avx2")
+static void BlendHalfAVX2(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	const __m256i lowByte = _mm256_set1_epi32(0xff);
+	const __m256i halfmask = _mm256_set1_epi32(int((params.colorMask >> 1) & 0x7f7f7f7f));
+	const __m256i amask = _mm256_set1_epi32(int(params.amask));
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i st = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(stencil + i)));
+		__m256i skip = _mm256_cmpeq_epi32(st, lowByte);
+		if (_mm256_movemask_epi8(skip) == -1) continue;
+
+		__m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+		__m256i out = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(d, 1), halfmask), _mm256_and_si256(_mm256_srli_epi32(s, 1), halfmask));
+		out = _mm256_blendv_epi8(_mm256_or_si256(out, amask), d, skip);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), out);
+	}
+	BlendHalfSSE2(dst + i, src + i, stencil + i, n - i, params);
+}
+
+static const PixelKernels sse2Kernels {
+	"SSE2", ExpandScalar, ScaleSSE2, DesaturateSSE2, BlendAlphaSSE2, BlendHalfSSE2
+};
+
+// palettes are only 256 entries, so tinting them stays on SSE2
+static const PixelKernels avx2Kernels {
+	"AVX2", ExpandAVX2, ScaleSSE2, DesaturateSSE2, BlendAlphaAVX2, BlendHalfAVX2
+};
+
+static void DetectX86(bool& sse2, bool& avx2)
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	sse2 = info[3] & (1 << 26);
+	// AVX2 also needs the OS to save the ymm registers
+	bool osxsave = info[2] & (1 << 27);
+	avx2 = false;
+	if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 6) == 6) {
+		__cpuidex(info, 7, 0);
+		avx2 = info[1] & (1 << 5);
+	}
+#else
+	__builtin_cpu_init();
+	sse2 = __builtin_cpu_supports("sse2");
+	avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif defined(KERNELS_NEON)
+
+static inline uint32x4_t LoadStencilNEON(const uint8_t* stencil)
+{
+	const uint32_t st[4] = { stencil[0], stencil[1], stencil[2], stencil[3] };
+	return vld1q_u32(st);
+}
+
+static void ScaleNEON(uint32_t* px, int n, const ScaleParams& params)
+{
+	const uint16_t factors[4] = { params.factor[0], params.factor[1], params.factor[2], params.factor[3] };
+	const uint16x4_t factor = vld1_u16(factors);
+	const uint32x4_t keep = vdupq_n_u32(params.keep);
+	const uint32x4_t fill = vdupq_n_u32(params.fill);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t p = vld1q_u32(px + i);
+		uint16x8_t lo = vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(p)));
+		uint16x8_t hi = vmovl_u8(vget_high_u8(vreinterpretq_u8_u32(p)));
+		lo = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(lo), factor), 16), vshrn_n_u32(vmull_u16(vget_high_u16(lo), factor), 16));
+		hi = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(hi), factor), 16), vshrn_n_u32(vmull_u16(vget_high_u16(hi), factor), 16));
+		uint32x4_t scaled = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+		vst1q_u32(px + i, vorrq_u32(vbslq_u32(keep, p, scaled), fill));
+	}
+	ScaleScalar(px + i, n - i, params);
+}
+
+static void DesaturateNEON(uint32_t* px, int n, const DesaturateParams& params)
+{
+	const uint32x4_t colorMask = vdupq_n_u32(params.colorMask);
+	const uint8x16_t add = vreinterpretq_u8_u32(vdupq_n_u32(params.add));
+	const uint8x16_t sub = vreinterpretq_u8_u32(vdupq_n_u32(params.sub));
+	const uint32x4_t lowByte = vdupq_n_u32(0xff);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t p = vld1q_u32(px + i);
+		uint32x4_t c = vandq_u32(p, colorMask);
+		uint32x4_t avg = vaddq_u32(vaddq_u32(c, vshrq_n_u32(c, 8)), vaddq_u32(vshrq_n_u32(c, 16), vshrq_n_u32(c, 24)));
+		avg = vmulq_n_u32(vandq_u32(avg, lowByte), 0x01010101);
+		uint8x16_t shaded = vqsubq_u8(vqaddq_u8(vreinterpretq_u8_u32(avg), add), sub);
+		vst1q_u32(px + i, vbslq_u32(colorMask, vreinterpretq_u32_u8(shaded), p));
+	}
+	DesaturateScalar(px + i, n - i, params);
+}
+
+static void BlendAlphaNEON(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	const uint32x4_t lowByte = vdupq_n_u32(0xff);
+	const uint32x4_t colorMask = vdupq_n_u32(params.colorMask);
+	const uint32x4_t amask = vdupq_n_u32(params.amask);
+	const int32x4_t aShift = vdupq_n_s32(-int(params.aShift));
+	const uint16x8_t one = vdupq_n_u16(1);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t st = LoadStencilNEON(stencil + i);
+		uint32x4_t skip = vceqq_u32(st, lowByte);
+
+		uint32x4_t s = vld1q_u32(src + i);
+		uint32x4_t d = vld1q_u32(dst + i);
+		uint32x4_t a = vandq_u32(vsubq_u32(vshlq_u32(s, aShift), st), lowByte);
+		uint8x16_t a8 = vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101));
+		uint8x16_t ia8 = vmvnq_u8(a8);
+		uint8x16_t s8 = vreinterpretq_u8_u32(s);
+		uint8x16_t d8 = vreinterpretq_u8_u32(d);
+
+		uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s8), vget_low_u8(a8)), vget_low_u8(d8), vget_low_u8(ia8));
+		uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s8), vget_high_u8(a8)), vget_high_u8(d8), vget_high_u8(ia8));
+		lo = vaddq_u16(lo, one);
+		hi = vaddq_u16(hi, one);
+		uint8x16_t blended = vcombine_u8(vshrn_n_u16(vsraq_n_u16(lo, lo, 8), 8), vshrn_n_u16(vsraq_n_u16(hi, hi, 8), 8));
+
+		uint32x4_t out = vorrq_u32(vandq_u32(vreinterpretq_u32_u8(blended), colorMask), amask);
+		vst1q_u32(dst + i, vbslq_u32(skip, d, out));
+	}
+	BlendAlphaScalar(dst + i, src + i, stencil + i, n - i, params);
+}
+
+static void BlendHalfNEON(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams& params)
+{
+	const uint32x4_t lowByte = vdupq_n_u32(0xff);
+	const uint32x4_t halfmask = vdupq_n_u32((params.colorMask >> 1) & 0x7f7f7f7f);
+	const uint32x4_t amask = vdupq_n_u32(params.amask);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t skip = vceqq_u32(LoadStencilNEON(stencil + i), lowByte);
+		uint32x4_t s = vld1q_u32(src + i);
+		uint32x4_t d = vld1q_u32(dst + i);
+		uint32x4_t out = vaddq_u32(vandq_u32(vshrq_n_u32(d, 1), halfmask), vandq_u32(vshrq_n_u32(s, 1), halfmask));
+		vst1q_u32(dst + i, vbslq_u32(skip, d, vorrq_u32(out, amask)));
+	}
+	BlendHalfScalar(dst + i, src + i, stencil + i, n - i, params);
+}
+
+// NEON has no gather, so the expansion stays scalar
+static const PixelKernels neonKernels {
+	"NEON", ExpandScalar, ScaleNEON, DesaturateNEON, BlendAlphaNEON, BlendHalfNEON
+};
+
+#endif
+
+const PixelKernels& PixelKernels::Scalar() noexcept
+{
+	return scalarKernels;
+}
+
+std::vector<const PixelKernels*> PixelKernels::Available()
+{
+	std::vector<const PixelKernels*> sets { &scalarKernels };
+#if defined(KERNELS_X86)
+	bool sse2 = false;
+	bool avx2 = false;
+	DetectX86(sse2, avx2);
+	if (sse2) sets.push_back(&sse2Kernels);
+	if (avx2) sets.push_back(&avx2Kernels);
+#elif defined(KERNELS_NEON)
+	// only defined when NEON is part of the target, so there is nothing to detect
+	sets.push_back(&neonKernels);
+#endif
+	return sets;
+}
+
+const PixelKernels& PixelKernels::Get() noexcept
+{
+	static const PixelKernels& kernels = []() -> const PixelKernels& {
+		const PixelKernels* best = Available().back();
+		Log(MESSAGE, "Video", "Using {} pixel kernels.", best->name);
+		return *best;
+	}();
+	return kernels;
+}
+
+}
@@ -0,0 +1,135 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include "Pixels.h"
+
+#include <vector>
+
+namespace GemRB {
+
+// a 32bpp format with a whole byte per channel, the only kind the row kernels handle
+// the alpha byte is the free one when the format has no alpha channel
+struct GEM_EXPORT PixelLayout {
+	uint8_t rShift = 0;
+	uint8_t gShift = 8;
+	uint8_t bShift = 16;
+	uint8_t aShift = 24;
+
+	static bool FromFormat(const PixelFormat& fmt, PixelLayout& layout) noexcept;
+
+	uint32_t ColorMask() const noexcept {
+		return (0xffU << rShift) | (0xffU << gShift) | (0xffU << bShift);
+	}
+
+	uint32_t AlphaMask() const noexcept {
+		return 0xffU << aShift;
+	}
+
+	uint32_t Pack(const Color& c) const noexcept {
+		return (uint32_t(c.r) << rShift) | (uint32_t(c.g) << gShift) | (uint32_t(c.b) << bShift) | (uint32_t(c.a) << aShift);
+	}
+};
+
+// byte = (byte * factor) >> 16 for every byte not in 'keep', then 'fill' is or-ed in
+// factors are indexed by the byte position of the channel (shift / 8)
+struct GEM_EXPORT ScaleParams {
+	uint16_t factor[4] {};
+	uint32_t keep = 0;
+	uint32_t fill = 0;
+
+	// channel = (channel * value) >> precision; value << (16 - precision) has to fit 16 bits
+	void Scale(uint8_t shift, unsigned int value, unsigned int precision) noexcept {
+		factor[shift / 8] = uint16_t(value << (16 - precision));
+	}
+
+	void Keep(uint8_t shift) noexcept {
+		keep |= 0xffU << shift;
+	}
+
+	void Fill(uint8_t shift, uint8_t value) noexcept {
+		factor[shift / 8] = 0;
+		fill |= uint32_t(value) << shift;
+	}
+
+	void ScaleColor(const PixelLayout& layout, const Color& tint, unsigned int precision) noexcept {
+		Scale(layout.rShift, tint.r, precision);
+		Scale(layout.gShift, tint.g, precision);
+		Scale(layout.bShift, tint.b, precision);
+	}
+};
+
+// the sum of the color bytes replaces each of them, then 'add' and 'sub' are
+// applied with unsigned saturation (all zero for greyscale)
+struct GEM_EXPORT DesaturateParams {
+	uint32_t colorMask = 0;
+	uint32_t add = 0;
+	uint32_t sub = 0;
+
+	static DesaturateParams Greyscale(const PixelLayout& layout) noexcept {
+		DesaturateParams params;
+		params.colorMask = layout.ColorMask();
+		return params;
+	}
+
+	static DesaturateParams Sepia(const PixelLayout& layout) noexcept {
+		DesaturateParams params = Greyscale(layout);
+		params.add = 21U << layout.rShift;
+		params.sub = 32U << layout.bShift;
+		return params;
+	}
+};
+
+// the blenders write the color bytes of 'dst' and or in 'amask' (the destination Amask)
+// a stencil value of 0xff leaves the pixel alone, anything else is subtracted from the source alpha
+struct GEM_EXPORT BlendParams {
+	uint32_t colorMask = 0;
+	uint32_t amask = 0;
+	uint8_t aShift = 24;
+
+	BlendParams(const PixelLayout& layout, uint32_t amask) noexcept
+	: colorMask(layout.ColorMask()), amask(amask), aShift(layout.aShift) {}
+};
+
+// row kernels for the software renderer, picked once at runtime by CPU features
+struct GEM_EXPORT PixelKernels {
+	using BlendRow = void (*)(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, const BlendParams&);
+
+	const char* name;
+	// dst[i] = palette[indices[i]]
+	void (*Expand)(const uint8_t* indices, const uint32_t* palette, uint32_t* dst, int n);
+	void (*Scale)(uint32_t* px, int n, const ScaleParams&);
+	void (*Desaturate)(uint32_t* px, int n, const DesaturateParams&);
+	// source over destination, like ShaderBlend
+	BlendRow BlendAlpha;
+	// the average of source and destination, ignoring alpha
+	BlendRow BlendHalf;
+
+	static const PixelKernels& Get() noexcept;
+	static const PixelKernels& Scalar() noexcept;
+	// every set this CPU can run, from the scalar one to the one Get picks
+	static std::vector<const PixelKernels*> Available();
+};
+
+}
+
+#endif // PIXELKERNELS_H
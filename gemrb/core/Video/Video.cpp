@@ -137,6 +137,8 @@ int Video::SwapBuffers(unsigned int fpscap)
 {
 	SwapBuffers(drawingBuffers);
 	drawingBuffers.clear();
+	lastFrameStats = frameStats;
+	frameStats = FrameStats();
 	drawingBuffer = NULL;
 	SetScreenClip(NULL);
 
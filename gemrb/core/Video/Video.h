@@ -86,6 +86,15 @@ public:
 		YV12    // YUV format for BIK videos
 	};
 
+	// what a driver did to draw a frame, for profiling
+	struct FrameStats {
+		uint32_t blits = 0; // sprites and buffers drawn
+		uint32_t drawCalls = 0; // submissions to the backend
+		uint32_t batchedBlits = 0; // blits merged into a batched submission
+		uint32_t flushes = 0; // forced flushes of the backend command queue
+		uint32_t uploads = 0; // textures (re)uploaded
+	};
+
 protected:
 	tick_t lastTime = 0;
 	EventMgr* EvntManager = nullptr;
@@ -108,6 +117,8 @@ protected:
 	// the current top of drawingBuffers that draw operations occur on
 	VideoBuffer* drawingBuffer = nullptr;
 	VideoBufferPtr stencilBuffer = nullptr;
+	FrameStats frameStats;
+	FrameStats lastFrameStats;
 
 	Region ClippedDrawingRect(const Region& target, const Region* clip = NULL) const;
 	virtual void Wait(uint32_t) = 0;
@@ -146,6 +157,8 @@ public:
 	bool GetFullscreenMode() const;
 	/** Swaps displayed and back buffers */
 	int SwapBuffers(unsigned int fpscap = 30);
+	/** The counters of the last complete frame */
+	const FrameStats& GetFrameStats() const { return lastFrameStats; }
 	VideoBufferPtr CreateBuffer(const Region&, BufferFormat = BufferFormat::DISPLAY);
 	void PushDrawingBuffer(const VideoBufferPtr&);
 	void PopDrawingBuffer();
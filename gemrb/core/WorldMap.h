@@ -130,7 +130,7 @@ public: //struct members
 	ResRef MapIconResRef;
 	ieDword Flags = 0;
 
-	AnimationFactory* bam = nullptr;
+	Holder<AnimationFactory> bam;
 private: //non-struct members
 	Holder<Sprite2D> MapMOS = nullptr;
 	std::vector<WMPAreaEntry> area_entries;
@@ -141,7 +141,7 @@ private: //non-struct members
 public:
 	WorldMap() noexcept = default;
 
-	void SetMapIcons(AnimationFactory *bam);
+	void SetMapIcons(Holder<AnimationFactory> bam);
 	Holder<Sprite2D> GetMapMOS() const { return MapMOS; }
 	void SetMapMOS(Holder<Sprite2D> newmos);
 	int GetEntryCount() const { return (int) area_entries.size(); }
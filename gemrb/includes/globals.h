@@ -45,6 +45,7 @@
 #include "Streams/DataStream.h"
 
 #include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <climits>
 #include <chrono>
@@ -180,8 +181,17 @@ GEM_EXPORT int CountElements(const char *str, char separator);
 #define SCHEDULE_MASK(time) (1 << core->Time.GetHour(time - core->Time.hour_size/2))
 
 using tick_t = unsigned long; // milliseconds
+// while set (non-zero), the fixed clock replaces the real one; see Interface::Main
+// only the main loop changes it, but other threads (ambients, prefetch, audio, saving) read it
+extern GEM_EXPORT std::atomic<tick_t> fixedClock;
+GEM_EXPORT void SetFixedClock(tick_t time);
+
 inline tick_t GetMilliseconds()
 {
+	tick_t fixed = fixedClock.load(std::memory_order_relaxed);
+	if (fixed) {
+		return fixed;
+	}
 	using namespace std::chrono;
 	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
 }
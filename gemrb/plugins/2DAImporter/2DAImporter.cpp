@@ -27,16 +27,53 @@ using namespace GemRB;
 
 #define SIGNLENGTH 256      //if a 2da has longer default value, change this
 
-static bool StringCompKey(const std::string& str, TableMgr::key_t key)
-{
-	return stricmp(str.c_str(), key.c_str()) == 0;
-}
-
 p2DAImporter::p2DAImporter() noexcept
 {
 	colNames.reserve(10);
 	rowNames.reserve(10);
-	rows.reserve(10);
+	rowLengths.reserve(10);
+}
+
+// the first of equal names wins, returns the value kept
+p2DAImporter::index_t p2DAImporter::AddName(NameIndex& index, const key_t& key, index_t value)
+{
+	NameIndex::hash_t hash = index.Hash(key);
+	size_t pos = index.Find(key, hash);
+	if (pos == NameIndex::npos) {
+		pos = index.Insert(std::string(key.c_str(), key.length()), value, hash);
+	}
+	return index[pos].value;
+}
+
+p2DAImporter::index_t p2DAImporter::FindName(const NameIndex& index, const key_t& key)
+{
+	size_t pos = index.Find(key);
+	return pos == NameIndex::npos ? npos : index[pos].value;
+}
+
+p2DAImporter::Cell p2DAImporter::ParseCell(const char* text, index_t id)
+{
+	Cell cell;
+	char* end = nullptr;
+	cell.text = id;
+	cell.signedVal = strtol(text, &end, 0);
+	cell.numeric = end != text;
+	cell.unsignedVal = strtoul(text, nullptr, 0);
+	return cell;
+}
+
+p2DAImporter::index_t p2DAImporter::Intern(const char* text, std::unordered_map<std::string, index_t>& interned)
+{
+	// a lone asterisk stands for the default value
+	if (text[0] == '*' && !text[1]) {
+		return 0;
+	}
+	auto it = interned.emplace(text, index_t(strings.size()));
+	if (it.second) {
+		strings.emplace_back(text);
+		foldedStrings.push_back(AddName(foldedIndex, key_t(text), index_t(foldedIndex.Size())));
+	}
+	return it.first->second;
 }
 
 bool p2DAImporter::Open(DataStream* str)
@@ -64,8 +101,15 @@ bool p2DAImporter::Open(DataStream* str)
 	} else { // no whitespace
 		defVal = Signature;
 	}
+	std::unordered_map<std::string, index_t> interned;
+	strings.push_back(defVal);
+	AddName(foldedIndex, key_t(defVal), 0);
+	foldedStrings.push_back(0);
+	interned.emplace(defVal, 0);
+	defCell = ParseCell(defVal.c_str(), 0);
+
 	bool colHead = true;
-	int row = 0;
+	std::vector<std::vector<index_t>> rows;
 	
 	constexpr int MAXLENGTH = 8192;
 	char buffer[MAXLENGTH]; // we can increase this if needed, but beware since it is a stack buffer
@@ -82,6 +126,7 @@ bool p2DAImporter::Open(DataStream* str)
 			colHead = false;
 			const char* cell = strtok(buffer, " ");
 			while (cell != nullptr) {
+				AddName(colIndex, key_t(cell), index_t(colNames.size()));
 				colNames.emplace_back(cell);
 				cell = strtok(nullptr, " ");
 			}
@@ -90,27 +135,45 @@ bool p2DAImporter::Open(DataStream* str)
 			const char* cell = strtok(line, " ");
 			if (cell == nullptr) continue;
 
+			AddName(rowIndex, key_t(cell), index_t(rowNames.size()));
 			rowNames.emplace_back(cell);
 			rows.emplace_back();
-			rows[row].reserve(10);
+			rows.back().reserve(10);
 			cell = strtok(nullptr, " ");
 			while (cell != nullptr) {
-				rows[row].emplace_back(cell);
+				rows.back().push_back(Intern(cell, interned));
 				cell = strtok(nullptr, " ");
 			}
-			row++;
 		}
 	}
 
 	delete str;
 	assert(rows.size() < std::numeric_limits<index_t>::max());
+
+	// parse each distinct value once, then lay the cells out by column
+	std::vector<Cell> parsed;
+	parsed.reserve(strings.size());
+	for (index_t id = 0; id < strings.size(); id++) {
+		parsed.push_back(ParseCell(strings[id].c_str(), id));
+	}
+	size_t width = 0;
+	for (const auto& row : rows) {
+		width = std::max(width, row.size());
+		rowLengths.push_back(static_cast<index_t>(row.size()));
+	}
+	columns.assign(width, column_t(rows.size(), defCell));
+	for (size_t row = 0; row < rows.size(); row++) {
+		for (size_t col = 0; col < rows[row].size(); col++) {
+			columns[col][row] = parsed[rows[row][col]];
+		}
+	}
 	return true;
 }
 
 /** Returns the actual number of Rows in the Table */
 p2DAImporter::index_t p2DAImporter::GetRowCount() const
 {
-	return static_cast<index_t>(rows.size());
+	return static_cast<index_t>(rowLengths.size());
 }
 
 p2DAImporter::index_t p2DAImporter::GetColNamesCount() const
@@ -121,25 +184,35 @@ p2DAImporter::index_t p2DAImporter::GetColNamesCount() const
 /** Returns the actual number of Columns in the Table */
 p2DAImporter::index_t p2DAImporter::GetColumnCount(index_t row) const
 {
-	if (rows.size() <= row) {
+	if (rowLengths.size() <= row) {
 		return 0;
 	}
-	return static_cast<index_t>(rows[row].size());
+	return rowLengths[row];
+}
+
+const p2DAImporter::Cell& p2DAImporter::GetCell(index_t row, index_t column) const
+{
+	if (rowLengths.size() <= row || rowLengths[row] <= column) {
+		return defCell;
+	}
+	return columns[column][row];
 }
+
 /** Returns a pointer to a zero terminated 2da element,
 	if it cannot return a value, it returns the default */
 const std::string& p2DAImporter::QueryField(index_t row, index_t column) const
 {
-	if (rows.size() <= row) {
-		return defVal;
-	}
-	if (rows[row].size() <= column) {
-		return defVal;
-	}
-	if (rows[row][column][0]=='*' && !rows[row][column][1]) {
-		return defVal;
-	}
-	return rows[row][column];
+	return strings[GetCell(row, column).text];
+}
+
+long p2DAImporter::QueryFieldLong(index_t row, index_t column) const
+{
+	return GetCell(row, column).signedVal;
+}
+
+unsigned long p2DAImporter::QueryFieldULong(index_t row, index_t column) const
+{
+	return GetCell(row, column).unsignedVal;
 }
 
 const std::string& p2DAImporter::QueryDefault() const
@@ -149,22 +222,12 @@ const std::string& p2DAImporter::QueryDefault() const
 
 p2DAImporter::index_t p2DAImporter::GetRowIndex(const key_t& key) const
 {
-	for (index_t index = 0; index < rowNames.size(); index++) {
-		if (StringCompKey(rowNames[index], key)) {
-			return index;
-		}
-	}
-	return npos;
+	return FindName(rowIndex, key);
 }
 
 p2DAImporter::index_t p2DAImporter::GetColumnIndex(const key_t& key) const
 {
-	for (index_t index = 0; index < colNames.size(); index++) {
-		if (StringCompKey(colNames[index], key)) {
-			return index;
-		}
-	}
-	return npos;
+	return FindName(colIndex, key);
 }
 
 const static std::string blank;
@@ -188,9 +251,8 @@ p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, long val, index_
 {
 	index_t max = GetRowCount();
 	for (index_t row = start; row < max; row++) {
-		const std::string& ret = QueryField( row, col );
-		long Value;
-		if (valid_signednumber(ret.c_str(), Value) && (Value == val))
+		const Cell& cell = GetCell(row, col);
+		if (cell.numeric && cell.signedVal == val)
 			return row;
 	}
 	return npos;
@@ -198,10 +260,13 @@ p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, long val, index_
 
 p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, const key_t& val, index_t start) const
 {
+	index_t folded = FindName(foldedIndex, val);
+	if (folded == npos) {
+		return npos;
+	}
 	index_t max = GetRowCount();
 	for (index_t row = start; row < max; row++) {
-		const std::string& ret = QueryField( row, col );
-		if (StringCompKey(ret, val))
+		if (foldedStrings[GetCell(row, col).text] == folded)
 			return row;
 	}
 	return npos;
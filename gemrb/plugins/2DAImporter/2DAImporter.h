@@ -24,21 +24,54 @@
 #include "TableMgr.h"
 
 #include "globals.h"
+#include "OpenHashMap.h"
+#include "Strings/CString.h"
 
 #include <cstring>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
 
 class p2DAImporter : public TableMgr {
 private:
-	using cell_t = std::string;
-	using row_t = std::vector<cell_t>;
-
-	std::vector<cell_t> colNames;
-	std::vector<cell_t> rowNames;
-	std::vector<row_t> rows;
+	// cells are stored by column, with their numeric values parsed up front
+	// and their text interned, so lookups neither parse nor compare strings
+	struct Cell {
+		index_t text = 0; // index into strings, 0 is the default value
+		long signedVal = 0;
+		unsigned long unsignedVal = 0;
+		bool numeric = false;
+	};
+	using column_t = std::vector<Cell>;
+	// case insensitive, so lookups can hash and compare the passed keys as they are
+	using KeyHash = CstrHashCI<key_t>;
+	struct KeyEqual {
+		bool operator()(const std::string& stored, const key_t& key) const
+		{
+			return stored.length() == key.length() && !strnicmp(stored.c_str(), key.c_str(), key.length());
+		}
+	};
+	using NameIndex = OpenHashMap<std::string, index_t, KeyHash, KeyEqual>;
+
+	std::vector<std::string> colNames;
+	std::vector<std::string> rowNames;
+	std::vector<column_t> columns; // columns[col][row]
+	std::vector<index_t> rowLengths;
+	std::vector<std::string> strings;
+	std::vector<index_t> foldedStrings; // case insensitive id for each of strings
+	NameIndex foldedIndex;
+	NameIndex rowIndex;
+	NameIndex colIndex;
 	std::string defVal;
+	Cell defCell;
+
+	index_t Intern(const char* text, std::unordered_map<std::string, index_t>& interned);
+	static Cell ParseCell(const char* text, index_t id);
+	static index_t AddName(NameIndex& index, const key_t& key, index_t value);
+	static index_t FindName(const NameIndex& index, const key_t& key);
+	const Cell& GetCell(index_t row, index_t column) const;
 public:
 	p2DAImporter() noexcept;
 
@@ -54,6 +87,8 @@ public:
 	/** Returns a pointer to a zero terminated 2da element,
 		if it cannot return a value, it returns the default */
 	const std::string& QueryField(index_t row = 0, index_t column = 0) const override;
+	long QueryFieldLong(index_t row, index_t column) const override;
+	unsigned long QueryFieldULong(index_t row, index_t column) const override;
 	const std::string& QueryDefault() const override;
 
 	index_t GetRowIndex(const key_t& string) const override;
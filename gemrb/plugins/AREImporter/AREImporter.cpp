@@ -365,7 +365,7 @@ bool AREImporter::ChangeMap(Map *map, bool day_or_night)
 	if (day_or_night) {
 		TmpResRef = map->WEDResRef;
 	} else {
-		TmpResRef.Format("{.7:}N", map->WEDResRef);
+		TmpResRef.Format("{:.7}N", map->WEDResRef);
 	}
 	PluginHolder<TileMapMgr> tmm = MakePluginHolder<TileMapMgr>(IE_WED_CLASS_ID);
 	DataStream* wedfile = gamedata->GetResource( TmpResRef, IE_WED_CLASS_ID );
@@ -473,6 +473,79 @@ static Ambient* SetupMainAmbients(Map *map, bool day_or_night) {
 	return ambi;
 }
 
+// the tilesets are only known after reading the wed overlays
+static std::vector<PrefetchRequest> WEDTilesets(DataStream& wed)
+{
+	std::vector<PrefetchRequest> tilesets;
+	char Signature[8];
+	ieDword overlaysCount;
+	ieDword overlaysOffset;
+	wed.Read(Signature, 8);
+	if (strncmp(Signature, "WED V1.3", 8) != 0) {
+		return tilesets;
+	}
+	wed.ReadDword(overlaysCount);
+	wed.Seek(4, GEM_CURRENT_POS);
+	wed.ReadDword(overlaysOffset);
+	for (ieDword i = 0; i < overlaysCount; i++) {
+		ResRef tis;
+		wed.Seek(overlaysOffset + i * 0x18 + 4, GEM_STREAM_START);
+		wed.ReadResRef(tis);
+		tilesets.emplace_back(tis, IE_TIS_CLASS_ID);
+	}
+	return tilesets;
+}
+
+std::vector<PrefetchRequest> AREImporter::GetDependencies(bool day_or_night)
+{
+	if (!(AreaFlags & AT_EXTENDED_NIGHT))
+		day_or_night = true;
+
+	std::vector<PrefetchRequest> deps;
+	// in the order GetMap needs them
+	deps.emplace_back(WEDResRef, IE_WED_CLASS_ID);
+	deps.back().expand = WEDTilesets;
+
+	ResRef TmpResRef;
+	if (day_or_night) {
+		deps.emplace_back(WEDResRef, IE_MOS_CLASS_ID);
+		TmpResRef.Format("{:.6}LM", WEDResRef);
+	} else {
+		TmpResRef.Format("{:.7}N", WEDResRef);
+		deps.emplace_back(TmpResRef, IE_MOS_CLASS_ID);
+		TmpResRef.Format("{:.6}LN", WEDResRef);
+	}
+	deps.emplace_back(TmpResRef, IE_BMP_CLASS_ID);
+	TmpResRef.Format("{:.6}SR", WEDResRef);
+	deps.emplace_back(TmpResRef, IE_BMP_CLASS_ID);
+	TmpResRef.Format("{:.6}HT", WEDResRef);
+	deps.emplace_back(TmpResRef, IE_BMP_CLASS_ID);
+	deps.emplace_back(Script, IE_BCS_CLASS_ID);
+
+	ResRef ref;
+	for (ieWord i = 0; i < ActorCount; i++) {
+		ieDword flags;
+		ieDword creOffset;
+		str->Seek(ActorOffset + i * 0x110 + 0x28, GEM_STREAM_START);
+		str->ReadDword(flags);
+		str->Seek(ActorOffset + i * 0x110 + 0x80, GEM_STREAM_START);
+		str->ReadResRef(ref);
+		str->ReadDword(creOffset);
+		// embedded creatures are already here
+		if (creOffset == 0 || (flags & 1)) {
+			deps.emplace_back(ref, IE_CRE_CLASS_ID);
+		}
+	}
+
+	for (ieDword i = 0; i < AnimCount; i++) {
+		str->Seek(AnimOffset + i * 0x4c + 0x28, GEM_STREAM_START);
+		str->ReadResRef(ref);
+		deps.emplace_back(ref, IE_BAM_CLASS_ID);
+	}
+
+	return deps;
+}
+
 Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 {
 	// if this area does not have extended night, force it to day mode
@@ -494,7 +567,7 @@ Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 	if (day_or_night) {
 		TmpResRef = WEDResRef;
 	} else {
-		TmpResRef.Format("{.7:}N", WEDResRef);
+		TmpResRef.Format("{:.7}N", WEDResRef);
 	}
 
 	// Small map for MapControl
@@ -752,9 +825,9 @@ Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 		ip->UsePoint = pos;
 		//FIXME: PST doesn't use this field
 		if (ip->GetUsePoint()) {
-			ip->Pos = ip->UsePoint;
+			ip->SetPos(ip->UsePoint);
 		} else {
-			ip->Pos = bbox.Center();
+			ip->SetPos(bbox.Center());
 		}
 		ip->Destination = Destination;
 		ip->EntranceName = Entrance;
@@ -852,7 +925,7 @@ Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 		}
 
 		//c->SetMap(map);
-		c->Pos = pos;
+		c->SetPos(pos);
 		c->LockDifficulty = LockDiff;
 		c->Flags = Flags;
 		c->TrapDetectionDiff = TrapDetDiff;
@@ -1219,8 +1292,8 @@ Map* AREImporter::GetMap(const ResRef& resRef, bool day_or_night)
 		if (pst && act->GetBase(IE_STATE_ID) & STATE_DEAD && act->GetBase(IE_MC_FLAGS) & MC_REMOVE_CORPSE) {
 			continue;
 		}
+		act->SetPos(pos);
 		map->AddActor(act, false);
-		act->Pos = pos;
 		act->Destination = des;
 		act->HomeLocation = des;
 		act->maxWalkDistance = maxDistance;
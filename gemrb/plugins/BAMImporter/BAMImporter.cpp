@@ -28,6 +28,8 @@
 #include "Video/RLE.h"
 #include "Streams/FileStream.h"
 
+#include <memory>
+
 using namespace GemRB;
 
 bool BAMImporter::Import(DataStream* str)
@@ -108,33 +110,80 @@ BAMImporter::index_t BAMImporter::GetCycleSize(index_t cycle)
 	return cycles[cycle].FramesCount;
 }
 
-Holder<Sprite2D> BAMImporter::GetFrameInternal(const FrameEntry& frameInfo, bool RLESprite, uint8_t* data)
+// everything needed to decode the frames after the importer is gone
+struct BAMFrameData : std::enable_shared_from_this<BAMFrameData> {
+	std::vector<uint8_t> data; // the frame data, starting at DataStart
+	std::vector<FrameEntry> frames;
+	PaletteHolder palette;
+	strpos_t dataStart;
+	ieByte colorKey;
+	bool allowCompression;
+	// whether the video driver blits RLE sprites as they are, unknown until the first one
+	int keepsRLE = -1;
+
+	Holder<Sprite2D> Decode(AnimationFactory::index_t idx, size_t& bytes);
+};
+
+// an RLE frame that points into the retained BAM data instead of holding a copy
+class BAMFrameSprite : public Sprite2D {
+	std::shared_ptr<const BAMFrameData> source;
+
+public:
+	BAMFrameSprite(const Region& rgn, uint8_t* pixels, const PixelFormat& fmt, std::shared_ptr<const BAMFrameData> src) noexcept
+	: Sprite2D(rgn, pixels, fmt), source(std::move(src))
+	{
+		freePixels = false;
+	}
+
+	Holder<Sprite2D> copy() const override
+	{
+		Holder<Sprite2D> spr(new BAMFrameSprite(Frame, static_cast<uint8_t*>(pixels), format, source));
+		spr->renderFlags = renderFlags;
+		return spr;
+	}
+};
+
+Holder<Sprite2D> BAMFrameData::Decode(AnimationFactory::index_t idx, size_t& bytes)
 {
 	Holder<Sprite2D> spr;
 	Video* video = core->GetVideoDriver();
+	const FrameEntry& frameInfo = frames[idx];
 	const Region& rgn = frameInfo.bounds;
-	uint8_t* dataBegin = data + frameInfo.dataOffset;
+	uint8_t* dataBegin = data.data() + frameInfo.dataOffset - dataStart;
 	
-	if (RLESprite) {
-		PixelFormat fmt = PixelFormat::RLE8Bit(palette, CompressedColorIndex);
-		const uint8_t* dataEnd = FindRLEPos(dataBegin, rgn.w, Point(rgn.w, rgn.h - 1), CompressedColorIndex);
+	if (allowCompression && frameInfo.RLE) {
+		PixelFormat fmt = PixelFormat::RLE8Bit(palette, colorKey);
+		const uint8_t* dataEnd = FindRLEPos(dataBegin, rgn.w, Point(rgn.w, rgn.h - 1), colorKey);
 		ptrdiff_t dataLen = dataEnd - dataBegin;
 		if (dataLen == 0) return nullptr;
+		if (keepsRLE == 1) {
+			bytes = 0;
+			return Holder<Sprite2D>(new BAMFrameSprite(rgn, dataBegin, fmt, shared_from_this()));
+		}
+
 		void* pixels = malloc(dataLen);
 		memcpy(pixels, dataBegin, dataLen);
 		spr = video->CreateSprite(rgn, pixels, fmt);
+		if (!spr) return nullptr;
+		// drivers that decode RLE anyway got a throwaway copy, the rest can share our data
+		keepsRLE = spr->Format().RLE;
+		if (keepsRLE) {
+			bytes = 0;
+			return Holder<Sprite2D>(new BAMFrameSprite(rgn, dataBegin, fmt, shared_from_this()));
+		}
 	} else {
 		void* pixels = nullptr;
 		if (frameInfo.RLE) {
-			pixels = DecodeRLEData(dataBegin, rgn.size, CompressedColorIndex);
+			pixels = DecodeRLEData(dataBegin, rgn.size, colorKey);
 		} else {
 			pixels = malloc(rgn.w * rgn.h);
 			memcpy(pixels, dataBegin, rgn.w * rgn.h);
 		}
-		PixelFormat fmt = PixelFormat::Paletted8Bit(palette, true, CompressedColorIndex);
+		PixelFormat fmt = PixelFormat::Paletted8Bit(palette, true, colorKey);
 		spr = video->CreateSprite(rgn, pixels, fmt);
 	}
 
+	bytes = spr ? spr->GetPitch() * spr->Frame.h : 0;
 	return spr;
 }
 
@@ -162,17 +211,21 @@ AnimationFactory* BAMImporter::GetAnimationFactory(const ResRef &resref, bool al
 	if (length == 0) return nullptr;
 	
 	auto FLT = CacheFLT();
-	uint8_t *data = (uint8_t*)malloc(length);
-	str->Read(data, length);
-
-	std::vector<Holder<Sprite2D>> animframes;
-	for (const auto& frameInfo : frames) {
-		bool RLECompressed = allowCompression && frameInfo.RLE;
-		animframes.push_back(GetFrameInternal(frameInfo, RLECompressed, data - DataStart));
-	}
-	free(data);
-
-	return new AnimationFactory(resref, std::move(animframes), cycles, std::move(FLT));
+	// only the compact BAM data is kept, frames are decoded when first used
+	auto frameData = std::make_shared<BAMFrameData>();
+	frameData->data.resize(length);
+	str->Read(frameData->data.data(), length);
+	frameData->frames = frames;
+	frameData->palette = palette;
+	frameData->dataStart = DataStart;
+	frameData->colorKey = CompressedColorIndex;
+	frameData->allowCompression = allowCompression;
+
+	auto loader = [frameData](index_t idx, size_t& bytes) {
+		return frameData->Decode(idx, bytes);
+	};
+	size_t loaderBytes = sizeof(BAMFrameData) + length + frames.size() * sizeof(FrameEntry);
+	return new AnimationFactory(resref, index_t(frames.size()), std::move(loader), loaderBytes, cycles, std::move(FLT));
 }
 
 /** Debug Function: Returns the Global Animation Palette as a Sprite2D Object.
@@ -61,7 +61,6 @@ private:
 	ieDword PaletteOffset = 0;
 	ieDword FLTOffset = 0;
 	strpos_t DataStart = 0;
-	Holder<Sprite2D> GetFrameInternal(const FrameEntry& frame, bool RLESprite, uint8_t* data);
 	std::vector<index_t> CacheFLT();
 };
 
@@ -26,59 +26,245 @@
 #include "Streams/SlicedStream.h"
 #include "Streams/FileCache.h"
 #include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
 #if defined(SUPPORTS_MEMSTREAM)
 #include "Streams/MappedFileMemoryStream.h"
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <list>
+#include <unordered_map>
+
 using namespace GemRB;
 
-BIFImporter::~BIFImporter(void)
-{
-	delete stream;
-	if (fentries) {
-		delete[] fentries;
+// archives stay open after their first use, so resources can be read
+// without reopening (and remapping) the bif each time; an archive that is
+// still loading is already listed, so others wait for it instead of loading
+// it again, while the lock is only held to look it up
+static const size_t MAX_OPEN_ARCHIVES = 16;
+static std::list<std::pair<std::string, std::shared_future<std::shared_ptr<BIFArchive>>>> openArchives;
+static std::mutex archivesMutex;
+// split between the open archives, so all the BIFC block caches together
+// stay below it (archives dropped from the list keep theirs until their
+// last stream is gone)
+static const size_t BIFC_CACHE_BUDGET = 32 * 1024 * 1024;
+
+/** A read-only view into the mapping of an archive, which it keeps alive. */
+class BIFSliceStream : public MemoryStream {
+	std::shared_ptr<BIFArchive> archive;
+
+public:
+	BIFSliceStream(std::shared_ptr<BIFArchive> archive, const char* name, const char* start, strpos_t size)
+	: MemoryStream(name, const_cast<char*>(start), size), archive(std::move(archive))
+	{}
+	~BIFSliceStream() override
+	{
+		// the memory belongs to the mapping, don't let MemoryStream free it
+		data = nullptr;
 	}
-	if (tentries) {
-		delete[] tentries;
+
+	strret_t Write(const void*, strpos_t) override { return Error; }
+	DataStream* Clone() const noexcept override
+	{
+		return new BIFSliceStream(archive, originalfile, data, size);
 	}
-}
+};
+
+/** Decompressed blocks of a BIFC file, inflated on demand and kept in a size limited cache. */
+class BIFCBlocks {
+	struct Block {
+		strpos_t start; // offset in the decompressed data
+		strpos_t compOffset; // offset in the compressed file
+		ieDword compLen;
+		ieDword decLen;
+	};
+
+	// Compressor only writes to streams, this one fills a block buffer
+	class BlockWriter : public DataStream {
+		std::vector<char>& buffer;
+	public:
+		explicit BlockWriter(std::vector<char>& buf) : buffer(buf) { size = buf.size(); }
+		strret_t Read(void*, strpos_t) override { return Error; }
+		strret_t Write(const void* src, strpos_t len) override
+		{
+			if (Pos + len > size) return Error;
+			memcpy(buffer.data() + Pos, src, len);
+			Pos += len;
+			return len;
+		}
+		stroff_t Seek(stroff_t pos, strpos_t startpos) override
+		{
+			if (startpos != GEM_STREAM_START) return Error;
+			Pos = pos;
+			return 0;
+		}
+	};
+
+	static const size_t CACHE_SIZE = BIFC_CACHE_BUDGET / MAX_OPEN_ARCHIVES;
+
+	DataStream* source;
+	PluginHolder<Compressor> comp;
+	std::vector<Block> blocks;
+	strpos_t totalSize = 0;
+
+	std::mutex mutex;
+	std::list<size_t> recent; // most recently used first
+	std::unordered_map<size_t, std::pair<std::vector<char>, std::list<size_t>::iterator>> cache;
+	size_t cachedBytes = 0;
+
+	const std::vector<char>* GetBlock(size_t idx)
+	{
+		auto it = cache.find(idx);
+		if (it != cache.end()) {
+			recent.splice(recent.begin(), recent, it->second.second);
+			return &it->second.first;
+		}
+
+		const Block& block = blocks[idx];
+		std::vector<char> buffer(block.decLen);
+		BlockWriter out(buffer);
+		source->Seek(block.compOffset, GEM_STREAM_START);
+		if (comp->Decompress(&out, source, block.compLen) != GEM_OK || out.GetPos() != block.decLen) {
+			Log(ERROR, "BIFImporter", "Failed to decompress block {} of {}.", idx, source->filename);
+			return nullptr;
+		}
+
+		while (cachedBytes + buffer.size() > CACHE_SIZE && !recent.empty()) {
+			auto victim = cache.find(recent.back());
+			cachedBytes -= victim->second.first.size();
+			cache.erase(victim);
+			recent.pop_back();
+		}
+		recent.push_front(idx);
+		cachedBytes += buffer.size();
+		auto& entry = cache[idx];
+		entry.first = std::move(buffer);
+		entry.second = recent.begin();
+		return &entry.first;
+	}
+
+public:
+	BIFCBlocks(DataStream* compressed, PluginHolder<Compressor> compressor)
+	: source(compressed), comp(std::move(compressor))
+	{}
+	BIFCBlocks(const BIFCBlocks&) = delete;
+	~BIFCBlocks() { delete source; }
+	BIFCBlocks& operator=(const BIFCBlocks&) = delete;
 
-DataStream* BIFImporter::DecompressBIFC(DataStream* compressed, const char* path)
+	// reads the block headers, skipping over the data
+	bool ReadTable()
+	{
+		ieDword unCompBifSize;
+		source->ReadDword(unCompBifSize);
+		while (totalSize < unCompBifSize) {
+			Block block;
+			block.start = totalSize;
+			if (source->ReadDword(block.decLen) != 4 || source->ReadDword(block.compLen) != 4) {
+				return false;
+			}
+			block.compOffset = source->GetPos();
+			if (!block.decLen || block.compLen > source->Remains()) {
+				return false;
+			}
+			source->Seek(block.compLen, GEM_CURRENT_POS);
+			blocks.push_back(block);
+			totalSize += block.decLen;
+		}
+		return true;
+	}
+
+	strpos_t Size() const { return totalSize; }
+	const char* Name() const { return source->originalfile; }
+
+	bool Copy(strpos_t pos, void* dest, strpos_t len)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		char* out = static_cast<char*>(dest);
+		auto it = std::upper_bound(blocks.begin(), blocks.end(), pos, [](strpos_t p, const Block& b) {
+			return p < b.start;
+		});
+		size_t idx = std::distance(blocks.begin(), it) - 1;
+		while (len) {
+			if (idx >= blocks.size()) return false;
+			const std::vector<char>* block = GetBlock(idx);
+			if (!block) return false;
+			strpos_t offset = pos - blocks[idx].start;
+			strpos_t chunk = std::min<strpos_t>(len, block->size() - offset);
+			memcpy(out, block->data() + offset, chunk);
+			out += chunk;
+			pos += chunk;
+			len -= chunk;
+			idx++;
+		}
+		return true;
+	}
+};
+
+/** Random access to the decompressed contents of a BIFC file. */
+class BIFCStream : public DataStream {
+	std::shared_ptr<BIFCBlocks> blocks;
+
+public:
+	explicit BIFCStream(std::shared_ptr<BIFCBlocks> bifc)
+	: blocks(std::move(bifc))
+	{
+		size = blocks->Size();
+		ExtractFileFromPath(filename, blocks->Name());
+		strlcpy(originalfile, blocks->Name(), _MAX_PATH);
+	}
+
+	strret_t Read(void* dest, strpos_t length) override
+	{
+		if (Pos + length > size || !blocks->Copy(Pos, dest, length)) {
+			return Error;
+		}
+		Pos += length;
+		return length;
+	}
+
+	strret_t Write(const void*, strpos_t) override { return Error; }
+
+	stroff_t Seek(stroff_t newpos, strpos_t type) override
+	{
+		switch (type) {
+			case GEM_CURRENT_POS:
+				Pos += newpos;
+				break;
+			case GEM_STREAM_START:
+				Pos = newpos;
+				break;
+			case GEM_STREAM_END:
+				Pos = size - newpos;
+				break;
+			default:
+				return InvalidPos;
+		}
+		if (Pos > size) {
+			Log(ERROR, "Streams", "Invalid seek position: {} (limit: {})", Pos, size);
+			return InvalidPos;
+		}
+		return 0;
+	}
+
+	DataStream* Clone() const noexcept override
+	{
+		return new BIFCStream(blocks);
+	}
+};
+
+DataStream* BIFImporter::OpenBIFC(DataStream* compressed)
 {
-	Log(MESSAGE, "BIFImporter", "Decompressing {} ...", compressed->filename);
 	if (!core->IsAvailable( PLUGIN_COMPRESSION_ZLIB ))
 		return NULL;
-	PluginHolder<Compressor> comp = MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB);
-	ieDword unCompBifSize;
-	compressed->ReadDword(unCompBifSize);
-#if !defined(SUPPORTS_MEMSTREAM)
-	fflush(stdout);
-#endif
-	FileStream out;
-	if (!out.Create(path)) {
-		Log(ERROR, "BIFImporter", "Cannot write {}.", path);
+
+	auto bifc = std::make_shared<BIFCBlocks>(compressed, MakePluginHolder<Compressor>(PLUGIN_COMPRESSION_ZLIB));
+	if (!bifc->ReadTable()) {
+		Log(ERROR, "BIFImporter", "Corrupt block table in {}.", compressed->filename);
 		return NULL;
 	}
-	size_t finalsize = 0;
-	int laststep = 0;
-	while (finalsize < unCompBifSize) {
-		ieDword complen, declen;
-		compressed->ReadDword(declen);
-		compressed->ReadDword(complen);
-		if (comp->Decompress( &out, compressed, complen ) != GEM_OK) {
-			return NULL;
-		}
-		finalsize = out.GetPos();
-		if (( int ) ( finalsize * ( 10.0 / unCompBifSize ) ) != laststep) {
-			laststep++;
-		}
-	}
-	out.Close(); // This is necesary, since windows won't open the file otherwise.
-#if defined(SUPPORTS_MEMSTREAM)
-	return new MappedFileMemoryStream{path};
-#else
-	return FileStream::OpenFile(path);
-#endif
+	return new BIFCStream(std::move(bifc));
 }
 
 DataStream* BIFImporter::DecompressBIF(DataStream* compressed, const char* /*path*/)
@@ -92,17 +278,15 @@ DataStream* BIFImporter::DecompressBIF(DataStream* compressed, const char* /*pat
 	return CacheCompressedStream(compressed, compressed->filename, complen);
 }
 
-int BIFImporter::OpenArchive(const char* path)
+std::shared_ptr<BIFArchive> BIFImporter::LoadArchive(const char* path)
 {
-	delete stream;
-	stream = nullptr;
-
 	char filename[_MAX_PATH];
 	ExtractFileFromPath(filename, path);
 
 	char cachePath[_MAX_PATH];
 	PathJoin(cachePath, core->config.CachePath, filename, nullptr);
 	char Signature[8];
+	auto bif = std::make_shared<BIFArchive>();
 #if defined(SUPPORTS_MEMSTREAM)
 	auto cacheStream = new MappedFileMemoryStream{cachePath};
 
@@ -113,101 +297,162 @@ int BIFImporter::OpenArchive(const char* path)
 		if (!file->isOk()) {
 			delete file;
 #else
-	stream = FileStream::OpenFile(cachePath);
+	bif->stream = FileStream::OpenFile(cachePath);
 
-	if (!stream) {
+	if (!bif->stream) {
 		FileStream *file = FileStream::OpenFile(path);
 	if (!file) {
 #endif
-			return GEM_ERROR;
+			return nullptr;
 		}
 		if (file->Read(Signature, 8) == GEM_ERROR) {
 			delete file;
-			return GEM_ERROR;
+			return nullptr;
 		}
 
 		if (strncmp(Signature, "BIF V1.0", 8) == 0) {
-			stream = DecompressBIF(file, cachePath);
+			bif->stream = DecompressBIF(file, cachePath);
 			delete file;
 		} else if (strncmp(Signature, "BIFCV1.0", 8) == 0) {
-			stream = DecompressBIFC(file, cachePath);
-			delete file;
+			// the blocks are inflated as they are needed, the stream owns the file now
+			bif->stream = OpenBIFC(file);
+			if (!bif->stream) delete file;
 		} else if (strncmp( Signature, "BIFFV1  ", 8 ) == 0) {
 			file->Seek(0, GEM_STREAM_START);
-			stream = file;
+			bif->stream = file;
 		} else {
 			delete file;
-			return GEM_ERROR;
+			return nullptr;
 		}
 #if defined(SUPPORTS_MEMSTREAM)
 	} else {
-		stream = cacheStream;
+		bif->stream = cacheStream;
 #endif
 	}
 
-	if (!stream)
-		return GEM_ERROR;
+	if (!bif->stream)
+		return nullptr;
 
-	stream->Read( Signature, 8 );
+	bif->stream->Read( Signature, 8 );
 
 	if (strncmp( Signature, "BIFFV1  ", 8 ) != 0) {
-		return GEM_ERROR;
+		return nullptr;
 	}
 
-	return ReadBIF();
+	if (bif->ReadEntries() != GEM_OK) {
+		return nullptr;
+	}
+	return bif;
+}
+
+int BIFImporter::OpenArchive(const char* path)
+{
+	std::shared_future<std::shared_ptr<BIFArchive>> listed;
+	std::promise<std::shared_ptr<BIFArchive>> loaded;
+	{
+		std::lock_guard<std::mutex> lock(archivesMutex);
+		for (auto it = openArchives.begin(); it != openArchives.end(); ++it) {
+			if (it->first == path) {
+				openArchives.splice(openArchives.begin(), openArchives, it);
+				listed = it->second;
+				break;
+			}
+		}
+		if (!listed.valid()) {
+			// streams handed out keep their archive alive, even after it's dropped here
+			openArchives.emplace_front(path, loaded.get_future().share());
+			if (openArchives.size() > MAX_OPEN_ARCHIVES) {
+				openArchives.pop_back();
+			}
+		}
+	}
+
+	if (listed.valid()) {
+		archive = listed.get();
+		return archive ? GEM_OK : GEM_ERROR;
+	}
+
+	archive = LoadArchive(path);
+	loaded.set_value(archive);
+	if (archive) {
+		return GEM_OK;
+	}
+
+	// don't remember the failure, so the next attempt tries again
+	std::lock_guard<std::mutex> lock(archivesMutex);
+	for (auto it = openArchives.begin(); it != openArchives.end(); ++it) {
+		if (it->first == path && it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !it->second.get()) {
+			openArchives.erase(it);
+			break;
+		}
+	}
+	return GEM_ERROR;
+}
+
+DataStream* BIFImporter::SliceArchive(strpos_t offset, strpos_t size) const
+{
+	// uncompressed archives are mapped, so just hand out a view into them
+	const MemoryStream* mapped = dynamic_cast<const MemoryStream*>(archive->stream);
+	if (mapped && offset + size <= mapped->Size()) {
+		return new BIFSliceStream(archive, mapped->originalfile, mapped->GetData() + offset, size);
+	}
+
+	std::lock_guard<std::mutex> lock(archive->streamMutex);
+	return SliceStream(archive->stream, offset, size);
 }
 
 DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 {
+	if (!archive) {
+		return NULL;
+	}
+
 	if (Type == IE_TIS_CLASS_ID) {
 		unsigned int srcResLoc = Resource & 0xFC000;
-		for (unsigned int i = 0; i < tentcount; i++) {
-			if (( tentries[i].resLocator & 0xFC000 ) == srcResLoc) {
-				return SliceStream( stream, tentries[i].dataOffset,
-							tentries[i].tileSize * tentries[i].tilesCount );
+		for (const TileEntry& entry : archive->tentries) {
+			if (( entry.resLocator & 0xFC000 ) == srcResLoc) {
+				return SliceArchive(entry.dataOffset, entry.tileSize * entry.tilesCount);
 			}
 		}
 	} else {
 		ieDword srcResLoc = Resource & 0x3FFF;
-		for (ieDword i = 0; i < fentcount; i++) {
-			if (( fentries[i].resLocator & 0x3FFF ) == srcResLoc) {
-				return SliceStream( stream, fentries[i].dataOffset,
-							fentries[i].fileSize );
+		for (const FileEntry& entry : archive->fentries) {
+			if (( entry.resLocator & 0x3FFF ) == srcResLoc) {
+				return SliceArchive(entry.dataOffset, entry.fileSize);
 			}
 		}
 	}
 	return NULL;
 }
 
-int BIFImporter::ReadBIF()
+int BIFArchive::ReadEntries()
 {
 	ieDword foffset;
+	ieDword fentcount;
+	ieDword tentcount;
 	stream->ReadDword(fentcount);
 	stream->ReadDword(tentcount);
 	stream->ReadDword(foffset);
-	stream->Seek( foffset, GEM_STREAM_START );
-	fentries = new FileEntry[fentcount];
-	tentries = new TileEntry[tentcount];
-	if (!fentries || !tentries) {
-		delete fentries;
-		delete tentries;
+	if (stream->Seek(foffset, GEM_STREAM_START) == GEM_ERROR) {
 		return GEM_ERROR;
 	}
+	fentries.resize(fentcount);
+	tentries.resize(tentcount);
 
-	for (unsigned int i = 0; i < fentcount; i++) {
-		stream->ReadDword(fentries[i].resLocator);
-		stream->ReadDword(fentries[i].dataOffset);
-		stream->ReadDword(fentries[i].fileSize);
-		stream->ReadWord(fentries[i].type);
-		stream->ReadWord(fentries[i].u1);
-	}
-	for (unsigned int i = 0; i < tentcount; i++) {
-		stream->ReadDword(tentries[i].resLocator);
-		stream->ReadDword(tentries[i].dataOffset);
-		stream->ReadDword(tentries[i].tilesCount);
-		stream->ReadDword(tentries[i].tileSize);
-		stream->ReadWord(tentries[i].type);
-		stream->ReadWord(tentries[i].u1);
+	for (FileEntry& entry : fentries) {
+		stream->ReadDword(entry.resLocator);
+		stream->ReadDword(entry.dataOffset);
+		stream->ReadDword(entry.fileSize);
+		stream->ReadWord(entry.type);
+		stream->ReadWord(entry.u1);
+	}
+	for (TileEntry& entry : tentries) {
+		stream->ReadDword(entry.resLocator);
+		stream->ReadDword(entry.dataOffset);
+		stream->ReadDword(entry.tilesCount);
+		stream->ReadDword(entry.tileSize);
+		stream->ReadWord(entry.type);
+		stream->ReadWord(entry.u1);
 	}
 	return GEM_OK;
 }
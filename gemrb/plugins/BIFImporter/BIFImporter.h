@@ -27,6 +27,10 @@
 
 #include "Streams/DataStream.h"
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace GemRB {
 
 struct FileEntry {
@@ -46,24 +50,35 @@ struct TileEntry {
 	ieWord  u1; //Unknown Field, part of type dword in ee
 };
 
+// an opened bif and its entry tables, shared by all the importers
+// (and the streams handed out) for the same file
+struct BIFArchive {
+	DataStream* stream = nullptr;
+	// guards the position of stream, for the slices that read through it
+	std::mutex streamMutex;
+	std::vector<FileEntry> fentries;
+	std::vector<TileEntry> tentries;
+
+	BIFArchive() noexcept = default;
+	BIFArchive(const BIFArchive&) = delete;
+	~BIFArchive() { delete stream; }
+	BIFArchive& operator=(const BIFArchive&) = delete;
+
+	int ReadEntries();
+};
+
 class BIFImporter : public IndexedArchive {
 private:
-	FileEntry* fentries = nullptr;
-	TileEntry* tentries = nullptr;
-	ieDword fentcount = 0;
-	ieDword tentcount = 0;
-	DataStream* stream = nullptr;
+	std::shared_ptr<BIFArchive> archive;
 public:
 	BIFImporter() noexcept = default;
-	BIFImporter(const BIFImporter&) = delete;
-	~BIFImporter() override;
-	BIFImporter& operator=(const BIFImporter&) = delete;
 	int OpenArchive(const char* filename) override;
 	DataStream* GetStream(unsigned long Resource, unsigned long Type) override;
 private:
+	DataStream* SliceArchive(strpos_t offset, strpos_t size) const;
+	static std::shared_ptr<BIFArchive> LoadArchive(const char* path);
 	static DataStream* DecompressBIF(DataStream* compressed, const char* path);
-	static DataStream* DecompressBIFC(DataStream* compressed, const char* path);
-	int ReadBIF();
+	static DataStream* OpenBIFC(DataStream* compressed);
 };
 
 }
@@ -85,19 +85,42 @@ bool CachedDirectoryImporter::Open(const char *dir, const char *desc)
 	if (!DirectoryImporter::Open(dir, desc))
 		return false;
 
-	Refresh();
+	Refresh(nullptr);
 
 	return true;
 }
 
-void CachedDirectoryImporter::Refresh()
+void CachedDirectoryImporter::Refresh(const char* fileName)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	if (!fileName) {
+		ListDirectory();
+		return;
+	}
+
+	char filePath[_MAX_PATH];
+	PathJoin(filePath, path, fileName, nullptr);
+	std::string buf = fileName;
+	StringToLower(buf);
+	if (file_exists(filePath)) {
+		cache.set(buf, fileName);
+	} else {
+		cache.remove(buf);
+	}
+}
+
+// called with the mutex held
+void CachedDirectoryImporter::ListDirectory()
 {
 	cache.clear();
 
 	DirectoryIterator it(path);
 	it.SetFlags(DirectoryIterator::Files, true);
-	if (!it)
+	if (!it) {
+		// still usable for the files added later
+		cache.init(64, 64);
 		return;
+	}
 
 	unsigned int count = 0;
 	do {
@@ -133,37 +156,40 @@ static std::string ConstructFilename(StringView resname, const char* ext)
 bool CachedDirectoryImporter::HasResource(StringView resname, SClass_ID type)
 {
 	const std::string& filename = ConstructFilename(resname, core->TypeExt(type));
+	std::lock_guard<std::mutex> lock(cacheMutex);
 	return cache.has(filename.c_str());
 }
 
 bool CachedDirectoryImporter::HasResource(StringView resname, const ResourceDesc &type)
 {
 	const std::string& filename = ConstructFilename(resname, type.GetExt());
+	std::lock_guard<std::mutex> lock(cacheMutex);
 	return cache.has(filename.c_str());
 }
 
-DataStream* CachedDirectoryImporter::GetResource(StringView resname, SClass_ID type)
+DataStream* CachedDirectoryImporter::OpenListed(StringView resname, const char* ext)
 {
-	const std::string& filename = ConstructFilename(resname, core->TypeExt(type));
-	const std::string *s = cache.get(filename.c_str());
-	if (!s)
-		return NULL;
+	const std::string& filename = ConstructFilename(resname, ext);
 	char buf[_MAX_PATH];
-	strcpy(buf, path);
-	PathAppend(buf, s->c_str());
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		const std::string *s = cache.get(filename.c_str());
+		if (!s)
+			return NULL;
+		strcpy(buf, path);
+		PathAppend(buf, s->c_str());
+	}
 	return FileStream::OpenFile(buf);
 }
 
+DataStream* CachedDirectoryImporter::GetResource(StringView resname, SClass_ID type)
+{
+	return OpenListed(resname, core->TypeExt(type));
+}
+
 DataStream* CachedDirectoryImporter::GetResource(StringView resname, const ResourceDesc &type)
 {
-	const std::string& filename = ConstructFilename(resname, type.GetExt());
-	const std::string *s = cache.get(filename.c_str());
-	if (!s)
-		return NULL;
-	char buf[_MAX_PATH];
-	strcpy(buf, path);
-	PathAppend(buf, s->c_str());
-	return FileStream::OpenFile(buf);
+	return OpenListed(resname, type.GetExt());
 }
 
 #include "plugindef.h"
@@ -22,6 +22,8 @@
 #include "ResourceSource.h"
 #include "StringMap.h"
 
+#include <mutex>
+
 namespace GemRB {
 
 class ResourceDesc;
@@ -44,17 +46,24 @@ public:
 class CachedDirectoryImporter : public DirectoryImporter {
 protected:
 	StringMap cache;
+	// lookups come from the prefetch workers too
+	std::mutex cacheMutex;
+
+	void ListDirectory();
+	DataStream* OpenListed(StringView resname, const char* ext);
 
 public:
 	CachedDirectoryImporter() noexcept = default;
 	bool Open(const char *dir, const char *desc) override;
-	void Refresh();
+	// the listing only changes here (the index in ResourceManager relies on it)
+	void Refresh(const char* fileName) override;
 	/** predicts the availability of a resource */
 	bool HasResource(StringView resname, SClass_ID type) override;
 	bool HasResource(StringView resname, const ResourceDesc &type) override;
 	/** returns resource */
 	DataStream* GetResource(StringView resname, SClass_ID type) override;
 	DataStream* GetResource(StringView resname, const ResourceDesc &type) override;
+	bool IsStatic() const override { return true; }
 };
 
 
@@ -434,355 +434,355 @@ int fx_uncanny_dodge (Scriptable* Owner, Actor* target, Effect* fx); // 1cb - 45
 int fx_unknown (Scriptable* Owner, Actor* target, Effect* fx);//???
 
 static EffectDesc effectnames[] = {
-	EffectDesc("*Crash*", fx_crash, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("ACVsCreatureType", fx_generic_effect, 0, -1 ), //0xdb
-	EffectDesc("ACVsDamageTypeModifier", fx_ac_vs_damage_type_modifier, 0, -1 ),
-	EffectDesc("ACVsDamageTypeModifier2", fx_ac_vs_damage_type_modifier, 0, -1 ), // used in IWD
+	EffectDesc("*Crash*", fx_crash, EFFECT_NO_ACTOR|EFFECT_STABLE, -1 ),
+	EffectDesc("AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("ACVsCreatureType", fx_generic_effect, EFFECT_STABLE, -1 ), //0xdb
+	EffectDesc("ACVsDamageTypeModifier", fx_ac_vs_damage_type_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("ACVsDamageTypeModifier2", fx_ac_vs_damage_type_modifier, EFFECT_STABLE, -1 ), // used in IWD
 	EffectDesc("AidNonCumulative", fx_set_aid_state, 0, -1 ),
-	EffectDesc("AIIdentifierModifier", fx_ids_modifier, 0, -1 ),
-	EffectDesc("AlchemyModifier", fx_alchemy_modifier, 0, -1 ),
-	EffectDesc("Alignment:Change", fx_alignment_change, 0, -1 ),
-	EffectDesc("Alignment:Invert", fx_alignment_invert, 0, -1 ),
-	EffectDesc("AlwaysBackstab", fx_always_backstab_modifier, 0, -1 ),
-	EffectDesc("AnimationIDModifier", fx_animation_id_modifier, 0, -1 ),
-	EffectDesc("AnimationStateChange", fx_animation_stance, 0, -1 ),
+	EffectDesc("AIIdentifierModifier", fx_ids_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("AlchemyModifier", fx_alchemy_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("Alignment:Change", fx_alignment_change, EFFECT_STABLE, -1 ),
+	EffectDesc("Alignment:Invert", fx_alignment_invert, EFFECT_STABLE, -1 ),
+	EffectDesc("AlwaysBackstab", fx_always_backstab_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("AnimationIDModifier", fx_animation_id_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("AnimationStateChange", fx_animation_stance, EFFECT_STABLE, -1 ),
 	EffectDesc("ApplyEffect", fx_apply_effect, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("ApplyEffectCurse", fx_apply_effect_curse, 0, -1 ),
-	EffectDesc("ApplyEffectItem", fx_apply_effect_item, 0, -1 ),
-	EffectDesc("ApplyEffectItemType", fx_apply_effect_item_type, 0, -1 ),
-	EffectDesc("ApplyEffectsList", fx_add_effects_list, 0, -1),
+	EffectDesc("ApplyEffectItem", fx_apply_effect_item, EFFECT_STABLE, -1 ),
+	EffectDesc("ApplyEffectItemType", fx_apply_effect_item_type, EFFECT_STABLE, -1 ),
+	EffectDesc("ApplyEffectsList", fx_add_effects_list, EFFECT_STABLE, -1),
 	EffectDesc("ApplyEffectRepeat", fx_apply_effect_repeat, 0, -1 ),
 	EffectDesc("CutScene2", fx_cutscene2, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("AttackSpeedModifier", fx_attackspeed_modifier, 0, -1 ),
-	EffectDesc("AttacksPerRoundModifier", fx_attacks_per_round_modifier, 0, -1 ),
-	EffectDesc("AuraCleansingModifier", fx_auracleansing_modifier, 0, -1 ),
-	EffectDesc("SummonDisable", fx_summon_disable, 0, -1 ), //unknown
-	EffectDesc("AvatarRemovalModifier", fx_avatar_removal_modifier, 0, -1 ),
-	EffectDesc("BackstabModifier", fx_backstab_modifier, 0, -1 ),
-	EffectDesc("BerserkStage1Modifier", fx_berserkstage1_modifier, 0, -1 ),
-	EffectDesc("BerserkStage2Modifier", fx_berserkstage2_modifier, 0, -1 ),
-	EffectDesc("BlessNonCumulative", fx_set_bless_state, 0, -1 ),
-	EffectDesc("Bounce:School", fx_bounce_school, 0, -1 ),
-	EffectDesc("Bounce:SchoolDec", fx_bounce_school_dec, 0, -1 ),
-	EffectDesc("Bounce:SecondaryType", fx_bounce_secondary_type, 0, -1 ),
-	EffectDesc("Bounce:SecondaryTypeDec", fx_bounce_secondary_type_dec, 0, -1 ),
-	EffectDesc("Bounce:Spell", fx_bounce_spell, 0, -1 ),
-	EffectDesc("Bounce:SpellDec", fx_bounce_spell_dec, 0, -1 ),
-	EffectDesc("Bounce:SpellLevel", fx_bounce_spelllevel, 0, -1 ),
-	EffectDesc("Bounce:SpellLevelDec", fx_bounce_spelllevel_dec, 0, -1 ),
-	EffectDesc("Bounce:Opcode", fx_bounce_opcode, 0, -1 ),
-	EffectDesc("Bounce:Projectile", fx_bounce_projectile, 0, -1 ),
-	EffectDesc("CantUseItem", fx_generic_effect, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("CantUseItemType", fx_generic_effect, 0, -1 ),
-	EffectDesc("CanUseAnyItem", fx_can_use_any_item_modifier, 0, -1 ),
-	EffectDesc("CastFromList", fx_select_spell, 0, -1 ),
+	EffectDesc("AttackSpeedModifier", fx_attackspeed_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("AttacksPerRoundModifier", fx_attacks_per_round_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("AuraCleansingModifier", fx_auracleansing_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("SummonDisable", fx_summon_disable, EFFECT_STABLE, -1 ), //unknown
+	EffectDesc("AvatarRemovalModifier", fx_avatar_removal_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("BackstabModifier", fx_backstab_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("BerserkStage1Modifier", fx_berserkstage1_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("BerserkStage2Modifier", fx_berserkstage2_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("BlessNonCumulative", fx_set_bless_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:School", fx_bounce_school, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:SchoolDec", fx_bounce_school_dec, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:SecondaryType", fx_bounce_secondary_type, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:SecondaryTypeDec", fx_bounce_secondary_type_dec, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:Spell", fx_bounce_spell, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:SpellDec", fx_bounce_spell_dec, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:SpellLevel", fx_bounce_spelllevel, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:SpellLevelDec", fx_bounce_spelllevel_dec, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:Opcode", fx_bounce_opcode, EFFECT_STABLE, -1 ),
+	EffectDesc("Bounce:Projectile", fx_bounce_projectile, EFFECT_STABLE, -1 ),
+	EffectDesc("CantUseItem", fx_generic_effect, EFFECT_NO_ACTOR|EFFECT_STABLE, -1 ),
+	EffectDesc("CantUseItemType", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("CanUseAnyItem", fx_can_use_any_item_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("CastFromList", fx_select_spell, EFFECT_STABLE, -1 ),
 	EffectDesc("CastingGlow", fx_casting_glow, 0, -1 ),
 	EffectDesc("CastingGlow2", fx_casting_glow, 0, -1 ), //used in iwd
-	EffectDesc("CastingLevelModifier", fx_castinglevel_modifier, 0, -1 ),
-	EffectDesc("CastingSpeedModifier", fx_castingspeed_modifier, 0, -1 ),
+	EffectDesc("CastingLevelModifier", fx_castinglevel_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("CastingSpeedModifier", fx_castingspeed_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("CastSpellOnCondition", fx_cast_spell_on_condition, 0, -1 ),
-	EffectDesc("ChangeBardSong", fx_change_bardsong, 0, -1 ),
-	EffectDesc("ChangeName", fx_change_name, 0, -1 ),
+	EffectDesc("ChangeBardSong", fx_change_bardsong, EFFECT_STABLE, -1 ),
+	EffectDesc("ChangeName", fx_change_name, EFFECT_STABLE, -1 ),
 	EffectDesc("ChangeWeather", fx_change_weather, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("ChantBadNonCumulative", fx_set_chantbad_state, 0, -1 ),
-	EffectDesc("ChantNonCumulative", fx_set_chant_state, 0, -1 ),
-	EffectDesc("ChaosShieldModifier", fx_chaos_shield_modifier, 0, -1 ),
-	EffectDesc("CharismaModifier", fx_charisma_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("CheckForBerserkModifier", fx_checkforberserk_modifier, 0, -1 ),
-	EffectDesc("ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("Color:BriefRGB", fx_brief_rgb, 0, -1 ),
-	EffectDesc("Color:GlowRGB", fx_glow_rgb, 0, -1 ),
-	EffectDesc("Color:DarkenRGB", fx_darken_rgb, 0, -1 ),
-	EffectDesc("Color:SetPalette", fx_set_color_gradient, 0, -1 ),
-	EffectDesc("Color:SetRGB", fx_set_color_rgb, 0, -1 ),
-	EffectDesc("Color:SetRGBGlobal", fx_set_color_rgb_global, 0, -1 ), //08
-	EffectDesc("Color:PulseRGB", fx_set_color_pulse_rgb, 0, -1 ), //9
-	EffectDesc("Color:PulseRGBGlobal", fx_set_color_pulse_rgb_global, 0, -1 ), //9
-	EffectDesc("ConstitutionModifier", fx_constitution_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("ChantBadNonCumulative", fx_set_chantbad_state, EFFECT_STABLE, -1 ),
+	EffectDesc("ChantNonCumulative", fx_set_chant_state, EFFECT_STABLE, -1 ),
+	EffectDesc("ChaosShieldModifier", fx_chaos_shield_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("CharismaModifier", fx_charisma_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("CheckForBerserkModifier", fx_checkforberserk_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("Color:BriefRGB", fx_brief_rgb, EFFECT_STABLE, -1 ),
+	EffectDesc("Color:GlowRGB", fx_glow_rgb, EFFECT_STABLE, -1 ),
+	EffectDesc("Color:DarkenRGB", fx_darken_rgb, EFFECT_STABLE, -1 ),
+	EffectDesc("Color:SetPalette", fx_set_color_gradient, EFFECT_STABLE, -1 ),
+	EffectDesc("Color:SetRGB", fx_set_color_rgb, EFFECT_STABLE, -1 ),
+	EffectDesc("Color:SetRGBGlobal", fx_set_color_rgb_global, EFFECT_STABLE, -1 ), //08
+	EffectDesc("Color:PulseRGB", fx_set_color_pulse_rgb, EFFECT_STABLE, -1 ), //9
+	EffectDesc("Color:PulseRGBGlobal", fx_set_color_pulse_rgb_global, EFFECT_STABLE, -1 ), //9
+	EffectDesc("ConstitutionModifier", fx_constitution_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
 	EffectDesc("ControlCreature", fx_set_charmed_state, 0, -1 ), //0xf1 same as charm
 	EffectDesc("CreateContingency", fx_create_contingency, 0, -1 ),
-	EffectDesc("CriticalHitModifier", fx_critical_hit_modifier, 0, -1 ),
-	EffectDesc("CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("Cure:Berserk", fx_cure_berserk_state, 0, -1 ),
-	EffectDesc("Cure:Blind", fx_cure_blind_state, 0, -1 ),
-	EffectDesc("Cure:CasterHold", fx_unpause_caster, 0, -1 ),
-	EffectDesc("Cure:Confusion", fx_cure_confused_state, 0, -1 ),
-	EffectDesc("Cure:Deafness", fx_cure_deaf_state, 0, -1 ),
+	EffectDesc("CriticalHitModifier", fx_critical_hit_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Berserk", fx_cure_berserk_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Blind", fx_cure_blind_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:CasterHold", fx_unpause_caster, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Confusion", fx_cure_confused_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Deafness", fx_cure_deaf_state, EFFECT_STABLE, -1 ),
 	EffectDesc("Cure:Death", fx_cure_dead_state, 0, -1 ),
-	EffectDesc("Cure:Defrost", fx_cure_frozen_state, 0, -1 ),
-	EffectDesc("Cure:Disease", fx_cure_diseased_state, 0, -1 ),
-	EffectDesc("Cure:Feeblemind", fx_cure_feebleminded_state, 0, -1 ),
-	EffectDesc("Cure:Hold", fx_cure_hold_state, 0, -1 ),
-	EffectDesc("Cure:Imprisonment", fx_freedom, 0, -1 ),
-	EffectDesc("Cure:Infravision", fx_cure_infravision_state, 0, -1 ),
-	EffectDesc("Cure:Intoxication", fx_cure_intoxication, 0, -1 ), //0xa4 (iwd2 has this working)
+	EffectDesc("Cure:Defrost", fx_cure_frozen_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Disease", fx_cure_diseased_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Feeblemind", fx_cure_feebleminded_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Hold", fx_cure_hold_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Imprisonment", fx_freedom, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Infravision", fx_cure_infravision_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Intoxication", fx_cure_intoxication, EFFECT_STABLE, -1 ), //0xa4 (iwd2 has this working)
 	EffectDesc("Cure:Invisible", fx_cure_invisible_state, 0, -1 ), //0x2f
 	EffectDesc("Cure:Invisible2", fx_cure_invisible_state, 0, -1 ), //0x74
-	//EffectDesc("Cure:ImprovedInvisible", fx_cure_improved_invisible_state, 0, -1 ),
-	EffectDesc("Cure:LevelDrain", fx_cure_leveldrain, 0, -1 ), //restoration
-	EffectDesc("Cure:Nondetection", fx_cure_nondetection_state, 0, -1 ),
-	EffectDesc("Cure:Panic", fx_cure_panic_state, 0, -1 ),
-	EffectDesc("Cure:Petrification", fx_cure_petrified_state, 0, -1 ),
-	EffectDesc("Cure:Poison", fx_cure_poisoned_state, 0, -1 ),
-	EffectDesc("Cure:Sanctuary", fx_cure_sanctuary_state, 0, -1 ),
-	EffectDesc("Cure:Silence", fx_cure_silenced_state, 0, -1 ),
-	EffectDesc("Cure:Sleep", fx_cure_sleep_state, 0, -1 ),
-	EffectDesc("Cure:Stun", fx_cure_stun_state, 0, -1 ),
+	//EffectDesc("Cure:ImprovedInvisible", fx_cure_improved_invisible_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:LevelDrain", fx_cure_leveldrain, EFFECT_STABLE, -1 ), //restoration
+	EffectDesc("Cure:Nondetection", fx_cure_nondetection_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Panic", fx_cure_panic_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Petrification", fx_cure_petrified_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Poison", fx_cure_poisoned_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Sanctuary", fx_cure_sanctuary_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Silence", fx_cure_silenced_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Sleep", fx_cure_sleep_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Cure:Stun", fx_cure_stun_state, EFFECT_STABLE, -1 ),
 	EffectDesc("CurrentHPModifier", fx_current_hp_modifier, EFFECT_DICED, -1 ),
 	EffectDesc("Damage", fx_damage, EFFECT_DICED, -1 ),
-	EffectDesc("DamageAnimation", fx_damage_animation, 0, -1 ),
-	EffectDesc("DamageBonusModifier", fx_damage_bonus_modifier, 0, -1 ),
-	EffectDesc("DamageBonusModifier2", fx_damage_bonus_modifier, 0, -1), //49 (iwd, ee)
-	EffectDesc("DamageLuckModifier", fx_damageluck_modifier, 0, -1 ),
-	EffectDesc("DamageVsCreature", fx_generic_effect, 0, -1 ),
+	EffectDesc("DamageAnimation", fx_damage_animation, EFFECT_STABLE, -1 ),
+	EffectDesc("DamageBonusModifier", fx_damage_bonus_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("DamageBonusModifier2", fx_damage_bonus_modifier, EFFECT_STABLE, -1), //49 (iwd, ee)
+	EffectDesc("DamageLuckModifier", fx_damageluck_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("DamageVsCreature", fx_generic_effect, EFFECT_STABLE, -1 ),
 	EffectDesc("Death", fx_death, 0, -1 ),
 	EffectDesc("Death2", fx_death, 0, -1 ), //(iwd2 effect)
 	EffectDesc("Death3", fx_death, 0, -1 ), //(iwd2 effect too, Banish)
-	EffectDesc("DetectAlignment", fx_detect_alignment, 0, -1 ),
-	EffectDesc("DetectIllusionsModifier", fx_detect_illusion_modifier, 0, -1 ),
+	EffectDesc("DetectAlignment", fx_detect_alignment, EFFECT_STABLE, -1 ),
+	EffectDesc("DetectIllusionsModifier", fx_detect_illusion_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("DexterityModifier", fx_dexterity_modifier, EFFECT_SPECIAL_UNDO, -1 ),
 	EffectDesc("DimensionDoor", fx_dimension_door, 0, -1 ),
-	EffectDesc("DisableButton", fx_disable_button, 0, -1 ), //sets disable button flag
-	EffectDesc("DisableChunk", fx_disable_chunk_modifier, 0, -1 ),
-	EffectDesc("DisableOverlay", fx_disable_overlay_modifier, 0, -1 ),
-	EffectDesc("DisableCasting", fx_disable_spellcasting, 0, -1 ),
-	EffectDesc("Disintegrate", fx_disintegrate, 0, -1 ),
-	EffectDesc("DispelEffects", fx_dispel_effects, 0, -1 ),
-	EffectDesc("DispelSchool", fx_dispel_school, 0, -1 ),
-	EffectDesc("DispelSchoolOne", fx_dispel_school_one, 0, -1 ),
-	EffectDesc("DispelSecondaryType", fx_dispel_secondary_type, 0, -1 ),
-	EffectDesc("DispelSecondaryTypeOne", fx_dispel_secondary_type_one, 0, -1 ),
+	EffectDesc("DisableButton", fx_disable_button, EFFECT_STABLE, -1 ), //sets disable button flag
+	EffectDesc("DisableChunk", fx_disable_chunk_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("DisableOverlay", fx_disable_overlay_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("DisableCasting", fx_disable_spellcasting, EFFECT_STABLE, -1 ),
+	EffectDesc("Disintegrate", fx_disintegrate, EFFECT_STABLE, -1 ),
+	EffectDesc("DispelEffects", fx_dispel_effects, EFFECT_STABLE, -1 ),
+	EffectDesc("DispelSchool", fx_dispel_school, EFFECT_STABLE, -1 ),
+	EffectDesc("DispelSchoolOne", fx_dispel_school_one, EFFECT_STABLE, -1 ),
+	EffectDesc("DispelSecondaryType", fx_dispel_secondary_type, EFFECT_STABLE, -1 ),
+	EffectDesc("DispelSecondaryTypeOne", fx_dispel_secondary_type_one, EFFECT_STABLE, -1 ),
 	EffectDesc("DisplayString", fx_display_string, 0, -1 ),
-	EffectDesc("Dither", fx_dither, 0, -1 ),
-	EffectDesc("DontJumpModifier", fx_dontjump_modifier, 0, -1 ),
-	EffectDesc("DrainItems", fx_drain_items, 0, -1 ),
-	EffectDesc("DrainSpells", fx_drain_spells, 0, -1 ),
-	EffectDesc("DropWeapon", fx_drop_weapon, 0, -1 ),
-	EffectDesc("ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("Dither", fx_dither, EFFECT_STABLE, -1 ),
+	EffectDesc("DontJumpModifier", fx_dontjump_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("DrainItems", fx_drain_items, EFFECT_STABLE, -1 ),
+	EffectDesc("DrainSpells", fx_drain_spells, EFFECT_STABLE, -1 ),
+	EffectDesc("DropWeapon", fx_drop_weapon, EFFECT_STABLE, -1 ),
+	EffectDesc("ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
 	EffectDesc("ExistanceDelayModifier", fx_existance_delay_modifier , 0, -1 ), //unknown
-	EffectDesc("ExperienceModifier", fx_experience_modifier, 0, -1 ),
-	EffectDesc("ExploreModifier", fx_explore_modifier, 0, -1 ),
+	EffectDesc("ExperienceModifier", fx_experience_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("ExploreModifier", fx_explore_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("FamiliarBond", fx_familiar_constitution_loss, 0, -1 ),
 	EffectDesc("FamiliarMarker", fx_familiar_marker, 0, -1 ),
 	EffectDesc("Farsee", fx_farsee, 0, -1 ),
-	EffectDesc("FatigueModifier", fx_fatigue_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("FatigueModifier", fx_fatigue_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
 	EffectDesc("FindFamiliar", fx_find_familiar, 0, -1 ),
 	EffectDesc("FindTraps", fx_find_traps, 0, -1 ),
-	EffectDesc("FindTrapsModifier", fx_find_traps_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("FistDamageModifier", fx_fist_damage_modifier, 0, -1 ),
-	EffectDesc("FistHitModifier", fx_fist_to_hit_modifier, 0, -1 ),
-	EffectDesc("ForceSurgeModifier", fx_force_surge_modifier, 0, -1 ),
+	EffectDesc("FindTrapsModifier", fx_find_traps_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("FistDamageModifier", fx_fist_damage_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("FistHitModifier", fx_fist_to_hit_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("ForceSurgeModifier", fx_force_surge_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("ForceVisible", fx_force_visible, 0, -1 ), //not invisible but improved invisible
-	EffectDesc("FreeAction", fx_cure_slow_state, 0, -1 ),
+	EffectDesc("FreeAction", fx_cure_slow_state, EFFECT_STABLE, -1 ),
 	EffectDesc("GenerateWish", fx_generate_wish, 0, -1 ),
 	EffectDesc("GoldModifier", fx_gold_modifier, 0, -1 ),
-	EffectDesc("HideInShadowsModifier", fx_hide_in_shadows_modifier, 0, -1 ),
-	EffectDesc("HLA", fx_generic_effect, 0, -1 ),
-	EffectDesc("HolyNonCumulative", fx_set_holy_state, 0, -1 ),
-	EffectDesc("Icon:Disable", fx_disable_portrait_icon, 0, -1 ),
-	EffectDesc("Icon:Display", fx_display_portrait_icon, 0, -1 ),
-	EffectDesc("Icon:Remove", fx_remove_portrait_icon, 0, -1 ),
+	EffectDesc("HideInShadowsModifier", fx_hide_in_shadows_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("HLA", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("HolyNonCumulative", fx_set_holy_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Icon:Disable", fx_disable_portrait_icon, EFFECT_STABLE, -1 ),
+	EffectDesc("Icon:Display", fx_display_portrait_icon, EFFECT_STABLE, -1 ),
+	EffectDesc("Icon:Remove", fx_remove_portrait_icon, EFFECT_STABLE, -1 ),
 	EffectDesc("Identify", fx_identify, 0, -1 ),
-	EffectDesc("IgnoreDialogPause", fx_ignore_dialogpause_modifier, 0, -1 ),
-	EffectDesc("IntelligenceModifier", fx_intelligence_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("IntoxicationModifier", fx_intoxication_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("InvisibleDetection", fx_see_invisible_modifier, 0, -1 ),
+	EffectDesc("IgnoreDialogPause", fx_ignore_dialogpause_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("IntelligenceModifier", fx_intelligence_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("IntoxicationModifier", fx_intoxication_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("InvisibleDetection", fx_see_invisible_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("Item:CreateDays", fx_create_item_days, 0, -1 ),
-	EffectDesc("Item:CreateInSlot", fx_create_item_in_slot, 0, -1 ),
+	EffectDesc("Item:CreateInSlot", fx_create_item_in_slot, EFFECT_STABLE, -1 ),
 	EffectDesc("Item:CreateInventory", fx_create_inventory_item, 0, -1 ),
-	EffectDesc("Item:CreateMagic", fx_create_magic_item, 0, -1 ),
-	EffectDesc("Item:Equip", fx_equip_item, 0, -1 ), //71
-	EffectDesc("Item:Remove", fx_remove_item, 0, -1 ), //70
-	EffectDesc("Item:RemoveInventory", fx_remove_inventory_item, 0, -1 ),
-	EffectDesc("KillCreatureType", fx_kill_creature_type, 0, -1 ),
-	EffectDesc("LevelModifier", fx_level_modifier, 0, -1 ),
-	EffectDesc("LevelDrainModifier", fx_leveldrain_modifier, 0, -1 ),
-	EffectDesc("LoreModifier", fx_lore_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("LuckModifier", fx_luck_modifier, EFFECT_NO_LEVEL_CHECK|EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("LuckCumulative", fx_luck_cumulative, 0, -1 ),
-	EffectDesc("LuckNonCumulative", fx_luck_non_cumulative, 0, -1 ),
-	EffectDesc("MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("MagicalRest", fx_magical_rest, 0, -1 ),
-	EffectDesc("MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, 0, -1 ),
-	EffectDesc("MagicResistanceModifier", fx_magic_resistance_modifier, 0, -1 ),
+	EffectDesc("Item:CreateMagic", fx_create_magic_item, EFFECT_STABLE, -1 ),
+	EffectDesc("Item:Equip", fx_equip_item, EFFECT_STABLE, -1 ), //71
+	EffectDesc("Item:Remove", fx_remove_item, EFFECT_STABLE, -1 ), //70
+	EffectDesc("Item:RemoveInventory", fx_remove_inventory_item, EFFECT_STABLE, -1 ),
+	EffectDesc("KillCreatureType", fx_kill_creature_type, EFFECT_STABLE, -1 ),
+	EffectDesc("LevelModifier", fx_level_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("LevelDrainModifier", fx_leveldrain_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("LoreModifier", fx_lore_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("LuckModifier", fx_luck_modifier, EFFECT_NO_LEVEL_CHECK|EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("LuckCumulative", fx_luck_cumulative, EFFECT_STABLE, -1 ),
+	EffectDesc("LuckNonCumulative", fx_luck_non_cumulative, EFFECT_STABLE, -1 ),
+	EffectDesc("MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("MagicalRest", fx_magical_rest, EFFECT_STABLE, -1 ),
+	EffectDesc("MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MagicResistanceModifier", fx_magic_resistance_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("MassRaiseDead", fx_mass_raise_dead, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("MaximumHPModifier", fx_maximum_hp_modifier, EFFECT_DICED|EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("MaximumHPModifier", fx_maximum_hp_modifier, EFFECT_DICED|EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
 	EffectDesc("Maze", fx_maze, 0, -1 ),
-	EffectDesc("MeleeDamageModifier", fx_melee_damage_modifier, 0, -1 ),
-	EffectDesc("MeleeHitModifier", fx_melee_to_hit_modifier, 0, -1 ),
-	EffectDesc("MinimumHPModifier", fx_minimum_hp_modifier, 0, -1 ),
-	EffectDesc("MiscastMagicModifier", fx_miscast_magic_modifier, 0, -1 ),
-	EffectDesc("MissileDamageModifier", fx_missile_damage_modifier, 0, -1 ),
-	EffectDesc("MissileHitModifier", fx_missile_to_hit_modifier, 0, -1 ),
-	EffectDesc("MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("MirrorImage", fx_mirror_image, 0, -1 ),
-	EffectDesc("MirrorImageModifier", fx_mirror_image_modifier, 0, -1 ),
+	EffectDesc("MeleeDamageModifier", fx_melee_damage_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MeleeHitModifier", fx_melee_to_hit_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MinimumHPModifier", fx_minimum_hp_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MiscastMagicModifier", fx_miscast_magic_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MissileDamageModifier", fx_missile_damage_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MissileHitModifier", fx_missile_to_hit_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("MirrorImage", fx_mirror_image, EFFECT_STABLE, -1 ),
+	EffectDesc("MirrorImageModifier", fx_mirror_image_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("ModifyGlobalVariable", fx_modify_global_variable, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("ModifyLocalVariable", fx_modify_local_variable, 0, -1 ),
 	EffectDesc("MonsterSummoning", fx_monster_summoning, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("MoraleBreakModifier", fx_morale_break_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("MoraleModifier", fx_morale_modifier, 0, -1 ),
-	EffectDesc("MovementRateModifier", fx_movement_modifier, 0, -1 ), //fast (7e)
-	EffectDesc("MovementRateModifier2", fx_movement_modifier, 0, -1 ),//slow (b0)
-	EffectDesc("MovementRateModifier3", fx_movement_modifier, 0, -1 ),//forced (IWD - 10a)
-	EffectDesc("MovementRateModifier4", fx_movement_modifier, 0, -1 ),//slow (IWD2 - 1b9)
+	EffectDesc("MoraleBreakModifier", fx_morale_break_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("MoraleModifier", fx_morale_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("MovementRateModifier", fx_movement_modifier, EFFECT_STABLE, -1 ), //fast (7e)
+	EffectDesc("MovementRateModifier2", fx_movement_modifier, EFFECT_STABLE, -1 ),//slow (b0)
+	EffectDesc("MovementRateModifier3", fx_movement_modifier, EFFECT_STABLE, -1 ),//forced (IWD - 10a)
+	EffectDesc("MovementRateModifier4", fx_movement_modifier, EFFECT_STABLE, -1 ),//slow (IWD2 - 1b9)
 	EffectDesc("MoveToArea", fx_move_to_area, 0, -1 ), //0xba
-	EffectDesc("NoCircleState", fx_no_circle_state, 0, -1 ),
-	EffectDesc("NPCBump", fx_npc_bump, 0, -1 ),
-	EffectDesc("OffscreenAIModifier", fx_offscreenai_modifier, 0, -1 ),
-	EffectDesc("OffhandHitModifier", fx_left_to_hit_modifier, 0, -1 ),
-	EffectDesc("OpenLocksModifier", fx_open_locks_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("Overlay:Entangle", fx_set_entangle_state, 0, -1 ),
-	EffectDesc("Overlay:Grease", fx_set_grease_state, 0, -1 ),
-	EffectDesc("Overlay:MinorGlobe", fx_set_minorglobe_state, 0, -1 ),
-	EffectDesc("Overlay:Sanctuary", fx_set_sanctuary_state, 0, -1 ),
-	EffectDesc("Overlay:ShieldGlobe", fx_set_shieldglobe_state, 0, -1 ),
-	EffectDesc("Overlay:Web", fx_set_web_state, 0, -1 ),
+	EffectDesc("NoCircleState", fx_no_circle_state, EFFECT_STABLE, -1 ),
+	EffectDesc("NPCBump", fx_npc_bump, EFFECT_STABLE, -1 ),
+	EffectDesc("OffscreenAIModifier", fx_offscreenai_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("OffhandHitModifier", fx_left_to_hit_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("OpenLocksModifier", fx_open_locks_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("Overlay:Entangle", fx_set_entangle_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Overlay:Grease", fx_set_grease_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Overlay:MinorGlobe", fx_set_minorglobe_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Overlay:Sanctuary", fx_set_sanctuary_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Overlay:ShieldGlobe", fx_set_shieldglobe_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Overlay:Web", fx_set_web_state, EFFECT_STABLE, -1 ),
 	EffectDesc("PauseTarget", fx_pause_target, 0, -1 ), //also known as casterhold
-	EffectDesc("PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("PlayMovie", fx_play_movie, EFFECT_NO_ACTOR, -1 ),
+	EffectDesc("PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("PlayMovie", fx_play_movie, EFFECT_NO_ACTOR|EFFECT_STABLE, -1 ),
 	EffectDesc("PlaySound", fx_playsound, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("PlayVisualEffect", fx_play_visual_effect, EFFECT_REINIT_ON_LOAD, -1 ),
-	EffectDesc("PoisonResistanceModifier", fx_poison_resistance_modifier, 0, -1 ),
-	EffectDesc("Polymorph", fx_polymorph, 0, -1 ),
-	EffectDesc("PortraitChange", fx_portrait_change, 0, -1 ),
-	EffectDesc("PowerWordKill", fx_power_word_kill, 0, -1 ),
+	EffectDesc("PoisonResistanceModifier", fx_poison_resistance_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("Polymorph", fx_polymorph, EFFECT_STABLE, -1 ),
+	EffectDesc("PortraitChange", fx_portrait_change, EFFECT_STABLE, -1 ),
+	EffectDesc("PowerWordKill", fx_power_word_kill, EFFECT_STABLE, -1 ),
 	EffectDesc("PowerWordSleep", fx_power_word_sleep, 0, -1 ),
 	EffectDesc("PowerWordStun", fx_power_word_stun, 0, -1 ),
-	EffectDesc("PriestSpellSlotsModifier", fx_bonus_priest_spells, 0, -1 ),
-	EffectDesc("Proficiency", fx_proficiency, 0, -1 ),
-//	EffectDesc("Protection:Animation", fx_protection_from_animation, 0, -1 ),
-	EffectDesc("Protection:Animation", fx_generic_effect, 0, -1 ),
-	EffectDesc("Protection:Backstab", fx_no_backstab_modifier, 0, -1 ),
-	EffectDesc("Protection:Creature", fx_generic_effect, 0, -1 ),
-	EffectDesc("Protection:Opcode", fx_protection_opcode, 0, -1 ),
-	EffectDesc("Protection:Opcode2", fx_protection_opcode, 0, -1 ),
+	EffectDesc("PriestSpellSlotsModifier", fx_bonus_priest_spells, EFFECT_STABLE, -1 ),
+	EffectDesc("Proficiency", fx_proficiency, EFFECT_STABLE, -1 ),
+//	EffectDesc("Protection:Animation", fx_protection_from_animation, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Animation", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Backstab", fx_no_backstab_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Creature", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Opcode", fx_protection_opcode, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Opcode2", fx_protection_opcode, EFFECT_STABLE, -1 ),
 	EffectDesc("Protection:Projectile",fx_protection_from_projectile, 0, -1 ),
 	EffectDesc("Protection:School",fx_protection_school, 0, -1 ),//overlay?
 	EffectDesc("Protection:SchoolDec",fx_protection_school_dec, 0, -1 ),//overlay?
 	EffectDesc("Protection:SecondaryType",fx_protection_secondary_type, 0, -1 ),//overlay?
 	EffectDesc("Protection:SecondaryTypeDec",fx_protection_secondary_type_dec, 0, -1 ),//overlay?
 	EffectDesc("Protection:Spell",fx_resist_spell, 0, -1 ),//overlay?
-	EffectDesc("Protection:Spell2", fx_resist_spell2, 0, -1),
-	EffectDesc("Protection:Spell3", fx_resist_spell_and_message, 0, -1),
+	EffectDesc("Protection:Spell2", fx_resist_spell2, EFFECT_STABLE, -1),
+	EffectDesc("Protection:Spell3", fx_resist_spell_and_message, EFFECT_STABLE, -1),
 	EffectDesc("Protection:SpellDec",fx_resist_spell_dec, 0, -1 ),//overlay?
 	EffectDesc("Protection:SpellLevel",fx_protection_spelllevel, 0, -1 ),//overlay?
 	EffectDesc("Protection:SpellLevelDec",fx_protection_spelllevel_dec, 0, -1 ),//overlay?
-	EffectDesc("Protection:String", fx_generic_effect, 0, -1 ),
-	EffectDesc("Protection:Tracking", fx_protection_from_tracking, 0, -1 ),
-	EffectDesc("Protection:Turn", fx_protection_from_turn, 0, -1 ),
-	EffectDesc("Protection:Weapons", fx_immune_to_weapon, EFFECT_NO_ACTOR|EFFECT_REINIT_ON_LOAD, -1 ),
+	EffectDesc("Protection:String", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Tracking", fx_protection_from_tracking, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Turn", fx_protection_from_turn, EFFECT_STABLE, -1 ),
+	EffectDesc("Protection:Weapons", fx_immune_to_weapon, EFFECT_NO_ACTOR|EFFECT_REINIT_ON_LOAD|EFFECT_STABLE, -1 ),
 	EffectDesc("PuppetMarker", fx_puppet_marker, 0, -1 ),
 	EffectDesc("ProjectImage", fx_puppet_master, 0, -1 ),
 	EffectDesc("Reveal:Area", fx_reveal_area, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("Reveal:Creatures", fx_reveal_creatures, 0, -1 ),
-	EffectDesc("Reveal:Magic", fx_reveal_magic, 0, -1 ),
+	EffectDesc("Reveal:Creatures", fx_reveal_creatures, EFFECT_STABLE, -1 ),
+	EffectDesc("Reveal:Magic", fx_reveal_magic, EFFECT_STABLE, -1 ),
 	EffectDesc("Reveal:Tracks", fx_reveal_tracks, 0, -1 ),
-	EffectDesc("RemoveCurse", fx_remove_curse, 0, -1 ),
-	EffectDesc("RemoveEffectsByResource", fx_remove_effects, 0, -1),
-	EffectDesc("RemoveImmunity", fx_remove_immunity, 0, -1 ),
+	EffectDesc("RemoveCurse", fx_remove_curse, EFFECT_STABLE, -1 ),
+	EffectDesc("RemoveEffectsByResource", fx_remove_effects, EFFECT_STABLE, -1),
+	EffectDesc("RemoveImmunity", fx_remove_immunity, EFFECT_STABLE, -1 ),
 	EffectDesc("RemoveMapNote", fx_remove_map_note, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("RemoveProjectile", fx_remove_projectile, 0, -1 ), //removes effects from actor and area
-	EffectDesc("RenableButton", fx_renable_button, 0, -1 ), //removes disable button flag
+	EffectDesc("RenableButton", fx_renable_button, EFFECT_STABLE, -1 ), //removes disable button flag
 	EffectDesc("RemoveCreature", fx_remove_creature, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("ReplaceCreature", fx_replace_creature, 0, -1 ),
-	EffectDesc("ReputationModifier", fx_reputation_modifier, 0, -1 ),
-	EffectDesc("RestoreSpells", fx_restore_spell_level, 0, -1 ),
-	EffectDesc("RetreatFrom2", fx_turn_undead, 0, -1 ),
-	EffectDesc("RightHitModifier", fx_right_to_hit_modifier, 0, -1 ),
-	EffectDesc("SaveVsBreathModifier", fx_save_vs_breath_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsDeathModifier", fx_save_vs_death_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsPolyModifier", fx_save_vs_poly_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsSpellsModifier", fx_save_vs_spell_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("SaveVsWandsModifier", fx_save_vs_wands_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("ReputationModifier", fx_reputation_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("RestoreSpells", fx_restore_spell_level, EFFECT_STABLE, -1 ),
+	EffectDesc("RetreatFrom2", fx_turn_undead, EFFECT_STABLE, -1 ),
+	EffectDesc("RightHitModifier", fx_right_to_hit_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("SaveVsBreathModifier", fx_save_vs_breath_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("SaveVsDeathModifier", fx_save_vs_death_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("SaveVsPolyModifier", fx_save_vs_poly_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("SaveVsSpellsModifier", fx_save_vs_spell_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("SaveVsWandsModifier", fx_save_vs_wands_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
 	EffectDesc("ScreenShake", fx_screenshake, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("ScriptingState", fx_scripting_state, 0, -1 ),
-	EffectDesc("Sequencer:Activate", fx_activate_spell_sequencer, EFFECT_PRESET_TARGET, -1 ),
+	EffectDesc("ScriptingState", fx_scripting_state, EFFECT_STABLE, -1 ),
+	EffectDesc("Sequencer:Activate", fx_activate_spell_sequencer, EFFECT_PRESET_TARGET|EFFECT_STABLE, -1 ),
 	EffectDesc("Sequencer:Create", fx_create_spell_sequencer, 0, -1 ),
-	EffectDesc("Sequencer:Store", fx_store_spell_sequencer, 0, -1 ),
-	EffectDesc("SetAIScript", fx_set_ai_script, 0, -1 ),
-	EffectDesc("SetConcealment", fx_set_concealment, 0, -1 ),
+	EffectDesc("Sequencer:Store", fx_store_spell_sequencer, EFFECT_STABLE, -1 ),
+	EffectDesc("SetAIScript", fx_set_ai_script, EFFECT_STABLE, -1 ),
+	EffectDesc("SetConcealment", fx_set_concealment, EFFECT_STABLE, -1 ),
 	EffectDesc("SetMapNote", fx_set_map_note, EFFECT_NO_ACTOR, -1 ),
-	EffectDesc("SetMeleeEffect", fx_generic_effect, 0, -1 ),
-	EffectDesc("SetRangedEffect", fx_generic_effect, 0, -1 ),
+	EffectDesc("SetMeleeEffect", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("SetRangedEffect", fx_generic_effect, EFFECT_STABLE, -1 ),
 	EffectDesc("SetTrap", fx_set_area_effect, 0, -1 ),
-	EffectDesc("SetTrapsModifier", fx_set_traps_modifier, 0, -1 ),
-	EffectDesc("SexModifier", fx_sex_modifier, 0, -1 ),
-	EffectDesc("SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1 ),
+	EffectDesc("SetTrapsModifier", fx_set_traps_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("SexModifier", fx_sex_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
 	EffectDesc("Sparkle", fx_sparkle, 0, -1 ),
-	EffectDesc("SpellDurationModifier", fx_spell_duration_modifier, 0, -1 ),
-	EffectDesc("Spell:Add", fx_add_innate, 0, -1 ),
-	EffectDesc("Spell:Cast", fx_cast_spell, 0, -1 ),
+	EffectDesc("SpellDurationModifier", fx_spell_duration_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("Spell:Add", fx_add_innate, EFFECT_STABLE, -1 ),
+	EffectDesc("Spell:Cast", fx_cast_spell, EFFECT_STABLE, -1 ),
 	EffectDesc("Spell:CastPoint", fx_cast_spell_point, 0, -1 ),
-	EffectDesc("Spell:Learn", fx_learn_spell, 0, -1 ),
-	EffectDesc("Spell:Remove", fx_remove_spell, 0, -1 ),
+	EffectDesc("Spell:Learn", fx_learn_spell, EFFECT_STABLE, -1 ),
+	EffectDesc("Spell:Remove", fx_remove_spell, EFFECT_STABLE, -1 ),
 	EffectDesc("SpellFocus",fx_generic_effect , 0, -1 ), //to implement school specific saving throw penalty to opponent
 	EffectDesc("SpellResistance",fx_generic_effect , 0, -1 ), //to implement school specific saving throw bonus
 	EffectDesc("Spelltrap",fx_spelltrap , 0, -1 ), //overlay: spmagglo
-	EffectDesc("Stat:SetStat", fx_set_stat, 0, -1),
+	EffectDesc("Stat:SetStat", fx_set_stat, EFFECT_STABLE, -1),
 	EffectDesc("State:Berserk", fx_set_berserk_state, 0, -1 ),
 	EffectDesc("State:Blind", fx_set_blind_state, 0, -1 ),
-	EffectDesc("State:Blur", fx_set_blur_state, 0, -1 ),
+	EffectDesc("State:Blur", fx_set_blur_state, EFFECT_STABLE, -1 ),
 	EffectDesc("State:Charmed", fx_set_charmed_state, EFFECT_NO_LEVEL_CHECK, -1 ), //0x05
-	EffectDesc("State:Confused", fx_set_confused_state, 0, -1 ),
-	EffectDesc("State:Deafness", fx_set_deaf_state, 0, -1 ),
+	EffectDesc("State:Confused", fx_set_confused_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Deafness", fx_set_deaf_state, EFFECT_STABLE, -1 ),
 	EffectDesc("State:Diseased", fx_set_diseased_state, 0, -1 ),
-	EffectDesc("State:Feeblemind", fx_set_feebleminded_state, 0, -1 ),
-	EffectDesc("State:Hasted", fx_set_hasted_state, 0, -1 ),
-	EffectDesc("State:Haste2", fx_set_hasted_state, 0, -1 ),
-	EffectDesc("State:Hold", fx_hold_creature, 0, -1 ), //175 (doesn't work in original iwd2)
-	EffectDesc("State:Hold2", fx_hold_creature, 0, -1 ),//185 (doesn't work in original iwd2)
-	EffectDesc("State:Hold3", fx_hold_creature, 0, -1 ),//109 iwd2
-	EffectDesc("State:HoldNoIcon", fx_hold_creature_no_icon, 0, -1 ), //109 (bg2) 0x6d
-	EffectDesc("State:HoldNoIcon2", fx_hold_creature_no_icon, 0, -1 ), //0xfb (iwd/iwd2)
-	EffectDesc("State:HoldNoIcon3", fx_hold_creature_no_icon, 0, -1 ), //0x1a8 (iwd2)
+	EffectDesc("State:Feeblemind", fx_set_feebleminded_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Hasted", fx_set_hasted_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Haste2", fx_set_hasted_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Hold", fx_hold_creature, EFFECT_STABLE, -1 ), //175 (doesn't work in original iwd2)
+	EffectDesc("State:Hold2", fx_hold_creature, EFFECT_STABLE, -1 ),//185 (doesn't work in original iwd2)
+	EffectDesc("State:Hold3", fx_hold_creature, EFFECT_STABLE, -1 ),//109 iwd2
+	EffectDesc("State:HoldNoIcon", fx_hold_creature_no_icon, EFFECT_STABLE, -1 ), //109 (bg2) 0x6d
+	EffectDesc("State:HoldNoIcon2", fx_hold_creature_no_icon, EFFECT_STABLE, -1 ), //0xfb (iwd/iwd2)
+	EffectDesc("State:HoldNoIcon3", fx_hold_creature_no_icon, EFFECT_STABLE, -1 ), //0x1a8 (iwd2)
 	EffectDesc("State:Imprisonment", fx_imprisonment, 0, -1 ),
-	EffectDesc("State:Infravision", fx_set_infravision_state, 0, -1 ),
+	EffectDesc("State:Infravision", fx_set_infravision_state, EFFECT_STABLE, -1 ),
 	EffectDesc("State:Invisible", fx_set_invisible_state, 0, -1 ), //both invis or improved invis
-	EffectDesc("State:Nondetection", fx_set_nondetection_state, 0, -1 ),
-	EffectDesc("State:Panic", fx_set_panic_state, 0, -1 ),
+	EffectDesc("State:Nondetection", fx_set_nondetection_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Panic", fx_set_panic_state, EFFECT_STABLE, -1 ),
 	EffectDesc("State:Petrification", fx_set_petrified_state, 0, -1 ),
 	EffectDesc("State:Poisoned", fx_set_poisoned_state, 0, -1 ),
 	EffectDesc("State:Regenerating", fx_set_regenerating_state, 0, -1 ),
-	EffectDesc("State:Silenced", fx_set_silenced_state, 0, -1 ),
-	EffectDesc("State:Helpless", fx_set_unconscious_state, 0, -1 ),
-	EffectDesc("State:Sleep", fx_set_unconscious_state, 0, -1 ),
-	EffectDesc("State:Slowed", fx_set_slowed_state, 0, -1 ),
-	EffectDesc("State:Stun", fx_set_stun_state, 0, -1 ),
-	EffectDesc("StealthModifier", fx_stealth_modifier, 0, -1 ),
-	EffectDesc("StoneSkinModifier", fx_stoneskin_modifier, 0, -1 ),
-	EffectDesc("StoneSkin2Modifier", fx_golem_stoneskin_modifier, 0, -1 ),
+	EffectDesc("State:Silenced", fx_set_silenced_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Helpless", fx_set_unconscious_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Sleep", fx_set_unconscious_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Slowed", fx_set_slowed_state, EFFECT_STABLE, -1 ),
+	EffectDesc("State:Stun", fx_set_stun_state, EFFECT_STABLE, -1 ),
+	EffectDesc("StealthModifier", fx_stealth_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("StoneSkinModifier", fx_stoneskin_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("StoneSkin2Modifier", fx_golem_stoneskin_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("StrengthModifier", fx_strength_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("StrengthBonusModifier", fx_strength_bonus_modifier, 0, -1 ),
+	EffectDesc("StrengthBonusModifier", fx_strength_bonus_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("SummonCreature", fx_summon_creature, EFFECT_NO_ACTOR, -1 ),
 	EffectDesc("RandomTeleport", fx_teleport_field, 0, -1 ),
 	EffectDesc("TeleportToTarget", fx_teleport_to_target, 0, -1 ),
-	EffectDesc("TimelessState", fx_timeless_modifier, 0, -1 ),
+	EffectDesc("TimelessState", fx_timeless_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("Timestop", fx_timestop, 0, -1 ),
-	EffectDesc("TitleModifier", fx_title_modifier, 0, -1 ),
-	EffectDesc("ToHitModifier", fx_to_hit_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("ToHitBonusModifier", fx_to_hit_bonus_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("ToHitVsCreature", fx_generic_effect, 0, -1 ),
-	EffectDesc("TrackingModifier", fx_tracking_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("TransparencyModifier", fx_transparency_modifier, 0, -1 ),
-	EffectDesc("TurnUndead", fx_turn_undead, 0, -1 ),
-	EffectDesc("UncannyDodge", fx_uncanny_dodge, 0, -1 ),
-	EffectDesc("Unknown", fx_unknown, EFFECT_NO_ACTOR, -1 ),
+	EffectDesc("TitleModifier", fx_title_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("ToHitModifier", fx_to_hit_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("ToHitBonusModifier", fx_to_hit_bonus_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("ToHitVsCreature", fx_generic_effect, EFFECT_STABLE, -1 ),
+	EffectDesc("TrackingModifier", fx_tracking_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("TransparencyModifier", fx_transparency_modifier, EFFECT_STABLE, -1 ),
+	EffectDesc("TurnUndead", fx_turn_undead, EFFECT_STABLE, -1 ),
+	EffectDesc("UncannyDodge", fx_uncanny_dodge, EFFECT_STABLE, -1 ),
+	EffectDesc("Unknown", fx_unknown, EFFECT_NO_ACTOR|EFFECT_STABLE, -1 ),
 	EffectDesc("Unlock", fx_knock, EFFECT_NO_ACTOR, -1 ), //open doors/containers
 	EffectDesc("UnsummonCreature", fx_unsummon_creature, EFFECT_NO_LEVEL_CHECK, -1 ),
-	EffectDesc("Usability:ItemUsability", fx_item_usability, EFFECT_NO_LEVEL_CHECK, -1 ),
+	EffectDesc("Usability:ItemUsability", fx_item_usability, EFFECT_NO_LEVEL_CHECK|EFFECT_STABLE, -1 ),
 	EffectDesc("Variable:StoreLocalVariable", fx_local_variable, 0, -1 ),
-	EffectDesc("VisualAnimationEffect", fx_visual_animation_effect, 0, -1 ), //unknown
-	EffectDesc("VisualRangeModifier", fx_visual_range_modifier, 0, -1 ),
+	EffectDesc("VisualAnimationEffect", fx_visual_animation_effect, EFFECT_STABLE, -1 ), //unknown
+	EffectDesc("VisualRangeModifier", fx_visual_range_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("VisualSpellHit", fx_visual_spell_hit, 0, -1 ),
-	EffectDesc("WildSurgeModifier", fx_wild_surge_modifier, 0, -1 ),
+	EffectDesc("WildSurgeModifier", fx_wild_surge_modifier, EFFECT_STABLE, -1 ),
 	EffectDesc("WingBuffet", fx_wing_buffet, 0, -1 ),
-	EffectDesc("WisdomModifier", fx_wisdom_modifier, EFFECT_SPECIAL_UNDO, -1 ),
-	EffectDesc("WizardSpellSlotsModifier", fx_bonus_wizard_spells, 0, -1 ),
+	EffectDesc("WisdomModifier", fx_wisdom_modifier, EFFECT_SPECIAL_UNDO|EFFECT_STABLE, -1 ),
+	EffectDesc("WizardSpellSlotsModifier", fx_bonus_wizard_spells, EFFECT_STABLE, -1 ),
 	EffectDesc(NULL, NULL, 0, 0 ),
 };
 
@@ -7188,7 +7188,7 @@ int fx_teleport_to_target (Scriptable* /*Owner*/, Actor* target, Effect* /*fx*/)
 		}
 		int rnd = core->Roll(1,tgts->Count(),-1);
 		const Actor *victim = (Actor *) tgts->GetTarget(rnd, ST_ACTOR);
-		delete tgts;
+		tgts->Release();
 		if (victim && PersonalDistance(victim, target)>20) {
 			target->SetPosition( victim->Pos, true, 0 );
 			target->SetColorMod(0xff, RGBModifier::ADD, 0x50, Color(0xff, 0xff, 0xff, 0), 0);
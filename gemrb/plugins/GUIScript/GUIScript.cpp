@@ -30,6 +30,7 @@
 #include "DialogHandler.h"
 #include "DisplayMessage.h"
 #include "EffectQueue.h"
+#include "Factory.h"
 #include "Game.h"
 #include "GameData.h"
 #include "ImageFactory.h"
@@ -8072,6 +8073,18 @@ static PyObject* GemRB_ConsoleWindowLog(PyObject * /*self*/, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR( GemRB_GetFactoryStats__doc,
+			 "GetFactoryStats() => dict\n\n"
+			 "Returns the residency, hit and eviction counts of the animation and image cache." );
+
+static PyObject* GemRB_GetFactoryStats(PyObject * /*self*/, PyObject* /*args*/)
+{
+	Factory::Stats stats = gamedata->GetFactory().GetStats();
+	return Py_BuildValue("{s:n,s:n,s:n,s:k,s:k,s:k,s:n}", "Entries", stats.entries,
+						 "Bytes", stats.bytes, "Budget", stats.budget, "Hits", stats.hits,
+						 "Misses", stats.misses, "Evicted", stats.evicted, "BytesFreed", stats.bytesFreed);
+}
+
 PyDoc_STRVAR( GemRB_GetCurrentArea__doc,
 "===== GetCurrentArea =====\n\
 \n\
@@ -13194,6 +13207,7 @@ static PyMethodDef GemRBMethods[] = {
 	METHOD(GetDamageReduction, METH_VARARGS),
 	METHOD(GetEquippedAmmunition, METH_VARARGS),
 	METHOD(GetEquippedQuickSlot, METH_VARARGS),
+	METHOD(GetFactoryStats, METH_NOARGS),
 	METHOD(GetGamePreview, METH_VARARGS),
 	METHOD(GetGameString, METH_VARARGS),
 	METHOD(GetGameTime, METH_NOARGS),
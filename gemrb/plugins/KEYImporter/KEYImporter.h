@@ -140,6 +140,7 @@ public:
 	/* returns resource */
 	DataStream* GetResource(StringView resname, SClass_ID type) override;
 	DataStream* GetResource(StringView resname, const ResourceDesc &type) override;
+	bool IsStatic() const override { return true; }
 };
 
 }
@@ -0,0 +1,339 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "NullVideo.h"
+
+#include "Logging/Logging.h"
+#include "Palette.h"
+#include "Sprite2D.h"
+#include "Video/RLE.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace GemRB;
+
+// the memory buffers are plain RGBA, byte order included
+static const PixelFormat memoryFormat {
+	0, 0, 0, 0,
+	0, 8, 16, 24,
+	0xff, 0xff00, 0xff0000, 0xff000000,
+	4, 32,
+	0, false,
+	false, nullptr
+};
+
+class NullVideoBuffer : public VideoBuffer {
+	std::vector<uint32_t> pixels;
+
+public:
+	NullVideoBuffer(const Region& r, bool software)
+	: VideoBuffer(r)
+	{
+		if (software) {
+			pixels.resize(r.w * r.h);
+		}
+	}
+
+	bool HasPixels() const noexcept { return !pixels.empty(); }
+	uint32_t* Row(int y) noexcept { return &pixels[y * rect.w]; }
+	const uint32_t* Row(int y) const noexcept { return &pixels[y * rect.w]; }
+
+	void Clear(const Region& rgn) override
+	{
+		if (pixels.empty()) return;
+		Region r = rgn.Intersect(Region(Point(), rect.size));
+		for (int y = r.y; y < r.y + r.h; ++y) {
+			std::fill_n(Row(y) + r.x, r.w, 0);
+		}
+	}
+
+	// movie frames are simply dropped, nobody is watching
+	void CopyPixels(const Region&, const void*, const int*, ...) override {}
+
+	bool RenderOnDisplay(void*) const override { return true; }
+};
+
+NullVideoDriver::NullVideoDriver(bool software)
+: software(software), kernels(PixelKernels::Get())
+{
+	PixelLayout::FromFormat(memoryFormat, layout);
+}
+
+int NullVideoDriver::Init()
+{
+	if (software) {
+		Log(MESSAGE, "NullVideo", "Rendering into memory with the {} row kernels.", kernels.name);
+	}
+	return GEM_OK;
+}
+
+int NullVideoDriver::CreateDriverDisplay(const char*)
+{
+	return GEM_OK;
+}
+
+int NullVideoDriver::PollEvents()
+{
+	return GEM_OK;
+}
+
+void NullVideoDriver::Wait(uint32_t ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+VideoBuffer* NullVideoDriver::NewVideoBuffer(const Region& r, BufferFormat)
+{
+	return new NullVideoBuffer(r, software);
+}
+
+Holder<Sprite2D> NullVideoDriver::CreateSprite(const Region& rgn, void* pixels, const PixelFormat& fmt)
+{
+	// like an SDL surface, a sprite without pixels gets a blank buffer to be filled through LockSprite
+	if (!pixels && !fmt.RLE) {
+		pixels = calloc(rgn.w * rgn.h, fmt.Bpp);
+	}
+	return MakeHolder<Sprite2D>(rgn, pixels, fmt, rgn.w * fmt.Bpp);
+}
+
+void NullVideoDriver::BlitSprite(const Holder<Sprite2D>& spr, const Region& src, Region dst,
+								 BlitFlags flags, Color tint)
+{
+	if (!software) return;
+
+	dst.x -= spr->Frame.x;
+	dst.y -= spr->Frame.y;
+	BlitSpriteClipped(spr, src, dst, flags, tint);
+}
+
+void NullVideoDriver::BlitGameSprite(const Holder<Sprite2D>& spr, const Point& p,
+									 BlitFlags flags, Color tint)
+{
+	if (!software) return;
+
+	Region src(0, 0, spr->Frame.w, spr->Frame.h);
+	Region dst(p - spr->Frame.origin, spr->Frame.size);
+	BlitSpriteClipped(spr, src, dst, flags, tint);
+}
+
+void NullVideoDriver::BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p, BlitFlags flags, Color)
+{
+	const NullVideoBuffer* source = static_cast<const NullVideoBuffer*>(buf.get());
+	NullVideoBuffer* target = static_cast<NullVideoBuffer*>(drawingBuffer);
+	if (!software || !source->HasPixels() || !target->HasPixels()) return;
+
+	Region dst(p + buf->Origin(), buf->Size());
+	Region clipped = ClippedDrawingRect(dst);
+	if (clipped.size.IsInvalid() || clipped.w == 0) return;
+	frameStats.blits++;
+
+	std::vector<uint8_t> stencil(clipped.w, 0);
+	for (int y = 0; y < clipped.h; ++y) {
+		const uint32_t* row = source->Row(clipped.y - dst.y + y) + clipped.x - dst.x;
+		BlendRow(target->Row(clipped.y + y) + clipped.x, row, stencil.data(), clipped.w, flags);
+	}
+}
+
+Holder<Sprite2D> NullVideoDriver::GetScreenshot(Region r, const VideoBufferPtr& buf)
+{
+	int width = r.w ? r.w : screenSize.w;
+	int height = r.h ? r.h : screenSize.h;
+	uint32_t* pixels = static_cast<uint32_t*>(calloc(width * height, sizeof(uint32_t)));
+
+	// only the buffer itself, since there is no composited screen
+	const NullVideoBuffer* source = static_cast<const NullVideoBuffer*>(buf.get());
+	if (source && source->HasPixels()) {
+		Region copy = Region(r.origin, Size(width, height)).Intersect(Region(Point(), buf->Size()));
+		for (int y = 0; y < copy.h; ++y) {
+			memcpy(pixels + (copy.y - r.y + y) * width + copy.x - r.x, source->Row(copy.y + y) + copy.x,
+				   copy.w * sizeof(uint32_t));
+		}
+	}
+
+	return MakeHolder<Sprite2D>(Region(0, 0, width, height), pixels, memoryFormat, width * 4);
+}
+
+void NullVideoDriver::DrawRectImp(const Region& rgn, const Color& color, bool fill, BlitFlags flags)
+{
+	NullVideoBuffer* target = static_cast<NullVideoBuffer*>(drawingBuffer);
+	if (!software || !target->HasPixels()) return;
+
+	std::vector<uint32_t> row(rgn.w, layout.Pack(color));
+	std::vector<uint8_t> stencil(rgn.w, 0);
+	auto span = [&](const Region& part) {
+		Region clipped = ClippedDrawingRect(part);
+		if (clipped.size.IsInvalid() || clipped.w == 0) return;
+		for (int y = clipped.y; y < clipped.y + clipped.h; ++y) {
+			BlendRow(target->Row(y) + clipped.x, row.data(), stencil.data(), clipped.w, flags);
+		}
+	};
+
+	if (fill) {
+		span(rgn);
+	} else {
+		span(Region(rgn.x, rgn.y, rgn.w, 1));
+		span(Region(rgn.x, rgn.y + rgn.h - 1, rgn.w, 1));
+		span(Region(rgn.x, rgn.y + 1, 1, rgn.h - 2));
+		span(Region(rgn.x + rgn.w - 1, rgn.y + 1, 1, rgn.h - 2));
+	}
+}
+
+// the same tinting the SDL software renderer does, see SRTinter_Flags
+void NullVideoDriver::TintRow(uint32_t* px, int n, BlitFlags flags, const Color& tint) const
+{
+	bool desaturate = flags & (BlitFlags::GREY | BlitFlags::SEPIA);
+	if (!desaturate && !(flags & (BlitFlags::COLOR_MOD | BlitFlags::ALPHA_MOD))) return;
+
+	ScaleParams params;
+	if (flags & BlitFlags::COLOR_MOD) {
+		params.ScaleColor(layout, tint, desaturate ? 10 : 8);
+	} else if (desaturate) {
+		params.ScaleColor(layout, Color(255, 255, 255, 255), 10);
+	} else {
+		params.keep = layout.ColorMask();
+	}
+	if (flags & BlitFlags::ALPHA_MOD) {
+		params.Scale(layout.aShift, tint.a, 8);
+	} else {
+		params.Keep(layout.aShift);
+	}
+	kernels.Scale(px, n, params);
+
+	if (flags & BlitFlags::GREY) {
+		kernels.Desaturate(px, n, DesaturateParams::Greyscale(layout));
+	} else if (flags & BlitFlags::SEPIA) {
+		kernels.Desaturate(px, n, DesaturateParams::Sepia(layout));
+	}
+}
+
+void NullVideoDriver::BlendRow(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, BlitFlags flags) const
+{
+	BlendParams params(layout, layout.AlphaMask());
+	if (flags & BlitFlags::HALFTRANS) {
+		kernels.BlendHalf(dst, src, stencil, n, params);
+	} else {
+		kernels.BlendAlpha(dst, src, stencil, n, params);
+	}
+}
+
+// 32bpp sprites may only have their masks set
+static bool SpriteLayout(const PixelFormat& fmt, PixelLayout& layout)
+{
+	auto shift = [](uint32_t mask) {
+		uint8_t s = 0;
+		while (mask && !(mask & 1)) {
+			mask >>= 1;
+			++s;
+		}
+		return s;
+	};
+
+	PixelFormat shifted = fmt;
+	shifted.Rshift = shift(fmt.Rmask);
+	shifted.Gshift = shift(fmt.Gmask);
+	shifted.Bshift = shift(fmt.Bmask);
+	shifted.Ashift = shift(fmt.Amask);
+	return PixelLayout::FromFormat(shifted, layout);
+}
+
+void NullVideoDriver::BlitSpriteClipped(const Holder<Sprite2D>& spr, const Region& src, const Region& dst,
+										BlitFlags flags, const Color& tint)
+{
+	NullVideoBuffer* target = static_cast<NullVideoBuffer*>(drawingBuffer);
+	if (!target->HasPixels()) return;
+
+	Region clipped = ClippedDrawingRect(dst);
+	if (clipped.size.IsInvalid() || clipped.w == 0) return;
+	frameStats.blits++;
+
+	const PixelFormat& fmt = spr->Format();
+	bool paletted = fmt.Bpp == 1;
+	PixelLayout spriteLayout;
+	if (!paletted && !SpriteLayout(fmt, spriteLayout)) {
+		return; // 16 and 24bpp sprites are not worth the trouble here
+	}
+	flags = BlitFlags(flags | (spr->renderFlags & (BlitFlags::MIRRORX | BlitFlags::MIRRORY)));
+
+	uint32_t palette[256];
+	if (paletted) {
+		PaletteHolder pal = fmt.palette;
+		for (int i = 0; i < 256; ++i) {
+			Color c = pal ? pal->col[i] : Color(i, i, i, 255);
+			// palette alpha only counts for blended sprites
+			if (!(flags & BlitFlags::BLENDED)) c.a = 255;
+			palette[i] = layout.Pack(c);
+		}
+		TintRow(palette, 256, flags, tint);
+	}
+
+	const uint8_t* pixels = static_cast<const uint8_t*>(spr->LockSprite());
+	int pitch = spr->GetPitch();
+	uint8_t* decoded = nullptr;
+	if (fmt.RLE) {
+		decoded = DecodeRLEData(pixels, spr->Frame.size, fmt.ColorKey);
+		pixels = decoded;
+		pitch = spr->Frame.w;
+	}
+
+	std::vector<uint32_t> row(clipped.w);
+	std::vector<uint8_t> stencil(clipped.w);
+	for (int y = 0; y < clipped.h; ++y) {
+		int fy = clipped.y + y - dst.y;
+		if (flags & BlitFlags::MIRRORY) fy = dst.h - 1 - fy;
+		const uint8_t* line = pixels + (src.y + fy) * pitch;
+
+		for (int x = 0; x < clipped.w; ++x) {
+			int fx = clipped.x + x - dst.x;
+			if (flags & BlitFlags::MIRRORX) fx = dst.w - 1 - fx;
+			int sx = src.x + fx;
+
+			if (paletted) {
+				uint8_t index = line[sx];
+				stencil[x] = (fmt.HasColorKey && index == fmt.ColorKey) ? 0xff : 0;
+				row[x] = palette[index];
+			} else {
+				uint32_t px;
+				memcpy(&px, line + sx * 4, 4);
+				stencil[x] = (fmt.HasColorKey && px == fmt.ColorKey) ? 0xff : 0;
+				Color c((px >> spriteLayout.rShift) & 0xff, (px >> spriteLayout.gShift) & 0xff,
+						(px >> spriteLayout.bShift) & 0xff, fmt.Amask ? (px >> spriteLayout.aShift) & 0xff : 255);
+				row[x] = layout.Pack(c);
+			}
+		}
+
+		if (!paletted) {
+			TintRow(row.data(), clipped.w, flags, tint);
+		}
+		BlendRow(target->Row(clipped.y + y) + clipped.x, row.data(), stencil.data(), clipped.w, flags);
+	}
+
+	free(decoded);
+	spr->UnlockSprite();
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0x4E554C56, "Null Video Driver")
+PLUGIN_DRIVER(NullVideoDriver, "none")
+PLUGIN_DRIVER(MemoryVideoDriver, "memory")
+END_PLUGIN()
@@ -0,0 +1,96 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef NULLVIDEO_H
+#define NULLVIDEO_H
+
+#include "Video/Video.h"
+#include "Video/PixelKernels.h"
+
+#include <vector>
+
+namespace GemRB {
+
+// a video driver without a display, for headless runs and benchmarks
+// "none" draws nothing at all, "memory" renders sprites into plain RGBA buffers
+class NullVideoDriver : public Video {
+public:
+	explicit NullVideoDriver(bool software = false);
+
+	int Init() override;
+	void SetWindowTitle(const char*) override {}
+	bool SetFullscreenMode(bool) override { return false; }
+	bool ToggleGrabInput() override { return false; }
+	void CaptureMouse(bool) override {}
+
+	void StartTextInput() override { textInput = true; }
+	void StopTextInput() override { textInput = false; }
+	bool InTextInput() override { return textInput; }
+	bool TouchInputEnabled() override { return false; }
+
+	Holder<Sprite2D> CreateSprite(const Region&, void* pixels, const PixelFormat&) override;
+	void BlitSprite(const Holder<Sprite2D>& spr, const Region& src, Region dst,
+					BlitFlags flags, Color tint = Color()) override;
+	void BlitGameSprite(const Holder<Sprite2D>& spr, const Point& p,
+						BlitFlags flags, Color tint = Color()) override;
+	void BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p, BlitFlags flags,
+						 Color tint = Color()) override;
+
+	Holder<Sprite2D> GetScreenshot(Region r, const VideoBufferPtr& buf = nullptr) override;
+	void SetGamma(int, int) override {}
+
+protected:
+	void Wait(uint32_t) override;
+
+private:
+	bool software;
+	bool textInput = false;
+	const PixelKernels& kernels;
+	PixelLayout layout;
+
+	VideoBuffer* NewVideoBuffer(const Region&, BufferFormat) override;
+	void SwapBuffers(VideoBuffers&) override {}
+	int PollEvents() override;
+	int CreateDriverDisplay(const char* title) override;
+
+	void DrawRectImp(const Region& rgn, const Color& color, bool fill, BlitFlags flags) override;
+	void DrawPointImp(const Point&, const Color&, BlitFlags) override {}
+	void DrawPointsImp(const std::vector<Point>&, const Color&, BlitFlags) override {}
+	void DrawCircleImp(const Point&, unsigned short, const Color&, BlitFlags) override {}
+	void DrawEllipseSegmentImp(const Point&, unsigned short, unsigned short, const Color&,
+							   double, double, bool, BlitFlags) override {}
+	void DrawPolygonImp(const Gem_Polygon*, const Point&, const Color&, bool, BlitFlags) override {}
+	void DrawLineImp(const Point&, const Point&, const Color&, BlitFlags) override {}
+	void DrawLinesImp(const std::vector<Point>&, const Color&, BlitFlags) override {}
+
+	void BlitSpriteClipped(const Holder<Sprite2D>& spr, const Region& src, const Region& dst,
+						   BlitFlags flags, const Color& tint);
+	void TintRow(uint32_t* px, int n, BlitFlags flags, const Color& tint) const;
+	void BlendRow(uint32_t* dst, const uint32_t* src, const uint8_t* stencil, int n, BlitFlags flags) const;
+};
+
+class MemoryVideoDriver : public NullVideoDriver {
+public:
+	MemoryVideoDriver() : NullVideoDriver(true) {}
+};
+
+}
+
+#endif
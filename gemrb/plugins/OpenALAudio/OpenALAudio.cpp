@@ -23,6 +23,7 @@
 #include "GameData.h"
 #include "Interface.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -238,6 +239,9 @@ bool OpenALAudioDriver::Init(void)
 		num_streams, (num_streams < MAX_STREAMS ? " (Fewer than desired.)" : "" ));
 
 	musicThread = std::thread(&OpenALAudioDriver::MusicManager, this);
+	for (int i = 0; i < DECODER_THREADS; i++) {
+		decoders.emplace_back(&OpenALAudioDriver::DecodeSounds, this);
+	}
 
 	if (!InitEFX()) {
 		Log(MESSAGE, "OpenAL", "EFX not available.");
@@ -336,7 +340,14 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 		return;
 	}
 
-	stayAlive = false;
+	{
+		std::lock_guard<std::mutex> lock(decodeMutex);
+		stayAlive = false;
+	}
+	decodeCond.notify_all();
+	for (auto& decoder : decoders) {
+		decoder.join();
+	}
 	
 	// AmigaOS4 should be built with -athread=native or this may not work
 	musicThread.join();
@@ -371,50 +382,180 @@ OpenALAudioDriver::~OpenALAudioDriver(void)
 	delete ambim;
 }
 
-ALuint OpenALAudioDriver::loadSound(StringView ResRef, tick_t &time_length)
+static std::string SoundKey(StringView ResRef)
 {
-	ALuint Buffer = 0;
+	std::string key(ResRef.c_str(), ResRef.length());
+	StringToLower(key);
+	return key;
+}
+
+bool OpenALAudioDriver::DecodeSound(StringView ResRef, DecodedSound& sound, bool background)
+{
+	ResourceHolder<SoundMgr> acm;
+	if (background) {
+		acm = ResourceHolder<SoundMgr>(static_cast<SoundMgr*>(gamedata->LoadResource(ResRef, &SoundMgr::ID)));
+	} else {
+		acm = GetResourceHolder<SoundMgr>(ResRef);
+	}
+	if (!acm) {
+		return false;
+	}
+	int cnt = acm->get_length();
+	sound.channels = acm->get_channels();
+	sound.samplerate = acm->get_samplerate();
+	//it is always reading the stuff into 16 bits
+	sound.samples.resize(cnt);
+	sound.samples.resize(acm->read_samples(sound.samples.data(), cnt));
+	//Sound Length in milliseconds
+	sound.length = ((cnt / sound.channels) * 1000) / sound.samplerate;
+	return true;
+}
+
+// picks up a sound from the decoders: waits if it is being decoded,
+// but takes over the ones that haven't started yet
+bool OpenALAudioDriver::TakeDecoded(const std::string& key, DecodedSound& sound)
+{
+	std::unique_lock<std::mutex> lock(decodeMutex);
+	auto it = pendingSounds.find(key);
+	if (it == pendingSounds.end()) {
+		return false;
+	}
+	if (it->second.state == DecodeState::Queued) {
+		decodeQueue.erase(std::find(decodeQueue.begin(), decodeQueue.end(), key));
+		pendingSounds.erase(it);
+		return false;
+	}
+	decodedCond.wait(lock, [&]() {
+		it = pendingSounds.find(key);
+		return it == pendingSounds.end() || it->second.state == DecodeState::Done;
+	});
+	if (it == pendingSounds.end()) {
+		// another thread claimed it
+		return false;
+	}
+	bool decoded = it->second.decoded;
+	sound = std::move(it->second.sound);
+	pendingSounds.erase(it);
+	return decoded;
+}
+
+void OpenALAudioDriver::DecodeSounds()
+{
+	std::unique_lock<std::mutex> lock(decodeMutex);
+	while (true) {
+		decodeCond.wait(lock, [this]() { return !stayAlive || !decodeQueue.empty(); });
+		if (!stayAlive) break;
+
+		std::string key = std::move(decodeQueue.front());
+		decodeQueue.pop_front();
+		pendingSounds[key].state = DecodeState::Decoding;
+		lock.unlock();
+
+		DecodedSound sound;
+		bool decoded = DecodeSound(key, sound, true);
+
+		lock.lock();
+		PendingSound& pending = pendingSounds[key];
+		pending.state = DecodeState::Done;
+		pending.decoded = decoded;
+		pending.sound = std::move(sound);
+		decodedCond.notify_all();
+	}
+}
+
+// sounds the decoders finished, but nobody played yet, go to the buffer cache,
+// where they are subject to its eviction instead of piling up here
+void OpenALAudioDriver::StoreDecoded()
+{
+	std::vector<std::pair<std::string, DecodedSound>> done;
+	{
+		std::lock_guard<std::mutex> lock(decodeMutex);
+		for (auto it = pendingSounds.begin(); it != pendingSounds.end();) {
+			if (it->second.state != DecodeState::Done) {
+				++it;
+				continue;
+			}
+			if (it->second.decoded) {
+				done.emplace_back(it->first, std::move(it->second.sound));
+			}
+			it = pendingSounds.erase(it);
+		}
+	}
+
+	for (const auto& sound : done) {
+		CacheBuffer(sound.first, sound.second, true);
+	}
+}
+
+void OpenALAudioDriver::Preload(const std::vector<ResRef>& sounds)
+{
+	StoreDecoded();
 
-	CacheEntry *e;
-	void* p;
+	std::vector<std::string> keys;
+	{
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		for (const ResRef& sound : sounds) {
+			if (sound.IsEmpty()) continue;
+			std::string key = SoundKey(sound);
+			if (!buffercache.Contains(key)) {
+				keys.push_back(std::move(key));
+			}
+		}
+	}
 
+	std::lock_guard<std::mutex> lock(decodeMutex);
+	// only bound the work in flight, finished sounds are moved out by StoreDecoded
+	size_t inFlight = 0;
+	for (const auto& pending : pendingSounds) {
+		if (pending.second.state != DecodeState::Done) {
+			inFlight++;
+		}
+	}
+	for (auto& key : keys) {
+		if (inFlight >= MAX_PENDING_SOUNDS) break;
+		if (!pendingSounds.emplace(key, PendingSound()).second) continue;
+		decodeQueue.push_back(std::move(key));
+		inFlight++;
+	}
+	decodeCond.notify_all();
+}
+
+ALuint OpenALAudioDriver::loadSound(StringView ResRef, tick_t &time_length)
+{
 	if (ResRef.empty()) {
 		return 0;
 	}
 	
-	LRUCache::key_t key(ResRef);
-	if(buffercache.Lookup(key, p))
+	std::string key = SoundKey(ResRef);
 	{
-		e = (CacheEntry*) p;
-		time_length = e->Length;
-		return e->Buffer;
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		const CacheEntry* e = buffercache.Lookup(key);
+		if (e) {
+			time_length = e->Length;
+			return e->Buffer;
+		}
 	}
 
 	//no cache entry...
-	alGenBuffers(1, &Buffer);
-	if (checkALError("Unable to create sound buffer", ERROR)) {
+	DecodedSound sound;
+	bool preloaded = TakeDecoded(key, sound);
+	if (!preloaded && !DecodeSound(ResRef, sound, false)) {
 		return 0;
 	}
 
-	ResourceHolder<SoundMgr> acm = GetResourceHolder<SoundMgr>(ResRef);
-	if (!acm) {
-		alDeleteBuffers( 1, &Buffer );
-		checkALError("Unable to delete buffer!", ERROR);
+	time_length = sound.length;
+	return CacheBuffer(key, sound, preloaded);
+}
+
+ALuint OpenALAudioDriver::CacheBuffer(const std::string& key, const DecodedSound& sound, bool preloaded)
+{
+	ALuint Buffer = 0;
+	alGenBuffers(1, &Buffer);
+	if (checkALError("Unable to create sound buffer", ERROR)) {
 		return 0;
 	}
-	int cnt = acm->get_length();
-	unsigned int riff_chans = acm->get_channels();
-	int samplerate = acm->get_samplerate();
-	//multiply always by 2 because it is in 16 bits
-	int rawsize = cnt * 2;
-	short* memory = (short*) malloc(rawsize);
-	//multiply always with 2 because it is in 16 bits
-	unsigned int cnt1 = acm->read_samples( memory, cnt ) * 2;
-	//Sound Length in milliseconds
-	time_length = ((cnt / riff_chans) * 1000) / samplerate;
-	//it is always reading the stuff into 16 bits
-	alBufferData( Buffer, GetFormatEnum( riff_chans, 16 ), memory, cnt1, samplerate );
-	free(memory);
+	alBufferData(Buffer, GetFormatEnum(sound.channels, 16), sound.samples.data(),
+		ALsizei(sound.samples.size() * sizeof(short)), sound.samplerate);
 
 	if (checkALError("Unable to fill buffer", ERROR)) {
 		alDeleteBuffers( 1, &Buffer );
@@ -422,14 +563,17 @@ ALuint OpenALAudioDriver::loadSound(StringView ResRef, tick_t &time_length)
 		return 0;
 	}
 
-	e = new CacheEntry;
-	e->Buffer = Buffer;
-	e->Length = time_length;
-
-	buffercache.SetAt(key, (void*)e);
-	//print("LoadSound: added %s to cache: %d. Cache size now %d", ResRef, e->Buffer, buffercache.GetCount());
+	std::lock_guard<std::mutex> lock(bufferMutex);
+	if (!buffercache.Insert(key, { Buffer, sound.length })) {
+		// someone else was quicker, use theirs
+		alDeleteBuffers(1, &Buffer);
+		return buffercache.Lookup(key)->Buffer;
+	}
+	if (preloaded) {
+		buffercache.preloaded++;
+	}
 
-	if (buffercache.GetCount() > BUFFER_CACHE_SIZE) {
+	if (buffercache.Size() > BUFFER_CACHE_SIZE) {
 		evictBuffer();
 	}
 	return Buffer;
@@ -815,50 +959,22 @@ void OpenALAudioDriver::SetAmbientStreamPitch(int stream, int pitch)
 bool OpenALAudioDriver::evictBuffer()
 {
 	// Note: this function assumes the caller holds bufferMutex
-
-	// Room for optimization: this is O(n^2) in the number of buffers
-	// at the tail that are used. It can be O(n) if LRUCache supports it.
-
-	unsigned int n = 0;
-	void* p;
-	LRUCache::key_t k;
-	bool res;
-
-	while ((res = buffercache.getLRU(n, k, p)) == true) {
-		CacheEntry* e = (CacheEntry*)p;
-		alDeleteBuffers(1, &e->Buffer);
-		if (alGetError() == AL_NO_ERROR) {
-			// Buffer was unused. An error would have indicated
-			// the buffer was still attached to a source.
-
-			delete e;
-			buffercache.Remove(k);
-
-			//print("Removed buffer %s from ACMImp cache", k);
-			break;
-		}
-		++n;
-	}
-
-	return res;
+	size_t removed = buffercache.Release([](const CacheEntry& e) {
+		alDeleteBuffers(1, &e.Buffer);
+		// an error indicates the buffer is still attached to a source
+		return alGetError() == AL_NO_ERROR;
+	}, 1);
+	buffercache.evictions += removed;
+	return removed != 0;
 }
 
 void OpenALAudioDriver::clearBufferCache(bool force)
 {
-	// Room for optimization: any method of iterating over the buffers
-	// would suffice. It doesn't have to be in LRU-order.
-	void* p;
-	LRUCache::key_t k;
-	int n = 0;
-	while (buffercache.getLRU(n, k, p)) {
-		CacheEntry* e = (CacheEntry*)p;
-		alDeleteBuffers(1, &e->Buffer);
-		if (force || alGetError() == AL_NO_ERROR) {
-			delete e;
-			buffercache.Remove(k);
-		} else
-			++n;
-	}
+	std::lock_guard<std::mutex> lock(bufferMutex);
+	buffercache.Release([force](const CacheEntry& e) {
+		alDeleteBuffers(1, &e.Buffer);
+		return alGetError() == AL_NO_ERROR || force;
+	}, buffercache.Size());
 }
 
 ALenum OpenALAudioDriver::GetFormatEnum(int channels, int bits) const
@@ -1056,6 +1172,18 @@ int OpenALAudioDriver::QueueALBuffer(ALuint source, ALuint buffer) const
 }
 
 void OpenALAudioDriver::UpdateMapAmbient(MapReverb& mapReverb) {
+	// what the last area decoded, but never played, leaves the decoders' hands
+	StoreDecoded();
+	{
+		// called on every area change, a good point to report how the last one went
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		unsigned long lookups = buffercache.hits + buffercache.misses;
+		Log(DEBUG, "OpenAL", "Sound buffers: {} hits, {} misses ({}% hit rate), {} decoded ahead, {} evicted",
+			buffercache.hits, buffercache.misses, lookups ? buffercache.hits * 100 / lookups : 0,
+			buffercache.preloaded, buffercache.evictions);
+		buffercache.hits = buffercache.misses = buffercache.preloaded = buffercache.evictions = 0;
+	}
+
 	if (hasEFX) {
 		mapReverb.getReverbProperties(reverbProperties);
 		hasReverbProperties = true;
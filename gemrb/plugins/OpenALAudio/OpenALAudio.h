@@ -27,14 +27,18 @@
 
 #include "ie_types.h"
 
-#include "LRUCache.h"
 #include "MusicMgr.h"
 #include "SoundMgr.h"
 #include "Streams/FileStream.h"
 #include "MapReverb.h"
 
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #if __APPLE__
 #include <OpenAL/OpenAL.h> // umbrella include for all the headers we want
@@ -48,6 +52,8 @@
 
 #define RETRY 5
 #define BUFFER_CACHE_SIZE 100
+#define DECODER_THREADS 2
+#define MAX_PENDING_SOUNDS 32
 #define MAX_STREAMS 30
 #define MUSICBUFFERS 10
 #define REFERENCE_DISTANCE 50
@@ -93,6 +99,70 @@ struct CacheEntry {
 	tick_t Length;
 };
 
+// AL buffers by sound name, most recently used first
+class BufferCache {
+	struct Item {
+		std::string key;
+		CacheEntry entry;
+	};
+	std::list<Item> items;
+	std::unordered_map<std::string, std::list<Item>::iterator> index;
+
+public:
+	unsigned long hits = 0;
+	unsigned long misses = 0;
+	unsigned long preloaded = 0; // misses served by the decoders
+	unsigned long evictions = 0;
+
+	size_t Size() const { return items.size(); }
+	bool Contains(const std::string& key) const { return index.count(key) != 0; }
+
+	const CacheEntry* Lookup(const std::string& key)
+	{
+		auto it = index.find(key);
+		if (it == index.end()) {
+			misses++;
+			return nullptr;
+		}
+		hits++;
+		items.splice(items.begin(), items, it->second);
+		return &it->second->entry;
+	}
+
+	// returns false if another thread added the same sound meanwhile
+	bool Insert(const std::string& key, const CacheEntry& entry)
+	{
+		if (Contains(key)) return false;
+		items.push_front({ key, entry });
+		index[key] = items.begin();
+		return true;
+	}
+
+	// walks from the least recently used end, removing the entries release accepts
+	template <typename F>
+	size_t Release(F release, size_t limit)
+	{
+		size_t removed = 0;
+		auto it = items.end();
+		while (it != items.begin() && removed < limit) {
+			--it;
+			if (!release(it->entry)) continue;
+			index.erase(it->key);
+			it = items.erase(it);
+			removed++;
+		}
+		return removed;
+	}
+};
+
+// samples decoded, but not yet put into an AL buffer
+struct DecodedSound {
+	std::vector<short> samples;
+	int channels = 0;
+	int samplerate = 0;
+	tick_t length = 0;
+};
+
 class OpenALAudioDriver : public Audio {
 public:
 	OpenALAudioDriver(void);
@@ -122,6 +192,7 @@ public:
 				int channels, short* memory,
 				int size, int samplerate) override;
 	void UpdateMapAmbient(MapReverb&) override;
+	void Preload(const std::vector<ResRef>& sounds) override;
 private:
 	int QueueALBuffer(ALuint source, ALuint buffer) const;
 
@@ -132,7 +203,8 @@ private:
 	std::recursive_mutex musicMutex;
 	ALuint MusicBuffer[MUSICBUFFERS]{};
 	std::shared_ptr<SoundMgr> MusicReader;
-	LRUCache buffercache;
+	std::mutex bufferMutex;
+	BufferCache buffercache;
 	AudioStream speech;
 	AudioStream streams[MAX_STREAMS];
 	int num_streams = 0;
@@ -141,6 +213,20 @@ private:
 	short* music_memory;
 	std::thread musicThread;
 
+	// sounds decoded ahead of time by the worker threads
+	enum class DecodeState { Queued, Decoding, Done };
+	struct PendingSound {
+		DecodeState state = DecodeState::Queued;
+		bool decoded = false;
+		DecodedSound sound;
+	};
+	std::mutex decodeMutex;
+	std::condition_variable decodeCond; // wakes the decoders
+	std::condition_variable decodedCond; // signals finished decodes
+	std::deque<std::string> decodeQueue;
+	std::unordered_map<std::string, PendingSound> pendingSounds;
+	std::vector<std::thread> decoders;
+
 	bool hasReverbProperties = false;
 	bool hasEFX = false;
 	ALuint efxEffectSlot = 0;
@@ -148,6 +234,11 @@ private:
 	MapReverbProperties reverbProperties;
 
 	ALuint loadSound(StringView ResRef, tick_t &time_length);
+	static bool DecodeSound(StringView ResRef, DecodedSound& sound, bool background);
+	ALuint CacheBuffer(const std::string& key, const DecodedSound& sound, bool preloaded);
+	bool TakeDecoded(const std::string& key, DecodedSound& sound);
+	void StoreDecoded();
+	void DecodeSounds();
 	int CountAvailableSources(int limit);
 	bool evictBuffer();
 	void clearBufferCache(bool force);
@@ -73,6 +73,10 @@ SDL20VideoDriver::~SDL20VideoDriver() noexcept
 	// we cant rely on the base destructor here
 	scratchBuffer = nullptr;
 	DestroyBuffers();
+	// sprites may hold on to the atlas for longer
+	if (atlas) {
+		atlas->Release();
+	}
 
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
@@ -192,6 +196,12 @@ int SDL20VideoDriver::CreateSDLDisplay(const char* title)
 	}
 #endif
 
+	atlas = std::make_shared<SDLTextureAtlas>(renderer);
+#if !USE_OPENGL_BACKEND && SDL_VERSION_ATLEAST(2, 0, 18)
+	// the GL backend has its own shader, which SDL_RenderGeometry would bypass
+	batching = sdl2_runtime_version >= SDL_VERSIONNUM(2,0,18);
+#endif
+
 	// we set logical size so that platforms where the window can be a diffrent size then requested
 	// function properly. eg iPhone and Android the requested size may be 640x480,
 	// but the window will always be the size of the screen
@@ -214,17 +224,27 @@ VideoBuffer* SDL20VideoDriver::NewVideoBuffer(const Region& r, BufferFormat fmt)
 		Log(ERROR, "SDL 2", "{}", SDL_GetError());
 		return nullptr;
 	}
-	return new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer);
+	SDLTextureVideoBuffer* buffer = new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer);
+	buffer->SetFlushHook([this]() {
+		FlushBatch();
+	});
+	return buffer;
 }
 
 void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 {
+	FlushBatch();
+
 #if USE_OPENGL_BACKEND
 	// we have coopted SDLs shader, so we need to reset uniforms to values appropriate for the render targets
 	blitRGBAShader->SetUniformValue("u_greyMode", 1, 0);
 	blitRGBAShader->SetUniformValue("u_stencil", 1, 0);
 	blitRGBAShader->SetUniformValue("u_dither", 1, 0);
 	blitRGBAShader->SetUniformValue("u_rgba", 1, 1);
+	shaderState.greyMode = 0;
+	shaderState.stencil = 0;
+	shaderState.dither = 0;
+	shaderState.rgba = 1;
 #endif
 	
 	SDL_SetRenderTarget(renderer, NULL);
@@ -238,6 +258,9 @@ void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 	}
 
 	SDL_RenderPresent( renderer );
+	if (atlas) {
+		atlas->ReleaseEmptyPages();
+	}
 }
 
 SDLVideoDriver::vid_buf_t* SDL20VideoDriver::ScratchBuffer() const
@@ -262,6 +285,7 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 {
 	// TODO: add support for BlitFlags::HALFTRANS, BlitFlags::COLOR_MOD, and others (no use for them ATM)
 
+	FlushBatch();
 	SDL_Texture* target = CurrentRenderBuffer();
 
 	assert(target);
@@ -271,14 +295,7 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 		return ret;
 	}
 
-	if (screenClip.size == screenSize)
-	{
-		// Some SDL backends complain on having a clip rect of the entire renderer size
-		// I'm not sure if it is an SDL bug; possibly its just 0 based so it is out of bounds?
-		SDL_RenderSetClipRect(renderer, NULL);
-	} else {
-		SDL_RenderSetClipRect(renderer, reinterpret_cast<SDL_Rect*>(&screenClip));
-	}
+	SetRenderClip(screenClip);
 
 	if (color) {
 		if (flags & BlitFlags::BLENDED) {
@@ -295,6 +312,130 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 	return 0;
 }
 
+void SDL20VideoDriver::SetRenderClip(const Region& clip)
+{
+	if (clip.size == screenSize)
+	{
+		// Some SDL backends complain on having a clip rect of the entire renderer size
+		// I'm not sure if it is an SDL bug; possibly its just 0 based so it is out of bounds?
+		SDL_RenderSetClipRect(renderer, NULL);
+	} else {
+		SDL_RenderSetClipRect(renderer, reinterpret_cast<const SDL_Rect*>(&clip));
+	}
+}
+
+static Uint8 AlphaForFlags(BlitFlags flags, const SDL_Color* tint)
+{
+	Uint8 alpha = SDL_ALPHA_OPAQUE;
+	if (flags & BlitFlags::ALPHA_MOD) {
+		alpha = tint->a;
+	}
+
+	if (flags & BlitFlags::HALFTRANS) {
+		alpha /= 2;
+	}
+	return alpha;
+}
+
+static SDL_BlendMode BlendModeForFlags(BlitFlags flags)
+{
+	if (flags & BlitFlags::ADD) {
+		return SDL_BLENDMODE_ADD;
+	} else if (flags & BlitFlags::MULTIPLY) {
+		return SDL_BLENDMODE_MOD;
+	} else if (flags & (BlitFlags::BLENDED | BlitFlags::HALFTRANS)) {
+		return SDL_BLENDMODE_BLEND;
+	}
+	return SDL_BLENDMODE_NONE;
+}
+
+// queues the blit if it can join the pending batch or start a new one
+bool SDL20VideoDriver::BatchCopy(SDL_Texture* texture, const Region& src, const Region& dst, BlitFlags flags, const SDL_Color* tint)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (!batching || (flags & BLIT_STENCIL_MASK)) {
+		return false;
+	}
+
+	SDL_Texture* target = CurrentRenderBuffer();
+	SDL_BlendMode blendMode = BlendModeForFlags(flags);
+	if (texture != batch.texture || target != batch.target || blendMode != batch.blendMode || screenClip != batch.clip) {
+		FlushBatch();
+		int w = 1;
+		int h = 1;
+		SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+		batch.texture = texture;
+		batch.target = target;
+		batch.blendMode = blendMode;
+		batch.clip = screenClip;
+		batch.texW = float(w);
+		batch.texH = float(h);
+	}
+
+	// the vertex colors do what the texture color and alpha mods do for SDL_RenderCopy
+	SDL_Color color = { 0xff, 0xff, 0xff, AlphaForFlags(flags, tint) };
+	if (flags & BlitFlags::COLOR_MOD) {
+		color.r = tint->r;
+		color.g = tint->g;
+		color.b = tint->b;
+	}
+
+	float u0 = src.x / batch.texW;
+	float u1 = (src.x + src.w) / batch.texW;
+	float v0 = src.y / batch.texH;
+	float v1 = (src.y + src.h) / batch.texH;
+	if (flags & BlitFlags::MIRRORX) {
+		std::swap(u0, u1);
+	}
+	if (flags & BlitFlags::MIRRORY) {
+		std::swap(v0, v1);
+	}
+
+	float x0 = float(dst.x);
+	float x1 = float(dst.x + dst.w);
+	float y0 = float(dst.y);
+	float y1 = float(dst.y + dst.h);
+
+	int base = int(batch.vertices.size());
+	batch.vertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+	batch.vertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+	batch.vertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+	batch.vertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+	for (int idx : { 0, 1, 2, 0, 2, 3 }) {
+		batch.indices.push_back(base + idx);
+	}
+	return true;
+#else
+	(void) texture; (void) src; (void) dst; (void) flags; (void) tint;
+	return false;
+#endif
+}
+
+void SDL20VideoDriver::FlushBatch()
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (batch.vertices.empty()) {
+		return;
+	}
+
+	SDL_SetRenderTarget(renderer, batch.target);
+	SetRenderClip(batch.clip);
+	SDL_SetTextureBlendMode(batch.texture, batch.blendMode);
+	SDL_SetTextureColorMod(batch.texture, 0xff, 0xff, 0xff);
+	SDL_SetTextureAlphaMod(batch.texture, SDL_ALPHA_OPAQUE);
+	int ret = SDL_RenderGeometry(renderer, batch.texture, batch.vertices.data(), int(batch.vertices.size()),
+								 batch.indices.data(), int(batch.indices.size()));
+	if (ret != 0) {
+		Log(ERROR, "SDLVideo", "{}", SDL_GetError());
+	}
+
+	frameStats.drawCalls++;
+	frameStats.batchedBlits += uint32_t(batch.vertices.size() / 4);
+	batch.vertices.clear();
+	batch.indices.clear();
+#endif
+}
+
 void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, const Region& src, const Region& dst, BlitFlags flags, const SDL_Color* tint)
 {
 	BlitFlags version = BlitFlags::NONE;
@@ -310,14 +451,29 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, co
 		flags &= ~spr->RenderWithFlags(version);
 	}
 
-	SDL_Texture* tex = spr->GetTexture(renderer);
-	BlitSpriteNativeClipped(tex, src, dst, flags, tint);
+	if (spr->IsTextureStale()) {
+		// pending blits may still use the old pixels or the reused atlas cell
+		FlushBatch();
+		frameStats.uploads++;
+	}
+	SDL_Rect area;
+	SDL_Texture* tex = spr->GetTexture(renderer, atlas, area);
+	Region texSrc = src;
+	texSrc.x += area.x;
+	texSrc.y += area.y;
+
+	if (spr->InAtlas() && BatchCopy(tex, texSrc, dst, flags, tint)) {
+		frameStats.blits++;
+		return;
+	}
+	BlitSpriteNativeClipped(tex, texSrc, dst, flags, tint);
 }
 
 void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Region& srgn, const Region& drgn, BlitFlags flags, const SDL_Color* tint)
 {
 	SDL_Rect srect = RectFromRegion(srgn);
 	SDL_Rect drect = RectFromRegion(drgn);
+	frameStats.blits++;
 	
 	int ret = 0;
 	if (flags&BLIT_STENCIL_MASK) {
@@ -325,11 +481,13 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		// 2. blend stencil segment to scratchpad
 		// 3. blend texture to scratchpad
 		// 4. copy scratchpad segment to screen
+		FlushBatch();
 
 #if USE_OPENGL_BACKEND
 		RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
 #if SDL_VERSION_ATLEAST(2, 0, 10)
 		SDL_RenderFlush(renderer);
+		frameStats.flushes++;
 #endif
 #else
 		std::static_pointer_cast<SDLTextureVideoBuffer>(scratchBuffer)->Clear(drect); // sets the render target to the scratch buffer
@@ -342,22 +500,16 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		stencilRect.x -= stencilBuffer->Origin().x;
 		stencilRect.y -= stencilBuffer->Origin().y;
 		SDL_RenderCopy(renderer, stencilTex, &stencilRect, &drect);
+		frameStats.drawCalls++;
 #endif
 
 		if (flags & (BlitFlags::ALPHA_MOD | BlitFlags::HALFTRANS)) {
-			Uint8 alpha = SDL_ALPHA_OPAQUE;
-			if (flags & BlitFlags::ALPHA_MOD) {
-				alpha = tint->a;
-			}
-			
-			if (flags & BlitFlags::HALFTRANS) {
-				alpha /= 2;
-			}
-			SDL_SetTextureAlphaMod(ScratchBuffer(), alpha);
+			SDL_SetTextureAlphaMod(ScratchBuffer(), AlphaForFlags(flags, tint));
 		}
 		SDL_SetRenderTarget(renderer, CurrentRenderBuffer());
 		SDL_SetTextureBlendMode(ScratchBuffer(), SDL_BLENDMODE_BLEND);
 		ret = SDL_RenderCopy(renderer, ScratchBuffer(), &drect, &drect);
+		frameStats.drawCalls++;
 	} else {
 		UpdateRenderTarget();
 		ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
@@ -383,48 +535,58 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 									   const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* tint)
 {
 #if USE_OPENGL_BACKEND
-#if SDL_VERSION_ATLEAST(2, 0, 10)
-	SDL_RenderFlush(renderer);
-#endif
-
 	uint32_t format = 0;
 	SDL_QueryTexture(texture, &format, nullptr, nullptr, nullptr);
-	blitRGBAShader->Use();
-	
-	blitRGBAShader->SetUniformValue("s_sprite", 1, 0);
-	blitRGBAShader->SetUniformValue("s_stencil", 1, 1);
-	
-	bool isRGBA = SDL_ISPIXELFORMAT_ALPHA(format);
-	blitRGBAShader->SetUniformValue("u_rgba", 1, isRGBA ? 1 : 0);
 
-	GLint greyMode = 0;
+	ShaderState state;
+	state.rgba = SDL_ISPIXELFORMAT_ALPHA(format) ? 1 : 0;
+	state.greyMode = 0;
 	if (flags & BlitFlags::GREY) {
-		greyMode = 1;
+		state.greyMode = 1;
 	} else if (flags & BlitFlags::SEPIA) {
-		greyMode = 2;
+		state.greyMode = 2;
 	}
 
-	blitRGBAShader->SetUniformValue("u_greyMode", 1, greyMode);
-
-	GLint channel = 3;
+	state.channel = 3;
 	if (flags & BlitFlags::STENCIL_RED) {
-		channel = 0;
+		state.channel = 0;
 	} else if (flags & BlitFlags::STENCIL_GREEN) {
-		channel = 1;
+		state.channel = 1;
 	} else if (flags & BlitFlags::STENCIL_BLUE) {
-		channel = 2;
+		state.channel = 2;
 	}
 
-	blitRGBAShader->SetUniformValue("u_channel", 1, channel);
-
 	bool doStencil = flags & BLIT_STENCIL_MASK;
-	blitRGBAShader->SetUniformValue("u_stencil", 1, doStencil ? 1 : 0);
+	state.stencil = doStencil ? 1 : 0;
+	state.dither = (flags & BlitFlags::STENCIL_DITHER) ? 1 : 0;
+	if (!doStencil && shaderState.channel >= 0) {
+		// unused without a stencil, so whatever is set is fine
+		state.channel = shaderState.channel;
+		state.dither = shaderState.dither;
+	}
+
+	// the queued draws have to be done with the old uniforms, but if nothing changes
+	// SDL is free to keep batching them; the stencil matrix depends on the destination
+	if (doStencil || !(state == shaderState)) {
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+		SDL_RenderFlush(renderer);
+		frameStats.flushes++;
+#endif
+
+		blitRGBAShader->Use();
+		blitRGBAShader->SetUniformValue("s_sprite", 1, 0);
+		blitRGBAShader->SetUniformValue("s_stencil", 1, 1);
+		blitRGBAShader->SetUniformValue("u_rgba", 1, state.rgba);
+		blitRGBAShader->SetUniformValue("u_greyMode", 1, state.greyMode);
+		blitRGBAShader->SetUniformValue("u_channel", 1, state.channel);
+		blitRGBAShader->SetUniformValue("u_stencil", 1, state.stencil);
+		shaderState = state;
+	}
 
 	if (doStencil) {
 		assert(stencilBuffer && dstrect);
 
-		bool doDither = flags & BlitFlags::STENCIL_DITHER;
-		blitRGBAShader->SetUniformValue("u_dither", 1, doDither ? 1 : 0);
+		blitRGBAShader->SetUniformValue("u_dither", 1, state.dither);
 
 		int texW = 0, texH = 0;
 		SDL_QueryTexture(CurrentStencilBuffer(), nullptr, nullptr, &texW, &texH);
@@ -477,16 +639,7 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 	}
 #endif
 	
-	Uint8 alpha = SDL_ALPHA_OPAQUE;
-	if (flags & BlitFlags::ALPHA_MOD) {
-		alpha = tint->a;
-	}
-	
-	if (flags & BlitFlags::HALFTRANS) {
-		alpha /= 2;
-	}
-	
-	SDL_SetTextureAlphaMod(texture, alpha);
+	SDL_SetTextureAlphaMod(texture, AlphaForFlags(flags, tint));
 
 	if (flags & BlitFlags::COLOR_MOD) {
 		SDL_SetTextureColorMod(texture, tint->r, tint->g, tint->b);
@@ -494,19 +647,12 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 		SDL_SetTextureColorMod(texture, 0xff, 0xff, 0xff);
 	}
 	
-	if (flags & BlitFlags::ADD) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
-	} else if (flags & BlitFlags::MULTIPLY) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_MOD);
-	} else if (flags & (BlitFlags::BLENDED | BlitFlags::HALFTRANS)) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
-	} else {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
-	}
+	SDL_SetTextureBlendMode(texture, BlendModeForFlags(flags));
 
 	SDL_RendererFlip flipflags = (flags & BlitFlags::MIRRORY) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
 	flipflags = static_cast<SDL_RendererFlip>(flipflags | ((flags & BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
 
+	frameStats.drawCalls++;
 	return SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, flipflags);
 }
 
@@ -522,12 +668,14 @@ void SDL20VideoDriver::DrawSDLPoints(const std::vector<SDL_Point>& points, const
 	}
 	UpdateRenderTarget(reinterpret_cast<const Color*>(&color), flags);
 	SDL_RenderDrawPoints(renderer, &points[0], int(points.size()));
+	frameStats.drawCalls++;
 }
 
 void SDL20VideoDriver::DrawPointImp(const Point& p, const Color& color, BlitFlags flags)
 {
 	UpdateRenderTarget(&color, flags);
 	SDL_RenderDrawPoint(renderer, p.x, p.y);
+	frameStats.drawCalls++;
 }
 
 void SDL20VideoDriver::DrawLinesImp(const std::vector<Point>& points, const Color& color, BlitFlags flags)
@@ -539,12 +687,14 @@ void SDL20VideoDriver::DrawSDLLines(const std::vector<SDL_Point>& points, const
 {
 	UpdateRenderTarget(reinterpret_cast<const Color*>(&color), flags);
 	SDL_RenderDrawLines(renderer, &points[0], int(points.size()));
+	frameStats.drawCalls++;
 }
 
 void SDL20VideoDriver::DrawLineImp(const Point& p1, const Point& p2, const Color& color, BlitFlags flags)
 {
 	UpdateRenderTarget(&color, flags);
 	SDL_RenderDrawLine(renderer, p1.x, p1.y, p2.x, p2.y);
+	frameStats.drawCalls++;
 }
 
 void SDL20VideoDriver::DrawRectImp(const Region& rgn, const Color& color, bool fill, BlitFlags flags)
@@ -555,6 +705,7 @@ void SDL20VideoDriver::DrawRectImp(const Region& rgn, const Color& color, bool f
 	} else {
 		SDL_RenderDrawRect(renderer, reinterpret_cast<const SDL_Rect*>(&rgn));
 	}
+	frameStats.drawCalls++;
 }
 
 void SDL20VideoDriver::DrawPolygonImp(const Gem_Polygon* poly, const Point& origin, const Color& color, bool fill, BlitFlags flags)
@@ -572,6 +723,7 @@ void SDL20VideoDriver::DrawPolygonImp(const Gem_Polygon* poly, const Point& orig
 				Point p2(segment.second + origin);
 				SDL_RenderDrawLine(renderer, p1.x, p1.y, p2.x, p2.y);
 			}
+			frameStats.drawCalls += uint32_t(lineSegments.size());
 		}
 	} else {
 		std::vector<SDL_Point> points(poly->Count() + 1);
@@ -591,6 +743,7 @@ void SDL20VideoDriver::DrawPolygonImp(const Gem_Polygon* poly, const Point& orig
 
 Holder<Sprite2D> SDL20VideoDriver::GetScreenshot(Region r, const VideoBufferPtr& buf)
 {
+	FlushBatch();
 	SDL_Rect rect = RectFromRegion(r);
 
 	unsigned int Width = r.w ? r.w : screenSize.w;
@@ -23,6 +23,9 @@
 
 #include "SDLVideo.h"
 #include "SDLSurfaceSprite2D.h"
+#include "SDLTextureAtlas.h"
+
+#include <functional>
 
 #if USE_OPENGL_BACKEND
 #include "GLSLProgram.h"
@@ -76,6 +79,13 @@ class SDLTextureVideoBuffer : public VideoBuffer {
 	// this is also used for rendering stencils
 	SDL_Surface* conversionBuffer = nullptr;
 
+	// called before the texture changes, so pending draws still see the old contents
+	std::function<void()> flushHook;
+
+	void Flush() const {
+		if (flushHook) flushHook();
+	}
+
 private:
 	static Region TextureRegion(SDL_Texture* tex, const Point& p) {
 		int w, h;
@@ -101,11 +111,17 @@ public:
 	}
 
 	~SDLTextureVideoBuffer() override {
+		Flush();
 		SDL_DestroyTexture(texture);
 		SDL_FreeSurface(conversionBuffer);
 	}
 
+	void SetFlushHook(std::function<void()> hook) {
+		flushHook = std::move(hook);
+	}
+
 	void Clear() override {
+		Flush();
 		SDL_SetRenderTarget(renderer, texture);
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
 #if SDL_COMPILEDVERSION == SDL_VERSIONNUM(2, 0, 10)
@@ -120,6 +136,7 @@ public:
 	}
 	
 	void Clear(const SDL_Rect& rgn) {
+		Flush();
 		SDL_SetRenderTarget(renderer, texture);
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
 		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
@@ -144,6 +161,7 @@ public:
 	void CopyPixels(const Region& bufDest, const void* pixelBuf, const int* pitch = NULL, ...) override {
 		int sdlpitch = bufDest.w * SDL_BYTESPERPIXEL(nativeFormat);
 		SDL_Rect dest = RectFromRegion(bufDest);
+		Flush();
 
 		if (nativeFormat == SDL_PIXELFORMAT_YV12) {
 			va_list args;
@@ -219,6 +237,40 @@ private:
 	SDL_GameController* gameController = nullptr;
 
 	GLSLProgram* blitRGBAShader = nullptr;
+#if USE_OPENGL_BACKEND
+	// the uniforms last set on blitRGBAShader, changing them requires a flush
+	struct ShaderState {
+		GLint rgba = -1;
+		GLint greyMode = -1;
+		GLint channel = -1;
+		GLint stencil = -1;
+		GLint dither = -1;
+
+		bool operator==(const ShaderState& other) const {
+			return rgba == other.rgba && greyMode == other.greyMode && channel == other.channel
+				&& stencil == other.stencil && dither == other.dither;
+		}
+	};
+	ShaderState shaderState;
+#endif
+
+	std::shared_ptr<SDLTextureAtlas> atlas;
+	bool batching = false;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	// consecutive atlas blits sharing all their state, drawn with a single SDL_RenderGeometry
+	struct SpriteBatch {
+		SDL_Texture* target = nullptr;
+		SDL_Texture* texture = nullptr;
+		SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+		Region clip;
+		float texW = 1.0f;
+		float texH = 1.0f;
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;
+	};
+	SpriteBatch batch;
+#endif
+
 public:
 	SDL20VideoDriver() noexcept;
 	~SDL20VideoDriver() noexcept override;
@@ -255,6 +307,10 @@ private:
 
 	void BeginCustomRendering(SDL_Texture*);
 	int UpdateRenderTarget(const Color* color = NULL, BlitFlags flags = BlitFlags::NONE);
+	void SetRenderClip(const Region& clip);
+
+	bool BatchCopy(SDL_Texture*, const Region& src, const Region& dst, BlitFlags flags, const SDL_Color* tint);
+	void FlushBatch();
 
 	void DrawSDLPoints(const std::vector<SDL_Point>& points, const SDL_Color& color, BlitFlags flags = BlitFlags::NONE) override;
 	void DrawSDLLines(const std::vector<SDL_Point>& points, const SDL_Color& color, BlitFlags flags = BlitFlags::NONE);
@@ -18,6 +18,8 @@
  *
  */
 
+#include "Video/PixelKernels.h"
+
 using namespace GemRB;
 
 template<bool PALALPHA>
@@ -25,6 +27,17 @@ struct SRTinter_NoTint {
 	void operator()(Uint8&, Uint8&, Uint8&, Uint8& a, unsigned int) const {
 		if (!PALALPHA) a = 255;
 	}
+
+	// what TintPalette depends on besides the flags, for caching its results
+	Color TintKey() const { return Color(); }
+
+	void TintPalette(uint32_t* pal, int n, const PixelKernels& kernels, const PixelLayout& layout, unsigned int) const {
+		if (PALALPHA) return;
+		ScaleParams params;
+		params.keep = layout.ColorMask();
+		params.Fill(layout.aShift, 255);
+		kernels.Scale(pal, n, params);
+	}
 };
 
 template<bool PALALPHA, bool TINTALPHA>
@@ -40,6 +53,20 @@ struct SRTinter_Tint {
 		if (TINTALPHA && !PALALPHA) a = tint.a;
 		if (!TINTALPHA && !PALALPHA) a = 255;
 	}
+
+	// what TintPalette depends on besides the flags, for caching its results
+	Color TintKey() const { return tint; }
+
+	void TintPalette(uint32_t* pal, int n, const PixelKernels& kernels, const PixelLayout& layout, unsigned int) const {
+		ScaleParams params;
+		params.ScaleColor(layout, tint, 8);
+		if (TINTALPHA && PALALPHA) params.Scale(layout.aShift, tint.a, 8);
+		if (!TINTALPHA && PALALPHA) params.Keep(layout.aShift);
+		if (TINTALPHA && !PALALPHA) params.Fill(layout.aShift, tint.a);
+		if (!TINTALPHA && !PALALPHA) params.Fill(layout.aShift, 255);
+		kernels.Scale(pal, n, params);
+	}
+
 	Color tint;
 };
 
@@ -75,6 +102,26 @@ struct SRTinter_Flags {
 			a = (tint.a * a) >> 8;
 	}
 
+	// what TintPalette depends on besides the flags, for caching its results
+	Color TintKey() const { return tint; }
+
+	void TintPalette(uint32_t* pal, int n, const PixelKernels& kernels, const PixelLayout& layout, unsigned int flags) const {
+		ScaleParams params;
+		params.ScaleColor(layout, tint, (flags & (BlitFlags::GREY | BlitFlags::SEPIA)) ? 10 : 8);
+		if (PALALPHA) {
+			params.Scale(layout.aShift, tint.a, 8);
+		} else {
+			params.Fill(layout.aShift, tint.a);
+		}
+		kernels.Scale(pal, n, params);
+
+		if (flags & BlitFlags::GREY) {
+			kernels.Desaturate(pal, n, DesaturateParams::Greyscale(layout));
+		} else if (flags & BlitFlags::SEPIA) {
+			kernels.Desaturate(pal, n, DesaturateParams::Sepia(layout));
+		}
+	}
+
 	Color tint;
 };
 
@@ -102,6 +149,33 @@ struct SRTinter_FlagsNoTint {
 
 		if (!PALALPHA) a = 255;
 	}
+
+	// what TintPalette depends on besides the flags, for caching its results
+	Color TintKey() const { return Color(); }
+
+	void TintPalette(uint32_t* pal, int n, const PixelKernels& kernels, const PixelLayout& layout, unsigned int flags) const {
+		ScaleParams params;
+		if (flags & (BlitFlags::GREY | BlitFlags::SEPIA)) {
+			// the >> 2 of the untinted shaders
+			params.Scale(layout.rShift, 256, 10);
+			params.Scale(layout.gShift, 256, 10);
+			params.Scale(layout.bShift, 256, 10);
+		} else {
+			params.keep = layout.ColorMask();
+		}
+		if (PALALPHA) {
+			params.Keep(layout.aShift);
+		} else {
+			params.Fill(layout.aShift, 255);
+		}
+		kernels.Scale(pal, n, params);
+
+		if (flags & BlitFlags::GREY) {
+			kernels.Desaturate(pal, n, DesaturateParams::Greyscale(layout));
+		} else if (flags & BlitFlags::SEPIA) {
+			kernels.Desaturate(pal, n, DesaturateParams::Sepia(layout));
+		}
+	}
 };
 
 
@@ -193,6 +267,11 @@ void SRBlender<Uint32, SRBlender_Alpha>::operator()(Uint32& pix, Uint8 r, Uint8
 	pix = (r << fmt.Rshift) | (g << fmt.Gshift) | (b << fmt.Bshift);
 }
 
+// the row kernel doing the same as the blender, if there is one
+inline PixelKernels::BlendRow RowBlender(const PixelKernels&, SRBlender_NoAlpha) { return nullptr; }
+inline PixelKernels::BlendRow RowBlender(const PixelKernels& kernels, SRBlender_HalfAlpha) { return kernels.BlendHalf; }
+inline PixelKernels::BlendRow RowBlender(const PixelKernels& kernels, SRBlender_Alpha) { return kernels.BlendAlpha; }
+
 // these always change together
 #define ADVANCE_ITERATORS(count) dest.Advance(count); cover.Advance(count);
 
@@ -329,6 +408,136 @@ static void BlitSpriteRLE_Partial(const Uint8* rledata, const int pitch, const R
 	}
 }
 
+// the last few packed and tinted palettes, since most blits reuse one
+struct RLEPaletteCache {
+	static constexpr int SIZE = 8;
+	struct Entry {
+		PaletteHolder pal; // held, so the address can't be reused by another palette
+		unsigned short version = 0;
+		Color tint;
+		unsigned int flags = 0;
+		uint32_t layout = 0;
+		uint32_t packed[256];
+	};
+	Entry entries[SIZE];
+	int next = 0;
+
+	template<typename Tinter>
+	const uint32_t* Get(const PaletteHolder& pal, const Tinter& tint, unsigned int flags,
+						const PixelKernels& kernels, const PixelLayout& layout)
+	{
+		// only greying and sepia change the tinted colors
+		flags &= BlitFlags::GREY | BlitFlags::SEPIA;
+		uint32_t layoutKey = layout.rShift | (layout.gShift << 8) | (layout.bShift << 16) | (uint32_t(layout.aShift) << 24);
+		const Color tintKey = tint.TintKey();
+		for (const Entry& e : entries) {
+			if (e.pal == pal && e.version == pal->GetVersion() && e.tint == tintKey
+				&& e.flags == flags && e.layout == layoutKey) {
+				return e.packed;
+			}
+		}
+
+		Entry& e = entries[next];
+		next = (next + 1) % SIZE;
+		e.pal = pal;
+		e.version = pal->GetVersion();
+		e.tint = tintKey;
+		e.flags = flags;
+		e.layout = layoutKey;
+		for (int i = 0; i < 256; ++i) {
+			e.packed[i] = layout.Pack(pal->col[i]);
+		}
+		tint.TintPalette(e.packed, 256, kernels, layout, flags);
+		return e.packed;
+	}
+};
+
+// 32bpp with a byte per channel: the tinter is applied once to the palette,
+// then each destination row is expanded, masked and blended by the row kernels
+template<typename Tinter>
+static void BlitSpriteRLE_Rows(const Uint8* rledata, const int pitch, const Region& srect,
+							   const PaletteHolder& pal, Uint8 transindex,
+							   SDLPixelIterator& dest, IAlphaIterator& cover,
+							   BlitFlags flags, const Tinter& tint,
+							   const PixelLayout& layout, PixelKernels::BlendRow blend)
+{
+	const PixelKernels& kernels = PixelKernels::Get();
+
+	// one cache per tinter type; the scratch rows only ever grow
+	static thread_local RLEPaletteCache paletteCache;
+	static thread_local std::vector<Uint8> indices;
+	static thread_local std::vector<Uint8> stencil;
+	static thread_local std::vector<uint32_t> row;
+	const uint32_t* palette = paletteCache.Get(pal, tint, flags, kernels, layout);
+	if (indices.size() < size_t(pitch)) indices.resize(pitch);
+	if (stencil.size() < size_t(srect.w)) stencil.resize(srect.w);
+	if (row.size() < size_t(srect.w)) row.resize(srect.w);
+	const BlendParams params(layout, dest.format.Amask);
+	const StaticAlphaIterator* fixedCover = dynamic_cast<const StaticAlphaIterator*>(&cover);
+
+	int count = srect.y * pitch;
+	while (count > 0) {
+		Uint8 p = *rledata++;
+		if (p == transindex) {
+			count -= (*rledata++) + 1;
+		} else {
+			--count;
+		}
+	}
+
+	int transQueue = -count;
+	for (int y = 0; y < srect.h; ++y) {
+		// transparent runs can continue on the next row
+		for (int x = 0; x < pitch;) {
+			if (transQueue > 0) {
+				int run = std::min(transQueue, pitch - x);
+				memset(&indices[x], transindex, run);
+				transQueue -= run;
+				x += run;
+				continue;
+			}
+
+			Uint8 p = *rledata++;
+			if (p == transindex) {
+				transQueue = (*rledata++) + 1;
+			} else {
+				indices[x++] = p;
+			}
+		}
+
+		const Uint8* src = &indices[srect.x];
+		kernels.Expand(src, palette, row.data(), srect.w);
+
+		const Point pos = dest.Position();
+		for (int i = 0; i < srect.w; ++i) {
+			Uint8 maskval;
+			if (fixedCover) {
+				maskval = fixedCover->alpha;
+			} else {
+				maskval = *cover;
+				cover.Advance(1);
+			}
+
+			if (src[i] == transindex) {
+				maskval = 0xff;
+			} else if ((flags & BlitFlags::STENCIL_DITHER) && maskval == 128) {
+				int x = pos.x + i * dest.xdir;
+				maskval = ((x + pos.y) % 2) ? 0xC0 : 0x80;
+			}
+			stencil[i] = maskval;
+		}
+
+		uint32_t* dst = reinterpret_cast<uint32_t*>(&*dest);
+		if (dest.xdir == IPixelIterator::Reverse) {
+			dst -= srect.w - 1;
+			std::reverse(row.begin(), row.begin() + srect.w);
+			std::reverse(stencil.begin(), stencil.begin() + srect.w);
+		}
+		blend(dst, row.data(), stencil.data(), srect.w, params);
+		dest.Advance(srect.w);
+	}
+}
+
 template<typename Blender, typename Tinter>
 static void BlitSpriteRLE(Holder<Sprite2D> spr, const Region& srect,
 						  SDL_Surface* dst, const Region& drect,
@@ -362,6 +571,13 @@ static void BlitSpriteRLE(Holder<Sprite2D> spr, const Region& srect,
 	switch (dstit.format.Bpp) {
 		case 4:
 		{
+			PixelLayout layout;
+			PixelKernels::BlendRow rowBlend = RowBlender(PixelKernels::Get(), Blender());
+			if (rowBlend && drect.size == srect.size && PixelLayout::FromFormat(dstit.format, layout)) {
+				BlitSpriteRLE_Rows(rledata, spr->Frame.w, srect, palette, ck, dstit, *cover, flags, tint, layout, rowBlend);
+				break;
+			}
+
 			SRBlender<Uint32, Blender> blend(dstit.format);
 			if (partial) {
 				BlitSpriteRLE_Partial<Uint32>(rledata, spr->Frame.w, srect, palette->col, ck, dstit, *cover, flags, tint, blend);
@@ -290,6 +290,9 @@ SDLTextureSprite2D::SDLTextureSprite2D(const Region& rgn, const PixelFormat& fmt
 SDLTextureSprite2D::~SDLTextureSprite2D() noexcept
 {
 	SDL_DestroyTexture(texture);
+	if (atlas) {
+		atlas->Free(slot);
+	}
 }
 
 SDLTextureSprite2D::SDLTextureSprite2D(const SDLTextureSprite2D& other) noexcept
@@ -322,6 +325,31 @@ SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer) const
 	return texture;
 }
 
+SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer, const std::shared_ptr<SDLTextureAtlas>& sharedAtlas, SDL_Rect& area) const
+{
+	if (!slot && !texture && sharedAtlas) {
+		slot = sharedAtlas->Allocate(Frame.w, Frame.h);
+		if (slot) {
+			atlas = sharedAtlas;
+			staleTexture = true;
+		}
+	}
+
+	if (!slot) {
+		area = { 0, 0, Frame.w, Frame.h };
+		return GetTexture(renderer);
+	}
+
+	if (staleTexture) {
+		if (!atlas->Upload(slot, GetSurface())) {
+			Log(ERROR, "SDLTextureSprite2D", "Atlas upload failed: {}", SDL_GetError());
+		}
+		staleTexture = false;
+	}
+	area = slot.area;
+	return slot.page;
+}
+
 void SDLTextureSprite2D::Invalidate() const noexcept
 {
 	staleTexture = true;
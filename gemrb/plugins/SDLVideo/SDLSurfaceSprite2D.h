@@ -26,6 +26,12 @@
 
 #include <SDL.h>
 
+#if SDL_VERSION_ATLEAST(1,3,0)
+#include "SDLTextureAtlas.h"
+
+#include <memory>
+#endif
+
 namespace GemRB {
 
 class SDLSurfaceSprite2D : public Sprite2D {
@@ -81,6 +87,8 @@ class SDLTextureSprite2D : public SDLSurfaceSprite2D {
 	mutable Uint32 texFormat = SDL_PIXELFORMAT_UNKNOWN;
 	mutable SDL_Texture* texture = nullptr;
 	mutable bool staleTexture = false;
+	mutable std::shared_ptr<SDLTextureAtlas> atlas;
+	mutable SDLTextureAtlas::Slot slot;
 	
 	void Invalidate() const noexcept override;
 public:
@@ -92,6 +100,12 @@ public:
 	Holder<Sprite2D> copy() const override;
 	
 	SDL_Texture* GetTexture(SDL_Renderer* renderer) const;
+	// the texture to draw and the area of it holding the sprite
+	// small sprites go into the atlas, if there is one and it has room
+	SDL_Texture* GetTexture(SDL_Renderer* renderer, const std::shared_ptr<SDLTextureAtlas>& sharedAtlas, SDL_Rect& area) const;
+	// whether the next GetTexture has to upload the pixels
+	bool IsTextureStale() const noexcept { return staleTexture || (!texture && !slot); }
+	bool InAtlas() const noexcept { return bool(slot); }
 };
 #endif
 
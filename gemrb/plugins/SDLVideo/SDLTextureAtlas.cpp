@@ -0,0 +1,158 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLTextureAtlas.h"
+
+#include "globals.h"
+#include "Logging/Logging.h"
+
+namespace GemRB {
+
+static const int CellStride = SDLTextureAtlas::CellSize + 2 * SDLTextureAtlas::Gutter;
+static const int CellsPerRow = SDLTextureAtlas::PageSize / CellStride;
+static const size_t CellsPerPage = CellsPerRow * CellsPerRow;
+static const Uint32 PageFormat = SDL_PIXELFORMAT_ARGB8888;
+
+SDLTextureAtlas::SDLTextureAtlas(SDL_Renderer* renderer) noexcept
+: renderer(renderer)
+{}
+
+SDLTextureAtlas::~SDLTextureAtlas() noexcept
+{
+	Release();
+}
+
+// returns the index of the new page or pages.size() if there is none
+size_t SDLTextureAtlas::AddPage()
+{
+	// released pages keep their place, since slots refer to pages by index
+	size_t idx = 0;
+	while (idx < pages.size() && pages[idx].texture) {
+		++idx;
+	}
+	if (disabled || idx == MaxPages) {
+		return pages.size();
+	}
+
+	SDL_Texture* texture = SDL_CreateTexture(renderer, PageFormat, SDL_TEXTUREACCESS_STATIC, PageSize, PageSize);
+	if (!texture) {
+		// every sprite just keeps its own texture then
+		Log(WARNING, "SDLTextureAtlas", "Disabled, cannot create a page: {}", SDL_GetError());
+		disabled = true;
+		return pages.size();
+	}
+
+	if (idx == pages.size()) {
+		pages.emplace_back();
+	}
+	Page& page = pages[idx];
+	page.texture = texture;
+	page.freeCells.clear();
+	page.freeCells.reserve(CellsPerPage);
+	// handed out from the back, so the first cells go first
+	for (int cell = int(CellsPerPage) - 1; cell >= 0; --cell) {
+		page.freeCells.push_back(uint16_t(cell));
+	}
+	return idx;
+}
+
+SDLTextureAtlas::Slot SDLTextureAtlas::Allocate(int w, int h)
+{
+	Slot slot;
+	if (!Fits(w, h)) {
+		return slot;
+	}
+
+	size_t idx = 0;
+	while (idx < pages.size() && (!pages[idx].texture || pages[idx].freeCells.empty())) {
+		++idx;
+	}
+	if (idx == pages.size()) {
+		idx = AddPage();
+		if (idx == pages.size()) {
+			return slot;
+		}
+	}
+
+	Page& page = pages[idx];
+	slot.page = page.texture;
+	slot.pageIdx = idx;
+	slot.cell = page.freeCells.back();
+	page.freeCells.pop_back();
+	slot.area = { (slot.cell % CellsPerRow) * CellStride + Gutter, (slot.cell / CellsPerRow) * CellStride + Gutter, w, h };
+	return slot;
+}
+
+void SDLTextureAtlas::Free(const Slot& slot) noexcept
+{
+	// the pages are already gone if the renderer was destroyed first
+	if (!slot || slot.pageIdx >= pages.size() || pages[slot.pageIdx].texture != slot.page) {
+		return;
+	}
+	pages[slot.pageIdx].freeCells.push_back(slot.cell);
+}
+
+bool SDLTextureAtlas::Upload(const Slot& slot, SDL_Surface* surface) const
+{
+	// this also turns a color key into alpha
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, PageFormat, 0);
+	if (!converted) {
+		return false;
+	}
+
+	// the sprite with its edges repeated into the gutter around it
+	const SDL_Rect& area = slot.area;
+	int w = area.w + 2 * Gutter;
+	int h = area.h + 2 * Gutter;
+	std::vector<Uint32> padded(w * h);
+	for (int y = 0; y < h; ++y) {
+		int srcY = Clamp(y - Gutter, 0, area.h - 1);
+		const Uint32* src = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(converted->pixels) + srcY * converted->pitch);
+		Uint32* dst = &padded[y * w];
+		for (int x = 0; x < w; ++x) {
+			dst[x] = src[Clamp(x - Gutter, 0, area.w - 1)];
+		}
+	}
+	SDL_FreeSurface(converted);
+
+	SDL_Rect cell = { area.x - Gutter, area.y - Gutter, w, h };
+	return SDL_UpdateTexture(slot.page, &cell, padded.data(), w * sizeof(Uint32)) == 0;
+}
+
+void SDLTextureAtlas::ReleaseEmptyPages() noexcept
+{
+	for (Page& page : pages) {
+		if (page.texture && page.freeCells.size() == CellsPerPage) {
+			SDL_DestroyTexture(page.texture);
+			page.texture = nullptr;
+		}
+	}
+}
+
+void SDLTextureAtlas::Release() noexcept
+{
+	for (const Page& page : pages) {
+		SDL_DestroyTexture(page.texture);
+	}
+	pages.clear();
+	disabled = true;
+}
+
+}
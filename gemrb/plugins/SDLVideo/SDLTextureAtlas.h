@@ -0,0 +1,86 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2023 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef SDLTEXTUREATLAS_H
+#define SDLTEXTUREATLAS_H
+
+#include <SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GemRB {
+
+// shared textures for tiles and other small sprites, so consecutive blits of them
+// use the same texture and can be batched
+// every page is a grid of equal cells and each sprite takes a whole cell; the cells
+// have a gutter repeating the sprite's edge pixels, so scaled blits that sample a
+// little outside the sprite don't pick up the neighbouring cell
+class SDLTextureAtlas {
+public:
+	static const int CellSize = 64; // the size of area tiles
+	static const int Gutter = 1;
+	static const int PageSize = 1024;
+	static const size_t MaxPages = 16;
+
+	struct Slot {
+		SDL_Texture* page = nullptr;
+		SDL_Rect area {};
+		size_t pageIdx = 0;
+		uint16_t cell = 0;
+
+		explicit operator bool() const noexcept { return page != nullptr; }
+	};
+
+private:
+	struct Page {
+		SDL_Texture* texture = nullptr; // nullptr once released, for reuse
+		std::vector<uint16_t> freeCells;
+	};
+
+	SDL_Renderer* renderer;
+	std::vector<Page> pages;
+	bool disabled = false;
+
+	size_t AddPage();
+
+public:
+	explicit SDLTextureAtlas(SDL_Renderer* renderer) noexcept;
+	SDLTextureAtlas(const SDLTextureAtlas&) = delete;
+	~SDLTextureAtlas() noexcept;
+	SDLTextureAtlas& operator=(const SDLTextureAtlas&) = delete;
+
+	static bool Fits(int w, int h) noexcept { return w <= CellSize && h <= CellSize; }
+
+	// an empty slot if the sprite is too large or the atlas is full
+	Slot Allocate(int w, int h);
+	void Free(const Slot&) noexcept;
+	bool Upload(const Slot&, SDL_Surface*) const;
+	// destroys the pages nothing uses anymore, eg. the tiles of an unloaded area;
+	// called between frames, when no pending blit can refer to them
+	void ReleaseEmptyPages() noexcept;
+	// destroys the pages, called before the renderer goes away
+	void Release() noexcept;
+};
+
+}
+
+#endif // SDLTEXTUREATLAS_H
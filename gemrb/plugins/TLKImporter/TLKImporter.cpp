@@ -115,6 +115,20 @@ bool TLKImporter::Open(DataStream* stream)
 		Log(ERROR, "TLKImporter", "Too many strings ({}), increase OVERRIDE_START.", StrRefCount);
 		return false;
 	}
+
+	recentStrings.clear();
+	decodedStrings.clear();
+	entries.assign(StrRefCount, Entry());
+	for (Entry& entry : entries) {
+		ieDword volume, pitch;
+		str->ReadWord(entry.type);
+		str->ReadResRef(entry.sound);
+		// volume and pitch variance fields are known to be unused at minimum in bg1
+		str->ReadDword(volume);
+		str->ReadDword(pitch);
+		str->ReadDword(entry.offset);
+		str->ReadDword(entry.length);
+	}
 	return true;
 }
 
@@ -332,12 +346,44 @@ ieStrRef TLKImporter::UpdateString(ieStrRef strref, const String& newvalue)
 	return OverrideTLK->UpdateString(strref, newvalue);
 }
 
+const TLKImporter::DecodedString& TLKImporter::DecodeString(ieDword strref)
+{
+	auto cached = decodedStrings.find(strref);
+	if (cached != decodedStrings.end()) {
+		recentStrings.splice(recentStrings.begin(), recentStrings, cached->second.second);
+		return cached->second.first;
+	}
+
+	DecodedString decoded;
+	const Entry& entry = entries[strref];
+	if (entry.type & 1) {
+		str->Seek(entry.offset + Offset, GEM_STREAM_START);
+		std::string mbstr(entry.length, '\0');
+		str->Read(&mbstr[0], entry.length);
+		String* tmp = StringFromCString(mbstr.c_str());
+		std::swap(decoded.text, *tmp);
+		delete tmp;
+	}
+	decoded.plain = decoded.text.find_first_of(L"<%[") == String::npos;
+
+	if (decodedStrings.size() >= MAX_CACHED_STRINGS) {
+		decodedStrings.erase(recentStrings.back());
+		recentStrings.pop_back();
+	}
+	recentStrings.push_front(strref);
+	auto& slot = decodedStrings[strref];
+	slot.first = std::move(decoded);
+	slot.second = recentStrings.begin();
+	return slot.first;
+}
+
 String TLKImporter::GetString(ieStrRef strref, STRING_FLAGS flags)
 {
 	String string;
 	bool empty = !(flags & STRING_FLAGS::ALLOW_ZERO) && !strref;
 	ieWord type;
 	ResRef SoundResRef;
+	bool plain = false;
 
 	if (empty || strref >= ieStrRef::OVERRIDE_START || (strref >= ieStrRef::BIO_START && strref <= ieStrRef::BIO_END)) {
 		if (OverrideTLK) {
@@ -351,30 +397,18 @@ String TLKImporter::GetString(ieStrRef strref, STRING_FLAGS flags)
 		type = 0;
 		SoundResRef.Reset();
 	} else {
-		ieDword Volume, Pitch, StrOffset;
-		ieDword l;
-		if (str->Seek( 18 + (ieDword(strref) * 0x1A), GEM_STREAM_START ) == GEM_ERROR) {
+		if (ieDword(strref) >= entries.size()) {
 			return L"";
 		}
-		str->ReadWord(type);
-		str->ReadResRef( SoundResRef );
-		// volume and pitch variance fields are known to be unused at minimum in bg1
-		str->ReadDword(Volume);
-		str->ReadDword(Pitch);
-		str->ReadDword(StrOffset);
-		str->ReadDword(l);
-				
-		if (type & 1) {
-			str->Seek( StrOffset + Offset, GEM_STREAM_START );
-			std::string mbstr(l, '\0');
-			str->Read(&mbstr[0], l);
-			String* tmp = StringFromCString(mbstr.c_str());
-			std::swap(string, *tmp);
-			delete tmp;
-		}
+		const Entry& entry = entries[ieDword(strref)];
+		type = entry.type;
+		SoundResRef = entry.sound;
+		const DecodedString& decoded = DecodeString(ieDword(strref));
+		string = decoded.text;
+		plain = decoded.plain;
 	}
 
-	if (bool(flags & STRING_FLAGS::RESOLVE_TAGS) || (type & 4)) {
+	if ((bool(flags & STRING_FLAGS::RESOLVE_TAGS) || (type & 4)) && !plain) {
 		string = ResolveTags(string);
 	}
 	if (type & 2 && bool(flags & STRING_FLAGS::SOUND) && !SoundResRef.IsEmpty()) {
@@ -400,11 +434,10 @@ StringBlock TLKImporter::GetStringBlock(ieStrRef strref, STRING_FLAGS flags)
 	if (empty) {
 		return StringBlock();
 	}
-	ieWord type;
-	str->Seek( 18 + (ieDword(strref) * 0x1A), GEM_STREAM_START );
-	str->ReadWord(type);
 	ResRef soundRef;
-	str->ReadResRef( soundRef );
+	if (ieDword(strref) < entries.size()) {
+		soundRef = entries[ieDword(strref)].sound;
+	}
 	return StringBlock(GetString( strref, flags ), soundRef);
 }
 
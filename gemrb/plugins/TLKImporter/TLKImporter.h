@@ -26,6 +26,10 @@
 #include "Variables.h"
 #include "TlkOverride.h"
 
+#include <list>
+#include <unordered_map>
+#include <vector>
+
 namespace GemRB {
 
 class TLKImporter : public StringMgr {
@@ -40,6 +44,25 @@ private:
 	Variables gtmap;
 	int charname = 0;
 
+	// the entry table is read once on open
+	struct Entry {
+		ieWord type = 0;
+		ResRef sound;
+		ieDword offset = 0;
+		ieDword length = 0;
+	};
+	std::vector<Entry> entries;
+
+	// recently used strings, already decoded
+	struct DecodedString {
+		String text;
+		bool plain = false; // no tags, ResolveTags would return it unchanged
+	};
+	using LRUList = std::list<ieDword>;
+	static const size_t MAX_CACHED_STRINGS = 4096;
+	LRUList recentStrings;
+	std::unordered_map<ieDword, std::pair<DecodedString, LRUList::iterator>> decodedStrings;
+
 public:
 	TLKImporter(void);
 	~TLKImporter(void) override;
@@ -57,6 +80,7 @@ public:
 private:
 	/** resolves day and monthname tokens */
 	void GetMonthName(int dayandmonth);
+	const DecodedString& DecodeString(ieDword strref);
 	String ResolveTags(const String& source);
 	String BuiltinToken(const ieVariable& Token);
 	ieStrRef ClassStrRef(int slot) const;
@@ -0,0 +1,202 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Times the actor grid against the scans over the whole actor list that
+// Map did before, with a crowd of creatures spawned over a large area:
+//   gemrb_bench_actorgrid [-n actors] [-t ticks] <gemrb.cfg>
+// Every tick, each actor walks a step, looks for an actor under a point
+// (like GetActor) and gathers its neighbours (like GetAllActorsInRadius).
+
+#include "ActorGrid.h"
+#include "BenchmarkCore.h"
+
+#include "Scriptable/Actor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace GemRB;
+
+static const Size AREA_SIZE(5120, 3840); // one of the largest areas of the games
+static const int NEIGHBOUR_RADIUS = 15; // in feet, like the spell and bump checks
+
+template<typename F>
+static double Time(int rounds, F&& fn)
+{
+	using namespace std::chrono;
+	auto start = steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		fn();
+	}
+	return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+static void Report(const char* what, double oldMs, double newMs)
+{
+	fprintf(stdout, "%-28s old %9.2f ms   new %9.2f ms   x%.2f\n", what, oldMs, newMs, newMs > 0 ? oldMs / newMs : 0.0);
+}
+
+// the old Map::GetActor: the first actor in the list with its circle under the point
+static Actor* ScanPoint(const std::vector<Actor*>& actors, const Point& p)
+{
+	for (Actor* actor : actors) {
+		if (actor->IsOver(p)) return actor;
+	}
+	return nullptr;
+}
+
+static Actor* QueryPoint(const ActorGrid& grid, const Point& p)
+{
+	int csize = std::max(grid.MaxCircleSize(), 2) - 1;
+	Region rgn(p - Point(csize * 16, csize * 12), Size(csize * 32 + 1, csize * 24 + 1));
+	return grid.Query(rgn, [&](const Actor* actor) {
+		return actor->IsOver(p);
+	});
+}
+
+static size_t ScanRadius(const std::vector<Actor*>& actors, const Point& p, std::vector<Actor*>& found)
+{
+	found.clear();
+	for (Actor* actor : actors) {
+		if (WithinRange(actor, p, NEIGHBOUR_RADIUS)) found.push_back(actor);
+	}
+	return found.size();
+}
+
+static size_t QueryRadius(const ActorGrid& grid, const Point& p, std::vector<Actor*>& found)
+{
+	found.clear();
+	grid.QueryRadius(p, NEIGHBOUR_RADIUS * 16 + 1, [&](Actor* actor) {
+		if (WithinRange(actor, p, NEIGHBOUR_RADIUS)) found.push_back(actor);
+		return false;
+	});
+	return found.size();
+}
+
+int main(int argc, char** argv)
+{
+	int actorCount = 250;
+	int ticks = 100;
+	int argi = 1;
+	for (; argi + 1 < argc && argv[argi][0] == '-'; argi += 2) {
+		if (!strcmp(argv[argi], "-n")) {
+			actorCount = atoi(argv[argi + 1]);
+		} else if (!strcmp(argv[argi], "-t")) {
+			ticks = atoi(argv[argi + 1]);
+		}
+	}
+	if (argi >= argc || actorCount <= 0 || ticks <= 0) {
+		fprintf(stderr, "Usage: %s [-n actors] [-t ticks] <gemrb.cfg>\n", argv[0]);
+		return 1;
+	}
+	if (!Benchmark::BootCore(argv[argi])) {
+		fprintf(stderr, "The engine did not start with %s, run gemrb with it to see why\n", argv[argi]);
+		return 1;
+	}
+
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> xDist(0, AREA_SIZE.w - 1);
+	std::uniform_int_distribution<int> yDist(0, AREA_SIZE.h - 1);
+	std::uniform_int_distribution<int> sizeDist(1, 4);
+	std::uniform_int_distribution<int> stepDist(-3, 3);
+
+	ActorGrid grid;
+	grid.Reset(AREA_SIZE);
+	std::vector<Actor*> actors;
+	for (int i = 0; i < actorCount; ++i) {
+		Actor* actor = new Actor();
+		actor->SetPos(Point(xDist(rng), yDist(rng)));
+		actor->circleSize = sizeDist(rng);
+		actors.push_back(actor);
+		grid.Insert(actor);
+	}
+	fprintf(stdout, "%d actors on %dx%d, %d ticks\n", actorCount, AREA_SIZE.w, AREA_SIZE.h, ticks);
+
+	// the same probes for both, from around the actors like script and mouse checks
+	std::vector<Point> probes;
+	for (const Actor* actor : actors) {
+		probes.push_back(actor->Pos + Point(stepDist(rng) * 8, stepDist(rng) * 6));
+	}
+
+	// the sums keep the lookups from being optimized away and check the results
+	std::vector<Actor*> found;
+	size_t oldHits = 0;
+	size_t newHits = 0;
+	double oldMs = Time(ticks, [&]() {
+		for (const Point& p : probes) {
+			oldHits += ScanPoint(actors, p) != nullptr;
+		}
+	});
+	double newMs = Time(ticks, [&]() {
+		for (const Point& p : probes) {
+			newHits += QueryPoint(grid, p) != nullptr;
+		}
+	});
+	Report("actor under a point", oldMs, newMs);
+	bool mismatch = oldHits != newHits;
+
+	size_t oldNear = 0;
+	size_t newNear = 0;
+	oldMs = Time(ticks, [&]() {
+		for (const Actor* actor : actors) {
+			oldNear += ScanRadius(actors, actor->Pos, found);
+		}
+	});
+	newMs = Time(ticks, [&]() {
+		for (const Actor* actor : actors) {
+			newNear += QueryRadius(grid, actor->Pos, found);
+		}
+	});
+	Report("neighbours in 15 feet", oldMs, newMs);
+	mismatch = mismatch || oldNear != newNear;
+
+	// what the grid costs in return: every step of every actor goes through Update
+	std::vector<Point> steps;
+	for (int i = 0; i < actorCount; ++i) {
+		steps.emplace_back(stepDist(rng), stepDist(rng));
+	}
+	// back and forth, so the crowd stays spread out
+	bool back = false;
+	newMs = Time(ticks, [&]() {
+		for (int i = 0; i < actorCount; ++i) {
+			Actor* actor = actors[i];
+			actor->SetPos(back ? actor->Pos - steps[i] : actor->Pos + steps[i]);
+			grid.Update(actor);
+		}
+		back = !back;
+	});
+	fprintf(stdout, "%-28s                    new %9.2f ms\n", "walking a step", newMs);
+
+	if (mismatch) {
+		fprintf(stderr, "The grid found %zu actors under points and %zu neighbours, the scans %zu and %zu\n", newHits, newNear, oldHits, oldNear);
+	}
+
+	for (Actor* actor : actors) {
+		grid.Remove(actor);
+		delete actor;
+	}
+	Benchmark::ShutdownCore();
+	return mismatch ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "BenchmarkCore.h"
+
+#include "Interface.h"
+#include "InterfaceConfig.h"
+
+namespace GemRB {
+namespace Benchmark {
+
+bool BootCore(const char* configPath)
+{
+	Interface::SanityCheck(VERSION_GEMRB);
+
+	char name[] = "gemrb";
+	char configFlag[] = "-c";
+	char quietFlag[] = "-q";
+	char* argv[] = { name, configFlag, const_cast<char*>(configPath), quietFlag };
+	CFGConfig config(4, argv);
+	if (!config.GetValueForKey("VideoDriver")) {
+		config.SetKeyValuePair("VideoDriver", "none");
+	}
+
+	core = new Interface();
+	if (core->Init(&config) == GEM_ERROR) {
+		delete core;
+		core = nullptr;
+		return false;
+	}
+	return true;
+}
+
+void ShutdownCore()
+{
+	delete core;
+	core = nullptr;
+}
+
+}
+}
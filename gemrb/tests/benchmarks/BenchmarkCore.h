@@ -0,0 +1,38 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Starts the engine for the benchmarks that need real game objects (actors
+// can't be built without the core and its tables). Any game config works,
+// including the dummy data set in gemrb/tests/minimal. There is no window
+// or sound, and the log stays quiet.
+
+#ifndef BENCHMARKCORE_H
+#define BENCHMARKCORE_H
+
+namespace GemRB {
+namespace Benchmark {
+
+bool BootCore(const char* configPath);
+void ShutdownCore();
+
+}
+}
+
+#endif
@@ -0,0 +1,317 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2003 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "LegacyTables.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace GemRB {
+namespace Legacy {
+
+/////////////////////////////////////////////////////////////////////////////
+// Variables
+
+Variables::Variables(int nBlockSize, int nHashTableSize)
+: m_nHashTableSize(nHashTableSize), m_nBlockSize(nBlockSize)
+{
+	assert( nBlockSize > 0 );
+	assert( nHashTableSize > 16 );
+}
+
+Variables::~Variables()
+{
+	RemoveAll();
+}
+
+bool Variables::MyCompareKey(const key_t& key, key_t str) const
+{
+	// we know 'key' cannot contain spaces (created via NewAssoc)
+	// therefore str.length() cannot be < key.length()
+	if (str.length() < key.length()) {
+		return false;
+	}
+
+	size_t s = 0;
+	size_t end = str.length();
+	for (size_t k = 0; s < end; ++s) {
+		if (str[s] == ' ')
+			continue;
+		if (tolower(key[k++]) != tolower(str[s]))
+			return false;
+	}
+
+	return s == end;
+}
+
+unsigned int Variables::MyHashKey(const key_t& key) const
+{
+	unsigned int nHash = 0;
+	for (const auto& chr : key) {
+		//the original engine ignores spaces in variable names
+		if (chr == ' ')
+			continue;
+		nHash = (nHash << 5) + nHash + tolower(chr);
+	}
+	return nHash;
+}
+
+void Variables::RemoveAll()
+{
+	if (m_pHashTable) {
+		for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
+			for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
+				free(pAssoc->key);
+			}
+		}
+	}
+	free(m_pHashTable);
+	m_pHashTable = nullptr;
+
+	m_nCount = 0;
+	m_pFreeList = nullptr;
+	MemBlock* p = m_pBlocks;
+	while (p != nullptr) {
+		MemBlock* pNext = p->pNext;
+		free(p);
+		p = pNext;
+	}
+	m_pBlocks = nullptr;
+}
+
+Variables::MyAssoc* Variables::NewAssoc(const key_t& key)
+{
+	if (m_pFreeList == nullptr) {
+		// add another block
+		MemBlock* newBlock = (MemBlock*) malloc(m_nBlockSize * sizeof(MyAssoc) + sizeof(MemBlock));
+		assert( newBlock != nullptr );
+		newBlock->pNext = m_pBlocks;
+		m_pBlocks = newBlock;
+
+		// chain them into free list
+		MyAssoc* pAssoc = (MyAssoc*) (newBlock + 1);
+		for (int i = 0; i < m_nBlockSize; i++) {
+			pAssoc->pNext = m_pFreeList;
+			m_pFreeList = pAssoc++;
+		}
+	}
+
+	MyAssoc* pAssoc = m_pFreeList;
+	m_pFreeList = m_pFreeList->pNext;
+	m_nCount++;
+	size_t len = key.length();
+	pAssoc->key = (char *) malloc(len + 1);
+	if (m_lParseKey) {
+		size_t j = 0;
+		for (const auto& chr : key) {
+			if (chr == ' ')
+				continue;
+			pAssoc->key[j++] = tolower(chr);
+		}
+		pAssoc->key[j] = 0;
+	} else {
+		memcpy(pAssoc->key, key.begin(), len);
+		pAssoc->key[len] = 0;
+	}
+	return pAssoc;
+}
+
+Variables::MyAssoc* Variables::GetAssocAt(const key_t& key, unsigned int& nHash) const
+{
+	if (key.empty() || key.c_str() == nullptr) {
+		nHash = 0;
+		return nullptr;
+	}
+
+	nHash = MyHashKey( key ) % m_nHashTableSize;
+
+	if (m_pHashTable == nullptr) {
+		return nullptr;
+	}
+
+	for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
+		if (m_lParseKey) {
+			if (MyCompareKey(key_t(pAssoc->key), key)) {
+				return pAssoc;
+			}
+		} else {
+			if (!strnicmp(pAssoc->key, key.c_str(), key.length())) {
+				return pAssoc;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+bool Variables::Lookup(const key_t& key, ieDword& rValue) const
+{
+	unsigned int nHash;
+	const MyAssoc* pAssoc = GetAssocAt(key, nHash);
+	if (pAssoc == nullptr) {
+		return false;
+	}
+
+	rValue = pAssoc->nValue;
+	return true;
+}
+
+void Variables::SetAt(const key_t& key, ieDword value)
+{
+	unsigned int nHash;
+	MyAssoc* pAssoc = GetAssocAt(key, nHash);
+	if (pAssoc == nullptr) {
+		if (key.empty()) return;
+		if (m_pHashTable == nullptr) {
+			m_pHashTable = (MyAssoc**) calloc(m_nHashTableSize, sizeof(MyAssoc*));
+		}
+
+		pAssoc = NewAssoc( key );
+		pAssoc->pNext = m_pHashTable[nHash];
+		m_pHashTable[nHash] = pAssoc;
+	}
+	pAssoc->nValue = value;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Cache
+
+static const CstrHashCI<ResRef> MyHashKey;
+
+Cache::Cache(int nBlockSize, int nHashTableSize)
+: m_nHashTableSize(nHashTableSize), m_nBlockSize(nBlockSize)
+{
+	assert( nBlockSize > 0 );
+	assert( nHashTableSize > 16 );
+}
+
+Cache::~Cache()
+{
+	RemoveAll();
+}
+
+void Cache::RemoveAll()
+{
+	if (m_pHashTable) {
+		for (unsigned int nHash = 0; nHash < m_nHashTableSize; nHash++) {
+			MyAssoc* pAssoc = m_pHashTable[nHash];
+			while (pAssoc != nullptr) {
+				MyAssoc* pAssocTmp = pAssoc->pNext;
+				pAssoc->MyAssoc::~MyAssoc();
+				pAssoc = pAssocTmp;
+			}
+		}
+		free(m_pHashTable);
+		m_pHashTable = nullptr;
+	}
+
+	m_nCount = 0;
+	m_pFreeList = nullptr;
+	MemBlock* p = m_pBlocks;
+	while (p != nullptr) {
+		MemBlock* pNext = p->pNext;
+		free(p);
+		p = pNext;
+	}
+	m_pBlocks = nullptr;
+}
+
+Cache::MyAssoc* Cache::NewAssoc()
+{
+	if (m_pFreeList == nullptr) {
+		// add another block
+		MemBlock* newBlock = (MemBlock*) malloc(m_nBlockSize * sizeof(MyAssoc) + sizeof(MemBlock));
+		assert( newBlock != nullptr );
+		newBlock->pNext = m_pBlocks;
+		m_pBlocks = newBlock;
+
+		// chain them into free list
+		MyAssoc* pAssoc = (MyAssoc*) (newBlock + 1);
+		for (int i = 0; i < m_nBlockSize; i++) {
+			pAssoc->pNext = m_pFreeList;
+			m_pFreeList = pAssoc++;
+		}
+	}
+
+	MyAssoc* pAssoc = m_pFreeList;
+	m_pFreeList = m_pFreeList->pNext;
+	m_nCount++;
+	pAssoc->nRefCount = 1;
+	return pAssoc;
+}
+
+Cache::MyAssoc* Cache::GetAssocAt(const ResRef& key) const
+{
+	if (m_pHashTable == nullptr || key.IsEmpty()) {
+		return nullptr;
+	}
+
+	size_t nHash = MyHashKey(key) % m_nHashTableSize;
+	for (auto pAssoc = m_pHashTable[nHash]; pAssoc != nullptr; pAssoc = pAssoc->pNext) {
+		if (key == pAssoc->key) {
+			return pAssoc;
+		}
+	}
+	return nullptr;
+}
+
+void *Cache::GetResource(const ResRef& key) const
+{
+	MyAssoc* pAssoc = GetAssocAt( key );
+	if (pAssoc == nullptr) {
+		return nullptr;
+	}
+
+	pAssoc->nRefCount++;
+	return pAssoc->data;
+}
+
+bool Cache::SetAt(const ResRef& key, void *rValue)
+{
+	if (key.IsEmpty()) return false;
+
+	if (m_pHashTable == nullptr) {
+		m_pHashTable = (MyAssoc**) calloc(m_nHashTableSize, sizeof(MyAssoc*));
+	}
+
+	MyAssoc* pAssoc = GetAssocAt( key );
+	if (pAssoc) {
+		//already exists, but we return true if it is the same
+		return pAssoc->data == rValue;
+	}
+
+	pAssoc = NewAssoc();
+	new (&pAssoc->key) ResRef(key);
+	pAssoc->data = rValue;
+	size_t nHash = MyHashKey(pAssoc->key) % m_nHashTableSize;
+	pAssoc->pNext = m_pHashTable[nHash];
+	pAssoc->pPrev = &m_pHashTable[nHash];
+	if (pAssoc->pNext) {
+		pAssoc->pNext->pPrev = &pAssoc->pNext;
+	}
+	m_pHashTable[nHash] = pAssoc;
+	return true;
+}
+
+}
+}
@@ -0,0 +1,123 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2003 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// The chained hash tables Variables and Cache used before they moved to
+// OpenHashMap, cut down to the integer variables and the lookups the
+// benchmark compares; kept only as a reference point.
+
+#ifndef LEGACYTABLES_H
+#define LEGACYTABLES_H
+
+#include "globals.h"
+
+#include "Strings/StringView.h"
+
+namespace GemRB {
+namespace Legacy {
+
+class Variables {
+protected:
+	struct MyAssoc {
+		MyAssoc* pNext;
+		char* key;
+		ieDword nValue;
+	};
+	struct MemBlock {
+		MemBlock* pNext;
+	};
+public:
+	using key_t = StringView;
+
+	explicit Variables(int nBlockSize = 10, int nHashTableSize = 2049);
+	Variables(const Variables&) = delete;
+	~Variables();
+	Variables& operator=(const Variables&) = delete;
+
+	inline void ParseKey(int arg)
+	{
+		m_lParseKey = (arg > 0);
+	}
+	inline int GetCount() const
+	{
+		return m_nCount;
+	}
+
+	bool Lookup(const key_t&, ieDword& rValue) const;
+	void SetAt(const key_t&, ieDword newValue);
+	void RemoveAll();
+
+protected:
+	MyAssoc** m_pHashTable = nullptr;
+	unsigned int m_nHashTableSize;
+	bool m_lParseKey = false;
+	int m_nCount = 0;
+	MyAssoc* m_pFreeList = nullptr;
+	MemBlock* m_pBlocks = nullptr;
+	int m_nBlockSize;
+
+	MyAssoc* NewAssoc(const key_t&);
+	MyAssoc* GetAssocAt(const key_t&, unsigned int&) const;
+	bool MyCompareKey(const key_t&, key_t str) const;
+	unsigned int MyHashKey(const key_t&) const;
+};
+
+class Cache {
+protected:
+	struct MyAssoc {
+		MyAssoc* pNext;
+		MyAssoc** pPrev;
+		ResRef key;
+		ieDword nRefCount;
+		void* data;
+	};
+	struct MemBlock {
+		MemBlock* pNext;
+	};
+
+public:
+	explicit Cache(int nBlockSize = 10, int nHashTableSize = 129);
+	Cache(const Cache&) = delete;
+	~Cache();
+	Cache& operator=(const Cache&) = delete;
+
+	inline int GetCount() const
+	{
+		return m_nCount;
+	}
+	void *GetResource(const ResRef& key) const;
+	bool SetAt(const ResRef& key, void *rValue);
+	void RemoveAll();
+
+protected:
+	MyAssoc** m_pHashTable = nullptr;
+	unsigned int m_nHashTableSize;
+	int m_nCount = 0;
+	MyAssoc* m_pFreeList = nullptr;
+	MemBlock* m_pBlocks = nullptr;
+	int m_nBlockSize;
+
+	MyAssoc* NewAssoc();
+	MyAssoc* GetAssocAt(const ResRef&) const;
+};
+
+}
+}
+
+#endif
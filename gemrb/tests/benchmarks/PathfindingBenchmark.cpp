@@ -0,0 +1,436 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Measures paths per second over area searchmaps, comparing the reused
+// PathFinderWorkspace with the per-search vectors and Fibonacci heap it replaced:
+//   gemrb_bench_pathfinding [-s size] [-n pairs] AR0100SR.BMP [more SR bitmaps]
+// The searches mirror Map::SearchPath with the default terrain table and no
+// actors or doors, so only the searchmap shapes the routes. Pairs the layers of
+// PathFinderHierarchy prove disconnected are timed separately, since FindPath
+// answers those without searching now.
+
+#include "Map.h"
+#include "PathFinder.h"
+#include "Sprite2D.h"
+
+#include "FibonacciHeap.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace GemRB;
+
+namespace GemRB {
+namespace Legacy {
+
+// what Map::FindPath used to allocate for every search
+class PathFinderWorkspace {
+	std::unique_ptr<FibonacciHeap<PQNode>> open;
+	std::vector<bool> isClosed;
+	std::vector<NavmapPoint> parents;
+	std::vector<unsigned short> distFromStart;
+	int width = 0;
+
+	size_t Index(const SearchmapPoint& p) const { return p.y * width + p.x; }
+
+public:
+	void Reset(const Size& mapSize)
+	{
+		width = mapSize.w;
+		open.reset(new FibonacciHeap<PQNode>());
+		isClosed = std::vector<bool>(mapSize.Area(), false);
+		parents = std::vector<NavmapPoint>(mapSize.Area(), Point(0, 0));
+		distFromStart = std::vector<unsigned short>(mapSize.Area(), std::numeric_limits<unsigned short>::max());
+	}
+
+	bool IsClosed(const SearchmapPoint& p) const { return isClosed[Index(p)]; }
+	void Close(const SearchmapPoint& p) { isClosed[Index(p)] = true; }
+	NavmapPoint GetParent(const SearchmapPoint& p) const { return parents[Index(p)]; }
+	unsigned short GetDistance(const SearchmapPoint& p) const { return distFromStart[Index(p)]; }
+	void SetParent(const SearchmapPoint& p, const NavmapPoint& parent, unsigned short dist)
+	{
+		parents[Index(p)] = parent;
+		distFromStart[Index(p)] = dist;
+	}
+
+	bool OpenEmpty() const { return open->empty(); }
+	void PushOpen(const PQNode& node) { open->emplace(node); }
+	PQNode PopOpen() { return open->pop(); }
+};
+
+// and the list it returned
+struct PathListNode {
+	PathListNode* Parent;
+	PathListNode* Next;
+	Point point;
+	orient_t orient;
+};
+
+}
+}
+
+// the defaults of AREImporter's terrain table
+static const PathMapFlags Passable[16] = {
+	PathMapFlags::NO_SEE, PathMapFlags::PASSABLE, PathMapFlags::PASSABLE, PathMapFlags::PASSABLE,
+	PathMapFlags::PASSABLE, PathMapFlags::PASSABLE, PathMapFlags::PASSABLE, PathMapFlags::PASSABLE,
+	PathMapFlags::IMPASSABLE, PathMapFlags::PASSABLE, PathMapFlags::SIDEWALL, PathMapFlags::IMPASSABLE,
+	PathMapFlags::IMPASSABLE, PathMapFlags::IMPASSABLE, PathMapFlags::PASSABLE | PathMapFlags::TRAVEL, PathMapFlags::PASSABLE
+};
+
+static uint32_t LoadDword(const std::vector<char>& data, size_t pos)
+{
+	uint32_t value = 0;
+	for (int i = 3; i >= 0; --i) {
+		value = (value << 8) | uint8_t(data[pos + i]);
+	}
+	return value;
+}
+
+// reads the 4 or 8 bit palette indices of an uncompressed bitmap into the
+// searchmap channel, like AREImporter::MakeTileProps does
+static Holder<Sprite2D> LoadSearchMap(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.size() < 54 || memcmp(data.data(), "BM", 2) != 0) {
+		return nullptr;
+	}
+
+	size_t pixelOffset = LoadDword(data, 10);
+	int width = int(LoadDword(data, 18));
+	int height = int(LoadDword(data, 22));
+	unsigned int bpp = uint8_t(data[28]) | (uint8_t(data[29]) << 8);
+	bool topDown = height < 0;
+	height = std::abs(height);
+	size_t stride = ((width * bpp + 31) / 32) * 4;
+	if ((bpp != 4 && bpp != 8) || LoadDword(data, 30) != 0 || width <= 0 || pixelOffset + stride * height > data.size()) {
+		return nullptr;
+	}
+
+	uint32_t* pixels = static_cast<uint32_t*>(malloc(width * height * 4));
+	const PixelFormat& fmt = TileProps::pixelFormat;
+	for (int y = 0; y < height; ++y) {
+		const uint8_t* row = reinterpret_cast<const uint8_t*>(data.data()) + pixelOffset + stride * (topDown ? y : height - 1 - y);
+		for (int x = 0; x < width; ++x) {
+			uint8_t smval = bpp == 8 ? row[x] & 0x0f : (row[x / 2] >> (x % 2 ? 0 : 4)) & 0x0f;
+			uint32_t r = uint8_t(Passable[smval]);
+			pixels[y * width + x] = (r << fmt.Rshift) | (uint32_t(smval) << fmt.Gshift) | (uint32_t(TileProps::defaultLighting) << fmt.Ashift);
+		}
+	}
+	return MakeHolder<Sprite2D>(Region(0, 0, width, height), pixels, fmt, uint16_t(width * 4));
+}
+
+static bool IsOpenFor(const TileProps& props, const SearchmapPoint& p, unsigned int size)
+{
+	PathMapFlags ret = props.QueryStaticInRadius(p, size);
+	if (bool(ret & (PathMapFlags::DOOR_IMPASSABLE | PathMapFlags::SIDEWALL))) {
+		ret &= ~PathMapFlags::PASSABLE;
+	}
+	return bool(ret & (PathMapFlags::PASSABLE | PathMapFlags::TRAVEL));
+}
+
+// Map::IsWalkableTo over the searchmap alone
+static bool IsWalkableTo(const TileProps& props, const Point& s, const Point& d)
+{
+	if (s == d) {
+		return false;
+	}
+
+	const SearchmapPoint start(s.x / 16, s.y / 12);
+	const SearchmapPoint goal(d.x / 16, d.y / 12);
+	SearchmapPoint cell = start;
+	const int stepX = d.x > s.x ? 1 : -1;
+	const int stepY = d.y > s.y ? 1 : -1;
+	const long lenX = std::abs(d.x - s.x);
+	const long lenY = std::abs(d.y - s.y);
+	PathMapFlags ret = PathMapFlags::IMPASSABLE;
+	while (true) {
+		PathMapFlags blockStatus = props.QuerySearchMap(cell);
+		if (blockStatus == PathMapFlags::IMPASSABLE && cell != start) {
+			return false;
+		}
+		ret |= blockStatus;
+		if (cell == goal) {
+			break;
+		}
+
+		bool moveX = cell.x != goal.x;
+		bool moveY = cell.y != goal.y;
+		if (moveX && moveY) {
+			long toX = stepX > 0 ? (cell.x + 1) * 16 - s.x : s.x - cell.x * 16;
+			long toY = stepY > 0 ? (cell.y + 1) * 12 - s.y : s.y - cell.y * 12;
+			long crossX = toX * lenY;
+			long crossY = toY * lenX;
+			bool tie = crossX == crossY;
+			moveX = crossX < crossY || (tie && (stepX == stepY || stepX > 0));
+			moveY = crossY < crossX || (tie && (stepX == stepY || stepY > 0));
+		}
+		if (moveX) cell.x += stepX;
+		if (moveY) cell.y += stepY;
+	}
+	return bool(ret & (PathMapFlags::PASSABLE | PathMapFlags::TRAVEL | PathMapFlags::ACTOR));
+}
+
+static const int dxAdjacent[4] = { 1, 0, -1, 0 };
+static const int dyAdjacent[4] = { 0, 1, 0, -1 };
+
+// the Theta* loop of Map::SearchPath, for either workspace
+template<typename Workspace>
+static bool Search(Workspace& ws, const TileProps& props, const NavmapPoint& nmptSource, NavmapPoint& nmptDest, unsigned int size)
+{
+	SearchmapPoint smptSource(nmptSource.x / 16, nmptSource.y / 12);
+	SearchmapPoint smptDest(nmptDest.x / 16, nmptDest.y / 12);
+	const Size& mapSize = props.GetSize();
+
+	ws.Reset(mapSize);
+	ws.SetParent(smptSource, nmptSource, 0);
+	ws.PushOpen(PQNode(nmptSource, 0));
+
+	while (!ws.OpenEmpty()) {
+		NavmapPoint nmptCurrent = ws.PopOpen().point;
+		SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
+		NavmapPoint nmptParent = ws.GetParent(smptCurrent);
+		if (nmptParent == Point(0, 0)) {
+			continue;
+		}
+		if (smptCurrent == smptDest) {
+			nmptDest = nmptCurrent;
+			return true;
+		}
+		ws.Close(smptCurrent);
+
+		for (int i = 0; i < 4; i++) {
+			NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
+			SearchmapPoint smptChild(nmptChild.x / 16, nmptChild.y / 12);
+			if (smptChild.x < 0 || smptChild.y < 0 || smptChild.x >= mapSize.w || smptChild.y >= mapSize.h) continue;
+			if (ws.IsClosed(smptChild)) continue;
+			if (!IsOpenFor(props, smptChild, size)) continue;
+
+			unsigned short oldDist = ws.GetDistance(smptChild);
+			unsigned short newDist = oldDist;
+			if (IsWalkableTo(props, nmptParent, nmptChild)) {
+				SearchmapPoint smptParent(nmptParent.x / 16, nmptParent.y / 12);
+				newDist = ws.GetDistance(smptParent) + Distance(smptParent, smptChild);
+				if (newDist < oldDist) {
+					ws.SetParent(smptChild, nmptParent, newDist);
+				}
+			} else if (IsWalkableTo(props, nmptCurrent, nmptChild)) {
+				newDist = ws.GetDistance(smptCurrent) + Distance(smptCurrent, smptChild);
+				if (newDist < oldDist) {
+					ws.SetParent(smptChild, nmptCurrent, newDist);
+				}
+			}
+
+			if (newDist < oldDist) {
+				int xDist = smptChild.x - smptDest.x;
+				int yDist = smptChild.y - smptDest.y;
+				int dxCross = smptDest.x - smptSource.x;
+				int dyCross = smptDest.y - smptSource.y;
+				int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
+				double heuristic = 1.5 * (std::hypot(xDist, yDist) + crossProduct);
+				ws.PushOpen(PQNode(nmptChild, newDist + heuristic));
+			}
+		}
+	}
+	return false;
+}
+
+static size_t LegacyFindPath(Legacy::PathFinderWorkspace& ws, const TileProps& props, const NavmapPoint& s, NavmapPoint d, unsigned int size)
+{
+	if (!Search(ws, props, s, d, size)) {
+		return 0;
+	}
+
+	Legacy::PathListNode* resultPath = nullptr;
+	NavmapPoint nmptCurrent = d;
+	SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
+	while (!resultPath || nmptCurrent != ws.GetParent(smptCurrent)) {
+		NavmapPoint nmptParent = ws.GetParent(smptCurrent);
+		Legacy::PathListNode* newStep = new Legacy::PathListNode;
+		newStep->point = nmptCurrent;
+		newStep->Next = resultPath;
+		newStep->Parent = nullptr;
+		newStep->orient = GetOrient(nmptCurrent, nmptParent);
+		if (resultPath) {
+			resultPath->Parent = newStep;
+		}
+		resultPath = newStep;
+		nmptCurrent = nmptParent;
+		smptCurrent = SearchmapPoint(nmptCurrent.x / 16, nmptCurrent.y / 12);
+	}
+
+	size_t steps = 0;
+	while (resultPath) {
+		Legacy::PathListNode* next = resultPath->Next;
+		delete resultPath;
+		resultPath = next;
+		++steps;
+	}
+	return steps;
+}
+
+static size_t FindPath(PathFinderWorkspace& ws, const TileProps& props, const NavmapPoint& s, NavmapPoint d, unsigned int size)
+{
+	if (!Search(ws, props, s, d, size)) {
+		return 0;
+	}
+
+	Path resultPath;
+	NavmapPoint nmptCurrent = d;
+	SearchmapPoint smptCurrent(nmptCurrent.x / 16, nmptCurrent.y / 12);
+	while (resultPath.empty() || nmptCurrent != ws.GetParent(smptCurrent)) {
+		NavmapPoint nmptParent = ws.GetParent(smptCurrent);
+		PathNode newStep;
+		newStep.point = nmptCurrent;
+		newStep.orient = GetOrient(nmptCurrent, nmptParent);
+		resultPath.push_back(newStep);
+		nmptCurrent = nmptParent;
+		smptCurrent = SearchmapPoint(nmptCurrent.x / 16, nmptCurrent.y / 12);
+	}
+	std::reverse(resultPath.begin(), resultPath.end());
+	return resultPath.size();
+}
+
+template<typename F>
+static double Time(int rounds, F&& fn)
+{
+	using namespace std::chrono;
+	auto start = steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		fn();
+	}
+	return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+static void Report(const char* what, size_t paths, double oldMs, double newMs)
+{
+	if (!paths) return;
+	fprintf(stdout, "%-24s old %10.0f/s   new %10.0f/s   x%.2f\n", what,
+		oldMs > 0 ? paths * 1000 / oldMs : 0.0, newMs > 0 ? paths * 1000 / newMs : 0.0, newMs > 0 ? oldMs / newMs : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int size = 2;
+	size_t pairCount = 500;
+	int argi = 1;
+	for (; argi + 1 < argc && argv[argi][0] == '-'; argi += 2) {
+		if (!strcmp(argv[argi], "-s")) {
+			size = atoi(argv[argi + 1]);
+		} else if (!strcmp(argv[argi], "-n")) {
+			pairCount = atoi(argv[argi + 1]);
+		}
+	}
+	if (argi >= argc) {
+		fprintf(stderr, "Usage: %s [-s size] [-n pairs] <searchmap.bmp> [...]\n", argv[0]);
+		return 1;
+	}
+
+	for (; argi < argc; ++argi) {
+		Holder<Sprite2D> image = LoadSearchMap(argv[argi]);
+		if (!image) {
+			fprintf(stderr, "%s is not a 4 or 8 bit uncompressed bitmap\n", argv[argi]);
+			return 1;
+		}
+		TileProps props(image);
+		const Size& mapSize = props.GetSize();
+
+		std::vector<SearchmapPoint> open;
+		for (int y = 0; y < mapSize.h; ++y) {
+			for (int x = 0; x < mapSize.w; ++x) {
+				if (IsOpenFor(props, SearchmapPoint(x, y), size)) {
+					open.emplace_back(x, y);
+				}
+			}
+		}
+		if (open.size() < 2) {
+			fprintf(stderr, "%s has no room for a creature of size %u\n", argv[argi], size);
+			continue;
+		}
+
+		// a fixed seed, so both sides and reruns see the same pairs
+		std::mt19937 rng(1);
+		std::uniform_int_distribution<size_t> pick(0, open.size() - 1);
+		PathFinderHierarchy hierarchy;
+		using Pair = std::pair<NavmapPoint, NavmapPoint>;
+		std::vector<Pair> connected;
+		std::vector<Pair> disconnected;
+		for (size_t i = 0; i < pairCount; ++i) {
+			SearchmapPoint s = open[pick(rng)];
+			SearchmapPoint d = open[pick(rng)];
+			if (s == d) continue;
+			Pair pair(NavmapPoint(s.x * 16 + 8, s.y * 12 + 6), NavmapPoint(d.x * 16 + 8, d.y * 12 + 6));
+			if (hierarchy.GetComponent(props, s, size) == hierarchy.GetComponent(props, d, size)) {
+				connected.push_back(pair);
+			} else {
+				disconnected.push_back(pair);
+			}
+		}
+		fprintf(stdout, "%s: %dx%d cells, size %u, %zu connected and %zu disconnected pairs\n",
+			argv[argi], mapSize.w, mapSize.h, size, connected.size(), disconnected.size());
+
+		// the step counts keep the searches from being optimized away and check the results
+		Legacy::PathFinderWorkspace oldWs;
+		PathFinderWorkspace newWs;
+		size_t oldSteps = 0;
+		size_t newSteps = 0;
+		double oldMs = Time(1, [&]() {
+			for (const Pair& pair : connected) {
+				oldSteps += LegacyFindPath(oldWs, props, pair.first, pair.second, size);
+			}
+		});
+		double newMs = Time(1, [&]() {
+			for (const Pair& pair : connected) {
+				newSteps += FindPath(newWs, props, pair.first, pair.second, size);
+			}
+		});
+		Report("connected paths", connected.size(), oldMs, newMs);
+
+		// these used to flood their whole region before giving up
+		size_t rejected = 0;
+		oldMs = Time(1, [&]() {
+			for (const Pair& pair : disconnected) {
+				oldSteps += LegacyFindPath(oldWs, props, pair.first, pair.second, size);
+			}
+		});
+		newMs = Time(1, [&]() {
+			for (const Pair& pair : disconnected) {
+				SearchmapPoint s(pair.first.x / 16, pair.first.y / 12);
+				SearchmapPoint d(pair.second.x / 16, pair.second.y / 12);
+				rejected += hierarchy.GetComponent(props, s, size) != hierarchy.GetComponent(props, d, size);
+			}
+		});
+		Report("disconnected pairs", disconnected.size(), oldMs, newMs);
+
+		if (oldSteps != newSteps || rejected != disconnected.size()) {
+			fprintf(stderr, "results differ: %zu and %zu steps, %zu of %zu rejected\n", oldSteps, newSteps, rejected, disconnected.size());
+			return 1;
+		}
+	}
+	return 0;
+}
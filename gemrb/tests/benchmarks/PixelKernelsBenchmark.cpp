@@ -0,0 +1,252 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Compares every pixel kernel set this CPU can run with the scalar one,
+// then times them on sprite sized rows:
+//   gemrb_bench_pixelkernels [rounds]
+//   gemrb_bench_pixelkernels --check
+// The comparison runs every row width up to a few vectors from unaligned
+// starts, so the scalar tails are covered too, and checks that nothing
+// past the row is written. --check stops after it, exiting with 1 on a
+// mismatch.
+
+#include "Video/PixelKernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace GemRB;
+
+static const int MAX_CHECK_WIDTH = 70; // a few AVX2 vectors and every tail length
+static const int MAX_OFFSET = 3;
+static const int GUARD = 8;
+static const int BENCH_WIDTH = 640;
+
+struct NamedLayout {
+	const char* name;
+	PixelLayout layout;
+};
+
+static std::vector<NamedLayout> Layouts()
+{
+	std::vector<NamedLayout> layouts(3);
+	layouts[0].name = "RGBA";
+	layouts[1].name = "BGRA";
+	layouts[1].layout.rShift = 16;
+	layouts[1].layout.bShift = 0;
+	layouts[2].name = "ARGB";
+	layouts[2].layout.aShift = 0;
+	layouts[2].layout.rShift = 8;
+	layouts[2].layout.gShift = 16;
+	layouts[2].layout.bShift = 24;
+	return layouts;
+}
+
+// one case: 'run' applies a kernel of the given set to the buffers, at an offset and width
+struct Case {
+	std::string name;
+	std::function<void(const PixelKernels&, uint32_t* dst, const uint32_t* src, const uint8_t* stencil, const uint8_t* indices, int n)> run;
+};
+
+static std::vector<Case> Cases(const PixelLayout& layout, std::mt19937& rng)
+{
+	std::vector<Case> cases;
+	std::vector<uint32_t> palette(256);
+	for (uint32_t& color : palette) {
+		color = rng();
+	}
+	cases.push_back({ "Expand", [palette](const PixelKernels& k, uint32_t* dst, const uint32_t*, const uint8_t*, const uint8_t* indices, int n) {
+		k.Expand(indices, palette.data(), dst, n);
+	}});
+
+	Color tint { uint8_t(rng()), uint8_t(rng()), uint8_t(rng()), uint8_t(rng()) };
+	ScaleParams tinted;
+	tinted.ScaleColor(layout, tint, 8);
+	tinted.Keep(layout.aShift);
+	ScaleParams faded = tinted;
+	faded.Scale(layout.aShift, tint.a, 8);
+	faded.keep = 0;
+	ScaleParams filled = tinted;
+	filled.keep = 0;
+	filled.Fill(layout.aShift, 0xff);
+	for (const auto& scale : { std::make_pair("Scale tint", tinted), std::make_pair("Scale tint+alpha", faded), std::make_pair("Scale fill", filled) }) {
+		ScaleParams params = scale.second;
+		cases.push_back({ scale.first, [params](const PixelKernels& k, uint32_t* dst, const uint32_t*, const uint8_t*, const uint8_t*, int n) {
+			k.Scale(dst, n, params);
+		}});
+	}
+
+	for (const auto& desat : { std::make_pair("Desaturate grey", DesaturateParams::Greyscale(layout)), std::make_pair("Desaturate sepia", DesaturateParams::Sepia(layout)) }) {
+		DesaturateParams params = desat.second;
+		cases.push_back({ desat.first, [params](const PixelKernels& k, uint32_t* dst, const uint32_t*, const uint8_t*, const uint8_t*, int n) {
+			k.Desaturate(dst, n, params);
+		}});
+	}
+
+	for (uint32_t amask : { 0U, layout.AlphaMask() }) {
+		BlendParams params(layout, amask);
+		std::string suffix = amask ? " +amask" : "";
+		cases.push_back({ "BlendAlpha" + suffix, [params](const PixelKernels& k, uint32_t* dst, const uint32_t* src, const uint8_t* stencil, const uint8_t*, int n) {
+			k.BlendAlpha(dst, src, stencil, n, params);
+		}});
+		cases.push_back({ "BlendHalf" + suffix, [params](const PixelKernels& k, uint32_t* dst, const uint32_t* src, const uint8_t* stencil, const uint8_t*, int n) {
+			k.BlendHalf(dst, src, stencil, n, params);
+		}});
+	}
+	return cases;
+}
+
+// whole vectors of covered, uncovered and mixed stencil values, so the skipping paths run too
+static void FillStencil(std::vector<uint8_t>& stencil, std::mt19937& rng)
+{
+	for (size_t i = 0; i < stencil.size(); i += 4) {
+		unsigned int kind = rng() % 3;
+		for (size_t j = i; j < i + 4 && j < stencil.size(); ++j) {
+			if (kind == 0) {
+				stencil[j] = 0xff;
+			} else if (kind == 1) {
+				stencil[j] = 0;
+			} else {
+				unsigned int value = rng();
+				stencil[j] = value & 1 ? 0xff : uint8_t(value >> 8);
+			}
+		}
+	}
+}
+
+static bool Check(const std::vector<const PixelKernels*>& sets)
+{
+	std::mt19937 rng(1);
+	const PixelKernels& scalar = PixelKernels::Scalar();
+	size_t size = MAX_CHECK_WIDTH + MAX_OFFSET + GUARD;
+	std::vector<uint32_t> src(size);
+	std::vector<uint32_t> dst(size);
+	std::vector<uint8_t> stencil(size);
+	std::vector<uint8_t> indices(size);
+	size_t compared = 0;
+
+	for (const NamedLayout& named : Layouts()) {
+		for (const Case& test : Cases(named.layout, rng)) {
+			for (int width = 0; width <= MAX_CHECK_WIDTH; ++width) {
+				for (int offset = 0; offset <= MAX_OFFSET; ++offset) {
+					for (uint32_t& px : src) px = rng();
+					for (uint32_t& px : dst) px = rng();
+					for (uint8_t& index : indices) index = uint8_t(rng());
+					FillStencil(stencil, rng);
+
+					std::vector<uint32_t> expected = dst;
+					test.run(scalar, expected.data() + offset, src.data() + offset, stencil.data() + offset, indices.data() + offset, width);
+					for (const PixelKernels* set : sets) {
+						if (set == &scalar) continue;
+						std::vector<uint32_t> actual = dst;
+						test.run(*set, actual.data() + offset, src.data() + offset, stencil.data() + offset, indices.data() + offset, width);
+						++compared;
+						if (actual == expected) continue;
+
+						size_t i = 0;
+						while (actual[i] == expected[i]) ++i;
+						fprintf(stderr, "%s %s differs from scalar on %s, width %d from offset %d: pixel %d is %08x, not %08x\n",
+							set->name, test.name.c_str(), named.name, width, offset, int(i) - offset, actual[i], expected[i]);
+						return false;
+					}
+				}
+			}
+		}
+	}
+	fprintf(stdout, "%zu rows match the scalar kernels\n", compared);
+	return true;
+}
+
+template<typename F>
+static double Time(int rounds, F&& fn)
+{
+	using namespace std::chrono;
+	auto start = steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		fn();
+	}
+	return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+static void Bench(const std::vector<const PixelKernels*>& sets, int rounds)
+{
+	std::mt19937 rng(2);
+	NamedLayout named = Layouts()[0];
+	std::vector<uint32_t> src(BENCH_WIDTH);
+	std::vector<uint32_t> dst(BENCH_WIDTH);
+	std::vector<uint8_t> stencil(BENCH_WIDTH);
+	std::vector<uint8_t> indices(BENCH_WIDTH);
+	for (uint32_t& px : src) px = rng();
+	for (uint8_t& index : indices) index = uint8_t(rng());
+	// sprites are mostly uncovered
+	FillStencil(stencil, rng);
+	for (uint8_t& value : stencil) {
+		if (rng() % 4) value = 0;
+	}
+
+	fprintf(stdout, "%d rows of %d pixels, %s\n", rounds, BENCH_WIDTH, named.name);
+	for (const Case& test : Cases(named.layout, rng)) {
+		double scalarMs = 0;
+		for (const PixelKernels* set : sets) {
+			for (uint32_t& px : dst) px = rng();
+			double ms = Time(rounds, [&]() {
+				test.run(*set, dst.data(), src.data(), stencil.data(), indices.data(), BENCH_WIDTH);
+			});
+			if (set == sets.front()) {
+				scalarMs = ms;
+				fprintf(stdout, "%-20s %-6s %9.2f ms\n", test.name.c_str(), set->name, ms);
+			} else {
+				fprintf(stdout, "%-20s %-6s %9.2f ms   x%.2f\n", "", set->name, ms, ms > 0 ? scalarMs / ms : 0.0);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool checkOnly = argc > 1 && !strcmp(argv[1], "--check");
+	int rounds = argc > 1 && !checkOnly ? atoi(argv[1]) : 20000;
+	if (rounds <= 0) {
+		fprintf(stderr, "Usage: %s [rounds | --check]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<const PixelKernels*> sets = PixelKernels::Available();
+	std::string names;
+	for (const PixelKernels* set : sets) {
+		names += names.empty() ? set->name : std::string(", ") + set->name;
+	}
+	fprintf(stdout, "kernel sets: %s\n", names.c_str());
+
+	if (!Check(sets)) {
+		return 1;
+	}
+	if (!checkOnly) {
+		Bench(sets, rounds);
+	}
+	return 0;
+}
@@ -0,0 +1,202 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Counts the heap allocations and times the object matching of a script
+// heavy area, with the pooled target sets against the list based ones
+// they replaced:
+//   gemrb_bench_scripttargets [-n actors] [-t ticks] [-e objects] <gemrb.cfg>
+// Every tick, each actor evaluates a few objects the way EvaluateObject
+// and the XthNearest filters do: it gathers the actors that pass its IDS
+// check sorted by distance, then picks one of the nearest.
+
+#include "BenchmarkCore.h"
+
+#include "GameScript/GameScript.h"
+#include "Scriptable/Actor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <new>
+#include <random>
+#include <vector>
+
+using namespace GemRB;
+
+// every allocation of the process, the core included, goes through here
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+	++allocations;
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+namespace GemRB {
+namespace Legacy {
+
+// Targets before the pool, cut down to what the benchmark uses
+class Targets {
+	std::list<targettype> objects;
+public:
+	void AddTarget(Scriptable* target, unsigned int distance, int ga_flags)
+	{
+		if (target->Type == ST_ACTOR && ga_flags && !static_cast<Actor*>(target)->ValidTarget(ga_flags)) {
+			return;
+		}
+		targettype Target = { target, distance };
+		for (auto m = objects.begin(); m != objects.end(); ++m) {
+			if ((*m).distance > distance) {
+				objects.insert(m, Target);
+				return;
+			}
+		}
+		objects.push_back(Target);
+	}
+
+	Scriptable* GetTarget(unsigned int index, int Type)
+	{
+		for (const targettype& t : objects) {
+			if (Type == -1 || t.actor->Type == Type) {
+				if (!index) return t.actor;
+				index--;
+			}
+		}
+		return nullptr;
+	}
+};
+
+}
+}
+
+static const Size AREA_SIZE(4000, 3000);
+static const int GA_FLAGS = GA_NO_DEAD | GA_NO_UNSCHEDULED;
+
+template<typename F>
+static double Time(int rounds, F&& fn)
+{
+	using namespace std::chrono;
+	auto start = steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		fn();
+	}
+	return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+	int actorCount = 250;
+	int ticks = 100;
+	int objects = 4;
+	int argi = 1;
+	for (; argi + 1 < argc && argv[argi][0] == '-'; argi += 2) {
+		if (!strcmp(argv[argi], "-n")) {
+			actorCount = atoi(argv[argi + 1]);
+		} else if (!strcmp(argv[argi], "-t")) {
+			ticks = atoi(argv[argi + 1]);
+		} else if (!strcmp(argv[argi], "-e")) {
+			objects = atoi(argv[argi + 1]);
+		}
+	}
+	if (argi >= argc || actorCount <= 0 || ticks <= 0 || objects <= 0) {
+		fprintf(stderr, "Usage: %s [-n actors] [-t ticks] [-e objects] <gemrb.cfg>\n", argv[0]);
+		return 1;
+	}
+	if (!Benchmark::BootCore(argv[argi])) {
+		fprintf(stderr, "The engine did not start with %s, run gemrb with it to see why\n", argv[argi]);
+		return 1;
+	}
+
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> xDist(0, AREA_SIZE.w - 1);
+	std::uniform_int_distribution<int> yDist(0, AREA_SIZE.h - 1);
+	std::vector<Actor*> actors;
+	for (int i = 0; i < actorCount; ++i) {
+		Actor* actor = new Actor();
+		actor->SetPos(Point(xDist(rng), yDist(rng)));
+		actors.push_back(actor);
+	}
+	fprintf(stdout, "%d actors, %d objects each per tick, %d ticks\n", actorCount, objects, ticks);
+
+	// an object of each actor matches every few actors, like an EA or class check
+	auto matches = [](int object, int i, int j) {
+		return i != j && (j + object + i) % (object + 2) == 0;
+	};
+
+	// the sums keep the matching from being optimized away and check the results
+	size_t oldPicked = 0;
+	size_t newPicked = 0;
+	size_t before = allocations;
+	double oldMs = Time(ticks, [&]() {
+		for (int i = 0; i < actorCount; ++i) {
+			for (int object = 0; object < objects; ++object) {
+				Legacy::Targets* tgts = new Legacy::Targets();
+				for (int j = 0; j < actorCount; ++j) {
+					if (!matches(object, i, j)) continue;
+					tgts->AddTarget(actors[j], Distance(actors[i]->Pos, actors[j]), GA_FLAGS);
+				}
+				const Scriptable* picked = tgts->GetTarget(object, ST_ACTOR);
+				if (picked) oldPicked += picked->GetGlobalID();
+				delete tgts;
+			}
+		}
+	});
+	size_t oldAllocations = allocations - before;
+
+	before = allocations;
+	double newMs = Time(ticks, [&]() {
+		for (int i = 0; i < actorCount; ++i) {
+			for (int object = 0; object < objects; ++object) {
+				Targets* tgts = Targets::Acquire();
+				for (int j = 0; j < actorCount; ++j) {
+					if (!matches(object, i, j)) continue;
+					tgts->AddTarget(actors[j], Distance(actors[i]->Pos, actors[j]), GA_FLAGS);
+				}
+				const Scriptable* picked = tgts->GetTarget(object, ST_ACTOR);
+				if (picked) newPicked += picked->GetGlobalID();
+				tgts->Release();
+			}
+		}
+	});
+	size_t newAllocations = allocations - before;
+
+	fprintf(stdout, "%-28s old %9.2f ms   new %9.2f ms   x%.2f\n", "object matching", oldMs, newMs, newMs > 0 ? oldMs / newMs : 0.0);
+	fprintf(stdout, "%-28s old %9.1f      new %9.1f\n", "allocations per tick", double(oldAllocations) / ticks, double(newAllocations) / ticks);
+
+	bool mismatch = oldPicked != newPicked;
+	if (mismatch) {
+		fprintf(stderr, "The pooled sets picked other targets than the lists\n");
+	}
+
+	for (Actor* actor : actors) {
+		delete actor;
+	}
+	Benchmark::ShutdownCore();
+	return mismatch ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2026 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Times the game variable and resource cache tables against the chained
+// tables they replaced, using the global variables of a saved game:
+//   gemrb_bench_variables BALDUR.gam [rounds]
+// Every round looks up each variable once, plus as many missing names.
+
+#include "Cache.h"
+#include "Variables.h"
+#include "LegacyTables.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace GemRB;
+
+static const size_t GAM_GLOBAL_OFFSET = 0x38; // followed by the count
+static const size_t GAM_GLOBAL_SIZE = 84; // name, 8 unused bytes, the value and 40 more
+
+static uint32_t LoadDword(const std::vector<char>& data, size_t pos)
+{
+	uint32_t value = 0;
+	for (int i = 3; i >= 0; --i) {
+		value = (value << 8) | uint8_t(data[pos + i]);
+	}
+	return value;
+}
+
+static bool LoadGlobals(const char* path, std::vector<std::string>& names, std::vector<ieDword>& values)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.size() < GAM_GLOBAL_OFFSET + 8 || memcmp(data.data(), "GAME", 4) != 0) {
+		return false;
+	}
+
+	size_t offset = LoadDword(data, GAM_GLOBAL_OFFSET);
+	size_t count = LoadDword(data, GAM_GLOBAL_OFFSET + 4);
+	if (offset + count * GAM_GLOBAL_SIZE > data.size()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		const char* entry = data.data() + offset + i * GAM_GLOBAL_SIZE;
+		std::string name(entry, strnlen(entry, ieVariable::Size));
+		// like ReadVariable
+		name.erase(name.find_last_not_of(' ') + 1);
+		names.push_back(name);
+		values.push_back(LoadDword(data, offset + i * GAM_GLOBAL_SIZE + 40));
+	}
+	return true;
+}
+
+template<typename F>
+static double Time(int rounds, F&& fn)
+{
+	using namespace std::chrono;
+	auto start = steady_clock::now();
+	for (int r = 0; r < rounds; ++r) {
+		fn();
+	}
+	return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+static void Report(const char* what, double oldMs, double newMs)
+{
+	printf("%-28s old %9.2f ms   new %9.2f ms   x%.2f\n", what, oldMs, newMs, newMs > 0 ? oldMs / newMs : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <game.gam> [rounds]\n", argv[0]);
+		return 1;
+	}
+	int rounds = argc > 2 ? atoi(argv[2]) : 1000;
+
+	std::vector<std::string> names;
+	std::vector<ieDword> values;
+	if (!LoadGlobals(argv[1], names, values) || names.empty()) {
+		fprintf(stderr, "%s has no global variables or is not a GAM file\n", argv[1]);
+		return 1;
+	}
+
+	// the misses share the prefixes, as checks of unset variables would
+	std::vector<std::string> missing;
+	for (const std::string& name : names) {
+		missing.push_back(name.substr(0, ieVariable::Size - 2) + "_X");
+	}
+	printf("%zu variables, %d rounds\n", names.size(), rounds);
+
+	Legacy::Variables oldVars;
+	oldVars.ParseKey(1);
+	Variables newVars;
+	newVars.SetType(GEM_VARIABLES_INT);
+	newVars.ParseKey(1);
+
+	double oldMs = Time(1, [&]() {
+		for (size_t i = 0; i < names.size(); ++i) {
+			oldVars.SetAt(StringView(names[i]), values[i]);
+		}
+	});
+	double newMs = Time(1, [&]() {
+		for (size_t i = 0; i < names.size(); ++i) {
+			newVars.SetAt(StringView(names[i]), values[i]);
+		}
+	});
+	Report("Variables load", oldMs, newMs);
+
+	// the sums keep the lookups from being optimized away and check the results
+	ieDword oldSum = 0;
+	ieDword newSum = 0;
+	oldMs = Time(rounds, [&]() {
+		ieDword value;
+		for (const std::string& name : names) {
+			if (oldVars.Lookup(StringView(name), value)) oldSum += value;
+		}
+	});
+	newMs = Time(rounds, [&]() {
+		ieDword value;
+		for (const std::string& name : names) {
+			if (newVars.Lookup(StringView(name), value)) newSum += value;
+		}
+	});
+	Report("Variables hits", oldMs, newMs);
+
+	oldMs = Time(rounds, [&]() {
+		ieDword value;
+		for (const std::string& name : missing) {
+			if (oldVars.Lookup(StringView(name), value)) oldSum += value;
+		}
+	});
+	newMs = Time(rounds, [&]() {
+		ieDword value;
+		for (const std::string& name : missing) {
+			if (newVars.Lookup(StringView(name), value)) newSum += value;
+		}
+	});
+	Report("Variables misses", oldMs, newMs);
+
+	// what compiled scripts do since the names are interned
+	std::vector<Variables::key_id> ids;
+	for (const std::string& name : names) {
+		ids.push_back(Variables::InternKey(StringView(name)));
+	}
+	ieDword internedSum = 0;
+	newMs = Time(rounds, [&]() {
+		ieDword value;
+		for (Variables::key_id id : ids) {
+			if (newVars.Lookup(id, value)) internedSum += value;
+		}
+	});
+	printf("%-28s                    new %9.2f ms\n", "Variables hits by id", newMs);
+
+	// resource names are shorter, so the cache sees fewer distinct keys
+	Legacy::Cache oldCache;
+	Cache newCache;
+	std::vector<ResRef> refs;
+	for (const std::string& name : names) {
+		refs.emplace_back(name.c_str());
+	}
+	for (ResRef& ref : refs) {
+		oldCache.SetAt(ref, &ref);
+		newCache.SetAt(ref, &ref);
+	}
+	size_t oldFound = 0;
+	size_t newFound = 0;
+	oldMs = Time(rounds, [&]() {
+		for (const ResRef& ref : refs) {
+			oldFound += oldCache.GetResource(ref) != nullptr;
+		}
+	});
+	newMs = Time(rounds, [&]() {
+		for (const ResRef& ref : refs) {
+			newFound += newCache.GetResource(ref) != nullptr;
+		}
+	});
+	Report("Cache hits", oldMs, newMs);
+	newCache.RemoveAll(nullptr);
+
+	if (oldSum != newSum || oldSum != internedSum || oldFound != newFound) {
+		fprintf(stderr, "the tables disagree!\n");
+		return 1;
+	}
+	return 0;
+}